@@ -0,0 +1,120 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+/**
+ * \file ReaderBenchmark.cpp
+ * \author Anthony Breant, Clement Poinsot, Jeremie Pantin, Mohamed Takhtoukh, Thomas Capet
+ * \version 1.0
+ * \date 17 october 2026
+ * \brief Measures the throughput of MfjFileReader on a synthetic file.
+ *
+ * Usage : Collision-Code-ReaderBench [nbGeometries] [nbAtoms] [dataFile]
+ */
+
+#include "../general/AtomInformations.h"
+#include "../math/RandomStream.h"
+#include "../reader/MfjFileReader.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+int main(int argc, char* argv[])
+{
+  const unsigned int nbGeometries = argc > 1 ? atoi(argv[1]) : 20000;
+  const unsigned int nbAtoms = argc > 2 ? atoi(argv[2]) : 100;
+  const std::string dataFile = argc > 3 ? argv[3] : "resources/atomInformations.csv";
+  const std::string fileName = "ReaderBenchmark.mfj";
+
+  try {
+    AtomInformations::getInstance()->loadFile(dataFile);
+
+    // Ensemble de conformeres : memes atomes, positions aleatoires.
+    const int masses[] = {12, 1, 14, 16};
+    RandomStream stream(0, 0, 0, 0, 0);
+    {
+      std::ofstream out(fileName.c_str());
+      out << "ReaderBenchmark" << std::endl << nbGeometries << std::endl << nbAtoms << std::endl
+          << "ang" << std::endl << "calc" << std::endl << "1.0000" << std::endl;
+      char line[128];
+      for (unsigned int g = 0; g < nbGeometries; ++g) {
+        for (unsigned int a = 0; a < nbAtoms; ++a) {
+          snprintf(line, sizeof(line), "%13.5f%13.5f%13.5f%4d%12.5f\n",
+                   40.0 * stream.getRandomNumber() - 20.0,
+                   40.0 * stream.getRandomNumber() - 20.0,
+                   40.0 * stream.getRandomNumber() - 20.0,
+                   masses[a % 4],
+                   stream.getRandomNumber() - 0.5);
+          out << line;
+        }
+        if (g < nbGeometries - 1) {
+          out << std::endl;
+        }
+      }
+    }
+    std::ifstream in(fileName.c_str(), std::ios::binary | std::ios::ate);
+    const double megaBytes = in.tellg() / 1e6;
+    in.close();
+
+    // Lecture a l'ancienne, ligne par ligne avec des flux, pour comparer :
+    // sans construction des molecules, c'est une borne basse de son cout.
+    auto start = std::chrono::steady_clock::now();
+    double checksum = 0.0;
+    {
+      std::ifstream file(fileName.c_str());
+      std::string line;
+      for (int i = 0; i < 6; ++i) {
+        std::getline(file, line);
+      }
+      while (std::getline(file, line)) {
+        std::istringstream iss(line);
+        std::string token;
+        while (iss >> token) {
+          std::istringstream value(token);
+          double v;
+          value >> v;
+          checksum += v;
+        }
+      }
+    }
+    double streamTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    MfjFileReader reader(fileName);
+    std::vector<Molecule*>* molecules = reader.loadResources();
+    double readerTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Geometries = " << molecules->size() << ", atoms = " << nbAtoms << ", size = " << megaBytes << " MB" << std::endl;
+    std::cout << "Streams (parsing only) : " << streamTime << " s (" << megaBytes / streamTime << " MB/s, "
+              << nbGeometries / streamTime << " geometries/s, checksum " << checksum << ")" << std::endl;
+    std::cout << "MfjFileReader : " << readerTime << " s (" << megaBytes / readerTime << " MB/s, "
+              << nbGeometries / readerTime << " geometries/s)" << std::endl;
+
+    for (unsigned int i = 0; i < molecules->size(); ++i) {
+      delete (*molecules)[i];
+    }
+    delete molecules;
+  } catch (std::string& e) {
+    std::cerr << e << std::endl;
+    remove(fileName.c_str());
+    return 1;
+  }
+
+  remove(fileName.c_str());
+  return 0;
+}
@@ -0,0 +1,93 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+/**
+ * \file RotationBenchmark.cpp
+ * \author Anthony Breant, Clement Poinsot, Jeremie Pantin, Mohamed Takhtoukh, Thomas Capet
+ * \version 1.0
+ * \date 17 october 2026
+ * \brief Compares the rotations by angles and by matrix of StdMathLib.
+ *
+ * Usage : Collision-Code-Bench [nbAtoms] [nbRotations]
+ */
+
+#include "../math/StdMathLib.h"
+#include "../math/RandomStream.h"
+#include "../math/RotationMatrix.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+int main(int argc, char* argv[])
+{
+  const unsigned int nbAtoms = argc > 1 ? atoi(argv[1]) : 1000;
+  const unsigned int nbRotations = argc > 2 ? atoi(argv[2]) : 10000;
+
+  StdMathLib mathLib;
+
+  // Positions aleatoires dans une boite de 20 angstroms.
+  RandomStream positionStream(0, 0, 0, 0, 0);
+  std::vector<Vector3D> initPos(nbAtoms);
+  for (unsigned int i = 0; i < nbAtoms; ++i) {
+    initPos[i].x = 20.0 * positionStream.getRandomNumber() - 10.0;
+    initPos[i].y = 20.0 * positionStream.getRandomNumber() - 10.0;
+    initPos[i].z = 20.0 * positionStream.getRandomNumber() - 10.0;
+  }
+  std::vector<Vector3D> anglePos(initPos);
+  std::vector<Vector3D> matrixPos(initPos);
+
+  // Memes angles pour les deux versions.
+  std::vector<double> angles(3 * nbRotations);
+  RandomStream angleStream(0, 0, 0, 0, 1);
+  for (unsigned int i = 0; i < angles.size(); ++i) {
+    angles[i] = 2.0 * M_PI * angleStream.getRandomNumber();
+  }
+
+  // Le checksum empeche le compilateur de supprimer les rotations.
+  double angleChecksum = 0.0;
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned int r = 0; r < nbRotations; ++r) {
+    mathLib.rotate(initPos, anglePos, angles[3 * r], angles[3 * r + 1], angles[3 * r + 2]);
+    angleChecksum += anglePos[r % nbAtoms].x;
+  }
+  double angleTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  double matrixChecksum = 0.0;
+  start = std::chrono::steady_clock::now();
+  for (unsigned int r = 0; r < nbRotations; ++r) {
+    mathLib.rotate(mathLib.calculateRotationMatrix(angles[3 * r], angles[3 * r + 1], angles[3 * r + 2]), initPos, matrixPos);
+    matrixChecksum += matrixPos[r % nbAtoms].x;
+  }
+  double matrixTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  // Ecart maximal entre les deux versions, sur la derniere rotation.
+  double maxDiff = 0.0;
+  for (unsigned int i = 0; i < nbAtoms; ++i) {
+    maxDiff = std::max(maxDiff, fabs(anglePos[i].x - matrixPos[i].x));
+    maxDiff = std::max(maxDiff, fabs(anglePos[i].y - matrixPos[i].y));
+    maxDiff = std::max(maxDiff, fabs(anglePos[i].z - matrixPos[i].z));
+  }
+
+  const double nbPositions = (double) nbAtoms * nbRotations;
+  std::cout << "Atoms = " << nbAtoms << ", rotations = " << nbRotations << std::endl;
+  std::cout << "Angles : " << angleTime << " s (" << 1e9 * angleTime / nbPositions << " ns per atom)" << std::endl;
+  std::cout << "Matrix : " << matrixTime << " s (" << 1e9 * matrixTime / nbPositions << " ns per atom)" << std::endl;
+  std::cout << "Speedup = " << angleTime / matrixTime << std::endl;
+  std::cout << "Maximal difference = " << maxDiff << " A (checksums " << angleChecksum << ", " << matrixChecksum << ")" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+/**
+ * \file ScalingBenchmark.cpp
+ * \author Anthony Breant, Clement Poinsot, Jeremie Pantin, Mohamed Takhtoukh, Thomas Capet
+ * \version 1.0
+ * \date 17 october 2026
+ * \brief Measures the speedup of TM and of EHSS and PA with the number of
+ * threads, on the first geometry of a file.
+ *
+ * The workload is fixed : 2 cycles of 10 velocities and 100 trajectories for
+ * TM, 200000 Monte-Carlo points for EHSS and PA. The threads are doubled from
+ * 1 to maxThreads. The results do not depend on the number of threads.
+ *
+ * Usage : Collision-Code-ScalingBench [maxThreads] [inFile] [dataFile]
+ */
+
+#include "../general/AtomInformations.h"
+#include "../general/GlobalParameters.h"
+#include "../general/StdGeometryCalculator.h"
+#include "../general/SystemParameters.h"
+#include "../math/RandomGenerator.h"
+#include "../reader/StdExtractResources.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Calculates a geometry with the methods chosen.
+ * \param calculator the calculator, its methods chosen.
+ * \param mol the geometry.
+ * \param nbThreads the number of threads.
+ * \param value the TM, or EHSS, result.
+ * \return the time of the calculation, in seconds.
+ */
+double timeCalculation(StdGeometryCalculator& calculator, Molecule* mol, unsigned int nbThreads, double& value)
+{
+  SystemParameters::getInstance()->setMaximalNumberThreads(nbThreads);
+  // Memes nombres aleatoires pour tous les nombres de threads.
+  RandomGenerator::getInstance()->setSeed(0);
+
+  auto start = std::chrono::steady_clock::now();
+  Result* result = calculator.calculate(mol, 0);
+  double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  value = calculator.willTMBeCalculated() ? result->getTM() : result->getEHSS();
+  delete result;
+  return time;
+}
+
+int main(int argc, char* argv[])
+{
+  const unsigned int maxThreads = argc > 1 ? atoi(argv[1]) : std::max(std::thread::hardware_concurrency(), 1u);
+  const std::string inFile = argc > 2 ? argv[2] : "resources/a10A1.mfj";
+  const std::string dataFile = argc > 3 ? argv[3] : "resources/atomInformations.csv";
+
+  try {
+    AtomInformations::getInstance()->loadFile(dataFile);
+
+    StdExtractResources extractor;
+    std::vector<Molecule*>* molecules = extractor.getGeometriesFromFile(inFile);
+    if (molecules == nullptr || molecules->empty()) {
+      throw "Impossible to load file " + inFile + ".";
+    }
+    Molecule* mol = (*molecules)[0];
+
+    GlobalParameters* parameters = GlobalParameters::getInstance();
+    parameters->setNumberCompleteCycles(2);
+    parameters->setNumberVelocityPoints(10);
+    parameters->setNbPointsMCIntegrationTM(100);
+    parameters->setNbPointsMCIntegrationEHSSPA(200000);
+
+    // Un calculateur par methode, les valeurs lues a la construction.
+    StdGeometryCalculator tmCalculator;
+    tmCalculator.shouldEHSSBeCalculated(false);
+    tmCalculator.shouldPABeCalculated(false);
+    tmCalculator.shouldAsymmetryParameterBeCalculated(false);
+    StdGeometryCalculator ehssPACalculator;
+    ehssPACalculator.shouldTMBeCalculated(false);
+    ehssPACalculator.shouldAsymmetryParameterBeCalculated(false);
+
+    std::vector<unsigned int> nbThreads;
+    for (unsigned int th = 1; th < maxThreads; th *= 2) {
+      nbThreads.push_back(th);
+    }
+    nbThreads.push_back(maxThreads);
+
+    std::cout << "Geometry = " << inFile << " (" << mol->getAtomNumber() << " atoms), hardware threads = "
+              << std::thread::hardware_concurrency() << std::endl;
+    std::cout << "Threads\tTM (s)\tSpeedup\tEfficiency\tEHSS/PA (s)\tSpeedup\tEfficiency\tTM\tEHSS" << std::endl;
+    double tmReference = 0.0;
+    double ehssPAReference = 0.0;
+    for (unsigned int i = 0; i < nbThreads.size(); ++i) {
+      const unsigned int th = nbThreads[i];
+      double tm = 0.0;
+      double ehss = 0.0;
+      const double tmTime = timeCalculation(tmCalculator, mol, th, tm);
+      const double ehssPATime = timeCalculation(ehssPACalculator, mol, th, ehss);
+      if (i == 0) {
+        tmReference = tmTime;
+        ehssPAReference = ehssPATime;
+      }
+      std::cout << th << "\t" << tmTime << "\t" << tmReference / tmTime << "\t" << tmReference / tmTime / th
+                << "\t" << ehssPATime << "\t" << ehssPAReference / ehssPATime << "\t"
+                << ehssPAReference / ehssPATime / th << "\t" << tm << "\t" << ehss << std::endl;
+    }
+
+    for (unsigned int i = 0; i < molecules->size(); ++i) {
+      delete (*molecules)[i];
+    }
+    delete molecules;
+  } catch (std::string& e) {
+    std::cerr << e << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -1,5 +1,6 @@
 #include "ConsoleView.h"
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <string>
@@ -7,11 +8,16 @@
 #include <chrono>
 #include <sstream>
 #include <iomanip>
+#include <cmath>
+#include <stdexcept>
 
 #include "../general/StdCmdView.h"
 #include "../general/AtomInformations.h"
 #include "../general/SystemParameters.h"
 #include "../general/GlobalParameters.h"
+#include "../math/StdPotentialEngine.h"
+#include "../math/StdCalculationOperator.h"
+#include "../math/RandomGenerator.h"
 #include "../observer/Event.h"
 #include "../observer/state/CalculationState.h"
 
@@ -19,7 +25,7 @@
 ConsoleView::ConsoleView(int argc, char* const argv[])
   : m_cmdView(nullptr), m_dataFile("resources/atomInformations.csv"),
   m_outFile("resCollision.ccout"), m_error(false),
-  m_geometriesFinished(0u), m_verbose(true)
+  m_geometriesFinished(0u), m_totalNumberGeometries(0u), m_verbose(true), m_streaming(false)
 {
   if (argc < 2) {
     // Pas de nom de fichier, c'est une erreur, on va rien faire.
@@ -47,42 +53,53 @@ void ConsoleView::update(ObservableEvent cond, Observable* obs) {
     switch(cond) {
     case ObservableEvent::EHSS_STARTED:
       if (m_cmdView->willEHSSBeCalculated()) {
-        std::cout << "[Geom. " << m_geometriesFinished + 1 << "/" << m_totalNumberGeometries << "] : Start EHSS" << std::endl;
+        std::cout << getGeometryLabel() << " : Start EHSS" << std::endl;
       }
       break;
 
     case ObservableEvent::PA_STARTED:
       if (m_cmdView->willPABeCalculated()) {
-        std::cout << "[Geom. " << m_geometriesFinished + 1 << "/" << m_totalNumberGeometries << "] : Start PA" << std::endl;
+        std::cout << getGeometryLabel() << " : Start PA" << std::endl;
       }
       break;
 
     case ObservableEvent::TM_STARTED:
-      std::cout << "[Geom. " << m_geometriesFinished + 1 << "/" << m_totalNumberGeometries << "] : Start TM" << std::endl;
+      std::cout << getGeometryLabel() << " : Start TM" << std::endl;
       break;
 
     case ObservableEvent::EHSS_ENDED:
       if (m_cmdView->willEHSSBeCalculated()) {
-        std::cout << "[Geom. " << m_geometriesFinished + 1 << "/" << m_totalNumberGeometries << "] : End EHSS" << std::endl;
+        std::cout << getGeometryLabel() << " : End EHSS" << std::endl;
         cS = dynamic_cast<CalculationState*>(obs);
-        std::cout << "[Geom. " << m_geometriesFinished + 1 << "/" << m_totalNumberGeometries << "] : EHSS = " << cS->getEHSSResult() << std::endl;
+        std::cout << getGeometryLabel() << " : EHSS = " << cS->getEHSSResult() << std::endl;
       }
       break;
 
     case ObservableEvent::PA_ENDED:
       if (m_cmdView->willPABeCalculated()) {
-        std::cout << "[Geom. " << m_geometriesFinished + 1 << "/" << m_totalNumberGeometries << "] : End PA" << std::endl;
+        std::cout << getGeometryLabel() << " : End PA" << std::endl;
         cS = dynamic_cast<CalculationState*>(obs);
-        std::cout << "[Geom. " << m_geometriesFinished + 1 << "/" << m_totalNumberGeometries << "] : PA = " << cS->getPAResult() << std::endl;
+        std::cout << getGeometryLabel() << " : PA = " << cS->getPAResult() << std::endl;
       }
       break;
 
+    case ObservableEvent::TM_CYCLE_ENDED:
+      cS = dynamic_cast<CalculationState*>(obs);
+      std::cout << std::fixed << std::setprecision(2);
+      std::cout << std::endl << getGeometryLabel() << " : Cycle " << cS->getNumberTMCycles() << " : TM = " << cS->getTMCycleResult();
+      // Pas d'erreur standard avec un seul cycle.
+      if (std::isfinite(cS->getTMCycleStandardError())) {
+        std::cout << " (+/- " << cS->getTMCycleStandardError() << " %)";
+      }
+      std::cout << std::endl;
+      break;
+
     case ObservableEvent::TM_ENDED:
       cS = dynamic_cast<CalculationState*>(obs);
       std::cout << std::fixed;
       std::cout << std::setprecision(2) << "\r " << cS->getPercentageFinishedTrajectories() << "% (" << cS->getNumberFinishedTractories() << "/" << cS->getNumberTotalTractories() << ")";
-      std::cout << std::endl << "[Geom. " << m_geometriesFinished + 1 << "/" << m_totalNumberGeometries << "] : End TM" << std::endl;
-      std::cout << "[Geom. " << m_geometriesFinished + 1 << "/" << m_totalNumberGeometries << "] : TM = " << cS->getTMResult() << std::endl;
+      std::cout << std::endl << getGeometryLabel() << " : End TM" << std::endl;
+      std::cout << getGeometryLabel() << " : TM = " << cS->getTMResult() << std::endl;
       std::cout << "-----" << std::endl;
       m_geometriesFinished++;
       break;
@@ -131,15 +148,27 @@ void ConsoleView::launch() {
 
     // On va la chronométrer.
     std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
-    // On charge les fichiers
-    m_totalNumberGeometries = m_cmdView->loadInputFiles();
+    if (m_streaming) {
+      // Les geometries sont lues pendant les calculs : leur nombre n'est
+      // pas connu a l'avance.
+      if (m_verbose) {
+        std::cout << "Streaming geometries from " << m_cmdView->getInputFiles()[0] << " to " << m_outFile << std::endl;
+        std::cout << "-----" << std::endl;
+      }
+      m_cmdView->setOutputFile(m_outFile);
+      m_cmdView->launchStreaming();
+    } else {
+      // On charge les fichiers
+      m_totalNumberGeometries = m_cmdView->loadInputFiles();
 
-    // On lance les calculs
-    m_cmdView->launch();
+      // On lance les calculs, le point de reprise etant a cote du fichier
+      // de sortie.
+      m_cmdView->setOutputFile(m_outFile);
+      m_cmdView->launch();
 
-    // Sauvegarde des resultats.
-    m_cmdView->setOutputFile(m_outFile);
-    m_cmdView->saveResults();
+      // Sauvegarde des resultats.
+      m_cmdView->saveResults();
+    }
     std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
     // On calcule le temps dexécution.
     std::chrono::duration<double, std::milli> duration = t2 - t1;
@@ -170,6 +199,7 @@ void ConsoleView::parse(int argc, char* const argv[]) {
   }
 
   // Lecture des options.
+  bool seedGiven = false;
   for (; i < argc;) {
     if (strcmp(argv[i], "-tab") == 0) {
       /// Fichier de données sur les atomes.
@@ -216,6 +246,14 @@ void ConsoleView::parse(int argc, char* const argv[]) {
       /// Pas de calcul de TM.
       m_cmdView->shouldTMBeCalculated(false);
       i++;
+    } else if (strcmp(argv[i], "-noasym") == 0) {
+      /// Pas de calcul du parametre d'asymetrie.
+      m_cmdView->shouldAsymmetryParameterBeCalculated(false);
+      i++;
+    } else if (strcmp(argv[i], "-stream") == 0) {
+      /// Calculs pendant la lecture des geometries.
+      m_streaming = true;
+      i++;
     } else if (strcmp(argv[i], "--help") == 0) {
       /// Affichage de l'aide.
       printHelp(argv[0]);
@@ -245,6 +283,346 @@ void ConsoleView::parse(int argc, char* const argv[]) {
         return;
       }
       i++;
+    } else if (strcmp(argv[i], "-seed") == 0) {
+      /// Graine des nombres aleatoires.
+      i++;
+      // Si on n'a pas de graine apres, c'est une erreur.
+      if (i == argc) {
+        printError(argv[0], "Veuillez entrer une graine.");
+        return;
+      }
+      // On prend la graine.
+      try {
+        int seed = convertToInteger(std::string(argv[i]));
+        if (seed < 0) {
+          printError(argv[0], "Veuillez entrer une graine valide.");
+          return;
+        }
+        RandomGenerator::getInstance()->setSeed(seed);
+        seedGiven = true;
+      } catch(std::invalid_argument e) {
+        printError(argv[0], "Veuillez entrer une graine valide.");
+        return;
+      }
+      i++;
+    } else if (strcmp(argv[i], "-ckpt") == 0) {
+      /// Intervalle entre deux points de reprise.
+      i++;
+      // Si on n'a pas d'intervalle apres, c'est une erreur.
+      if (i == argc) {
+        printError(argv[0], "Veuillez entrer un intervalle entre deux points de reprise.");
+        return;
+      }
+      // On prend l'intervalle.
+      try {
+        double interval = convertToDouble(std::string(argv[i]));
+        if (interval <= 0.0) {
+          printError(argv[0], "Veuillez entrer un intervalle entre deux points de reprise valide.");
+          return;
+        }
+        SystemParameters::getInstance()->setCheckpointInterval(interval);
+      } catch(std::invalid_argument e) {
+        printError(argv[0], "Veuillez entrer un intervalle entre deux points de reprise valide.");
+        return;
+      }
+      i++;
+    } else if (strcmp(argv[i], "-resume") == 0) {
+      /// Reprise depuis le point de reprise.
+      SystemParameters::getInstance()->setResumed(true);
+      i++;
+    } else if (strcmp(argv[i], "-cache") == 0) {
+      /// Fichier du cache des resultats.
+      i++;
+      // Si on n'a pas de nom de fichier apres, c'est une erreur.
+      if (i == argc) {
+        printError(argv[0], "Veuillez entrer un nom de fichier de cache des resultats.");
+        return;
+      }
+      // On a un nom de fichier, on le prend.
+      SystemParameters::getInstance()->setResultCacheFile(argv[i]);
+      i++;
+    } else if (strcmp(argv[i], "-cachemax") == 0) {
+      /// Taille maximale du cache des resultats.
+      i++;
+      // Si on n'a pas de taille apres, c'est une erreur.
+      if (i == argc) {
+        printError(argv[0], "Veuillez entrer une taille maximale du cache des resultats.");
+        return;
+      }
+      // On prend la taille.
+      try {
+        double size = convertToDouble(std::string(argv[i]));
+        if (size <= 0.0) {
+          printError(argv[0], "Veuillez entrer une taille maximale du cache des resultats valide.");
+          return;
+        }
+        SystemParameters::getInstance()->setResultCacheMaxSize(size);
+      } catch(std::invalid_argument e) {
+        printError(argv[0], "Veuillez entrer une taille maximale du cache des resultats valide.");
+        return;
+      }
+      i++;
+    } else if (strcmp(argv[i], "-kernel") == 0) {
+      /// Noyau de calcul du potentiel.
+      i++;
+      // Si on n'a pas de noyau apres, c'est une erreur.
+      if (i == argc) {
+        printError(argv[0], "Veuillez entrer un noyau de calcul du potentiel.");
+        return;
+      }
+      // On prend le noyau.
+      PotentialKernel kernel;
+      if (!StdPotentialEngine::findKernel(std::string(argv[i]), kernel)) {
+        printError(argv[0], "Veuillez entrer un noyau de calcul du potentiel valide (auto, scalar, simd, avx2, avx512).");
+        return;
+      }
+      SystemParameters::getInstance()->setPotentialKernel(kernel);
+      i++;
+    } else if (strcmp(argv[i], "-batch") == 0) {
+      /// Nombre de trajectoires integrees ensemble.
+      i++;
+      // Si on n'a pas de nombre de trajectoires apres, c'est une erreur.
+      if (i == argc) {
+        printError(argv[0], "Veuillez entrer un nombre de trajectoires integrees ensemble.");
+        return;
+      }
+      // On prend le nombre de trajectoires.
+      try {
+        int batchSize = convertToInteger(std::string(argv[i]));
+        if (batchSize < 1) {
+          printError(argv[0], "Veuillez entrer un nombre de trajectoires integrees ensemble valide.");
+          return;
+        }
+        SystemParameters::getInstance()->setTrajectoryBatchSize(batchSize);
+      } catch(std::invalid_argument e) {
+        printError(argv[0], "Veuillez entrer un nombre de trajectoires integrees ensemble valide.");
+        return;
+      }
+      i++;
+    } else if (strcmp(argv[i], "-progress") == 0) {
+      /// Frequence d'affichage de la progression.
+      i++;
+      // Si on n'a pas de frequence apres, c'est une erreur.
+      if (i == argc) {
+        printError(argv[0], "Veuillez entrer une frequence d'affichage de la progression.");
+        return;
+      }
+      // On prend la frequence.
+      try {
+        double rate = convertToDouble(std::string(argv[i]));
+        if (rate <= 0.0) {
+          printError(argv[0], "Veuillez entrer une frequence d'affichage de la progression valide.");
+          return;
+        }
+        SystemParameters::getInstance()->setProgressRate(rate);
+      } catch(std::invalid_argument e) {
+        printError(argv[0], "Veuillez entrer une frequence d'affichage de la progression valide.");
+        return;
+      }
+      i++;
+    } else if (strcmp(argv[i], "-integ") == 0) {
+      /// Integrateur des trajectoires.
+      i++;
+      // Si on n'a pas d'integrateur apres, c'est une erreur.
+      if (i == argc) {
+        printError(argv[0], "Veuillez entrer un integrateur des trajectoires.");
+        return;
+      }
+      // On prend l'integrateur.
+      if (strcmp(argv[i], "mobcal") == 0) {
+        GlobalParameters::getInstance()->setTrajectoryIntegrator(TrajectoryIntegrator::MOBCAL);
+      } else if (strcmp(argv[i], "dopri") == 0) {
+        GlobalParameters::getInstance()->setTrajectoryIntegrator(TrajectoryIntegrator::DORMAND_PRINCE);
+      } else {
+        printError(argv[0], "Veuillez entrer un integrateur des trajectoires valide (mobcal, dopri).");
+        return;
+      }
+      i++;
+    } else if (strcmp(argv[i], "-tol") == 0) {
+      /// Tolerance de l'integrateur adaptatif.
+      i++;
+      // Si on n'a pas de tolerance apres, c'est une erreur.
+      if (i == argc) {
+        printError(argv[0], "Veuillez entrer une tolerance de l'integrateur.");
+        return;
+      }
+      // On prend la tolerance.
+      try {
+        double tolerance = convertToDouble(std::string(argv[i]));
+        if (tolerance <= 0.0) {
+          printError(argv[0], "Veuillez entrer une tolerance de l'integrateur valide.");
+          return;
+        }
+        GlobalParameters::getInstance()->setIntegratorTolerance(tolerance);
+      } catch(std::invalid_argument e) {
+        printError(argv[0], "Veuillez entrer une tolerance de l'integrateur valide.");
+        return;
+      }
+      i++;
+    } else if (strcmp(argv[i], "-pam") == 0) {
+      /// Methode de calcul de PA.
+      i++;
+      // Si on n'a pas de methode apres, c'est une erreur.
+      if (i == argc) {
+        printError(argv[0], "Veuillez entrer une methode de calcul de PA.");
+        return;
+      }
+      // On prend la methode.
+      if (strcmp(argv[i], "mc") == 0) {
+        GlobalParameters::getInstance()->setPAMethod(PAMethod::MONTE_CARLO);
+      } else if (strcmp(argv[i], "raster") == 0) {
+        GlobalParameters::getInstance()->setPAMethod(PAMethod::RASTER);
+      } else {
+        printError(argv[0], "Veuillez entrer une methode de calcul de PA valide (mc, raster).");
+        return;
+      }
+      i++;
+    } else if (strcmp(argv[i], "-pao") == 0) {
+      /// Nombre d'orientations de PA rasterisee.
+      i++;
+      // Si on n'a pas de nombre apres, c'est une erreur.
+      if (i == argc) {
+        printError(argv[0], "Veuillez entrer un nombre d'orientations pour PA.");
+        return;
+      }
+      // On prend le nombre.
+      try {
+        int nbOrientations = convertToInteger(std::string(argv[i]));
+        if (nbOrientations <= 0) {
+          printError(argv[0], "Veuillez entrer un nombre d'orientations pour PA valide.");
+          return;
+        }
+        GlobalParameters::getInstance()->setNbOrientationsPA(nbOrientations);
+      } catch(std::invalid_argument e) {
+        printError(argv[0], "Veuillez entrer un nombre d'orientations pour PA valide.");
+        return;
+      }
+      i++;
+    } else if (strcmp(argv[i], "-paps") == 0) {
+      /// Taille des pixels de PA rasterisee.
+      i++;
+      // Si on n'a pas de taille apres, c'est une erreur.
+      if (i == argc) {
+        printError(argv[0], "Veuillez entrer une taille de pixel pour PA.");
+        return;
+      }
+      // On prend la taille.
+      try {
+        double pixelSize = convertToDouble(std::string(argv[i]));
+        if (pixelSize <= 0.0) {
+          printError(argv[0], "Veuillez entrer une taille de pixel pour PA valide.");
+          return;
+        }
+        GlobalParameters::getInstance()->setPAPixelSize(pixelSize);
+      } catch(std::invalid_argument e) {
+        printError(argv[0], "Veuillez entrer une taille de pixel pour PA valide.");
+        return;
+      }
+      i++;
+    } else if (strcmp(argv[i], "-pot") == 0) {
+      /// Methode d'evaluation du potentiel.
+      i++;
+      // Si on n'a pas de methode apres, c'est une erreur.
+      if (i == argc) {
+        printError(argv[0], "Veuillez entrer une methode d'evaluation du potentiel.");
+        return;
+      }
+      // On prend la methode.
+      if (strcmp(argv[i], "exact") == 0) {
+        GlobalParameters::getInstance()->setPotentialMode(PotentialMode::EXACT);
+      } else if (strcmp(argv[i], "celllist") == 0) {
+        GlobalParameters::getInstance()->setPotentialMode(PotentialMode::CELL_LIST);
+      } else if (strcmp(argv[i], "grid") == 0) {
+        GlobalParameters::getInstance()->setPotentialMode(PotentialMode::GRID);
+      } else {
+        printError(argv[0], "Veuillez entrer une methode d'evaluation du potentiel valide (exact, celllist, grid).");
+        return;
+      }
+      i++;
+    } else if (strcmp(argv[i], "-clcut") == 0) {
+      /// Distance de coupure de la liste de cellules.
+      i++;
+      // Si on n'a pas de distance apres, c'est une erreur.
+      if (i == argc) {
+        printError(argv[0], "Veuillez entrer une distance de coupure.");
+        return;
+      }
+      // On prend la distance.
+      try {
+        double cutoff = convertToDouble(std::string(argv[i]));
+        if (cutoff <= 0.0) {
+          printError(argv[0], "Veuillez entrer une distance de coupure valide.");
+          return;
+        }
+        GlobalParameters::getInstance()->setCellListCutoff(cutoff);
+      } catch(std::invalid_argument e) {
+        printError(argv[0], "Veuillez entrer une distance de coupure valide.");
+        return;
+      }
+      i++;
+    } else if (strcmp(argv[i], "-clsize") == 0) {
+      /// Taille des cellules de la liste de cellules.
+      i++;
+      // Si on n'a pas de taille apres, c'est une erreur.
+      if (i == argc) {
+        printError(argv[0], "Veuillez entrer une taille de cellule.");
+        return;
+      }
+      // On prend la taille.
+      try {
+        double cellSize = convertToDouble(std::string(argv[i]));
+        if (cellSize <= 0.0) {
+          printError(argv[0], "Veuillez entrer une taille de cellule valide.");
+          return;
+        }
+        GlobalParameters::getInstance()->setCellListCellSize(cellSize);
+      } catch(std::invalid_argument e) {
+        printError(argv[0], "Veuillez entrer une taille de cellule valide.");
+        return;
+      }
+      i++;
+    } else if (strcmp(argv[i], "-gridsp") == 0) {
+      /// Pas de la grille du potentiel.
+      i++;
+      // Si on n'a pas de pas apres, c'est une erreur.
+      if (i == argc) {
+        printError(argv[0], "Veuillez entrer un pas de grille.");
+        return;
+      }
+      // On prend le pas.
+      try {
+        double spacing = convertToDouble(std::string(argv[i]));
+        if (spacing <= 0.0) {
+          printError(argv[0], "Veuillez entrer un pas de grille valide.");
+          return;
+        }
+        GlobalParameters::getInstance()->setGridSpacing(spacing);
+      } catch(std::invalid_argument e) {
+        printError(argv[0], "Veuillez entrer un pas de grille valide.");
+        return;
+      }
+      i++;
+    } else if (strcmp(argv[i], "-gridext") == 0) {
+      /// Marge de la grille du potentiel autour de la molecule.
+      i++;
+      // Si on n'a pas de marge apres, c'est une erreur.
+      if (i == argc) {
+        printError(argv[0], "Veuillez entrer une marge de grille.");
+        return;
+      }
+      // On prend la marge.
+      try {
+        double extent = convertToDouble(std::string(argv[i]));
+        if (extent < 0.0) {
+          printError(argv[0], "Veuillez entrer une marge de grille valide.");
+          return;
+        }
+        GlobalParameters::getInstance()->setGridExtent(extent);
+      } catch(std::invalid_argument e) {
+        printError(argv[0], "Veuillez entrer une marge de grille valide.");
+        return;
+      }
+      i++;
     } else if (strcmp(argv[i], "-temp") == 0) {
       /// Temperature
       i++;
@@ -262,6 +640,61 @@ void ConsoleView::parse(int argc, char* const argv[]) {
         return;
       }
       i++;
+    } else if (strcmp(argv[i], "-temps") == 0) {
+      /// Temperatures du balayage de TM.
+      i++;
+      // Si on n'a pas de temperatures apres, c'est une erreur.
+      if (i == argc) {
+        printError(argv[0], "Veuillez entrer des temperatures separees par des virgules.");
+        return;
+      }
+      // On prend les temperatures.
+      try {
+        std::vector<double> temperatures;
+        std::istringstream iss(argv[i]);
+        std::string temperature;
+        while (std::getline(iss, temperature, ',')) {
+          temperatures.push_back(convertToDouble(temperature));
+          if (temperatures.back() <= 0.0) {
+            throw std::invalid_argument("Negative temperature");
+          }
+        }
+        if (temperatures.empty()) {
+          throw std::invalid_argument("No temperature");
+        }
+        // La premiere est la temperature du calcul.
+        GlobalParameters::getInstance()->setTemperature(temperatures[0]);
+        GlobalParameters::getInstance()->setTemperatureSweep(temperatures);
+      } catch(std::invalid_argument e) {
+        printError(argv[0], "Veuillez entrer des temperatures valides, separees par des virgules.");
+        return;
+      }
+      i++;
+    } else if (strcmp(argv[i], "-gas") == 0) {
+      /// Gaz tampons de TM.
+      i++;
+      // Si on n'a pas de gaz apres, c'est une erreur.
+      if (i == argc) {
+        printError(argv[0], "Veuillez entrer des gaz separes par des virgules.");
+        return;
+      }
+      // On prend les gaz, chacun une seule fois.
+      std::vector<BufferGas> gases;
+      std::istringstream iss(argv[i]);
+      std::string name;
+      bool valid = true;
+      while (valid && std::getline(iss, name, ',')) {
+        BufferGas gas;
+        valid = StdCalculationOperator::findBufferGas(name, gas)
+                && std::find(gases.begin(), gases.end(), gas) == gases.end();
+        gases.push_back(gas);
+      }
+      if (!valid || gases.empty()) {
+        printError(argv[0], "Veuillez entrer des gaz valides (he, n2, uffhe, uffn2), separes par des virgules et sans repetition.");
+        return;
+      }
+      GlobalParameters::getInstance()->setBufferGases(gases);
+      i++;
     } else if (strcmp(argv[i], "-mtp") == 0) {
       /// Nombre de points dans les integrations de Monte-Carlo pour les methodes EHSS et PA.
       i++;
@@ -381,6 +814,69 @@ void ConsoleView::parse(int argc, char* const argv[]) {
         return;
       }
       i++;
+    } else if (strcmp(argv[i], "-tmse") == 0) {
+      /// Erreur standard relative visee pour la methode TM.
+      i++;
+      // Si on n'a pas d'erreur apres, c'est une erreur.
+      if (i == argc) {
+        printError(argv[0], "Veuillez entrer une erreur standard relative visee pour la methode TM.");
+        return;
+      }
+      // On prend l'erreur.
+      try {
+        double target = convertToDouble(std::string(argv[i]));
+        if (target < 0.0) {
+          throw std::invalid_argument("Negative target");
+        }
+        GlobalParameters::getInstance()->setTMStandardErrorTarget(target);
+      } catch(std::invalid_argument e) {
+        printError(argv[0], "Veuillez entrer une erreur standard relative visee pour la methode TM valide.");
+        return;
+      }
+      i++;
+    } else if (strcmp(argv[i], "-b2warm") == 0) {
+      /// Recherche de b2max a partir de la geometrie precedente.
+      GlobalParameters::getInstance()->setB2maxWarmStart(true);
+      i++;
+    } else if (strcmp(argv[i], "-samp") == 0) {
+      /// Echantillonnage des trajectoires.
+      i++;
+      // Si on n'a pas de methode apres, c'est une erreur.
+      if (i == argc) {
+        printError(argv[0], "Veuillez entrer une methode d'echantillonnage des trajectoires.");
+        return;
+      }
+      // On prend la methode.
+      if (strcmp(argv[i], "mc") == 0) {
+        GlobalParameters::getInstance()->setSamplingMethod(SamplingMethod::MONTE_CARLO);
+      } else if (strcmp(argv[i], "sobol") == 0) {
+        GlobalParameters::getInstance()->setSamplingMethod(SamplingMethod::SOBOL);
+      } else {
+        printError(argv[0], "Veuillez entrer une methode d'echantillonnage des trajectoires valide (mc, sobol).");
+        return;
+      }
+      i++;
+    } else if (strcmp(argv[i], "-qmcr") == 0) {
+      /// Nombre de repliques des points de Sobol de EHSS/PA.
+      i++;
+      // Si on n'a pas de nombre apres, c'est une erreur.
+      if (i == argc) {
+        printError(argv[0], "Veuillez entrer un nombre de repliques des points de Sobol.");
+        return;
+      }
+      // On prend le nombre.
+      try {
+        int nbReplicates = convertToInteger(std::string(argv[i]));
+        if (nbReplicates < 2) {
+          printError(argv[0], "Veuillez entrer un nombre de repliques des points de Sobol valide (au moins 2).");
+          return;
+        }
+        GlobalParameters::getInstance()->setNbReplicatesQMC(nbReplicates);
+      } catch(std::invalid_argument e) {
+        printError(argv[0], "Veuillez entrer un nombre de repliques des points de Sobol valide.");
+        return;
+      }
+      i++;
     } else if (strcmp(argv[i], "-inp") == 0) {
       /// Nombre de points dans les integrations de vitesse.
       i++;
@@ -421,13 +917,19 @@ void ConsoleView::parse(int argc, char* const argv[]) {
       return;
     }
   }
+
+  // La graine par defaut change a chaque lancement : aucun resultat du cache
+  // ne serait retrouve.
+  if (SystemParameters::getInstance()->getResultCacheFile() != "" && !seedGiven) {
+    printError(argv[0], "Veuillez entrer une graine avec -seed pour utiliser le cache des resultats.");
+  }
 }
 
 /**
  * \return a string describing the command parameters.
  */
 std::string getCmdStr() {
-  return std::string(" inFile [-chg chargesFile] [-tab dataFile] [-out outputFile] [-nopa] [-noehss] [-notm] [-th nbThreads] [-mtp nbPoints] [-temp temperature] [-sw1 potEnergyStart] [-sw2 potEnergyClose] [-dt1 timeStepStart] [-dt2 timeStepClose] [-et energyThreshold] [-itn nbCycles] [-inp nbPoints] [-imp nbPoints] [-sil] [--help]");
+  return std::string(" inFile [-chg chargesFile] [-tab dataFile] [-out outputFile] [-nopa] [-noehss] [-notm] [-noasym] [-stream] [-th nbThreads] [-seed seed] [-ckpt seconds] [-resume] [-cache cacheFile] [-cachemax megabytes] [-kernel name] [-batch nbTrajectories] [-progress rate] [-integ name] [-tol tolerance] [-pot mode] [-clcut cutoff] [-clsize cellSize] [-gridsp spacing] [-gridext extent] [-mtp nbPoints] [-pam method] [-pao nbOrientations] [-paps pixelSize] [-temp temperature] [-temps t1,t2,...] [-gas g1,g2,...] [-sw1 potEnergyStart] [-sw2 potEnergyClose] [-dt1 timeStepStart] [-dt2 timeStepClose] [-et energyThreshold] [-itn nbCycles] [-tmse stdError] [-b2warm] [-samp method] [-qmcr nbReplicates] [-inp nbPoints] [-imp nbPoints] [-sil] [--help]");
 }
 
 void ConsoleView::printHelp(std::string progName) {
@@ -443,15 +945,41 @@ void ConsoleView::printHelp(std::string progName) {
   std::cout << "   -nopa : Precise que la methode PA ne devra pas etre calculee." << std::endl;
   std::cout << "   -noehss : Precise que la methode EHSS ne devra pas etre calculee." << std::endl;
   std::cout << "   -notm : Precise que la methode TM ne devra pas etre calculee." << std::endl;
+  std::cout << "   -noasym : Precise que le parametre d'asymetrie structurelle ne devra pas etre calcule avec la methode TM." << std::endl;
+  std::cout << "   -stream : Lit les geometries pendant les calculs, au plus " << SystemParameters::getInstance()->getStreamQueueSize() << " en avance, et ecrit chaque resultat dans le fichier de sortie des qu'il est connu. La memoire utilisee ne depend pas du nombre de geometries. Incompatible avec -chg." << std::endl;
   std::cout << "   -th nbThreads : Nombre de threads pour le calcul. Par defaut, " << SystemParameters::getInstance()->getMaximalNumberThreads() << "." << std::endl;
+  std::cout << "   -seed seed : Graine des nombres aleatoires. Avec la meme graine, les resultats sont identiques quel que soit le nombre de threads. Par defaut, l'heure du lancement (donnee dans les resultats)." << std::endl;
+  std::cout << "   -ckpt seconds : Enregistre l'avancement des calculs (resultats des geometries terminees, cycles de TM termines des autres) dans le fichier outputFile.ckpt, au plus une fois toutes les seconds secondes. Le fichier est supprime a la fin des calculs. Par defaut, pas d'enregistrement." << std::endl;
+  std::cout << "   -resume : Reprend les calculs interrompus la ou outputFile.ckpt les a laisses, avec les memes options et la graine enregistree : les resultats sont ceux d'un calcul sans interruption, quel que soit le nombre de threads. Sans ce fichier, les calculs commencent au debut. L'avancement est enregistre comme avec -ckpt, toutes les 600 secondes si -ckpt n'est pas donne." << std::endl;
+  std::cout << "   -cache cacheFile : Garde les resultats des geometries dans le fichier cacheFile, lu au debut et ecrit a la fin des calculs. Une geometrie deja calculee avec les memes options, la meme graine et a la meme place dans les fichiers n'est pas recalculee. -seed est obligatoire : la graine par defaut change a chaque lancement. Le noyau (-kernel, auto etant celui choisi sur la machine) et -batch changent les derniers chiffres des resultats de TM : le cache est propre a chaque noyau et a chaque -batch. Plusieurs calculs peuvent partager cacheFile : un seul l'ecrit a la fois, en gardant les resultats ajoutes par les autres, grace au fichier cacheFile.lock. Par defaut, pas de cache." << std::endl;
+  std::cout << "   -cachemax megabytes : Taille maximale de cacheFile, en megaoctets. Au-dela, les resultats utilises le moins recemment sont supprimes. Par defaut, " << SystemParameters::getInstance()->getResultCacheMaxSize() << "." << std::endl;
+  std::cout << "   -kernel name : Noyau de calcul du potentiel pour la methode TM : auto, scalar, simd, avx2 ou avx512. Le noyau scalar sert de reference. Par defaut, auto (ici " << StdPotentialEngine::getKernelName(StdPotentialEngine::getBestKernel()) << ")." << std::endl;
+  std::cout << "   -batch nbTrajectories : Nombre de trajectoires de la methode TM integrees ensemble, les atomes etant lus une fois pour toutes. 1 integre les trajectoires une a une, comme Mobcal. Par defaut, " << SystemParameters::getInstance()->getTrajectoryBatchSize() << "." << std::endl;
+  std::cout << "   -progress rate : Nombre d'affichages de la progression de la methode TM par seconde, faits par un thread a part. Par defaut, " << SystemParameters::getInstance()->getProgressRate() << "." << std::endl;
+  std::cout << "   -integ name : Integrateur des trajectoires de la methode TM : mobcal (Runge-Kutta-Gill puis Adams-Moulton, pas dt1 et dt2 fixes) ou dopri (Dormand-Prince 5(4), pas adapte a l'erreur estimee). Par defaut, mobcal." << std::endl;
+  std::cout << "   -tol tolerance : Tolerance relative de l'integrateur dopri. Par defaut, " << GlobalParameters::getInstance()->getIntegratorTolerance() << "." << std::endl;
+  std::cout << "   -pot mode : Evaluation du potentiel pour la methode TM : exact (somme sur tous les atomes) ou celllist (Lennard-Jones sur les atomes proches seulement, pour les grosses molecules) ou grid (interpolation sur une grille calculee une fois autour de la molecule). L'erreur estimee des approximations est donnee dans les resultats. Par defaut, exact." << std::endl;
+  std::cout << "   -clcut cutoff : Distance de coupure de celllist, en angstroms. Par defaut, " << GlobalParameters::getInstance()->getCellListCutoff() << "." << std::endl;
+  std::cout << "   -clsize cellSize : Taille des cellules de celllist, en angstroms. Par defaut, " << GlobalParameters::getInstance()->getCellListCellSize() << "." << std::endl;
+  std::cout << "   -gridsp spacing : Pas de la grille de grid, en angstroms. Par defaut, " << GlobalParameters::getInstance()->getGridSpacing() << "." << std::endl;
+  std::cout << "   -gridext extent : Marge de la grille de grid autour de la molecule, en angstroms (au-dela, le potentiel est calcule exactement). Par defaut, " << GlobalParameters::getInstance()->getGridExtent() << "." << std::endl;
   std::cout << "   -temp temperature : Temperature. Par defaut, " << GlobalParameters::getInstance()->getTemperature() << " degres." << std::endl;
+  std::cout << "   -temps t1,t2,... : Balayage en temperature de TM : les trajectoires sont calculees une seule fois, a des vitesses couvrant toutes les temperatures, puis TM et la mobilite sont calcules a chaque temperature, une ligne par temperature a la fin du fichier de sortie. La premiere temperature remplace -temp. Augmenter -inp si les temperatures sont tres differentes." << std::endl;
+  std::cout << "   -gas g1,g2,... : Gaz tampons de TM : he (Helium, parametres de Mobcal), n2 (azote), uffhe et uffn2 (Helium et azote, parametres UFF), lus dans les colonnes du fichier de donnees. Les tirages des trajectoires, le parametre d'asymetrie, EHSS et PA sont communs a tous les gaz, TM etant calcule pour chacun, une ligne par gaz a la fin du fichier de sortie. Le premier gaz donne les resultats principaux. Par defaut, he." << std::endl;
   std::cout << "   -mtp nbPoints : Nombre de points dans les integrations de Monte-Carlo pour les methodes EHSS et PA. Par defaut, " << GlobalParameters::getInstance()->getNbPointsMCIntegrationEHSSPA() << "." << std::endl;
+  std::cout << "   -pam method : Methode de calcul de PA : mc (trajectoires aleatoires de Monte-Carlo, comme EHSS) ou raster (aire projetee des spheres dures rasterisee, moyennee sur des orientations fixes, sans nombres aleatoires). Par defaut, mc." << std::endl;
+  std::cout << "   -pao nbOrientations : Nombre d'orientations moyennees par PA raster. Par defaut, " << GlobalParameters::getInstance()->getNbOrientationsPA() << "." << std::endl;
+  std::cout << "   -paps pixelSize : Taille des pixels de PA raster, en angstroms. Par defaut, " << GlobalParameters::getInstance()->getPAPixelSize() << "." << std::endl;
   std::cout << "   -sw1 potEnergyStart : L'energie potentielle au debut du calcul d'une trajectoire par methode TM. Par defaut, " << GlobalParameters::getInstance()->getPotentialEnergyStart() << "." << std::endl;
   std::cout << "   -sw2 potEnergyClose : L'energie potentielle lorsqu'on est proche d'une collision dans le calcul d'une trajectoire par methode TM. Par defaut, " << GlobalParameters::getInstance()->getPotentialEnergyCloseCollision() << "." << std::endl;
   std::cout << "   -dt1 timeStepStart : Le pas entre deux points d'une trajectoire au debut de la trajectoire dans le calcul par methode TM. Par defaut, " << GlobalParameters::getInstance()->getTimeStepStart() << "." << std::endl;
   std::cout << "   -dt2 timeStepClose : Le pas entre deux points d'une trajectoire lorsqu'on est proche d'une collision dans le calcul par methode TM. Par defaut, " << GlobalParameters::getInstance()->getTimeStepCloseCollision() << "." << std::endl;
   std::cout << "   -et energyThreshold : Le seuil de conservation de l'energie entre deux points d'une trajectoire dans le calcul par methode TM. Par defaut, " << GlobalParameters::getInstance()->getEnergyConservationThreshold() << "%." << std::endl;
   std::cout << "   -itn nbCycles : Nombre de cycles complets pour la methode TM. Par defaut, " << GlobalParameters::getInstance()->getNumberCompleteCycles() << "." << std::endl;
+  std::cout << "   -tmse stdError : Erreur standard relative visee, en %, pour la methode TM : les cycles s'arretent des qu'elle est atteinte, apres au moins 3 cycles, et -itn devient le nombre maximal de cycles. La valeur de TM et son erreur sont affichees apres chaque cycle. Par defaut, 0 (tous les cycles sont calcules)." << std::endl;
+  std::cout << "   -b2warm : La recherche du parametre d'impact maximal (b2max) de TM part de celui de la geometrie precedente, pour les conformeres d'un meme ensemble. La supposition est verifiee, b2max et TM ne changent donc pas, mais moins de trajectoires sont calculees : leur nombre et celui des trajectoires economisees sont donnes a la fin du fichier de sortie." << std::endl;
+  std::cout << "   -samp method : Echantillonnage des orientations et parametres d'impact des trajectoires de TM et EHSS/PA : mc (nombres pseudo-aleatoires, comme Mobcal) ou sobol (points de Sobol brouilles, quasi-Monte-Carlo : la meme precision avec moins de trajectoires, de preference en nombre puissance de 2). Avec sobol, chaque cycle de TM est brouille independamment. Par defaut, mc." << std::endl;
+  std::cout << "   -qmcr nbReplicates : Nombre de brouillages independants des points de Sobol de EHSS/PA, dont l'ecart donne l'erreur standard de EHSS et PA. Par defaut, " << GlobalParameters::getInstance()->getNbReplicatesQMC() << "." << std::endl;
   std::cout << "   -inp nbPoints : Nombre de points dans les integrations de vitesse. Par defaut, " << GlobalParameters::getInstance()->getNumberVelocityPoints() << "." << std::endl;
   std::cout << "   -imp nbPoints : Nombre de points dans les integrations de Monte-Carlo pour la methode TM. Par defaut, " << GlobalParameters::getInstance()->getNbPointsMCIntegrationTM() << "." << std::endl;
   std::cout << "   -sil : Mode \"silencieux\". Aucune information ne sera affichee dans la console durant le calcul." << std::endl;
@@ -495,3 +1023,14 @@ int ConsoleView::convertToInteger(const std::string& s)
   }
   return x;
 }
+
+std::string ConsoleView::getGeometryLabel() const
+{
+  std::ostringstream oss;
+  oss << "[Geom. " << m_geometriesFinished + 1;
+  if (m_totalNumberGeometries != 0) {
+    oss << "/" << m_totalNumberGeometries;
+  }
+  oss << "]";
+  return oss.str();
+}
@@ -92,6 +92,12 @@ class ConsoleView : public Observer
      */
     int convertToInteger(const std::string& s);
 
+    /**
+     * \return the label of the geometry being calculated, with the total
+     * number of geometries when it is known.
+     */
+    std::string getGeometryLabel() const;
+
   private:
     /**
      * The CmdView instance to work with.
@@ -129,6 +135,12 @@ class ConsoleView : public Observer
      * Indicates if we want text updates in console.
      */
     bool m_verbose;
+
+    /**
+     * Indicates if the geometries are streamed : calculated while they are
+     * read, and their results saved as soon as they are known.
+     */
+    bool m_streaming;
 };
 
 #endif
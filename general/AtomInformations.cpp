@@ -32,6 +32,28 @@ AtomInformations::~AtomInformations()
   //dtor
 }
 
+namespace
+{
+  /**
+   * Names of the numerical columns, for the error messages.
+   */
+  const char* const COLUMN_NAMES[] = {
+    "Atomic number",
+    "Atomic mass",
+    "Hard sphere radius",
+    "EOLJ for Helium",
+    "ROLJ for Helium",
+    "EOLJ for N2",
+    "ROLJ for N2",
+    "EOLJ for UFF",
+    "ROLJ for UFF",
+    "EOLJ for Helium with UFF",
+    "ROLJ for Helium with UFF",
+    "EOLJ for N2 with UFF",
+    "ROLJ for N2 with UFF"
+  };
+}
+
 void AtomInformations::loadFile(std::string fileName)
 {
   std::ifstream file(fileName, std::ifstream::in);
@@ -41,8 +63,14 @@ void AtomInformations::loadFile(std::string fileName)
     throw oss.str();
   }
 
-  // On vide la map.
-  m_atomInfos.clear();
+  // On vide la table.
+  m_elementIds.clear();
+  m_symbols.clear();
+  for (int c = 0; c < COLOR; ++c) {
+    m_values[c].clear();
+  }
+  m_invalidValues.clear();
+  m_massIndex.clear();
 
   // Le fichier est ouvert.
   std::string line;
@@ -84,172 +112,154 @@ void AtomInformations::loadFile(std::string fileName)
       }
       columns.push_back(value);
     }
-    // On ajoute l'association symbol-colonnes à la map.
-    m_atomInfos.insert(std::pair<std::string, std::vector<std::string>>(symbol, columns));
+
+    // Le numero atomique est l'indice de l'element dans la table.
+    const std::string& z = columns[AtomInformations::ATOMIC_NUMBER];
+    if (!isdigit(z[0])) {
+      std::ostringstream oss;
+      oss << "Atomic number for symbol " << symbol << " can't be " << z << ".";
+      throw oss.str();
+    }
+    const int id = atoi(z.c_str());
+    if (id < (int) m_symbols.size() && m_symbols[id] != "") {
+      std::ostringstream oss;
+      oss << "Atomic number " << id << " is given twice in " << fileName << ".";
+      throw oss.str();
+    }
+    if (id >= (int) m_symbols.size()) {
+      m_symbols.resize(id + 1);
+      for (int c = 0; c < COLOR; ++c) {
+        m_values[c].resize(id + 1, NAN);
+      }
+    }
+    m_symbols[id] = symbol;
+    m_elementIds[symbol] = id;
+
+    // Les colonnes numeriques sont converties une seule fois. Une valeur
+    // invalide ne provoque une erreur que si elle est demandee.
+    for (int c = 0; c < COLOR; ++c) {
+      const std::string& s = columns[c];
+      if (isdigit(s[0])) {
+        m_values[c][id] = atof(s.c_str());
+      } else {
+        m_invalidValues[id * COLUMN_NUMBER + c] = s;
+      }
+    }
   }
 
-  if (m_atomInfos.empty()) {
+  if (m_elementIds.empty()) {
         // Fichier ne contenant aucune donnée.
         std::ostringstream oss;
         oss << "File " << fileName << "is empty.";
         throw oss.str();
   }
+
+  // Index des masses arrondies. Pour une meme masse, le premier symbole
+  // dans l'ordre alphabetique l'emporte.
+  std::map<std::string, int> sorted(m_elementIds.begin(), m_elementIds.end());
+  for (auto it = sorted.begin(); it != sorted.end(); ++it) {
+    const float massF = m_values[ATOMIC_MASS][it->second];
+    if (std::isnan(massF)) {
+      continue;
+    }
+    const int mass = (int) std::round(massF);
+    if (mass >= (int) m_massIndex.size()) {
+      m_massIndex.resize(mass + 1, -1);
+    }
+    if (m_massIndex[mass] < 0) {
+      m_massIndex[mass] = it->second;
+    }
+  }
 }
 
 std::string AtomInformations::getSymbol(int atomicMass)
 {
-  // On va boucler sur toute la map, et chercher la masse arrondie.
-  // Si on la trouve, on la retourne.
-  for (auto it = m_atomInfos.begin(); it != m_atomInfos.end(); ++it) {
-    std::string s = it->second[AtomInformations::ATOMIC_MASS];
-
-    // Si s ne commence pas par un chiffre, c'est une erreur.
-    if (!isdigit(s[0])) {
-      std::ostringstream oss;
-      oss << "Atomic mass for symbol " << it->first << " can't be " << s << "." << std::endl;
-      oss << "Error in searching for symbol for integer atomic mass " << atomicMass << ".";
-      throw oss.str();
-    }
+  return m_symbols[getElementIdFromMass(atomicMass)];
+}
 
-    float massF = atof(s.c_str());
-    if (std::round(massF) == atomicMass) {
-      return it->first;
-    }
+int AtomInformations::getElementIdFromMass(int atomicMass) const
+{
+  if (atomicMass < 0 || atomicMass >= (int) m_massIndex.size() || m_massIndex[atomicMass] < 0) {
+    // On n'a rien trouvé, exception.
+    std::ostringstream oss;
+    oss << "Symbol for integer atomic mass " << atomicMass << " can't be found.";
+    throw oss.str();
   }
-
-  // On n'a rien trouvé, exception.
-  std::ostringstream oss;
-  oss << "Symbol for integer atomic mass " << atomicMass << " can't be found.";
-  throw oss.str();
+  return m_massIndex[atomicMass];
 }
 
-int AtomInformations::getAtomicNumber(std::string symb) const
+int AtomInformations::getElementId(const std::string& symb) const
 {
-  auto it = m_atomInfos.find(symb);
-  if (it == m_atomInfos.end()) {
+  auto it = m_elementIds.find(symb);
+  if (it == m_elementIds.end()) {
     throw std::string("Atomic symbol " + symb + " not known.");
   }
+  return it->second;
+}
 
-  std::string s = it->second[AtomInformations::ATOMIC_NUMBER];
-
-  // Si s ne commence pas par un chiffre, c'est une erreur.
-  if (!isdigit(s[0])) {
+const std::string& AtomInformations::getElementSymbol(int id) const
+{
+  if (id < 0 || id >= (int) m_symbols.size() || m_symbols[id] == "") {
     std::ostringstream oss;
-    oss << "Atomic number for symbol " << symb << " can't be " << s << ".";
+    oss << "Element id " << id << " not known.";
     throw oss.str();
   }
+  return m_symbols[id];
+}
 
-  return atoi(s.c_str());
+int AtomInformations::getAtomicNumber(std::string symb) const
+{
+  return getElementId(symb);
 }
 
 double AtomInformations::getAtomicMass(std::string symb)
 {
-  auto mass = m_massesValues.find(symb);
-  if (mass == m_massesValues.end()) {
-    // Si la masse n'est pas encore enregistrée, on l'enregistre.
-    auto it = m_atomInfos.find(symb);
-    if (it == m_atomInfos.end()) {
-      throw std::string("Atomic symbol " + symb + " not known.");
-    }
-
-    std::string s = it->second[AtomInformations::ATOMIC_MASS];
-
-    // Si s ne commence pas par un chiffre, c'est une erreur.
-    if (!isdigit(s[0])) {
-      std::ostringstream oss;
-      oss << "Atomic mass for symbol " << symb << " can't be " << s << ".";
-      throw oss.str();
-    }
-
-    float massF = atof(s.c_str());
-    m_massesValues.insert(std::pair<std::string, float>(symb, massF));
-    return massF;
-  }
-
-  // La masse est déjà enregistrée, on la retourne juste.
-  return mass->second;
+  return getAtomicMass(getElementId(symb));
 }
 
 double AtomInformations::getEOLJHe(std::string symb)
 {
-  auto eolj = m_EOLJHeValues.find(symb);
-  if (eolj == m_EOLJHeValues.end()) {
-    // Si la masse n'est pas encore enregistrée, on l'enregistre.
-    auto it = m_atomInfos.find(symb);
-    if (it == m_atomInfos.end()) {
-      throw std::string("Atomic symbol " + symb + " not known.");
-    }
-
-    std::string s = it->second[AtomInformations::EOLJ_He];
-
-    // Si s ne commence pas par un chiffre, c'est une erreur.
-    if (!isdigit(s[0])) {
-      std::ostringstream oss;
-      oss << "EOLJ for Helium for symbol " << symb << " can't be " << s << ".";
-      throw oss.str();
-    }
-
-    float eoljF = atof(s.c_str());
-    m_EOLJHeValues.insert(std::pair<std::string, float>(symb, eoljF));
-    return eoljF;
-  }
-
-  // La masse est déjà enregistrée, on la retourne juste.
-  return eolj->second;
+  return getEOLJHe(getElementId(symb));
 }
 
 double AtomInformations::getROLJHe(std::string symb)
 {
-  auto rolj = m_ROLJHeValues.find(symb);
-  if (rolj == m_ROLJHeValues.end()) {
-    // Si la masse n'est pas encore enregistrée, on l'enregistre.
-    auto it = m_atomInfos.find(symb);
-    if (it == m_atomInfos.end()) {
-      throw std::string("Atomic symbol " + symb + " not known.");
-    }
-
-    std::string s = it->second[AtomInformations::ROLJ_He];
-
-    // Si s ne commence pas par un chiffre, c'est une erreur.
-    if (!isdigit(s[0])) {
-      std::ostringstream oss;
-      oss << "ROLJ for Helium for symbol " << symb << " can't be " << s << ".";
-      throw oss.str();
-    }
-
-    float roljF = atof(s.c_str());
-    m_EOLJHeValues.insert(std::pair<std::string, float>(symb, roljF));
-    return roljF;
-  }
-
-  // La masse est déjà enregistrée, on la retourne juste.
-  return rolj->second;
+  return getROLJHe(getElementId(symb));
 }
 
 double AtomInformations::getHSRadius(std::string symb)
 {
-  auto rhs = m_rhsValues.find(symb);
-  if (rhs == m_rhsValues.end()) {
-    // Si RHS n'est pas encore enregistré, on l'enregistre.
-    auto it = m_atomInfos.find(symb);
-    if (it == m_atomInfos.end()) {
-      throw std::string("Atomic symbol " + symb + " not known.");
-    }
-
-    std::string s = it->second[AtomInformations::HARD_SPHERE_RADIUS];
+  return getHSRadius(getElementId(symb));
+}
 
-    // Si s ne commence pas par un chiffre, c'est une erreur.
-    if (!isdigit(s[0])) {
-      std::ostringstream oss;
-      oss << "Hard sphere radius for symbol " << symb << " can't be " << s << ".";
-      throw oss.str();
+std::string AtomInformations::getTableDescription() const
+{
+  // Les valeurs sont en float : 9 chiffres les distinguent toutes.
+  std::ostringstream oss;
+  oss.precision(9);
+  for (unsigned int id = 0; id < m_symbols.size(); ++id) {
+    if (m_symbols[id] == "") {
+      continue;
     }
-
-    float val = atof(s.c_str());
-    m_rhsValues.insert(std::pair<std::string, float>(symb, val));
-    return val;
+    oss << m_symbols[id];
+    for (int c = 0; c < COLOR; ++c) {
+      oss << " " << m_values[c][id];
+    }
+    oss << std::endl;
   }
+  return oss.str();
+}
 
-  // RHS est déjà enregistré, on le retourne juste.
-  return rhs->second;
+double AtomInformations::getValue(int id, int column) const
+{
+  if (id < 0 || id >= (int) m_symbols.size() || std::isnan(m_values[column][id])) {
+    // Element absent (exception levee par getElementSymbol), ou valeur
+    // qui n'est pas un nombre.
+    const std::string& symb = getElementSymbol(id);
+    std::ostringstream oss;
+    oss << COLUMN_NAMES[column] << " for symbol " << symb << " can't be "
+        << m_invalidValues.find(id * COLUMN_NUMBER + column)->second << ".";
+    throw oss.str();
+  }
+  return m_values[column][id];
 }
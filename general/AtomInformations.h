@@ -18,6 +18,8 @@
  * \date 11 mars 2016
  * \brief Class implementing a singleton to access data on atoms.
  * \details Data contains atomic number, mass, hard sphere radius, parameters of Lennard-Jones and color.
+ * The file is parsed once into a table indexed by atomic number, the element
+ * id carried by the atoms.
  */
 
 #ifndef ATOMINFORMATIONS_H
@@ -25,6 +27,7 @@
 
 #include <string>
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 class AtomInformations
@@ -49,14 +52,20 @@ class AtomInformations
      */
     void loadFile(std::string fileName);
 
+    /**
+     * \return a description of all the values loaded, to check that
+     * calculations are done with the same data.
+     */
+    std::string getTableDescription() const;
+
     /**
      * Tests if a symbol exists.
      * \param symb the symbol to test.
      * \return true if symbol exists in data.
      */
-    bool isExistingSymbol(std::string symb) const
+    bool isExistingSymbol(const std::string& symb) const
     {
-      return m_atomInfos.find(symb) != m_atomInfos.end();
+      return m_elementIds.find(symb) != m_elementIds.end();
     }
 
     /**
@@ -67,6 +76,24 @@ class AtomInformations
      */
     std::string getSymbol(int atomicMass);
 
+    /**
+     * \param atomicMass the mass to search for.
+     * \return the element id of the symbol returned by getSymbol(atomicMass).
+     */
+    int getElementIdFromMass(int atomicMass) const;
+
+    /**
+     * \param symb the symbol of an element.
+     * \return the id of the element, its atomic number.
+     */
+    int getElementId(const std::string& symb) const;
+
+    /**
+     * \param id the id of an element.
+     * \return the symbol of the element.
+     */
+    const std::string& getElementSymbol(int id) const;
+
     /**
      * \param symb the symbol of the atom to search atomic number for.
      * \return the atomic number of the atom of symbol symb.
@@ -97,6 +124,22 @@ class AtomInformations
      */
     double getHSRadius(std::string symb);
 
+    /**
+     * Same values, from the id of the element.
+     */
+    double getAtomicMass(int id) const {return getValue(id, ATOMIC_MASS);}
+    double getHSRadius(int id) const {return getValue(id, HARD_SPHERE_RADIUS);}
+    double getEOLJHe(int id) const {return getValue(id, EOLJ_He);}
+    double getROLJHe(int id) const {return getValue(id, ROLJ_He);}
+    double getEOLJN2(int id) const {return getValue(id, EOLJ_N2);}
+    double getROLJN2(int id) const {return getValue(id, ROLJ_N2);}
+    double getEOLJUFF(int id) const {return getValue(id, EOLJ_UFF);}
+    double getROLJUFF(int id) const {return getValue(id, ROLJ_UFF);}
+    double getEOLJUFFHe(int id) const {return getValue(id, EOLJ_UFF_He);}
+    double getROLJUFFHe(int id) const {return getValue(id, ROLJ_UFF_He);}
+    double getEOLJUFFN2(int id) const {return getValue(id, EOLJ_UFF_N2);}
+    double getROLJUFFN2(int id) const {return getValue(id, ROLJ_UFF_N2);}
+
   private:
     /**
      * Enumeration representing the different columns in the file,
@@ -113,6 +156,7 @@ class AtomInformations
         EOLJ_N2,
         ROLJ_N2,
         EOLJ_UFF,
+        ROLJ_UFF,
         EOLJ_UFF_He,
         ROLJ_UFF_He,
         EOLJ_UFF_N2,
@@ -128,38 +172,43 @@ class AtomInformations
      */
     AtomInformations();
 
-  private:
     /**
-     * Static instance of AtomInformations to work with.
+     * \param id the id of an element.
+     * \param column a numerical column, before COLOR.
+     * \return the value of the column for the element.
      */
-    static AtomInformations* m_instance;
+    double getValue(int id, int column) const;
 
+  private:
     /**
-     * Map containing all the infos for atoms.
-     * To a symbol is associating string values corresponding
-     * to the columns of the file loaded by calling loadFile().
+     * Static instance of AtomInformations to work with.
      */
-    std::map<std::string, std::vector<std::string>> m_atomInfos;
+    static AtomInformations* m_instance;
 
     /**
-     * Map containing atomic masses associated with symbols.
+     * Ids of the elements associated with symbols.
      */
-    std::map<std::string, float> m_massesValues;
+    std::unordered_map<std::string, int> m_elementIds;
 
     /**
-     * Map containing EOLJ for Helium associated with symbols.
+     * Symbols of the elements, indexed by id. Empty if there is
+     * no element of this atomic number in the file.
      */
-    std::map<std::string, float> m_EOLJHeValues;
+    std::vector<std::string> m_symbols;
 
     /**
-     * Map containing ROLJ for Helium associated with symbols.
+     * Numerical columns of the file, indexed by column then by id.
+     * Kept in float, the precision of the values of the file. A value
+     * which is not a positive number is NaN, and its text is in
+     * m_invalidValues, with the key id * COLUMN_NUMBER + column.
      */
-    std::map<std::string, float> m_ROLJHeValues;
+    std::vector<float> m_values[COLOR];
+    std::map<int, std::string> m_invalidValues;
 
     /**
-     * Map containing RHS values associated with symbols.
+     * Element ids indexed by rounded mass, -1 if there is none.
      */
-    std::map<std::string, float> m_rhsValues;
+    std::vector<int> m_massIndex;
 };
 
 #endif // ATOMINFORMATIONS_H
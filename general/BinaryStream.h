@@ -0,0 +1,79 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+/**
+ * \file BinaryStream.h
+ * \author Anthony Breant, Clement Poinsot, Jeremie Pantin, Mohamed Takhtoukh, Thomas Capet
+ * \version 1.0
+ * \date 17 october 2026
+ * \brief Functions writing and reading values in binary streams, for the
+ * files of Checkpoint and ResultCache.
+ *
+ * The values are written as they are in memory : the files are read back
+ * on the same kind of machine.
+ */
+
+#ifndef BINARYSTREAM_H
+#define BINARYSTREAM_H
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+template <typename T>
+inline void writeValue(std::ostream& out, const T& value)
+{
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+inline void readValue(std::istream& in, T& value)
+{
+  in.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+template <typename T>
+inline void writeVector(std::ostream& out, const std::vector<T>& values)
+{
+  writeValue(out, (uint32_t) values.size());
+  if (!values.empty()) {
+    out.write(reinterpret_cast<const char*>(&values[0]), values.size() * sizeof(T));
+  }
+}
+
+template <typename T>
+inline void readVector(std::istream& in, std::vector<T>& values)
+{
+  uint32_t size = 0;
+  readValue(in, size);
+  values.resize(in ? size : 0);
+  if (!values.empty()) {
+    in.read(reinterpret_cast<char*>(&values[0]), values.size() * sizeof(T));
+  }
+}
+
+inline void writeString(std::ostream& out, const std::string& s)
+{
+  writeVector(out, std::vector<char>(s.begin(), s.end()));
+}
+
+inline void readString(std::istream& in, std::string& s)
+{
+  std::vector<char> chars;
+  readVector(in, chars);
+  s.assign(chars.begin(), chars.end());
+}
+
+#endif // BINARYSTREAM_H
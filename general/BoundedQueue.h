@@ -0,0 +1,114 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+/**
+ * \file BoundedQueue.h
+ * \author Anthony Breant, Clement Poinsot, Jeremie Pantin, Mohamed Takhtoukh, Thomas Capet
+ * \version 1.0
+ * \date 17 october 2026
+ * \brief A queue of limited size shared by threads producing and consuming values.
+ *
+ * A producer waits while the queue is full, so that it never gets more than
+ * capacity values ahead of the consumers.
+ */
+
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+template <typename T>
+class BoundedQueue
+{
+  public:
+    /**
+     * Constructs an empty queue.
+     * \param capacity the maximal number of values in the queue (at least 1).
+     */
+    BoundedQueue(std::size_t capacity)
+      : m_capacity(capacity < 1 ? 1 : capacity), m_closed(false) {}
+
+    /**
+     * Adds a value at the end of the queue, waits while the queue is full.
+     * \param value the value to add.
+     * \return false if the queue is closed, the value is then not added.
+     */
+    bool push(const T& value) {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_notFull.wait(lock, [this]{ return m_closed || m_values.size() < m_capacity; });
+      if (m_closed) {
+        return false;
+      }
+      m_values.push_back(value);
+      m_notEmpty.notify_one();
+      return true;
+    }
+
+    /**
+     * Takes the first value of the queue, waits while the queue is empty.
+     * The values still in a closed queue can be taken.
+     * \param value the value taken.
+     * \return false if the queue is closed and empty.
+     */
+    bool pop(T& value) {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_notEmpty.wait(lock, [this]{ return m_closed || !m_values.empty(); });
+      if (m_values.empty()) {
+        return false;
+      }
+      value = m_values.front();
+      m_values.pop_front();
+      m_notFull.notify_one();
+      return true;
+    }
+
+    /**
+     * Closes the queue : no more values can be added, and the threads
+     * waiting on it are woken up.
+     */
+    void close() {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_closed = true;
+      m_notFull.notify_all();
+      m_notEmpty.notify_all();
+    }
+
+  private:
+    BoundedQueue(const BoundedQueue&);
+    BoundedQueue& operator = (const BoundedQueue&);
+
+  private:
+    /**
+     * Maximal number of values in the queue.
+     */
+    std::size_t m_capacity;
+
+    /**
+     * Indicates if values can still be added.
+     */
+    bool m_closed;
+
+    /**
+     * Values waiting to be taken.
+     */
+    std::deque<T> m_values;
+
+    std::mutex m_mutex;
+    std::condition_variable m_notFull;
+    std::condition_variable m_notEmpty;
+};
+
+#endif // BOUNDEDQUEUE_H
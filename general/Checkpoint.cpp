@@ -0,0 +1,333 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+#include "Checkpoint.h"
+
+#include "BinaryStream.h"
+
+#include "../math/RandomGenerator.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+Checkpoint* Checkpoint::m_instance = new Checkpoint();
+constexpr double Checkpoint::m_DefaultInterval;
+
+namespace
+{
+  /**
+   * First bytes of a checkpoint file, with the version of its format.
+   */
+  const std::string CheckpointMagic = "Collision-Code checkpoint 1";
+}
+
+Checkpoint::Checkpoint()
+  : m_enabled(false), m_interval(m_DefaultInterval)
+{
+
+}
+
+Checkpoint::~Checkpoint()
+{
+
+}
+
+void Checkpoint::start(const std::string& filename, double interval, bool resume)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_filename = filename;
+  m_interval = interval > 0.0 ? interval : m_DefaultInterval;
+  m_parameters = "";
+  m_geometries.clear();
+
+  // Sans fichier, le calcul commence simplement.
+  if (resume && std::ifstream(m_filename.c_str())) {
+    load();
+  }
+
+  m_enabled = true;
+  m_lastWriting = std::chrono::steady_clock::now();
+}
+
+void Checkpoint::checkParameters(const std::string& parameters)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_parameters != "" && m_parameters != parameters) {
+    std::ostringstream oss;
+    oss << "The checkpoint file " << m_filename << " was written with other parameters.";
+    throw oss.str();
+  }
+  m_parameters = parameters;
+}
+
+bool Checkpoint::find(unsigned int geometry, GeometryCheckpoint& progression) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_geometries.find(geometry);
+  if (it == m_geometries.end()) {
+    return false;
+  }
+  progression = it->second;
+  return true;
+}
+
+void Checkpoint::save(unsigned int geometry, const GeometryCheckpoint& progression)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_enabled) {
+    return;
+  }
+  m_geometries[geometry] = progression;
+
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  if (std::chrono::duration<double>(now - m_lastWriting).count() >= m_interval) {
+    write();
+    m_lastWriting = now;
+  }
+}
+
+void Checkpoint::saveResult(unsigned int geometry, unsigned int nbAtoms, Result* result)
+{
+  if (!m_enabled) {
+    return;
+  }
+  GeometryCheckpoint progression;
+  progression.nbAtoms = nbAtoms;
+  progression.finished = true;
+  progression.hardSpheres = true;
+  progression.tmStarted = false;
+  progression.result = writeResult(result);
+  // Les cycles de TM ne servent plus.
+  progression.tm.bufferGasIndex = 0;
+  progression.tm.nbCycles = 0;
+  progression.tm.nbIntegratedTrajectories = 0;
+  progression.tm.nbIntegrationSteps = 0;
+  progression.tm.nbPotentialCalculations = 0;
+  progression.tm.nbFailedTrajectories = 0;
+  save(geometry, progression);
+}
+
+void Checkpoint::finish()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_enabled) {
+    return;
+  }
+  m_enabled = false;
+  m_geometries.clear();
+  std::remove(m_filename.c_str());
+}
+
+void Checkpoint::load()
+{
+  std::ifstream in(m_filename.c_str(), std::ios::in | std::ios::binary);
+  std::string magic(CheckpointMagic.size(), '\0');
+  in.read(&magic[0], magic.size());
+  if (!in || magic != CheckpointMagic) {
+    std::ostringstream oss;
+    oss << "The file " << m_filename << " is not a checkpoint file.";
+    throw oss.str();
+  }
+
+  // Les nombres aleatoires doivent etre les memes qu'avant l'interruption.
+  unsigned int seed = 0;
+  readValue(in, seed);
+  RandomGenerator::getInstance()->setSeed(seed);
+  readString(in, m_parameters);
+
+  uint32_t nbGeometries = 0;
+  readValue(in, nbGeometries);
+  for (uint32_t i = 0; i < nbGeometries && in; ++i) {
+    unsigned int geometry = 0;
+    GeometryCheckpoint g;
+    readValue(in, geometry);
+    readValue(in, g.nbAtoms);
+    readValue(in, g.finished);
+    readValue(in, g.hardSpheres);
+    readValue(in, g.tmStarted);
+    readString(in, g.result);
+    readValue(in, g.tm.bufferGasIndex);
+    readValue(in, g.tm.nbCycles);
+    readVector(in, g.tm.b2max);
+    readVector(in, g.tm.om11st);
+    readVector(in, g.tm.om12st);
+    readVector(in, g.tm.om13st);
+    readVector(in, g.tm.om22st);
+    readVector(in, g.tm.q1st);
+    readVector(in, g.tm.q2st);
+    readValue(in, g.tm.nbIntegratedTrajectories);
+    readValue(in, g.tm.nbIntegrationSteps);
+    readValue(in, g.tm.nbPotentialCalculations);
+    readValue(in, g.tm.nbFailedTrajectories);
+    m_geometries[geometry] = g;
+  }
+
+  if (!in) {
+    std::ostringstream oss;
+    oss << "The checkpoint file " << m_filename << " is truncated.";
+    throw oss.str();
+  }
+}
+
+void Checkpoint::write()
+{
+  const std::string tmpFilename = m_filename + ".tmp";
+  {
+    std::ofstream out(tmpFilename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out) {
+      std::ostringstream oss;
+      oss << "Cannot open file " << tmpFilename << ".";
+      throw oss.str();
+    }
+
+    out.write(CheckpointMagic.c_str(), CheckpointMagic.size());
+    writeValue(out, RandomGenerator::getInstance()->getSeed());
+    writeString(out, m_parameters);
+
+    writeValue(out, (uint32_t) m_geometries.size());
+    for (auto it = m_geometries.begin(); it != m_geometries.end(); ++it) {
+      const GeometryCheckpoint& g = it->second;
+      writeValue(out, it->first);
+      writeValue(out, g.nbAtoms);
+      writeValue(out, g.finished);
+      writeValue(out, g.hardSpheres);
+      writeValue(out, g.tmStarted);
+      writeString(out, g.result);
+      writeValue(out, g.tm.bufferGasIndex);
+      writeValue(out, g.tm.nbCycles);
+      writeVector(out, g.tm.b2max);
+      writeVector(out, g.tm.om11st);
+      writeVector(out, g.tm.om12st);
+      writeVector(out, g.tm.om13st);
+      writeVector(out, g.tm.om22st);
+      writeVector(out, g.tm.q1st);
+      writeVector(out, g.tm.q2st);
+      writeValue(out, g.tm.nbIntegratedTrajectories);
+      writeValue(out, g.tm.nbIntegrationSteps);
+      writeValue(out, g.tm.nbPotentialCalculations);
+      writeValue(out, g.tm.nbFailedTrajectories);
+    }
+
+    out.flush();
+    if (!out) {
+      std::ostringstream oss;
+      oss << "Cannot write file " << tmpFilename << ".";
+      throw oss.str();
+    }
+  }
+
+  // Le fichier precedent reste complet jusqu'au remplacement.
+#ifdef _WIN32
+  std::remove(m_filename.c_str());
+#endif
+  if (std::rename(tmpFilename.c_str(), m_filename.c_str()) != 0) {
+    std::ostringstream oss;
+    oss << "Cannot write file " << m_filename << ".";
+    throw oss.str();
+  }
+}
+
+std::string Checkpoint::writeResult(Result* result)
+{
+  std::ostringstream out(std::ios::out | std::ios::binary);
+  writeValue(out, result->isEHSSSaved());
+  writeValue(out, result->getEHSS());
+  writeValue(out, result->isPASaved());
+  writeValue(out, result->getPA());
+  writeValue(out, result->isTMSaved());
+  writeValue(out, result->getTM());
+  writeValue(out, result->getStructAsymParam());
+  writeValue(out, result->getStandardDeviation());
+  writeValue(out, result->getNumberOfFailedTrajectories());
+  writeValue(out, result->isPotentialApproximated());
+  writeValue(out, result->getPotentialError());
+  writeValue(out, result->getPotentialGradientError());
+  writeValue(out, result->getAverageNumberSteps());
+  writeValue(out, result->getAverageNumberPotentialCalculations());
+  writeValue(out, result->getNumberCyclesTM());
+  writeValue(out, result->getStandardError());
+  writeValue(out, result->getNumberB2maxTrajectories());
+  writeValue(out, result->getNumberSavedB2maxTrajectories());
+  writeValue(out, result->getStandardErrorEHSS());
+  writeValue(out, result->getStandardErrorPA());
+  writeVector(out, result->getTemperatureSweep());
+  writeVector(out, result->getBufferGasesTM());
+  return out.str();
+}
+
+void Checkpoint::readResult(const std::string& data, Result* result)
+{
+  std::istringstream in(data, std::ios::in | std::ios::binary);
+  bool saved;
+  double value;
+  double value2;
+  int n;
+  int n2;
+
+  readValue(in, saved);
+  readValue(in, value);
+  if (saved) {
+    result->setEHSS(value);
+  }
+  readValue(in, saved);
+  readValue(in, value);
+  if (saved) {
+    result->setPA(value);
+  }
+  readValue(in, saved);
+  readValue(in, value);
+  if (saved) {
+    result->setTM(value);
+  }
+  readValue(in, value);
+  result->setStructAsymParam(value);
+  readValue(in, value);
+  result->setStandardDeviation(value);
+  readValue(in, n);
+  result->setNumberOfFailedTrajectories(n);
+  readValue(in, saved);
+  readValue(in, value);
+  readValue(in, value2);
+  if (saved) {
+    result->setPotentialError(value, value2);
+  }
+  readValue(in, value);
+  readValue(in, value2);
+  result->setTrajectoryStatistics(value, value2);
+  readValue(in, n);
+  readValue(in, value);
+  result->setConvergenceTM(n, value);
+  readValue(in, n);
+  readValue(in, n2);
+  result->addB2maxTrajectories(n, n2);
+  readValue(in, value);
+  readValue(in, value2);
+  result->setStandardErrorsEHSSPA(value, value2);
+
+  std::vector<TemperatureTM> sweep;
+  readVector(in, sweep);
+  for (auto it = sweep.begin(); it != sweep.end(); ++it) {
+    result->addTemperatureTM(*it);
+  }
+  std::vector<BufferGasTM> gases;
+  readVector(in, gases);
+  for (auto it = gases.begin(); it != gases.end(); ++it) {
+    result->addBufferGasTM(*it);
+  }
+
+  if (!in) {
+    throw std::string("The results of the checkpoint file are truncated.");
+  }
+}
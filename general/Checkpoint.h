@@ -0,0 +1,233 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+/**
+ * \file Checkpoint.h
+ * \author Anthony Breant, Clement Poinsot, Jeremie Pantin, Mohamed Takhtoukh, Thomas Capet
+ * \version 1.0
+ * \date 17 october 2026
+ * \brief A singleton saving the progression of the calculations in a binary file,
+ * to resume them after an interruption.
+ *
+ * The results of the finished geometries and the state of TM of the
+ * geometries in progress, at the end of their last cycle, are written at
+ * most every few minutes. The random numbers only depend on the seed, the
+ * geometry and the trajectory, so a resumed calculation gives the same
+ * results as an uninterrupted one.
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "../math/Result.h"
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * State of TM of a geometry at the end of a cycle.
+ */
+struct TMCheckpoint {
+  /// Index of the buffer gas being calculated.
+  unsigned int bufferGasIndex;
+  /// Number of cycles done with this buffer gas.
+  int nbCycles;
+  /// b2max at each velocity.
+  std::vector<double> b2max;
+  /// Omega* of the cycles done.
+  std::vector<double> om11st;
+  std::vector<double> om12st;
+  std::vector<double> om13st;
+  std::vector<double> om22st;
+  /// Q(1)* and Q(2)* of the cycles done, at each velocity.
+  std::vector<double> q1st;
+  std::vector<double> q2st;
+  /// Counters of the trajectories of all the buffer gases.
+  unsigned long long nbIntegratedTrajectories;
+  unsigned long long nbIntegrationSteps;
+  unsigned long long nbPotentialCalculations;
+  int nbFailedTrajectories;
+};
+
+/**
+ * Progression of the calculations of a geometry.
+ */
+struct GeometryCheckpoint {
+  /// Number of atoms of the geometry, to check it is the same.
+  unsigned int nbAtoms;
+  /// Indicates if all the calculations are done.
+  bool finished;
+  /// Indicates if EHSS and PA are done.
+  bool hardSpheres;
+  /// Indicates if tm holds cycles of TM.
+  bool tmStarted;
+  /// Results known, written by Checkpoint::writeResult.
+  std::string result;
+  /// State of TM, if started.
+  TMCheckpoint tm;
+};
+
+class Checkpoint
+{
+  public:
+    /**
+     * \return an instance of Checkpoint to work with.
+     */
+    static Checkpoint* getInstance() {
+      return m_instance;
+    }
+
+    /**
+     * Destructor.
+     */
+    virtual ~Checkpoint();
+
+    /**
+     * \return true if the progression of the calculations is saved, false otherwise.
+     */
+    bool isEnabled() const {
+      return m_enabled;
+    }
+
+    /**
+     * Starts saving the progression of the calculations. When resuming,
+     * the progression is read from the file if it exists, and the seed of
+     * the calculation is the one of the file.
+     * \param filename the name of the file.
+     * \param interval the minimal time between two writings of the file, in
+     * seconds, m_DefaultInterval if not positive.
+     * \param resume true to resume the calculations saved in the file.
+     */
+    void start(const std::string& filename, double interval, bool resume);
+
+    /**
+     * Checks that the calculations are resumed with the same parameters.
+     * Throws an exception otherwise.
+     * \param parameters a description of all the parameters of the calculations.
+     */
+    void checkParameters(const std::string& parameters);
+
+    /**
+     * Gives the progression of a geometry saved in the file.
+     * \param geometry the index of the geometry.
+     * \param progression the progression of the geometry.
+     * \return false if nothing is saved for the geometry.
+     */
+    bool find(unsigned int geometry, GeometryCheckpoint& progression) const;
+
+    /**
+     * Saves the progression of a geometry. The file is written if the last
+     * writing is older than the interval.
+     * \param geometry the index of the geometry.
+     * \param progression the progression of the geometry.
+     */
+    void save(unsigned int geometry, const GeometryCheckpoint& progression);
+
+    /**
+     * Saves the results of a finished geometry.
+     * \param geometry the index of the geometry.
+     * \param nbAtoms the number of atoms of the geometry.
+     * \param result the results of the geometry.
+     */
+    void saveResult(unsigned int geometry, unsigned int nbAtoms, Result* result);
+
+    /**
+     * Stops saving the progression once all the results are written, and
+     * removes the file.
+     */
+    void finish();
+
+    /**
+     * Writes the results known in a binary string.
+     * \param result the results.
+     * \return the binary string.
+     */
+    static std::string writeResult(Result* result);
+
+    /**
+     * Reads results written by writeResult in new results.
+     * \param data the binary string.
+     * \param result the new results.
+     */
+    static void readResult(const std::string& data, Result* result);
+
+  private:
+    /**
+     * Private constructor.
+     */
+    Checkpoint();
+
+    /**
+     * Reads the file.
+     */
+    void load();
+
+    /**
+     * Writes the file, through a temporary file, so that an interruption
+     * never leaves a partial file.
+     */
+    void write();
+
+  private:
+    /**
+     * Static instance of Checkpoint to work with.
+     */
+    static Checkpoint* m_instance;
+
+    /**
+     * Minimal time between two writings of the file, in seconds, when not given.
+     */
+    static constexpr double m_DefaultInterval = 600.0;
+
+    /**
+     * Indicates if the progression is saved.
+     * Default value : false.
+     */
+    bool m_enabled;
+
+    /**
+     * Name of the file.
+     */
+    std::string m_filename;
+
+    /**
+     * Minimal time between two writings of the file, in seconds.
+     */
+    double m_interval;
+
+    /**
+     * Time of the last writing of the file.
+     */
+    std::chrono::steady_clock::time_point m_lastWriting;
+
+    /**
+     * Description of the parameters of the calculations saved.
+     */
+    std::string m_parameters;
+
+    /**
+     * Progression of each geometry, by index.
+     */
+    std::map<unsigned int, GeometryCheckpoint> m_geometries;
+
+    /**
+     * Protects the progression, saved by the geometries calculated at the
+     * same time.
+     */
+    mutable std::mutex m_mutex;
+};
+
+#endif // CHECKPOINT_H
@@ -61,6 +61,12 @@ class CmdView : public Observable {
      */
     virtual bool willTMBeCalculated() const = 0;
 
+    /**
+     * \return true if the structural asymmetry parameter will be calculated
+     * with TM, false otherwise.
+     */
+    virtual bool willAsymmetryParameterBeCalculated() const = 0;
+
     /**
      * Indicates if yes or no, EHSS should be calculated.
      * \param b true if EHSS should be calculated, else otherwise.
@@ -79,6 +85,13 @@ class CmdView : public Observable {
      */
     virtual void shouldTMBeCalculated(bool b) = 0;
 
+    /**
+     * Indicates if yes or no, the structural asymmetry parameter should be
+     * calculated with TM.
+     * \param b true if the structural asymmetry parameter should be calculated, else otherwise.
+     */
+    virtual void shouldAsymmetryParameterBeCalculated(bool b) = 0;
+
     /**
      * Indicates a new file to load.
      * \param fileName the name of the file to load.
@@ -136,6 +149,13 @@ class CmdView : public Observable {
      * Write the results in the output file.
      */
     virtual void launch() = 0;
+
+    /**
+     * Launches all the calculations, on all input files, while they are read.
+     * Each result is appended to the output file as soon as it is known,
+     * and the geometries are released once their results are written.
+     */
+    virtual void launchStreaming() = 0;
 };
 
 #endif
@@ -68,6 +68,12 @@ class GeometryCalculator {
      */
     virtual bool willTMBeCalculated() const = 0;
 
+    /**
+     * \return true if the structural asymmetry parameter will be calculated
+     * with TM, false otherwise.
+     */
+    virtual bool willAsymmetryParameterBeCalculated() const = 0;
+
     /**
      * Indicates if calculations are finished for the molecule.
      * \param mol the molecule.
@@ -112,6 +118,13 @@ class GeometryCalculator {
      */
     virtual void shouldTMBeCalculated(bool b) = 0;
 
+    /**
+     * Indicates if yes or no, the structural asymmetry parameter should be
+     * calculated with TM.
+     * \param b true if the structural asymmetry parameter should be calculated, else otherwise.
+     */
+    virtual void shouldAsymmetryParameterBeCalculated(bool b) = 0;
+
     /**
      * Sets a vector of molecules (geometries) for CCS calculation.
      * \param geometries a vector of geometries.
@@ -128,6 +141,16 @@ class GeometryCalculator {
      * Launches all the calculations, on all geometries.
      */
     virtual void launchCalculations() = 0;
+
+    /**
+     * Runs the calculations on one geometry, which doesn't need to be in
+     * the vector of geometries. The result is not kept by the calculator.
+     * \param mol the geometry.
+     * \param geometryIndex the index of the geometry among all geometries,
+     * the random numbers depend on it.
+     * \return the results for the geometry, to be destroyed by the caller.
+     */
+    virtual Result* calculate(Molecule* mol, unsigned int geometryIndex) = 0;
 };
 
 #endif
@@ -9,8 +9,15 @@ GlobalParameters::GlobalParameters()
   m_timeStepStart(0.5), m_potentialEnergyCloseCollision(0.0025),
   m_timeStepCloseCollision(0.05), m_nbCompleteCycles(10),
   m_nbVelocityPoints(40), m_nbPointsMCIntegrationTM(25),
-  m_nbPointsMCIntegrationEHSSPA(250000), m_energyConservationThreshold(99.0)
+  m_nbPointsMCIntegrationEHSSPA(250000), m_energyConservationThreshold(99.0),
+  m_potentialMode(PotentialMode::EXACT), m_cellListCutoff(12.0),
+  m_cellListCellSize(6.0), m_gridSpacing(0.2), m_gridExtent(6.0),
+  m_trajectoryIntegrator(TrajectoryIntegrator::MOBCAL), m_integratorTolerance(1e-6),
+  m_TMStandardErrorTarget(0.0), m_b2maxWarmStart(false),
+  m_samplingMethod(SamplingMethod::MONTE_CARLO), m_nbReplicatesQMC(8),
+  m_PAMethod(PAMethod::MONTE_CARLO), m_nbOrientationsPA(500), m_PAPixelSize(0.05)
 {
+  m_bufferGases.push_back(BufferGas::HE);
 }
 
 GlobalParameters::~GlobalParameters()
@@ -22,6 +22,56 @@
 #ifndef GLOBALPARAMETERS_H
 #define GLOBALPARAMETERS_H
 
+#include "../math/PotentialEngine.h"
+
+#include <vector>
+
+/**
+ * Integrators of the trajectories of TM method.
+ */
+enum class TrajectoryIntegrator {
+  /// Runge-Kutta-Gill then Adams-Moulton, time steps dt1 and dt2 as Mobcal.
+  MOBCAL,
+  /// Dormand-Prince 5(4), time step adapted to the estimated error.
+  DORMAND_PRINCE
+};
+
+/**
+ * Methods of calculation of PA.
+ */
+enum class PAMethod {
+  /// Random rays, the same as EHSS, as Mobcal.
+  MONTE_CARLO,
+  /// Projected area rasterized for a fixed set of orientations.
+  RASTER
+};
+
+/**
+ * Methods of sampling of the orientations and impact parameters of the
+ * trajectories of TM and EHSS/PA.
+ */
+enum class SamplingMethod {
+  /// Pseudo-random numbers, as Mobcal.
+  MONTE_CARLO,
+  /// Scrambled Sobol points (randomized quasi-Monte-Carlo).
+  SOBOL
+};
+
+/**
+ * Buffer gases of TM method, with the columns of Lennard-Jones parameters
+ * read in atomInformations.csv.
+ */
+enum class BufferGas {
+  /// Helium, parameters of Mobcal (EOLJ_He, ROLJ_He).
+  HE,
+  /// Nitrogen (EOLJ_N2, ROLJ_N2).
+  N2,
+  /// Helium, parameters of UFF (EOLJ_UFF_He, ROLJ_UFF_He).
+  UFF_HE,
+  /// Nitrogen, parameters of UFF (EOLJ_UFF_N2, ROLJ_UFF_N2).
+  UFF_N2
+};
+
 class GlobalParameters
 {
   public:
@@ -45,6 +95,24 @@ class GlobalParameters
       return m_temperature;
     }
 
+    /**
+     * Returns the temperatures at which TM is also calculated, reusing the
+     * trajectories.
+     * \return the temperatures of the sweep, empty without sweep.
+     */
+    const std::vector<double>& getTemperatureSweep() const {
+      return m_temperatureSweep;
+    }
+
+    /**
+     * Returns the buffer gases of TM, calculated with the same trajectory
+     * samples. The first one gives the main results.
+     * \return the buffer gases.
+     */
+    const std::vector<BufferGas>& getBufferGases() const {
+      return m_bufferGases;
+    }
+
     /**
      * Returns the potential energy at the start of a trajectory.
      * \return the potential energy at the start of a trajectory.
@@ -126,6 +194,117 @@ class GlobalParameters
       return m_energyConservationThreshold;
     }
 
+    /**
+     * Returns the way the potential is evaluated for TM method.
+     * \return the way the potential is evaluated for TM method.
+     */
+    PotentialMode getPotentialMode() const {
+      return m_potentialMode;
+    }
+
+    /**
+     * Returns the cutoff of the cell list, in angstroms.
+     * \return the cutoff of the cell list, in angstroms.
+     */
+    double getCellListCutoff() const {
+      return m_cellListCutoff;
+    }
+
+    /**
+     * Returns the size of the cells of the cell list, in angstroms.
+     * \return the size of the cells of the cell list, in angstroms.
+     */
+    double getCellListCellSize() const {
+      return m_cellListCellSize;
+    }
+
+    /**
+     * Returns the spacing of the grid of the potential, in angstroms.
+     * \return the spacing of the grid of the potential, in angstroms.
+     */
+    double getGridSpacing() const {
+      return m_gridSpacing;
+    }
+
+    /**
+     * Returns the margin of the grid of the potential around the molecule, in angstroms.
+     * \return the margin of the grid of the potential around the molecule, in angstroms.
+     */
+    double getGridExtent() const {
+      return m_gridExtent;
+    }
+
+    /**
+     * Returns the integrator of the trajectories for TM method.
+     * \return the integrator of the trajectories for TM method.
+     */
+    TrajectoryIntegrator getTrajectoryIntegrator() const {
+      return m_trajectoryIntegrator;
+    }
+
+    /**
+     * Returns the relative tolerance of the adaptive integrator.
+     * \return the relative tolerance of the adaptive integrator.
+     */
+    double getIntegratorTolerance() const {
+      return m_integratorTolerance;
+    }
+
+    /**
+     * Returns the relative standard error of TM under which its cycles stop.
+     * \return the target of the relative standard error, in percents, 0 if
+     * all the cycles are calculated.
+     */
+    double getTMStandardErrorTarget() const {
+      return m_TMStandardErrorTarget;
+    }
+
+    /**
+     * Indicates if the search of b2max of TM starts from the profile found
+     * for the previous geometry.
+     * \return true if the search of b2max is warm started.
+     */
+    bool isB2maxWarmStart() const {
+      return m_b2maxWarmStart;
+    }
+
+    /**
+     * \return the method of sampling of the trajectories.
+     */
+    SamplingMethod getSamplingMethod() const {
+      return m_samplingMethod;
+    }
+
+    /**
+     * Returns the number of independent scramblings of the Sobol points of
+     * EHSS/PA, from which their standard error is estimated.
+     * \return the number of replicates.
+     */
+    int getNbReplicatesQMC() const {
+      return m_nbReplicatesQMC;
+    }
+
+    /**
+     * \return the method of calculation of PA.
+     */
+    PAMethod getPAMethod() const {
+      return m_PAMethod;
+    }
+
+    /**
+     * \return the number of orientations averaged by the rasterized PA.
+     */
+    int getNbOrientationsPA() const {
+      return m_nbOrientationsPA;
+    }
+
+    /**
+     * \return the size of the pixels of the rasterized PA, in angstroms.
+     */
+    double getPAPixelSize() const {
+      return m_PAPixelSize;
+    }
+
     /**
      * Sets the temperature to t.
      * \param t the new temperature.
@@ -134,6 +313,22 @@ class GlobalParameters
       m_temperature = t;
     }
 
+    /**
+     * Sets the temperatures of the sweep to t.
+     * \param t the new temperatures, empty for no sweep.
+     */
+    void setTemperatureSweep(const std::vector<double>& t) {
+      m_temperatureSweep = t;
+    }
+
+    /**
+     * Sets the buffer gases of TM to g.
+     * \param g the new buffer gases, not empty.
+     */
+    void setBufferGases(const std::vector<BufferGas>& g) {
+      m_bufferGases = g;
+    }
+
     /**
      * Sets the potential energy at the start of a trajectory to pES.
      * \param pES the new potential energy at the start of a trajectory.
@@ -215,6 +410,120 @@ class GlobalParameters
       m_energyConservationThreshold = eCT;
     }
 
+    /**
+     * Sets the way the potential is evaluated for TM method to m.
+     * \param m the new way the potential is evaluated for TM method.
+     */
+    void setPotentialMode(PotentialMode m) {
+      m_potentialMode = m;
+    }
+
+    /**
+     * Sets the cutoff of the cell list, in angstroms, to c.
+     * \param c the new cutoff of the cell list, in angstroms.
+     */
+    void setCellListCutoff(double c) {
+      m_cellListCutoff = c;
+    }
+
+    /**
+     * Sets the size of the cells of the cell list, in angstroms, to s.
+     * \param s the new size of the cells of the cell list, in angstroms.
+     */
+    void setCellListCellSize(double s) {
+      m_cellListCellSize = s;
+    }
+
+    /**
+     * Sets the spacing of the grid of the potential, in angstroms, to s.
+     * \param s the new spacing of the grid of the potential, in angstroms.
+     */
+    void setGridSpacing(double s) {
+      m_gridSpacing = s;
+    }
+
+    /**
+     * Sets the margin of the grid of the potential around the molecule, in angstroms, to e.
+     * \param e the new margin of the grid of the potential, in angstroms.
+     */
+    void setGridExtent(double e) {
+      m_gridExtent = e;
+    }
+
+    /**
+     * Sets the integrator of the trajectories for TM method to i.
+     * \param i the new integrator of the trajectories for TM method.
+     */
+    void setTrajectoryIntegrator(TrajectoryIntegrator i) {
+      m_trajectoryIntegrator = i;
+    }
+
+    /**
+     * Sets the relative tolerance of the adaptive integrator to t.
+     * \param t the new relative tolerance of the adaptive integrator.
+     */
+    void setIntegratorTolerance(double t) {
+      m_integratorTolerance = t;
+    }
+
+    /**
+     * Sets the relative standard error of TM under which its cycles stop to e.
+     * The number of complete cycles is then the maximal number of cycles.
+     * \param e the new target, in percents, 0 to calculate all the cycles.
+     */
+    void setTMStandardErrorTarget(double e) {
+      m_TMStandardErrorTarget = e;
+    }
+
+    /**
+     * Indicates if the search of b2max of TM starts from the profile found
+     * for the previous geometry.
+     * \param b true to warm start the search of b2max.
+     */
+    void setB2maxWarmStart(bool b) {
+      m_b2maxWarmStart = b;
+    }
+
+    /**
+     * Sets the method of sampling of the trajectories to m.
+     * \param m the new method of sampling.
+     */
+    void setSamplingMethod(SamplingMethod m) {
+      m_samplingMethod = m;
+    }
+
+    /**
+     * Sets the number of scramblings of the Sobol points of EHSS/PA to n.
+     * \param n the new number of replicates.
+     */
+    void setNbReplicatesQMC(int n) {
+      m_nbReplicatesQMC = n;
+    }
+
+    /**
+     * Sets the method of calculation of PA to m.
+     * \param m the new method of calculation of PA.
+     */
+    void setPAMethod(PAMethod m) {
+      m_PAMethod = m;
+    }
+
+    /**
+     * Sets the number of orientations averaged by the rasterized PA to n.
+     * \param n the new number of orientations.
+     */
+    void setNbOrientationsPA(int n) {
+      m_nbOrientationsPA = n;
+    }
+
+    /**
+     * Sets the size of the pixels of the rasterized PA to s.
+     * \param s the new size of the pixels, in angstroms.
+     */
+    void setPAPixelSize(double s) {
+      m_PAPixelSize = s;
+    }
+
 
   private:
     /**
@@ -235,6 +544,18 @@ class GlobalParameters
      */
     double m_temperature;
 
+    /**
+     * Temperatures of the sweep of TM.
+     * Default value : none.
+     */
+    std::vector<double> m_temperatureSweep;
+
+    /**
+     * Buffer gases of TM.
+     * Default value : Helium only.
+     */
+    std::vector<BufferGas> m_bufferGases;
+
     /**
      * Potential energy at the start of a trajectory.
      * Default value : 0.00005.
@@ -296,6 +617,90 @@ class GlobalParameters
      * Default value : 99%.
      */
     double m_energyConservationThreshold;
+
+    /**
+     * Way the potential is evaluated for TM method.
+     * Default value : EXACT.
+     */
+    PotentialMode m_potentialMode;
+
+    /**
+     * Cutoff of the cell list, in angstroms.
+     * Default value : 12.0.
+     */
+    double m_cellListCutoff;
+
+    /**
+     * Size of the cells of the cell list, in angstroms.
+     * Default value : 6.0.
+     */
+    double m_cellListCellSize;
+
+    /**
+     * Spacing of the grid of the potential, in angstroms.
+     * Default value : 0.2.
+     */
+    double m_gridSpacing;
+
+    /**
+     * Margin of the grid of the potential around the molecule, in angstroms.
+     * Default value : 6.0.
+     */
+    double m_gridExtent;
+
+    /**
+     * Integrator of the trajectories for TM method.
+     * Default value : MOBCAL.
+     */
+    TrajectoryIntegrator m_trajectoryIntegrator;
+
+    /**
+     * Relative tolerance of the adaptive integrator.
+     * Default value : 1e-6.
+     */
+    double m_integratorTolerance;
+
+    /**
+     * Relative standard error of TM under which its cycles stop, in percents.
+     * Default value : 0, all the cycles are calculated as Mobcal.
+     */
+    double m_TMStandardErrorTarget;
+
+    /**
+     * Indicates if the search of b2max starts from the previous geometry.
+     * Default value : false, each search starts as Mobcal.
+     */
+    bool m_b2maxWarmStart;
+
+    /**
+     * Method of sampling of the trajectories.
+     * Default value : MONTE_CARLO.
+     */
+    SamplingMethod m_samplingMethod;
+
+    /**
+     * Number of scramblings of the Sobol points of EHSS/PA.
+     * Default value : 8.
+     */
+    int m_nbReplicatesQMC;
+
+    /**
+     * Method of calculation of PA.
+     * Default value : MONTE_CARLO.
+     */
+    PAMethod m_PAMethod;
+
+    /**
+     * Number of orientations averaged by the rasterized PA.
+     * Default value : 500.
+     */
+    int m_nbOrientationsPA;
+
+    /**
+     * Size of the pixels of the rasterized PA, in angstroms.
+     * Default value : 0.05.
+     */
+    double m_PAPixelSize;
 };
 
 #endif
@@ -0,0 +1,366 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+#include "ResultCache.h"
+
+#include "BinaryStream.h"
+#include "Checkpoint.h"
+
+#include "../math/StdMathLib.h"
+#include "../math/StdResult.h"
+
+#include <fcntl.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+ResultCache* ResultCache::m_instance = new ResultCache();
+constexpr double ResultCache::m_LockTimeout;
+
+namespace
+{
+  /**
+   * First bytes of a cache file, with the version of its format.
+   */
+  const std::string ResultCacheMagic = "Collision-Code result cache 1";
+
+  /**
+   * Size of an entry of the file without its results : key, last use and
+   * size of the results.
+   */
+  const std::size_t EntryOverhead = 2 * sizeof(uint64_t) + sizeof(uint32_t);
+
+  /**
+   * Hash FNV-1a of 64 bits.
+   */
+  class Hash
+  {
+    public:
+      Hash()
+        : m_value(14695981039346656037ULL) {}
+
+      void add(const void* data, std::size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; ++i) {
+          m_value = (m_value ^ bytes[i]) * 1099511628211ULL;
+        }
+      }
+
+      template <typename T>
+      void add(const T& value) {
+        add(&value, sizeof(T));
+      }
+
+      uint64_t getValue() const {
+        return m_value;
+      }
+
+    private:
+      uint64_t m_value;
+  };
+}
+
+ResultCache::ResultCache()
+  : m_enabled(false), m_maxSize(0), m_parametersKey(0), m_lastUse(0), m_size(0),
+  m_modified(false), m_nbHits(0), m_nbMisses(0), m_nbEvictions(0)
+{
+
+}
+
+ResultCache::~ResultCache()
+{
+
+}
+
+void ResultCache::start(const std::string& filename, double maxSize, const std::string& parameters)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_filename = filename;
+  m_maxSize = maxSize > 0.0 ? maxSize * 1e6 : 0;
+  Hash hash;
+  hash.add(parameters.c_str(), parameters.size());
+  m_parametersKey = hash.getValue();
+  m_entries.clear();
+  m_uses.clear();
+  m_lastUse = 0;
+  m_size = 0;
+  m_modified = false;
+  m_nbHits = 0;
+  m_nbMisses = 0;
+  m_nbEvictions = 0;
+
+  // Sans fichier, le cache commence vide.
+  if (std::ifstream(m_filename.c_str())) {
+    std::unordered_map<uint64_t, Entry> entries;
+    read(entries);
+    merge(entries);
+  }
+  // La taille maximale a pu diminuer depuis l'ecriture.
+  evict();
+
+  m_enabled = true;
+}
+
+Result* ResultCache::find(Molecule* mol, unsigned int geometry)
+{
+  if (!m_enabled) {
+    return nullptr;
+  }
+  const uint64_t key = calculateKey(mol, geometry);
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_entries.find(key);
+  if (it == m_entries.end()) {
+    ++m_nbMisses;
+    return nullptr;
+  }
+  ++m_nbHits;
+  use(key, it->second);
+
+  Result* result = new StdResult(mol);
+  Checkpoint::readResult(it->second.result, result);
+  return result;
+}
+
+void ResultCache::add(Molecule* mol, unsigned int geometry, Result* result)
+{
+  if (!m_enabled) {
+    return;
+  }
+  const uint64_t key = calculateKey(mol, geometry);
+  const std::string data = Checkpoint::writeResult(result);
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_entries.find(key);
+  if (it == m_entries.end()) {
+    Entry entry = {0, data};
+    it = m_entries.insert(std::make_pair(key, entry)).first;
+    m_size += data.size() + EntryOverhead;
+  } else {
+    // Meme cle, resultats recalcules : les derniers remplacent les anciens.
+    m_size += data.size();
+    m_size -= it->second.result.size();
+    it->second.result = data;
+  }
+  use(key, it->second);
+  evict();
+}
+
+void ResultCache::finish()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_enabled) {
+    return;
+  }
+  m_enabled = false;
+  if (!m_modified) {
+    return;
+  }
+
+  // Les resultats ecrits par les autres calculs depuis le debut sont gardes.
+  lockFile();
+  try {
+    if (std::ifstream(m_filename.c_str())) {
+      std::unordered_map<uint64_t, Entry> entries;
+      read(entries);
+      merge(entries);
+    }
+    evict();
+    write();
+  } catch (...) {
+    unlockFile();
+    throw;
+  }
+  unlockFile();
+  m_modified = false;
+}
+
+uint64_t ResultCache::calculateKey(Molecule* mol, unsigned int geometry) const
+{
+  // Les atomes sont centres comme pour les calculs : une geometrie
+  // translatee donne les memes resultats.
+  StdMathLib mathLib;
+  MoleculeData data(mol->getData());
+  Vector3D massCenter = mathLib.calculateMassCenter(data);
+  data.translate(Vector3D(-massCenter.x, -massCenter.y, -massCenter.z));
+
+  Hash hash;
+  hash.add(m_parametersKey);
+  hash.add(geometry);
+  hash.add((uint32_t) data.size());
+  for (unsigned int i = 0; i < data.size(); ++i) {
+    const Vector3D position = data.getPosition(i);
+    hash.add(position.x);
+    hash.add(position.y);
+    hash.add(position.z);
+    hash.add(data.getElementId(i));
+    hash.add(data.getCharges()[i]);
+  }
+  return hash.getValue();
+}
+
+void ResultCache::use(uint64_t key, Entry& entry)
+{
+  if (entry.lastUse != 0) {
+    m_uses.erase(entry.lastUse);
+  }
+  entry.lastUse = ++m_lastUse;
+  m_uses.insert(std::make_pair(entry.lastUse, key));
+  m_modified = true;
+}
+
+void ResultCache::evict()
+{
+  while (m_size > m_maxSize && !m_uses.empty()) {
+    auto it = m_entries.find(m_uses.begin()->second);
+    m_size -= it->second.result.size() + EntryOverhead;
+    m_entries.erase(it);
+    m_uses.erase(m_uses.begin());
+    ++m_nbEvictions;
+    m_modified = true;
+  }
+}
+
+void ResultCache::read(std::unordered_map<uint64_t, Entry>& entries) const
+{
+  std::ifstream in(m_filename.c_str(), std::ios::in | std::ios::binary);
+  std::string magic(ResultCacheMagic.size(), '\0');
+  in.read(&magic[0], magic.size());
+  if (!in || magic != ResultCacheMagic) {
+    std::ostringstream oss;
+    oss << "The file " << m_filename << " is not a result cache file.";
+    throw oss.str();
+  }
+
+  uint64_t lastUse = 0;
+  readValue(in, lastUse);
+  uint64_t nbEntries = 0;
+  readValue(in, nbEntries);
+  for (uint64_t i = 0; i < nbEntries && in; ++i) {
+    uint64_t key = 0;
+    Entry entry;
+    readValue(in, key);
+    readValue(in, entry.lastUse);
+    readString(in, entry.result);
+    entries[key] = entry;
+  }
+
+  if (!in) {
+    std::ostringstream oss;
+    oss << "The result cache file " << m_filename << " is truncated.";
+    throw oss.str();
+  }
+}
+
+void ResultCache::merge(std::unordered_map<uint64_t, Entry>& entries)
+{
+  for (auto it = entries.begin(); it != entries.end(); ++it) {
+    if (m_entries.insert(*it).second) {
+      m_size += it->second.result.size() + EntryOverhead;
+    }
+  }
+
+  // Les utilisations des calculs partageant le fichier ont ete numerotees a
+  // partir du meme nombre : elles sont melangees dans l'ordre de ces numeros.
+  std::vector<std::pair<uint64_t, uint64_t> > uses;
+  for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+    uses.push_back(std::make_pair(it->second.lastUse, it->first));
+  }
+  std::sort(uses.begin(), uses.end());
+  m_uses.clear();
+  m_lastUse = 0;
+  for (auto it = uses.begin(); it != uses.end(); ++it) {
+    m_entries[it->second].lastUse = ++m_lastUse;
+    m_uses.insert(std::make_pair(m_lastUse, it->second));
+  }
+}
+
+void ResultCache::write()
+{
+  const std::string tmpFilename = m_filename + ".tmp";
+  {
+    std::ofstream out(tmpFilename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out) {
+      std::ostringstream oss;
+      oss << "Cannot open file " << tmpFilename << ".";
+      throw oss.str();
+    }
+
+    out.write(ResultCacheMagic.c_str(), ResultCacheMagic.size());
+    writeValue(out, m_lastUse);
+    writeValue(out, (uint64_t) m_entries.size());
+    // Dans l'ordre des utilisations, pour relire le fichier a l'identique.
+    for (auto it = m_uses.begin(); it != m_uses.end(); ++it) {
+      const Entry& entry = m_entries[it->second];
+      writeValue(out, it->second);
+      writeValue(out, entry.lastUse);
+      writeString(out, entry.result);
+    }
+
+    out.flush();
+    if (!out) {
+      std::ostringstream oss;
+      oss << "Cannot write file " << tmpFilename << ".";
+      throw oss.str();
+    }
+  }
+
+  // Le fichier precedent reste complet jusqu'au remplacement.
+#ifdef _WIN32
+  std::remove(m_filename.c_str());
+#endif
+  if (std::rename(tmpFilename.c_str(), m_filename.c_str()) != 0) {
+    std::ostringstream oss;
+    oss << "Cannot write file " << m_filename << ".";
+    throw oss.str();
+  }
+}
+
+void ResultCache::lockFile()
+{
+  const std::string lockFilename = m_filename + ".lock";
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  while (true) {
+    // La creation du fichier echoue s'il existe deja.
+    int fd = open(lockFilename.c_str(), O_CREAT | O_EXCL | O_WRONLY, 0644);
+    if (fd >= 0) {
+      close(fd);
+      return;
+    }
+    if (errno != EEXIST
+        || std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() >= m_LockTimeout) {
+      std::ostringstream oss;
+      oss << "The result cache file " << m_filename << " is locked by another calculation. Remove "
+          << lockFilename << " if no calculation uses it.";
+      throw oss.str();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+}
+
+void ResultCache::unlockFile()
+{
+  std::remove((m_filename + ".lock").c_str());
+}
@@ -0,0 +1,276 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+/**
+ * \file ResultCache.h
+ * \author Anthony Breant, Clement Poinsot, Jeremie Pantin, Mohamed Takhtoukh, Thomas Capet
+ * \version 1.0
+ * \date 17 october 2026
+ * \brief A singleton keeping the results of the geometries in a binary file,
+ * to reuse them in later calculations.
+ *
+ * A result is found by a hash of the parameters of the calculations, with
+ * the data on the atoms (masses, radii and Lennard-Jones parameters), of the
+ * index of the geometry, which gives its random numbers, and of the atoms of
+ * the geometry centered on its mass center : the same geometry calculated
+ * with the same parameters and seed gives the same results. The kernel of
+ * the potential and the number of trajectories integrated together are
+ * parameters too : they change the last digits of TM. The file is read when
+ * the calculations start and written when they finish. Beyond its maximal
+ * size, the results used the least recently are removed.
+ *
+ * Only one calculation may write the file at a time : it holds the lock
+ * file filename.lock while it reads the file again, adds the results written
+ * by the other calculations since its start and replaces the file. The other
+ * calculations wait for the lock.
+ */
+
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include "../math/Result.h"
+#include "../molecule/Molecule.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+class ResultCache
+{
+  public:
+    /**
+     * \return an instance of ResultCache to work with.
+     */
+    static ResultCache* getInstance() {
+      return m_instance;
+    }
+
+    /**
+     * Destructor.
+     */
+    virtual ~ResultCache();
+
+    /**
+     * \return true if the results are cached, false otherwise.
+     */
+    bool isEnabled() const {
+      return m_enabled;
+    }
+
+    /**
+     * Starts caching the results, reading the file if it exists.
+     * \param filename the name of the file.
+     * \param maxSize the maximal size of the file, in megabytes.
+     * \param parameters a description of all the parameters of the calculations.
+     */
+    void start(const std::string& filename, double maxSize, const std::string& parameters);
+
+    /**
+     * Gives the results of a geometry calculated before.
+     * \param mol the geometry.
+     * \param geometry the index of the geometry.
+     * \return new results, nullptr if the geometry isn't in the cache.
+     */
+    Result* find(Molecule* mol, unsigned int geometry);
+
+    /**
+     * Adds the results of a calculated geometry, removing the results used
+     * the least recently if the cache is too big.
+     * \param mol the geometry.
+     * \param geometry the index of the geometry.
+     * \param result the results of the geometry.
+     */
+    void add(Molecule* mol, unsigned int geometry, Result* result);
+
+    /**
+     * Stops caching the results and writes the file. The statistics stay
+     * available.
+     */
+    void finish();
+
+    /**
+     * \return the number of geometries found in the cache.
+     */
+    unsigned int getNumberHits() const {
+      return m_nbHits;
+    }
+
+    /**
+     * \return the number of geometries not found in the cache.
+     */
+    unsigned int getNumberMisses() const {
+      return m_nbMisses;
+    }
+
+    /**
+     * \return the number of results removed from the cache.
+     */
+    unsigned int getNumberEvictions() const {
+      return m_nbEvictions;
+    }
+
+    /**
+     * \return the number of results in the cache.
+     */
+    unsigned int getNumberEntries() const {
+      return m_entries.size();
+    }
+
+    /**
+     * \return the size of the results in the cache, in bytes.
+     */
+    std::size_t getSize() const {
+      return m_size;
+    }
+
+  private:
+    /**
+     * A result in the cache.
+     */
+    struct Entry {
+      /// Number of the last use of the result.
+      uint64_t lastUse;
+      /// Results, written by Checkpoint::writeResult.
+      std::string result;
+    };
+
+    /**
+     * Private constructor.
+     */
+    ResultCache();
+
+    /**
+     * \param mol a geometry.
+     * \param geometry the index of the geometry.
+     * \return the key of the results of the geometry.
+     */
+    uint64_t calculateKey(Molecule* mol, unsigned int geometry) const;
+
+    /**
+     * Marks a result as the last one used.
+     * \param key the key of the result.
+     * \param entry the result.
+     */
+    void use(uint64_t key, Entry& entry);
+
+    /**
+     * Removes the results used the least recently until the cache is
+     * smaller than its maximal size.
+     */
+    void evict();
+
+    /**
+     * Reads the results of the file.
+     * \param entries the results read, by key.
+     */
+    void read(std::unordered_map<uint64_t, Entry>& entries) const;
+
+    /**
+     * Adds results read from the file to the cache, the ones already in the
+     * cache being kept, and numbers the uses of all the results again.
+     * \param entries the results read, by key.
+     */
+    void merge(std::unordered_map<uint64_t, Entry>& entries);
+
+    /**
+     * Writes the file, through a temporary file, so that an interruption
+     * never leaves a partial file.
+     */
+    void write();
+
+    /**
+     * Creates the lock file, waiting for the other calculations writing the
+     * file. Throws an exception after m_LockTimeout seconds.
+     */
+    void lockFile();
+
+    /**
+     * Removes the lock file.
+     */
+    void unlockFile();
+
+  private:
+    /**
+     * Static instance of ResultCache to work with.
+     */
+    static ResultCache* m_instance;
+
+    /**
+     * Maximal time waiting for the lock file, in seconds.
+     */
+    static constexpr double m_LockTimeout = 60.0;
+
+    /**
+     * Indicates if the results are cached.
+     * Default value : false.
+     */
+    bool m_enabled;
+
+    /**
+     * Name of the file.
+     */
+    std::string m_filename;
+
+    /**
+     * Maximal size of the results in the cache, in bytes.
+     */
+    std::size_t m_maxSize;
+
+    /**
+     * Hash of the description of the parameters of the calculations.
+     */
+    uint64_t m_parametersKey;
+
+    /**
+     * Results by key.
+     */
+    std::unordered_map<uint64_t, Entry> m_entries;
+
+    /**
+     * Keys of the results by number of their last use, the least recently
+     * used first.
+     */
+    std::map<uint64_t, uint64_t> m_uses;
+
+    /**
+     * Number of the last use of a result.
+     */
+    uint64_t m_lastUse;
+
+    /**
+     * Size of the results in the cache, in bytes.
+     */
+    std::size_t m_size;
+
+    /**
+     * Indicates if the file has to be written.
+     */
+    bool m_modified;
+
+    /**
+     * Statistics of the cache since the start.
+     */
+    unsigned int m_nbHits;
+    unsigned int m_nbMisses;
+    unsigned int m_nbEvictions;
+
+    /**
+     * Protects the results, used by the geometries calculated at the same time.
+     */
+    std::mutex m_mutex;
+};
+
+#endif // RESULTCACHE_H
@@ -13,21 +13,32 @@
 
 #include "StdCmdView.h"
 
+#include "AtomInformations.h"
+#include "Checkpoint.h"
 #include "GlobalParameters.h"
+#include "ResultCache.h"
+#include "SystemParameters.h"
 #include "StdGeometryCalculator.h"
+#include "BoundedQueue.h"
 #include "../reader/StdExtractResources.h"
 #include "../reader/ChargesReader.h"
 #include "../reader/ChgChargesReader.h"
+#include "../reader/MfjFileReader.h"
 #include "../molecule/Molecule.h"
 #include "../writer/FileWriter.h"
 #include "../writer/StdFileWriter.h"
 #include "../observer/Event.h"
 #include "../math/Mean.h"
 #include "../math/StdMean.h"
+#include "../math/RunningMean.h"
+#include "../math/StdPotentialEngine.h"
+#include "../math/StdCalculationOperator.h"
+#include "../math/RandomGenerator.h"
 
 #include <sstream>
 #include <fstream>
 #include <iostream>
+#include <thread>
 
 StdCmdView::StdCmdView()
 {
@@ -118,7 +129,7 @@ int StdCmdView::loadInputFiles() {
   return m_geometries.size();
 }
 
-void doLines(std::ostringstream& oStream, bool EHSS, bool PA, bool TM) {
+void doLines(std::ostream& oStream, bool EHSS, bool PA, bool TM, bool asym) {
   oStream << " -----";
   if (EHSS) {
     oStream << "-----------";
@@ -133,13 +144,16 @@ void doLines(std::ostringstream& oStream, bool EHSS, bool PA, bool TM) {
     oStream << "-";
   }
   if (TM) {
-    oStream << "---------------------------------------------------------------";
+    oStream << "---------------------------------------";
+  }
+  if (TM && asym) {
+    oStream << "------------------------";
   }
   oStream << "---" << std::endl;
 }
 
-void doEntete(std::ostringstream& oStream, bool EHSS, bool PA, bool TM) {
-  doLines(oStream, EHSS, PA, TM);
+void doEntete(std::ostream& oStream, bool EHSS, bool PA, bool TM, bool asym) {
+  doLines(oStream, EHSS, PA, TM, asym);
 
   oStream << "|   N° ";
   if (EHSS) {
@@ -149,36 +163,85 @@ void doEntete(std::ostringstream& oStream, bool EHSS, bool PA, bool TM) {
     oStream << "\t|   PA CS";
   }
   if (TM) {
-    oStream << "\t|   TM CS" << "\t| Struct Asym Param" << "\t|  Std dev (%)" << "\t|  Failed traj";
+    oStream << "\t|   TM CS";
+    if (asym) {
+      oStream << "\t| Struct Asym Param";
+    }
+    oStream << "\t|  Std dev (%)" << "\t|  Failed traj";
   }
   oStream << "\t|" << std::endl;
 
-  doLines(oStream, EHSS, PA, TM);
+  doLines(oStream, EHSS, PA, TM, asym);
 }
 
-std::string StdCmdView::getResultFormat() const {
-  // Les calculs sont finis, on les enregistre dans le fichier output.
-  std::ostringstream oStream;
-  FileWriter* fileWriter = new StdFileWriter(oStream);
-
-  // Variables globales.
+/**
+ * Writes the values used for the calculations, before the results.
+ */
+void doGlobalVariables(std::ostream& oStream, const GeometryCalculator* calculator) {
   oStream << "****************" << std::endl;
   oStream << "GLOBAL VARIABLES" << std::endl;
   oStream << "****************" << std::endl;
-  GeometryCalculator::CalculationValues calculationValues = m_calculator->getCalculationValues();
+  GeometryCalculator::CalculationValues calculationValues = calculator->getCalculationValues();
   oStream << "Temperature = " << calculationValues.temperature << std::endl;
-  if (m_calculator->willEHSSBeCalculated() || m_calculator->willPABeCalculated()) {
+  const std::vector<double>& sweep = GlobalParameters::getInstance()->getTemperatureSweep();
+  if (calculator->willTMBeCalculated() && !sweep.empty()) {
+    oStream << "Temperatures of the TM sweep =";
+    for (unsigned int i = 0; i < sweep.size(); ++i) {
+      oStream << (i == 0 ? " " : ", ") << sweep[i];
+    }
+    oStream << std::endl;
+  }
+  const std::vector<BufferGas>& gases = GlobalParameters::getInstance()->getBufferGases();
+  if (calculator->willTMBeCalculated() && (gases.size() > 1 || gases[0] != BufferGas::HE)) {
+    oStream << "Buffer gases of TM =";
+    for (unsigned int i = 0; i < gases.size(); ++i) {
+      oStream << (i == 0 ? " " : ", ") << StdCalculationOperator::getBufferGasName(gases[i]);
+    }
+    oStream << std::endl;
+  }
+  if (calculator->willTMBeCalculated() && GlobalParameters::getInstance()->isB2maxWarmStart()) {
+    oStream << "b2max search = warm start from the previous geometry" << std::endl;
+  }
+  oStream << "Seed = " << RandomGenerator::getInstance()->getSeed() << std::endl;
+  if (GlobalParameters::getInstance()->getSamplingMethod() == SamplingMethod::SOBOL) {
+    oStream << "Sampling = sobol (EHSS/PA replicates = " << GlobalParameters::getInstance()->getNbReplicatesQMC() << ")" << std::endl;
+  }
+  if (calculator->willEHSSBeCalculated() || calculator->willPABeCalculated()) {
     oStream << "Number of Monte-Carlo trajectories in EHSS/PA methods = " << GlobalParameters::getInstance()->getNbPointsMCIntegrationEHSSPA() << std::endl;
   }
-  if (m_calculator->willTMBeCalculated()) {
+  if (calculator->willPABeCalculated() && GlobalParameters::getInstance()->getPAMethod() == PAMethod::RASTER) {
+    oStream << "PA = raster (orientations = " << GlobalParameters::getInstance()->getNbOrientationsPA()
+            << ", pixel size = " << GlobalParameters::getInstance()->getPAPixelSize() << " A)" << std::endl;
+  }
+  if (calculator->willTMBeCalculated()) {
     oStream << "**" << std::endl;
     oStream << "Potential energy at start (sw1) = " << calculationValues.potentialEnergyStart << std::endl;
     oStream << "Potential energy when close to a collision (sw2) = " << calculationValues.potentialEnergyCloseCollision << std::endl;
     oStream << "Time step at start (dtsf1) = " << calculationValues.timeStepStart << std::endl;
     oStream << "Time step when close to a collision (dtsf2) = " << calculationValues.timeStepCloseCollision << std::endl;
     oStream << "Energy conservation threshold = " << calculationValues.energyConservationThreshold << "%" << std::endl;
+    oStream << "Potential kernel = " << StdPotentialEngine::getKernelName(StdPotentialEngine::resolveKernel(SystemParameters::getInstance()->getPotentialKernel())) << std::endl;
+    oStream << "Trajectories integrated together = " << SystemParameters::getInstance()->getTrajectoryBatchSize() << std::endl;
+    if (GlobalParameters::getInstance()->getTrajectoryIntegrator() == TrajectoryIntegrator::DORMAND_PRINCE) {
+      oStream << "Integrator = dormand-prince (tolerance = " << GlobalParameters::getInstance()->getIntegratorTolerance() << ")" << std::endl;
+    } else {
+      oStream << "Integrator = mobcal" << std::endl;
+    }
+    if (GlobalParameters::getInstance()->getPotentialMode() == PotentialMode::CELL_LIST) {
+      oStream << "Potential = cell list (cutoff = " << GlobalParameters::getInstance()->getCellListCutoff()
+              << " A, cell size = " << GlobalParameters::getInstance()->getCellListCellSize() << " A)" << std::endl;
+    } else if (GlobalParameters::getInstance()->getPotentialMode() == PotentialMode::GRID) {
+      oStream << "Potential = grid (spacing = " << GlobalParameters::getInstance()->getGridSpacing()
+              << " A, extent = " << GlobalParameters::getInstance()->getGridExtent() << " A)" << std::endl;
+    } else {
+      oStream << "Potential = exact" << std::endl;
+    }
     oStream << "**" << std::endl;
     oStream << "Number of complete cycles for TM method (itn) = " << calculationValues.numberCyclesTM << std::endl;
+    if (GlobalParameters::getInstance()->getTMStandardErrorTarget() > 0.0) {
+      oStream << "Target relative standard error for TM method = " << GlobalParameters::getInstance()->getTMStandardErrorTarget()
+              << "% (itn is the maximal number of cycles)" << std::endl;
+    }
     oStream << "Number of points in velocity integration (inp) = " << calculationValues.numberPointsVelocity << std::endl;
     oStream << "Number of points in Monte-Carlo integrations for TM method (imp) = " << calculationValues.numberPointsMCIntegrationTM << std::endl;
     oStream << "Total number of points = " << calculationValues.numberCyclesTM * calculationValues.numberPointsVelocity * calculationValues.numberPointsMCIntegrationTM << std::endl;
@@ -187,6 +250,39 @@ std::string StdCmdView::getResultFormat() const {
   oStream << "*******" << std::endl;
   oStream << "RESULTS" << std::endl;
   oStream << "*******";
+}
+
+void doTemperatureSweep(std::ostream& oStream, int num, Result* result) {
+  const std::vector<TemperatureTM>& sweep = result->getTemperatureSweep();
+  for (auto it = sweep.begin(); it != sweep.end(); ++it) {
+    oStream << "|\t" << num << "\t|\t" << it->temperature << "\t|\t" << it->crossSection
+            << "\t|\t" << it->mobility << "\t|\t" << it->stdDeviation << "\t|" << std::endl;
+  }
+}
+
+void doBufferGases(std::ostream& oStream, int num, Result* result) {
+  const std::vector<BufferGasTM>& gases = result->getBufferGasesTM();
+  for (auto it = gases.begin(); it != gases.end(); ++it) {
+    oStream << "|\t" << num << "\t|\t" << StdCalculationOperator::getBufferGasName(it->gas) << "\t|\t" << it->crossSection
+            << "\t|\t" << it->mobility << "\t|\t" << it->stdDeviation << "\t|" << std::endl;
+  }
+}
+
+void doResultCache(std::ostream& oStream) {
+  ResultCache* cache = ResultCache::getInstance();
+  oStream << std::endl;
+  oStream << "Geometries found in the result cache and calculated, results evicted, results and size (MB) of the cache :" << std::endl;
+  oStream << "|\t" << cache->getNumberHits() << "\t|\t" << cache->getNumberMisses() << "\t|\t" << cache->getNumberEvictions()
+          << "\t|\t" << cache->getNumberEntries() << "\t|\t" << cache->getSize() / 1e6 << "\t|" << std::endl;
+}
+
+std::string StdCmdView::getResultFormat() const {
+  // Les calculs sont finis, on les enregistre dans le fichier output.
+  std::ostringstream oStream;
+  FileWriter* fileWriter = new StdFileWriter(oStream);
+
+  // Variables globales.
+  doGlobalVariables(oStream, m_calculator);
 
   // Entete des colonnes.
   std::string lastFile = "";
@@ -201,10 +297,10 @@ std::string StdCmdView::getResultFormat() const {
     if (file != lastFile) {
       oStream << std::endl;
       oStream << "File : " << file << std::endl;
-      doEntete(oStream, m_calculator->willEHSSBeCalculated(), m_calculator->willPABeCalculated(), m_calculator->willTMBeCalculated());
+      doEntete(oStream, m_calculator->willEHSSBeCalculated(), m_calculator->willPABeCalculated(), m_calculator->willTMBeCalculated(), m_calculator->willAsymmetryParameterBeCalculated());
       lastFile = file;
     } else {
-      doLines(oStream, m_calculator->willEHSSBeCalculated(), m_calculator->willPABeCalculated(), m_calculator->willTMBeCalculated());
+      doLines(oStream, m_calculator->willEHSSBeCalculated(), m_calculator->willPABeCalculated(), m_calculator->willTMBeCalculated(), m_calculator->willAsymmetryParameterBeCalculated());
     }
 
     // D'abord, numéro de la géométrie associé au fichier d'où elle vient.
@@ -214,11 +310,106 @@ std::string StdCmdView::getResultFormat() const {
     oStream << std::endl;
     ++num;
   }
-  doLines(oStream, m_calculator->willEHSSBeCalculated(), m_calculator->willPABeCalculated(), m_calculator->willTMBeCalculated());
+  doLines(oStream, m_calculator->willEHSSBeCalculated(), m_calculator->willPABeCalculated(), m_calculator->willTMBeCalculated(), m_calculator->willAsymmetryParameterBeCalculated());
   oStream << "|  Mean";
   mean->accept(*fileWriter);
   oStream << std::endl;
-  doLines(oStream, m_calculator->willEHSSBeCalculated(), m_calculator->willPABeCalculated(), m_calculator->willTMBeCalculated());
+  doLines(oStream, m_calculator->willEHSSBeCalculated(), m_calculator->willPABeCalculated(), m_calculator->willTMBeCalculated(), m_calculator->willAsymmetryParameterBeCalculated());
+
+  // Cout de l'integration des trajectoires, par geometrie.
+  if (m_calculator->willTMBeCalculated()) {
+    oStream << std::endl;
+    oStream << "Average integration steps and calculations of the potential per trajectory :" << std::endl;
+    num = 1;
+    for (auto it = m_geometries.begin(); it != m_geometries.end(); ++it) {
+      Result* result = m_calculator->getResults(*it);
+      oStream << "|\t" << num << "\t|\t" << result->getAverageNumberSteps()
+              << "\t|\t" << result->getAverageNumberPotentialCalculations() << "\t|" << std::endl;
+      ++num;
+    }
+  }
+
+  // Erreurs de EHSS et PA, par geometrie.
+  if ((m_calculator->willEHSSBeCalculated() || m_calculator->willPABeCalculated())
+      && GlobalParameters::getInstance()->getSamplingMethod() == SamplingMethod::SOBOL) {
+    oStream << std::endl;
+    oStream << "Relative standard errors of EHSS and PA over the scramblings of the Sobol points (%) :" << std::endl;
+    num = 1;
+    for (auto it = m_geometries.begin(); it != m_geometries.end(); ++it) {
+      Result* result = m_calculator->getResults(*it);
+      oStream << "|\t" << num << "\t|\t" << result->getStandardErrorEHSS()
+              << "\t|\t" << result->getStandardErrorPA() << "\t|" << std::endl;
+      ++num;
+    }
+  }
+
+  // TM a chaque temperature du balayage, par geometrie.
+  if (m_calculator->willTMBeCalculated() && !GlobalParameters::getInstance()->getTemperatureSweep().empty()) {
+    oStream << std::endl;
+    oStream << "TM cross section, mobility (m2/(V.s)) and standard deviation (%) at each temperature (K) :" << std::endl;
+    num = 1;
+    for (auto it = m_geometries.begin(); it != m_geometries.end(); ++it) {
+      doTemperatureSweep(oStream, num, m_calculator->getResults(*it));
+      ++num;
+    }
+  }
+
+  // TM avec chaque gaz tampon, par geometrie.
+  if (m_calculator->willTMBeCalculated() && GlobalParameters::getInstance()->getBufferGases().size() > 1) {
+    oStream << std::endl;
+    oStream << "TM cross section, mobility (m2/(V.s)) and standard deviation (%) with each buffer gas :" << std::endl;
+    num = 1;
+    for (auto it = m_geometries.begin(); it != m_geometries.end(); ++it) {
+      doBufferGases(oStream, num, m_calculator->getResults(*it));
+      ++num;
+    }
+  }
+
+  // Recherche de b2max, par geometrie.
+  if (m_calculator->willTMBeCalculated() && GlobalParameters::getInstance()->isB2maxWarmStart()) {
+    oStream << std::endl;
+    oStream << "Trajectories of the coarse search of b2max calculated and saved by the warm start (negative when the guess is rejected) :" << std::endl;
+    num = 1;
+    for (auto it = m_geometries.begin(); it != m_geometries.end(); ++it) {
+      Result* result = m_calculator->getResults(*it);
+      oStream << "|\t" << num << "\t|\t" << result->getNumberB2maxTrajectories()
+              << "\t|\t" << result->getNumberSavedB2maxTrajectories() << "\t|" << std::endl;
+      ++num;
+    }
+  }
+
+  // Convergence de TM, par geometrie.
+  if (m_calculator->willTMBeCalculated() && GlobalParameters::getInstance()->getTMStandardErrorTarget() > 0.0) {
+    oStream << std::endl;
+    oStream << "Cycles calculated for TM and relative standard error of TM (%) :" << std::endl;
+    num = 1;
+    for (auto it = m_geometries.begin(); it != m_geometries.end(); ++it) {
+      Result* result = m_calculator->getResults(*it);
+      oStream << "|\t" << num << "\t|\t" << result->getNumberCyclesTM()
+              << "\t|\t" << result->getStandardError() << "\t|" << std::endl;
+      ++num;
+    }
+  }
+
+  // Erreurs estimees du potentiel approche, par geometrie.
+  if (m_calculator->willTMBeCalculated()
+      && GlobalParameters::getInstance()->getPotentialMode() != PotentialMode::EXACT) {
+    oStream << std::endl;
+    oStream << "Estimated errors of the potential (relative to max(|V|, kT) and max(|grad V|, kT/A)) :" << std::endl;
+    num = 1;
+    for (auto it = m_geometries.begin(); it != m_geometries.end(); ++it) {
+      Result* result = m_calculator->getResults(*it);
+      if (result->isPotentialApproximated()) {
+        oStream << "|\t" << num << "\t|\t" << result->getPotentialError()
+                << "\t|\t" << result->getPotentialGradientError() << "\t|" << std::endl;
+      }
+      ++num;
+    }
+  }
+
+  if (ResultCache::getInstance()->isEnabled()) {
+    doResultCache(oStream);
+  }
 
   delete mean;
   delete fileWriter;
@@ -238,10 +429,66 @@ void StdCmdView::saveResults() {
   oFile << getResultFormat();
   oFile.close();
 
+  // Les resultats sont ecrits, l'avancement ne sert plus.
+  Checkpoint::getInstance()->finish();
+  ResultCache::getInstance()->finish();
+
   // On notifie les observateurs.
   notifyObservers(ObservableEvent::FILE_SAVED);
 }
 
+void StdCmdView::startCheckpoint()
+{
+  SystemParameters* systemParameters = SystemParameters::getInstance();
+  if (systemParameters->getCheckpointInterval() <= 0.0 && !systemParameters->isResumed()) {
+    return;
+  }
+  if (m_outputFile == "") {
+    throw std::string("There is no output file.");
+  }
+
+  // La graine est celle du point de reprise.
+  Checkpoint* checkpoint = Checkpoint::getInstance();
+  checkpoint->start(m_outputFile + ".ckpt", systemParameters->getCheckpointInterval(), systemParameters->isResumed());
+
+  // Les parametres des calculs sont ceux de l'en-tete des resultats, avec
+  // les methodes calculees, les fichiers lus et les donnees sur les atomes.
+  std::ostringstream parameters;
+  doGlobalVariables(parameters, m_calculator);
+  parameters << std::endl << m_calculator->willEHSSBeCalculated() << m_calculator->willPABeCalculated()
+             << m_calculator->willTMBeCalculated() << m_calculator->willAsymmetryParameterBeCalculated() << std::endl;
+  for (auto it = m_inputFiles.begin(); it != m_inputFiles.end(); ++it) {
+    parameters << *it << std::endl;
+  }
+  parameters << m_chargeFile << std::endl;
+  // Les masses, rayons et parametres de Lennard-Jones du fichier de donnees.
+  parameters << AtomInformations::getInstance()->getTableDescription();
+  checkpoint->checkParameters(parameters.str());
+}
+
+void StdCmdView::startResultCache()
+{
+  SystemParameters* systemParameters = SystemParameters::getInstance();
+  if (systemParameters->getResultCacheFile() == "") {
+    return;
+  }
+
+  // Les parametres des calculs sont ceux de l'en-tete des resultats, a la
+  // precision des doubles, avec les methodes calculees et les donnees sur
+  // les atomes. Le noyau et le nombre de trajectoires integrees ensemble en
+  // font partie : ils changent les derniers chiffres de TM. La graine est
+  // celle du point de reprise.
+  std::ostringstream parameters;
+  parameters.precision(17);
+  doGlobalVariables(parameters, m_calculator);
+  parameters << std::endl << m_calculator->willEHSSBeCalculated() << m_calculator->willPABeCalculated()
+             << m_calculator->willTMBeCalculated() << m_calculator->willAsymmetryParameterBeCalculated() << std::endl;
+  // Les masses, rayons et parametres de Lennard-Jones du fichier de donnees.
+  parameters << AtomInformations::getInstance()->getTableDescription();
+  ResultCache::getInstance()->start(systemParameters->getResultCacheFile(), systemParameters->getResultCacheMaxSize(),
+                                    parameters.str());
+}
+
 void StdCmdView::launch()
 {
   // On donne les géométries au calculateur.
@@ -253,9 +500,300 @@ void StdCmdView::launch()
   // On passe les observateurs du calcul.
   m_calculator->takeObservers(m_observers);
 
+  // Reprise des calculs interrompus.
+  startCheckpoint();
+  startResultCache();
+
   // On lance les calculs.
   m_calculator->launchCalculations();
 
   // On indique que les calculs sont termines.
   notifyObservers(ObservableEvent::CALCULATIONS_FINISHED);
 }
+
+namespace
+{
+  /**
+   * A geometry read from an input file, then its results once calculated.
+   */
+  struct StreamedGeometry {
+    unsigned int index;
+    std::string file;
+    Molecule* mol;
+    Result* result;
+  };
+
+  /**
+   * Reads the geometries of all the input files and adds them to the queue,
+   * with their index among all geometries. The .mfj files are read one
+   * geometry after the other, the other formats are loaded all at once.
+   * Stops when the queue is closed.
+   */
+  void readGeometries(const std::vector<std::string>& inputFiles, BoundedQueue<StreamedGeometry>& geometries)
+  {
+    unsigned int index = 0;
+    for (auto it = inputFiles.begin(); it != inputFiles.end(); ++it) {
+      const std::string& file = *it;
+      if (file.size() >= 4 && file.compare(file.size() - 4, 4, ".mfj") == 0) {
+        MfjFileReader reader(file);
+        reader.open();
+        while (Molecule* mol = reader.readNextGeometry()) {
+          StreamedGeometry g = {index++, file, mol, nullptr};
+          if (!geometries.push(g)) {
+            delete mol;
+            return;
+          }
+        }
+      } else {
+        StdExtractResources extractor;
+        std::vector<Molecule*>* l = extractor.getGeometriesFromFile(file);
+        if (l == nullptr) {
+          std::ostringstream oss;
+          oss << "Impossible to load file " << file << ".";
+          throw oss.str();
+        }
+        for (auto it2 = l->begin(); it2 != l->end(); ++it2) {
+          StreamedGeometry g = {index++, file, *it2, nullptr};
+          if (!geometries.push(g)) {
+            // File fermee : on libere les geometries restantes.
+            for (; it2 != l->end(); ++it2) {
+              delete *it2;
+            }
+            delete l;
+            return;
+          }
+        }
+        delete l;
+      }
+    }
+  }
+
+  /**
+   * Appends the results to the output, in the order of the geometries,
+   * then the mean and the statistics of the trajectories once the queue
+   * is closed. The geometries and their results are destroyed once written.
+   */
+  void writeResults(std::ostream& oStream, BoundedQueue<StreamedGeometry>& results, const bool& failed,
+                    const GeometryCalculator* calculator)
+  {
+    const bool EHSS = calculator->willEHSSBeCalculated();
+    const bool PA = calculator->willPABeCalculated();
+    const bool TM = calculator->willTMBeCalculated();
+    const bool asym = calculator->willAsymmetryParameterBeCalculated();
+    const bool approximatedPotential = GlobalParameters::getInstance()->getPotentialMode() != PotentialMode::EXACT;
+    const bool adaptiveTM = GlobalParameters::getInstance()->getTMStandardErrorTarget() > 0.0;
+    const bool sobol = GlobalParameters::getInstance()->getSamplingMethod() == SamplingMethod::SOBOL;
+    const bool temperatureSweep = !GlobalParameters::getInstance()->getTemperatureSweep().empty();
+    const bool bufferGases = GlobalParameters::getInstance()->getBufferGases().size() > 1;
+    const bool b2maxWarmStart = GlobalParameters::getInstance()->isB2maxWarmStart();
+    const bool resultCache = ResultCache::getInstance()->isEnabled();
+
+    FileWriter* fileWriter = new StdFileWriter(oStream);
+    Mean* mean = new RunningMean();
+
+    // Les sections de fin sont remplies au fur et a mesure.
+    std::ostringstream statistics;
+    std::ostringstream hardSphereErrors;
+    std::ostringstream temperatures;
+    std::ostringstream gases;
+    std::ostringstream b2maxSearch;
+    std::ostringstream convergence;
+    std::ostringstream errors;
+
+    std::string lastFile = "";
+    std::map<unsigned int, StreamedGeometry> pending;
+    unsigned int next = 0;
+    StreamedGeometry g;
+    while (results.pop(g)) {
+      pending.insert(std::make_pair(g.index, g));
+
+      // Les resultats arrives avant celui de la geometrie suivante attendent.
+      for (auto it = pending.begin(); it != pending.end() && it->first == next; it = pending.erase(it)) {
+        Result* result = it->second.result;
+        const unsigned int num = next + 1;
+
+        if (it->second.file != lastFile) {
+          oStream << std::endl;
+          oStream << "File : " << it->second.file << std::endl;
+          doEntete(oStream, EHSS, PA, TM, asym);
+          lastFile = it->second.file;
+        } else {
+          doLines(oStream, EHSS, PA, TM, asym);
+        }
+        oStream << "|\t" << num;
+        mean->addResult(result);
+        result->accept(*fileWriter);
+        // La ligne est sur le disque des qu'elle est ecrite.
+        oStream << std::endl;
+
+        statistics << "|\t" << num << "\t|\t" << result->getAverageNumberSteps()
+                   << "\t|\t" << result->getAverageNumberPotentialCalculations() << "\t|" << std::endl;
+        doTemperatureSweep(temperatures, num, result);
+        doBufferGases(gases, num, result);
+        b2maxSearch << "|\t" << num << "\t|\t" << result->getNumberB2maxTrajectories()
+                    << "\t|\t" << result->getNumberSavedB2maxTrajectories() << "\t|" << std::endl;
+        hardSphereErrors << "|\t" << num << "\t|\t" << result->getStandardErrorEHSS()
+                         << "\t|\t" << result->getStandardErrorPA() << "\t|" << std::endl;
+        convergence << "|\t" << num << "\t|\t" << result->getNumberCyclesTM()
+                    << "\t|\t" << result->getStandardError() << "\t|" << std::endl;
+        if (result->isPotentialApproximated()) {
+          errors << "|\t" << num << "\t|\t" << result->getPotentialError()
+                 << "\t|\t" << result->getPotentialGradientError() << "\t|" << std::endl;
+        }
+
+        delete result;
+        delete it->second.mol;
+        ++next;
+      }
+    }
+
+    if (!failed) {
+      doLines(oStream, EHSS, PA, TM, asym);
+      oStream << "|  Mean";
+      mean->accept(*fileWriter);
+      oStream << std::endl;
+      doLines(oStream, EHSS, PA, TM, asym);
+
+      if (TM) {
+        oStream << std::endl;
+        oStream << "Average integration steps and calculations of the potential per trajectory :" << std::endl;
+        oStream << statistics.str();
+      }
+      if ((EHSS || PA) && sobol) {
+        oStream << std::endl;
+        oStream << "Relative standard errors of EHSS and PA over the scramblings of the Sobol points (%) :" << std::endl;
+        oStream << hardSphereErrors.str();
+      }
+      if (TM && temperatureSweep) {
+        oStream << std::endl;
+        oStream << "TM cross section, mobility (m2/(V.s)) and standard deviation (%) at each temperature (K) :" << std::endl;
+        oStream << temperatures.str();
+      }
+      if (TM && bufferGases) {
+        oStream << std::endl;
+        oStream << "TM cross section, mobility (m2/(V.s)) and standard deviation (%) with each buffer gas :" << std::endl;
+        oStream << gases.str();
+      }
+      if (TM && b2maxWarmStart) {
+        oStream << std::endl;
+        oStream << "Trajectories of the coarse search of b2max calculated and saved by the warm start (negative when the guess is rejected) :" << std::endl;
+        oStream << b2maxSearch.str();
+      }
+      if (TM && adaptiveTM) {
+        oStream << std::endl;
+        oStream << "Cycles calculated for TM and relative standard error of TM (%) :" << std::endl;
+        oStream << convergence.str();
+      }
+      if (TM && approximatedPotential) {
+        oStream << std::endl;
+        oStream << "Estimated errors of the potential (relative to max(|V|, kT) and max(|grad V|, kT/A)) :" << std::endl;
+        oStream << errors.str();
+      }
+      if (resultCache) {
+        doResultCache(oStream);
+      }
+      oStream.flush();
+    }
+
+    // Resultats jamais ecrits, apres une erreur.
+    for (auto it = pending.begin(); it != pending.end(); ++it) {
+      delete it->second.result;
+      delete it->second.mol;
+    }
+
+    delete mean;
+    delete fileWriter;
+  }
+}
+
+void StdCmdView::launchStreaming()
+{
+  if (m_inputFiles.size() == 0) {
+    throw std::string("There is no input file.");
+  }
+  if (m_outputFile == "") {
+    throw std::string("There is no output file.");
+  }
+  // Les charges s'appliquent a toutes les geometries chargees.
+  if (m_chargeFile != "") {
+    throw std::string("A charge file can't be used while streaming the geometries.");
+  }
+
+  m_calculator->saveCalculationValues();
+  m_calculator->takeObservers(m_observers);
+
+  // Reprise des calculs interrompus, avant l'en-tete qui donne la graine.
+  startCheckpoint();
+  startResultCache();
+
+  // L'en-tete est ecrit avant le premier resultat.
+  std::ofstream oFile(m_outputFile);
+  if (!oFile) {
+    std::ostringstream oss;
+    oss << "Cannot open file " << m_outputFile << ".";
+    throw oss.str();
+  }
+  doGlobalVariables(oFile, m_calculator);
+  oFile.flush();
+
+  const unsigned int queueSize = SystemParameters::getInstance()->getStreamQueueSize();
+  BoundedQueue<StreamedGeometry> geometries(queueSize);
+  BoundedQueue<StreamedGeometry> results(queueSize);
+  bool failed = false;
+
+  // Lecture des geometries, au plus queueSize en avance sur les calculs.
+  std::string readerError;
+  std::thread reader([&]() {
+    try {
+      readGeometries(m_inputFiles, geometries);
+    } catch (std::string& e) {
+      readerError = e;
+    }
+    geometries.close();
+  });
+
+  // Ecriture des resultats, des qu'ils sont connus.
+  std::thread writer([&]() {
+    writeResults(oFile, results, failed, m_calculator);
+  });
+
+  // Calculs, dans ce thread, qui notifie les observateurs.
+  StreamedGeometry g = {0, "", nullptr, nullptr};
+  try {
+    while (geometries.pop(g)) {
+      g.result = m_calculator->calculate(g.mol, g.index);
+      results.push(g);
+      g.mol = nullptr;
+    }
+  } catch (...) {
+    // On arrete la lecture et l'ecriture avant de remonter l'erreur.
+    failed = true;
+    geometries.close();
+    results.close();
+    reader.join();
+    writer.join();
+    delete g.mol;
+    while (geometries.pop(g)) {
+      delete g.mol;
+    }
+    throw;
+  }
+
+  reader.join();
+  failed = readerError != "";
+  results.close();
+  writer.join();
+  oFile.close();
+
+  if (failed) {
+    throw readerError;
+  }
+  Checkpoint::getInstance()->finish();
+  ResultCache::getInstance()->finish();
+
+  // On indique que les calculs sont termines.
+  notifyObservers(ObservableEvent::CALCULATIONS_FINISHED);
+
+  // On notifie les observateurs.
+  notifyObservers(ObservableEvent::FILE_SAVED);
+}
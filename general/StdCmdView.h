@@ -80,6 +80,14 @@ class StdCmdView : public CmdView
       return m_calculator->willTMBeCalculated();
     }
 
+    /**
+     * \return true if the structural asymmetry parameter will be calculated
+     * with TM, false otherwise.
+     */
+    bool willAsymmetryParameterBeCalculated() const {
+      return m_calculator->willAsymmetryParameterBeCalculated();
+    }
+
     /**
      * Indicates if yes or no, EHSS should be calculated.
      * \param b true if EHSS should be calculated, else otherwise.
@@ -104,6 +112,15 @@ class StdCmdView : public CmdView
       m_calculator->shouldTMBeCalculated(b);
     }
 
+    /**
+     * Indicates if yes or no, the structural asymmetry parameter should be
+     * calculated with TM.
+     * \param b true if the structural asymmetry parameter should be calculated, else otherwise.
+     */
+    void shouldAsymmetryParameterBeCalculated(bool b) {
+      m_calculator->shouldAsymmetryParameterBeCalculated(b);
+    }
+
     /**
      * Indicates a new file to load.
      * \param fileName the name of the file to load.
@@ -171,6 +188,30 @@ class StdCmdView : public CmdView
      */
     void launch();
 
+    /**
+     * Launches all the calculations, on all input files, while they are read.
+     * A thread reads the geometries, at most a few ahead of the
+     * calculations, and another one appends each result to the output
+     * file as soon as it is known, then releases the geometry.
+     * A charge file can't be used.
+     */
+    void launchStreaming();
+
+  private:
+    /**
+     * Starts saving the progression of the calculations next to the output
+     * file, if asked, and resumes it. The parameters of the calculations
+     * must be the ones of the progression resumed.
+     */
+    void startCheckpoint();
+
+    /**
+     * Starts caching the results of the geometries, if asked. The results
+     * are found by the parameters of the calculations and the atoms of the
+     * geometries, not by the files read.
+     */
+    void startResultCache();
+
   private:
     /**
      * A calculator for the CCS.
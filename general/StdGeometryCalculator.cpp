@@ -13,19 +13,28 @@
 
 #include "StdGeometryCalculator.h"
 
+#include "Checkpoint.h"
 #include "GlobalParameters.h"
+#include "ResultCache.h"
 #include "SystemParameters.h"
 
 #include "../math/CalculationOperator.h"
 #include "../math/MonoThreadCalculationOperator.h"
 #include "../math/MultiThreadCalculationOperator.h"
+#include "../observer/OrderedObserver.h"
 #include "../observer/state/CalculationState.h"
 
+#include <omp.h>
+
+#include <algorithm>
+#include <cmath>
+
 #include <string>
 
 
 StdGeometryCalculator::StdGeometryCalculator()
-  : m_geometries(nullptr), m_EHSSWillBeCalculated(true), m_PAWillBeCalculated(true), m_TMWillBeCalculated(true)
+  : m_geometries(nullptr), m_EHSSWillBeCalculated(true), m_PAWillBeCalculated(true), m_TMWillBeCalculated(true),
+    m_asymmetryParameterWillBeCalculated(true)
 {
   saveCalculationValues();
 }
@@ -44,6 +53,8 @@ bool StdGeometryCalculator::areCalculationsFinished(Molecule* mol) const
     throw std::string("Can't test calculation ending for a null pointer to molecule.");
   }
 
+  std::lock_guard<std::mutex> lock(m_resultsMutex);
+
   // On teste si la molécule est dans la vectore des molécules à calculer.
   auto state = m_calculationsState.find(mol);
   if (state == m_calculationsState.end()) {
@@ -66,6 +77,7 @@ Result* StdGeometryCalculator::getResults(Molecule* mol) const
     throw std::string("Can't obtain results of a non-finished calculation.");
   }
 
+  std::lock_guard<std::mutex> lock(m_resultsMutex);
   return m_results.find(mol)->second;
 }
 
@@ -110,26 +122,150 @@ void StdGeometryCalculator::launchCalculations()
       throw std::string("Can't calculate on null vector of geometries.");
   }
 
-  unsigned int maxNumberOfThreads = SystemParameters::getInstance()->getMaximalNumberThreads();
+  const unsigned int maxNumberOfThreads = std::max(SystemParameters::getInstance()->getMaximalNumberThreads(), 1u);
+  const unsigned int nbGeometries = m_geometries->size();
 
-  // Pour toutes les géométries.
+  // Les threads sont partages selon la plus grosse geometrie.
+  unsigned int maxNumberAtoms = 0;
   for (auto it = m_geometries->begin(); it != m_geometries->end(); ++it) {
-    // On a un besoin d'un nouveau calculateur.
-    CalculationOperator* calculator;
-
-    // Pour le pattern Observer.
-    CalculationState* calculationState = new CalculationState(*it,
-                                          m_calculationValues.numberCyclesTM *
-                                          m_calculationValues.numberPointsVelocity *
-                                          m_calculationValues.numberPointsMCIntegrationTM);
-    // On ajoute tous les observeurs.
-    std::for_each(m_obsList.begin(), m_obsList.end(), [&](Observer* obs){ calculationState->addObserver(obs); });
-
-    if (maxNumberOfThreads <= 1) {
+    maxNumberAtoms = std::max(maxNumberAtoms, (*it)->getAtomNumber());
+  }
+  const unsigned int nbThreads = getNumberThreadsPerGeometry(maxNumberAtoms, maxNumberOfThreads);
+  const unsigned int nbConcurrentGeometries = std::min(nbGeometries, maxNumberOfThreads / nbThreads);
+
+  if (nbConcurrentGeometries <= 1) {
+    // Pour toutes les géométries, une à une.
+    for (auto it = m_geometries->begin(); it != m_geometries->end(); ++it) {
+      Result* result = calculate(*it, it - m_geometries->begin(), maxNumberOfThreads, m_obsList);
+
+      // Calcul terminé, enregistrement des résultats et passage du booléen
+      // de l'état à true.
+      m_calculationsState[*it] = true;
+      m_results.insert(std::pair<Molecule*, Result*>(*it, result));
+    }
+    return;
+  }
+
+  // Les observateurs sont notifies comme si les geometries etaient
+  // calculees une a une.
+  OrderedObserver orderedObserver(m_obsList, *m_geometries);
+  const std::vector<Observer*> observers(1, &orderedObserver);
+
+  // Les notifications d'une geometrie attendant son tour sont transmises
+  // apres son calcul : les etats sont gardes jusqu'a la fin, et detruits
+  // avant l'observateur.
+  std::vector<std::unique_ptr<CalculationState> > states(nbGeometries);
+
+  std::string error;
+  bool failed = false;
+
+  // Chaque geometrie lance ses propres threads.
+  const int maxActiveLevels = omp_get_max_active_levels();
+  omp_set_max_active_levels(std::max(maxActiveLevels, 2));
+
+  // Les geometries sont prises dans l'ordre, la premiere non terminee
+  // etant toujours en cours de calcul.
+  #pragma omp parallel for schedule(dynamic, 1) num_threads(nbConcurrentGeometries)
+  for (int i = 0; i < (int) nbGeometries; ++i) {
+    Molecule* mol = (*m_geometries)[i];
+    try {
+      {
+        std::lock_guard<std::mutex> lock(m_resultsMutex);
+        if (failed) {
+          continue;
+        }
+      }
+      Result* result = calculate(mol, i, nbThreads, observers, &states[i]);
+
+      std::lock_guard<std::mutex> lock(m_resultsMutex);
+      m_calculationsState[mol] = true;
+      m_results.insert(std::pair<Molecule*, Result*>(mol, result));
+    } catch (std::string& e) {
+      // Les exceptions ne peuvent pas sortir de la region parallele.
+      std::lock_guard<std::mutex> lock(m_resultsMutex);
+      if (!failed) {
+        failed = true;
+        error = e;
+      }
+    }
+  }
+
+  omp_set_max_active_levels(maxActiveLevels);
+
+  if (failed) {
+    throw error;
+  }
+}
+
+unsigned int StdGeometryCalculator::getNumberThreadsPerGeometry(unsigned int nbAtoms, unsigned int maxNumberOfThreads) const
+{
+  double work = 0.0;
+  if (willTMBeCalculated()) {
+    work += (double) nbAtoms * m_calculationValues.numberCyclesTM * m_calculationValues.numberPointsVelocity
+            * m_calculationValues.numberPointsMCIntegrationTM * GlobalParameters::getInstance()->getBufferGases().size();
+  }
+  if (willEHSSBeCalculated() || willPABeCalculated()) {
+    work += (double) nbAtoms * m_calculationValues.numberPointsMCIntegrationEHSSPA * m_HardSphereTrajectoryCost;
+  }
+
+  const double nbThreads = std::ceil(work / m_WorkPerThread);
+  if (nbThreads >= maxNumberOfThreads) {
+    return maxNumberOfThreads;
+  }
+  return std::max((unsigned int) nbThreads, 1u);
+}
+
+Result* StdGeometryCalculator::calculate(Molecule* mol, unsigned int geometryIndex)
+{
+  return calculate(mol, geometryIndex, SystemParameters::getInstance()->getMaximalNumberThreads(), m_obsList);
+}
+
+Result* StdGeometryCalculator::calculate(Molecule* mol, unsigned int geometryIndex, unsigned int nbThreads,
+                                         const std::vector<Observer*>& observers,
+                                         std::unique_ptr<CalculationState>* keptState)
+{
+  // Pour le pattern Observer. Les trajectoires de TM sont calculees pour
+  // chaque gaz. L'etat est detruit apres le calculateur, qui le notifie
+  // jusque dans son destructeur, meme apres une erreur.
+  std::unique_ptr<CalculationState> ownState;
+  std::unique_ptr<CalculationState>& state = keptState != nullptr ? *keptState : ownState;
+  state.reset(new CalculationState(mol,
+                                   m_calculationValues.numberCyclesTM *
+                                   m_calculationValues.numberPointsVelocity *
+                                   m_calculationValues.numberPointsMCIntegrationTM *
+                                   GlobalParameters::getInstance()->getBufferGases().size()));
+  CalculationState* calculationState = state.get();
+
+  // On a un besoin d'un nouveau calculateur.
+  std::unique_ptr<CalculationOperator> calculator;
+  calculationState->setProgressRate(SystemParameters::getInstance()->getProgressRate());
+  // On ajoute tous les observeurs.
+  std::for_each(observers.begin(), observers.end(), [&](Observer* obs){ calculationState->addObserver(obs); });
+
+  // Geometrie deja calculee avec les memes parametres : ses resultats sont
+  // notifies comme s'ils venaient d'etre calcules.
+  Result* result = ResultCache::getInstance()->find(mol, geometryIndex);
+  if (result != nullptr) {
+    if (willEHSSBeCalculated() || willPABeCalculated()) {
+      calculationState->setEHSSStarted();
+      calculationState->setPAStarted();
+      calculationState->setEHSSResult(result->getEHSS());
+      calculationState->setEHSSEnded();
+      calculationState->setPAResult(result->getPA());
+      calculationState->setPAEnded();
+    }
+    if (willTMBeCalculated()) {
+      calculationState->setTMStarted();
+      calculationState->setTMResult(result->getTM());
+      calculationState->setTMEnded();
+    }
+    calculationState->oneCalculationFinished();
+  } else {
+    if (nbThreads <= 1) {
       // 0 ou 1 thread -> MonoThread.
-      calculator =
+      calculator.reset(
       new MonoThreadCalculationOperator(calculationState,
-                                        *it,
+                                        mol,
                                         m_calculationValues.temperature,
                                         m_calculationValues.potentialEnergyStart,
                                         m_calculationValues.timeStepStart,
@@ -139,13 +275,13 @@ void StdGeometryCalculator::launchCalculations()
                                         m_calculationValues.numberPointsVelocity,
                                         m_calculationValues.numberPointsMCIntegrationTM,
                                         m_calculationValues.energyConservationThreshold,
-                                        m_calculationValues.numberPointsMCIntegrationEHSSPA);
+                                        m_calculationValues.numberPointsMCIntegrationEHSSPA));
     } else {
       // Plus d'un thread -> MultiThread
-      calculator =
+      calculator.reset(
       new MultiThreadCalculationOperator(calculationState,
-                                         *it,
-                                         maxNumberOfThreads,
+                                         mol,
+                                         nbThreads,
                                          m_calculationValues.temperature,
                                          m_calculationValues.potentialEnergyStart,
                                          m_calculationValues.timeStepStart,
@@ -155,9 +291,13 @@ void StdGeometryCalculator::launchCalculations()
                                          m_calculationValues.numberPointsVelocity,
                                          m_calculationValues.numberPointsMCIntegrationTM,
                                          m_calculationValues.energyConservationThreshold,
-                                         m_calculationValues.numberPointsMCIntegrationEHSSPA);
+                                         m_calculationValues.numberPointsMCIntegrationEHSSPA));
     }
 
+    // Les nombres aleatoires dependent de la geometrie.
+    calculator->setGeometryIndex(geometryIndex);
+    calculator->setAsymmetryParameterCalculated(willAsymmetryParameterBeCalculated());
+
     // Si on doit calculer EHSS ou PA, on se lance.
     if (willEHSSBeCalculated() || willPABeCalculated()) {
       calculator->runEHSSAndPA();
@@ -167,16 +307,20 @@ void StdGeometryCalculator::launchCalculations()
       calculator->runTM();
     }
 
-    calculator->getResults()->EHSSNeedsToBePrinted(willEHSSBeCalculated());
-    calculator->getResults()->PANeedsToBePrinted(willPABeCalculated());
-    calculator->getResults()->TMNeedsToBePrinted(willTMBeCalculated());
+    result = calculator->getResults();
+    ResultCache::getInstance()->add(mol, geometryIndex, result);
 
-    // Calcul terminé, enregistrement des résultats et passage du booléen
-    // de l'état à true.
-    m_calculationsState[*it] = true;
-    m_results.insert(std::pair<Molecule*, Result*>(*it, calculator->getResults()));
-
-    //delete calculator->getCalculationState();
-    delete calculator;
+    // Le calculateur notifie la fin du calcul a sa destruction.
+    calculator.reset();
   }
-}
+
+  result->EHSSNeedsToBePrinted(willEHSSBeCalculated());
+  result->PANeedsToBePrinted(willPABeCalculated());
+  result->TMNeedsToBePrinted(willTMBeCalculated());
+  result->StructAsymParamNeedsToBePrinted(willAsymmetryParameterBeCalculated());
+
+  // Geometrie terminee, a ne pas recalculer apres une interruption.
+  Checkpoint::getInstance()->saveResult(geometryIndex, mol->getAtomNumber(), result);
+
+  return result;
+}
\ No newline at end of file
@@ -26,6 +26,10 @@
 #include "GeometryCalculator.h"
 
 #include <map>
+#include <memory>
+#include <mutex>
+
+class CalculationState;
 
 class StdGeometryCalculator : public GeometryCalculator
 {
@@ -55,6 +59,12 @@ class StdGeometryCalculator : public GeometryCalculator
      */
     bool willTMBeCalculated() const {return m_TMWillBeCalculated;}
 
+    /**
+     * \return true if the structural asymmetry parameter will be calculated
+     * with TM, false otherwise.
+     */
+    bool willAsymmetryParameterBeCalculated() const {return m_asymmetryParameterWillBeCalculated;}
+
     /**
      * Indicates if calculations are finished for the molecule.
      * \param mol the molecule.
@@ -101,6 +111,13 @@ class StdGeometryCalculator : public GeometryCalculator
      */
     void shouldTMBeCalculated(bool b) {m_TMWillBeCalculated = b;}
 
+    /**
+     * Indicates if yes or no, the structural asymmetry parameter should be
+     * calculated with TM.
+     * \param b true if the structural asymmetry parameter should be calculated, else otherwise.
+     */
+    void shouldAsymmetryParameterBeCalculated(bool b) {m_asymmetryParameterWillBeCalculated = b;}
+
     /**
      * Sets a vector of molecules (geometries) for CCS calculation.
      * \param geometries a vector of geometries.
@@ -117,10 +134,56 @@ class StdGeometryCalculator : public GeometryCalculator
 
     /**
      * Launches all the calculations, on all geometries.
+     * Small geometries are calculated several at a time, each one with
+     * a part of the threads, and their notifications are kept in the order
+     * of the geometries.
      */
     void launchCalculations();
 
+    /**
+     * Runs the calculations on one geometry, which doesn't need to be in
+     * the vector of geometries. The result is not kept by the calculator.
+     * \param mol the geometry.
+     * \param geometryIndex the index of the geometry among all geometries,
+     * the random numbers depend on it.
+     * \return the results for the geometry, to be destroyed by the caller.
+     */
+    Result* calculate(Molecule* mol, unsigned int geometryIndex);
+
+  private:
+    /**
+     * Runs the calculations on one geometry.
+     * \param mol the geometry.
+     * \param geometryIndex the index of the geometry among all geometries.
+     * \param nbThreads the number of threads working on the geometry.
+     * \param observers the observers notified about the calculations.
+     * \param keptState if not null, receives the state of the calculation, which
+     * notifies the observers, to keep it after the calculation. Otherwise, the
+     * state is destroyed at the end of the calculation.
+     * \return the results for the geometry, to be destroyed by the caller.
+     */
+    Result* calculate(Molecule* mol, unsigned int geometryIndex, unsigned int nbThreads,
+                      const std::vector<Observer*>& observers,
+                      std::unique_ptr<CalculationState>* keptState = nullptr);
+
+    /**
+     * Chooses the number of threads working on a geometry, so that each one
+     * has about m_WorkPerThread atom-trajectories to calculate, the
+     * remaining threads calculating other geometries.
+     * \param nbAtoms the number of atoms of the geometry.
+     * \param maxNumberOfThreads the number of threads of all geometries.
+     * \return the number of threads for the geometry, between 1 and maxNumberOfThreads.
+     */
+    unsigned int getNumberThreadsPerGeometry(unsigned int nbAtoms, unsigned int maxNumberOfThreads) const;
+
   private:
+    /**
+     * Number of atom-trajectories of TM method worth a thread. A trajectory
+     * of EHSS or PA counts as m_HardSphereTrajectoryCost of them.
+     */
+    static const unsigned int m_WorkPerThread = 200000;
+    static constexpr double m_HardSphereTrajectoryCost = 0.01;
+
     /**
      * The observers which want to be notified about calculations.
      */
@@ -143,6 +206,12 @@ class StdGeometryCalculator : public GeometryCalculator
      */
     std::map<Molecule*, bool> m_calculationsState;
 
+    /**
+     * Protects the maps of results and states, filled by the geometries
+     * calculated at the same time.
+     */
+    mutable std::mutex m_resultsMutex;
+
     /**
      * A boolean indicating if EHSS should be calculated.
      */
@@ -158,6 +227,11 @@ class StdGeometryCalculator : public GeometryCalculator
      */
     bool m_TMWillBeCalculated;
 
+    /**
+     * A boolean indicating if the structural asymmetry parameter should be calculated.
+     */
+    bool m_asymmetryParameterWillBeCalculated;
+
     /**
      * Values used in calculations.
      */
@@ -3,7 +3,10 @@
 SystemParameters* SystemParameters::m_instance = new SystemParameters();
 
 SystemParameters::SystemParameters()
-  : m_maxNumberThreads(20)
+  : m_maxNumberThreads(20), m_potentialKernel(PotentialKernel::AUTO),
+  m_trajectoryBatchSize(8), m_progressRate(10.0), m_streamQueueSize(4),
+  m_checkpointInterval(0.0), m_resumed(false), m_resultCacheFile(""),
+  m_resultCacheMaxSize(100.0)
 {
 
 }
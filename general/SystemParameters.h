@@ -22,6 +22,9 @@
 #ifndef SYSTEMPARAMETERS_H
 #define SYSTEMPARAMETERS_H
 
+#include "../math/PotentialEngine.h"
+
+#include <string>
 
 class SystemParameters
 {
@@ -54,6 +57,137 @@ class SystemParameters
       m_maxNumberThreads = n;
     }
 
+    /**
+     * Returns the kernel asked to evaluate the potential in TM method.
+     * \return the kernel asked.
+     */
+    PotentialKernel getPotentialKernel() const {
+      return m_potentialKernel;
+    }
+
+    /**
+     * Sets the kernel to evaluate the potential in TM method to k.
+     * \param k the new kernel.
+     */
+    void setPotentialKernel(PotentialKernel k) {
+      m_potentialKernel = k;
+    }
+
+    /**
+     * Returns the number of trajectories integrated together in TM method.
+     * \return the number of trajectories integrated together.
+     */
+    unsigned int getTrajectoryBatchSize() const {
+      return m_trajectoryBatchSize;
+    }
+
+    /**
+     * Sets the number of trajectories integrated together in TM method to n.
+     * 1 integrates the trajectories one after the other, as Mobcal.
+     * \param n the new number of trajectories integrated together.
+     */
+    void setTrajectoryBatchSize(unsigned int n) {
+      m_trajectoryBatchSize = n;
+    }
+
+    /**
+     * Returns the number of notifications of the progression of TM method per second.
+     * \return the number of notifications per second.
+     */
+    double getProgressRate() const {
+      return m_progressRate;
+    }
+
+    /**
+     * Sets the number of notifications of the progression of TM method per second to r.
+     * \param r the new number of notifications per second.
+     */
+    void setProgressRate(double r) {
+      m_progressRate = r;
+    }
+
+    /**
+     * Returns the number of geometries read or calculated in advance when
+     * they are streamed.
+     * \return the number of geometries in advance.
+     */
+    unsigned int getStreamQueueSize() const {
+      return m_streamQueueSize;
+    }
+
+    /**
+     * Sets the number of geometries read or calculated in advance when they
+     * are streamed to n.
+     * \param n the new number of geometries in advance.
+     */
+    void setStreamQueueSize(unsigned int n) {
+      m_streamQueueSize = n;
+    }
+
+    /**
+     * Returns the minimal time between two savings of the progression of the
+     * calculations, in seconds.
+     * \return the time between two savings, 0 if the progression is not saved.
+     */
+    double getCheckpointInterval() const {
+      return m_checkpointInterval;
+    }
+
+    /**
+     * Sets the minimal time between two savings of the progression of the
+     * calculations to t seconds. 0 doesn't save the progression.
+     * \param t the new time between two savings.
+     */
+    void setCheckpointInterval(double t) {
+      m_checkpointInterval = t;
+    }
+
+    /**
+     * \return true if the calculations resume from their saved progression, false otherwise.
+     */
+    bool isResumed() const {
+      return m_resumed;
+    }
+
+    /**
+     * Indicates if the calculations resume from their saved progression.
+     * \param b true to resume the calculations.
+     */
+    void setResumed(bool b) {
+      m_resumed = b;
+    }
+
+    /**
+     * \return the name of the file caching the results of the geometries, empty if there is no cache.
+     */
+    const std::string& getResultCacheFile() const {
+      return m_resultCacheFile;
+    }
+
+    /**
+     * Sets the name of the file caching the results of the geometries. An
+     * empty name doesn't cache the results.
+     * \param filename the new name of the file.
+     */
+    void setResultCacheFile(const std::string& filename) {
+      m_resultCacheFile = filename;
+    }
+
+    /**
+     * \return the maximal size of the cache of the results, in megabytes.
+     */
+    double getResultCacheMaxSize() const {
+      return m_resultCacheMaxSize;
+    }
+
+    /**
+     * Sets the maximal size of the cache of the results to size megabytes.
+     * \param size the new maximal size.
+     */
+    void setResultCacheMaxSize(double size) {
+      m_resultCacheMaxSize = size;
+    }
+
   private:
     /**
      * Constructor.
@@ -72,6 +206,54 @@ class SystemParameters
      * Default value : 20.
      */
     unsigned int m_maxNumberThreads;
+
+    /**
+     * Kernel to evaluate the potential in TM method.
+     * Default value : AUTO.
+     */
+    PotentialKernel m_potentialKernel;
+
+    /**
+     * Number of trajectories integrated together in TM method.
+     * Default value : 8.
+     */
+    unsigned int m_trajectoryBatchSize;
+
+    /**
+     * Number of notifications of the progression of TM method per second.
+     * Default value : 10.
+     */
+    double m_progressRate;
+
+    /**
+     * Number of geometries read or calculated in advance when they are streamed.
+     * Default value : 4.
+     */
+    unsigned int m_streamQueueSize;
+
+    /**
+     * Minimal time between two savings of the progression of the calculations, in seconds.
+     * Default value : 0 (no saving).
+     */
+    double m_checkpointInterval;
+
+    /**
+     * Indicates if the calculations resume from their saved progression.
+     * Default value : false.
+     */
+    bool m_resumed;
+
+    /**
+     * Name of the file caching the results of the geometries.
+     * Default value : "" (no cache).
+     */
+    std::string m_resultCacheFile;
+
+    /**
+     * Maximal size of the cache of the results, in megabytes.
+     * Default value : 100.
+     */
+    double m_resultCacheMaxSize;
 };
 
 #endif
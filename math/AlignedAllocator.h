@@ -0,0 +1,76 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+/**
+ * \file AlignedAllocator.h
+ * \author Anthony Breant, Clement Poinsot, Jeremie Pantin, Mohamed Takhtoukh, Thomas Capet
+ * \version 1.0
+ * \date 17 october 2026
+ * \brief An allocator aligning the arrays of std::vector on cache lines.
+ */
+
+#ifndef ALIGNEDALLOCATOR_H
+#define ALIGNEDALLOCATOR_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+template <typename T, std::size_t Alignment = 64>
+class AlignedAllocator
+{
+  public:
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind
+    {
+      typedef AlignedAllocator<U, Alignment> other;
+    };
+
+    AlignedAllocator() {}
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    /**
+     * \return n uninitialized values, the first on an Alignment boundary.
+     */
+    T* allocate(std::size_t n)
+    {
+      void* p = nullptr;
+      if (n > 0 && posix_memalign(&p, Alignment, n * sizeof(T)) != 0) {
+        throw std::bad_alloc();
+      }
+      return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, std::size_t)
+    {
+      free(p);
+    }
+};
+
+template <typename T, typename U, std::size_t Alignment>
+inline bool operator == (const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&)
+{
+  return true;
+}
+
+template <typename T, typename U, std::size_t Alignment>
+inline bool operator != (const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&)
+{
+  return false;
+}
+
+#endif // ALIGNEDALLOCATOR_H
@@ -50,6 +50,20 @@ class CalculationOperator {
      * Launches the calculation of TM.
      */
     virtual void runTM() = 0;
+
+    /**
+     * Sets the index of the geometry among those calculated. With the seed,
+     * it identifies the random numbers drawn for this geometry.
+     * \param index the index of the geometry.
+     */
+    virtual void setGeometryIndex(unsigned int index) = 0;
+
+    /**
+     * Indicates if yes or no, the structural asymmetry parameter should be
+     * calculated by runTM.
+     * \param b true if the structural asymmetry parameter should be calculated.
+     */
+    virtual void setAsymmetryParameterCalculated(bool b) = 0;
 };
 
 #endif // CALCULATIONOPERATOR_H
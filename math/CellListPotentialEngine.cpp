@@ -0,0 +1,439 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+#include "CellListPotentialEngine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// Comme dans StdPotentialEngine, les versions AVX2 et AVX-512 des boucles
+// ne sont compilees que pour x86 avec GCC/Clang.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define COLLISION_X86_KERNELS
+#endif
+
+/**
+ * The quadrupoles neglected are below (1 / ratio)^2 of the
+ * contribution of the cell.
+ */
+const double CellListPotentialEngine::m_MultipoleOpeningRatio = 4.0;
+
+
+namespace
+{
+  /**
+   * Adds the monopole and the dipole of the 6 terms of the n first cells
+   * to the Lennard-Jones sums. n is a multiple of 8.
+   */
+  __attribute__((always_inline))
+  inline void addMultipoleSums(const double* cx, const double* cy, const double* cz,
+                               const double* c6, const double* c6x, const double* c6y, const double* c6z,
+                               unsigned int n, const Vector3D& p,
+                               double& sumE00, double& sumDex, double& sumDey, double& sumDez)
+  {
+    const double px = p.x;
+    const double py = p.y;
+    const double pz = p.z;
+
+    double e00 = 0.0;
+    double dex = 0.0;
+    double dey = 0.0;
+    double dez = 0.0;
+
+    #pragma omp simd aligned(cx, cy, cz, c6, c6x, c6y, c6z : 64) \
+      reduction(+:e00, dex, dey, dez)
+    for (unsigned int i = 0; i < n; ++i) {
+      const double xx = px - cx[i];
+      const double yy = py - cy[i];
+      const double zz = pz - cz[i];
+      const double r2 = xx * xx + yy * yy + zz * zz;
+
+      const double inv2 = 1.0 / r2;
+      const double inv6 = inv2 * inv2 * inv2;
+      const double inv8 = inv6 * inv2;
+      const double inv10 = inv8 * inv2;
+
+      // -C6 / r^6 developpe au premier ordre autour du centre de la cellule.
+      const double cr = c6x[i] * xx + c6y[i] * yy + c6z[i] * zz;
+      e00 -= c6[i] * inv6 + 6.0 * cr * inv8;
+      const double de00 = 6.0 * c6[i] * inv8 + 48.0 * cr * inv10;
+      dex += de00 * xx - 6.0 * c6x[i] * inv8;
+      dey += de00 * yy - 6.0 * c6y[i] * inv8;
+      dez += de00 * zz - 6.0 * c6z[i] * inv8;
+    }
+
+    sumE00 += e00;
+    sumDex += dex;
+    sumDey += dey;
+    sumDez += dez;
+  }
+
+#ifdef COLLISION_X86_KERNELS
+  // Meme boucle, vectorisee pour AVX2 et AVX-512.
+  __attribute__((target("avx2,fma")))
+  void addMultipoleSumsAVX2(const double* cx, const double* cy, const double* cz,
+                            const double* c6, const double* c6x, const double* c6y, const double* c6z,
+                            unsigned int n, const Vector3D& p,
+                            double& sumE00, double& sumDex, double& sumDey, double& sumDez)
+  {
+    addMultipoleSums(cx, cy, cz, c6, c6x, c6y, c6z, n, p, sumE00, sumDex, sumDey, sumDez);
+  }
+
+  __attribute__((target("avx512f,prefer-vector-width=512")))
+  void addMultipoleSumsAVX512(const double* cx, const double* cy, const double* cz,
+                              const double* c6, const double* c6x, const double* c6y, const double* c6z,
+                              unsigned int n, const Vector3D& p,
+                              double& sumE00, double& sumDex, double& sumDey, double& sumDez)
+  {
+    addMultipoleSums(cx, cy, cz, c6, c6x, c6y, c6z, n, p, sumE00, sumDex, sumDey, sumDez);
+  }
+#endif
+}
+
+
+void CellListPotentialEngine::Atoms::resize(unsigned int n)
+{
+  x.resize(n);
+  y.resize(n);
+  z.resize(n);
+  eox4.resize(n);
+  rolj6.resize(n);
+  rolj12.resize(n);
+  charge.resize(n);
+}
+
+void CellListPotentialEngine::Multipoles::resize(unsigned int n)
+{
+  cx.resize(n);
+  cy.resize(n);
+  cz.resize(n);
+  c6.resize(n);
+  c6x.resize(n);
+  c6y.resize(n);
+  c6z.resize(n);
+}
+
+
+CellListPotentialEngine::CellListPotentialEngine(const std::vector<Vector3D>& pos,
+                                                 const std::vector<double>& eolj,
+                                                 const std::vector<double>& rolj,
+                                                 const std::vector<double>& charges,
+                                                 double maxROLJ,
+                                                 double ionInducedDipolePotential,
+                                                 double cutoff,
+                                                 double cellSize,
+                                                 PotentialKernel kernel)
+  : StdPotentialEngine(pos, eolj, rolj, charges, maxROLJ, ionInducedDipolePotential, kernel),
+  m_cutoff(cutoff), m_cellSize(cellSize)
+{
+  // Il faut voir tous les atomes a moins de 2 * ROLJ maximal pour que
+  // la distance au plus proche atome (dMax) reste exacte.
+  if (m_cutoff < 2.0 * m_maxROLJ) {
+    m_cutoff = 2.0 * m_maxROLJ;
+  }
+
+  m_sorted.resize(m_nbAtoms);
+
+  // Les atomes proches ne portent que Lennard-Jones : leurs charges restent nulles.
+  m_near.resize(m_nbPaddedAtoms);
+
+  // Les atomes charges ne portent que leur charge. Les positions sont
+  // remplies par setPositions.
+  for (unsigned int i = 0; i < m_nbAtoms; ++i) {
+    if (m_charge[i] != 0.0) {
+      m_chargedAtoms.push_back(i);
+    }
+  }
+  m_nbPaddedCharged = ((m_chargedAtoms.size() + m_PaddingAtoms - 1) / m_PaddingAtoms) * m_PaddingAtoms;
+  m_charged.resize(m_nbPaddedCharged);
+  std::fill(m_charged.x.begin(), m_charged.x.end(), m_PaddingPosition);
+  std::fill(m_charged.y.begin(), m_charged.y.end(), m_PaddingPosition);
+  std::fill(m_charged.z.begin(), m_charged.z.end(), m_PaddingPosition);
+  for (unsigned int i = 0; i < m_chargedAtoms.size(); ++i) {
+    m_charged.charge[i] = m_charge[m_chargedAtoms[i]];
+  }
+
+  setPositions(pos);
+}
+
+CellListPotentialEngine::~CellListPotentialEngine()
+{
+
+}
+
+PotentialEngine* CellListPotentialEngine::clone() const
+{
+  return new CellListPotentialEngine(*this);
+}
+
+
+void CellListPotentialEngine::setPositions(const std::vector<Vector3D>& pos)
+{
+  // Les tableaux non tries servent au calcul exact de reference.
+  StdPotentialEngine::setPositions(pos);
+
+  for (unsigned int i = 0; i < m_chargedAtoms.size(); ++i) {
+    m_charged.x[i] = pos[m_chargedAtoms[i]].x;
+    m_charged.y[i] = pos[m_chargedAtoms[i]].y;
+    m_charged.z[i] = pos[m_chargedAtoms[i]].z;
+  }
+
+  m_levels.clear();
+  if (m_nbAtoms == 0) {
+    return;
+  }
+
+  // Boite englobante de la molecule.
+  Vector3D posMin(pos[0]);
+  Vector3D posMax(pos[0]);
+  for (unsigned int i = 1; i < m_nbAtoms; ++i) {
+    posMin.x = std::min(posMin.x, pos[i].x);
+    posMin.y = std::min(posMin.y, pos[i].y);
+    posMin.z = std::min(posMin.z, pos[i].z);
+    posMax.x = std::max(posMax.x, pos[i].x);
+    posMax.y = std::max(posMax.y, pos[i].y);
+    posMax.z = std::max(posMax.z, pos[i].z);
+  }
+
+  // Niveau le plus fin.
+  m_origin = posMin;
+  Level level;
+  level.nx = (int) ((posMax.x - posMin.x) / m_cellSize) + 1;
+  level.ny = (int) ((posMax.y - posMin.y) / m_cellSize) + 1;
+  level.nz = (int) ((posMax.z - posMin.z) / m_cellSize) + 1;
+
+  // Tri des atomes par cellule (tri par denombrement).
+  std::vector<unsigned int> cellOfAtom(m_nbAtoms);
+  m_cellStart.assign(level.nx * level.ny * level.nz + 1, 0);
+  for (unsigned int i = 0; i < m_nbAtoms; ++i) {
+    int ix = std::min((int) ((pos[i].x - m_origin.x) / m_cellSize), level.nx - 1);
+    int iy = std::min((int) ((pos[i].y - m_origin.y) / m_cellSize), level.ny - 1);
+    int iz = std::min((int) ((pos[i].z - m_origin.z) / m_cellSize), level.nz - 1);
+    cellOfAtom[i] = ix + level.nx * (iy + level.ny * iz);
+    m_cellStart[cellOfAtom[i] + 1]++;
+  }
+  for (unsigned int c = 1; c < m_cellStart.size(); ++c) {
+    m_cellStart[c] += m_cellStart[c - 1];
+  }
+
+  std::vector<unsigned int> next(m_cellStart.begin(), m_cellStart.end() - 1);
+  for (unsigned int i = 0; i < m_nbAtoms; ++i) {
+    unsigned int j = next[cellOfAtom[i]]++;
+    m_sorted.x[j] = pos[i].x;
+    m_sorted.y[j] = pos[i].y;
+    m_sorted.z[j] = pos[i].z;
+    m_sorted.eox4[j] = m_eox4[i];
+    m_sorted.rolj6[j] = m_rolj6[i];
+    m_sorted.rolj12[j] = m_rolj12[i];
+  }
+
+  // Multipoles des cellules du niveau le plus fin, par rapport a leur centre.
+  level.cells.resize(level.nx * level.ny * level.nz);
+  for (int iz = 0; iz < level.nz; ++iz) {
+    for (int iy = 0; iy < level.ny; ++iy) {
+      for (int ix = 0; ix < level.nx; ++ix) {
+        unsigned int c = ix + level.nx * (iy + level.ny * iz);
+        Cell& cell = level.cells[c];
+        cell.cx = m_origin.x + (ix + 0.5) * m_cellSize;
+        cell.cy = m_origin.y + (iy + 0.5) * m_cellSize;
+        cell.cz = m_origin.z + (iz + 0.5) * m_cellSize;
+        cell.c6 = cell.c6x = cell.c6y = cell.c6z = 0.0;
+        cell.nbAtoms = m_cellStart[c + 1] - m_cellStart[c];
+
+        for (unsigned int j = m_cellStart[c]; j < m_cellStart[c + 1]; ++j) {
+          double c6 = m_sorted.eox4[j] * m_sorted.rolj6[j];
+          cell.c6 += c6;
+          cell.c6x += c6 * (m_sorted.x[j] - cell.cx);
+          cell.c6y += c6 * (m_sorted.y[j] - cell.cy);
+          cell.c6z += c6 * (m_sorted.z[j] - cell.cz);
+        }
+      }
+    }
+  }
+  m_levels.push_back(level);
+
+  // Niveaux suivants : les cellules sont regroupees par 2 x 2 x 2, les
+  // multipoles des cellules filles etant deplaces au centre de la cellule mere.
+  double size = m_cellSize;
+  unsigned int nbCells = level.cells.size();
+  while (m_levels.back().nx > 1 || m_levels.back().ny > 1 || m_levels.back().nz > 1) {
+    const Level& fine = m_levels.back();
+    Level coarse;
+    size *= 2.0;
+    coarse.nx = (fine.nx + 1) / 2;
+    coarse.ny = (fine.ny + 1) / 2;
+    coarse.nz = (fine.nz + 1) / 2;
+    coarse.cells.resize(coarse.nx * coarse.ny * coarse.nz);
+    nbCells += coarse.cells.size();
+
+    for (int iz = 0; iz < coarse.nz; ++iz) {
+      for (int iy = 0; iy < coarse.ny; ++iy) {
+        for (int ix = 0; ix < coarse.nx; ++ix) {
+          Cell& cell = coarse.cells[ix + coarse.nx * (iy + coarse.ny * iz)];
+          cell.cx = m_origin.x + (ix + 0.5) * size;
+          cell.cy = m_origin.y + (iy + 0.5) * size;
+          cell.cz = m_origin.z + (iz + 0.5) * size;
+          cell.c6 = cell.c6x = cell.c6y = cell.c6z = 0.0;
+          cell.nbAtoms = 0;
+
+          for (int jz = 2 * iz; jz < std::min(2 * iz + 2, fine.nz); ++jz) {
+            for (int jy = 2 * iy; jy < std::min(2 * iy + 2, fine.ny); ++jy) {
+              for (int jx = 2 * ix; jx < std::min(2 * ix + 2, fine.nx); ++jx) {
+                const Cell& child = fine.cells[jx + fine.nx * (jy + fine.ny * jz)];
+                cell.nbAtoms += child.nbAtoms;
+                cell.c6 += child.c6;
+                cell.c6x += child.c6x + child.c6 * (child.cx - cell.cx);
+                cell.c6y += child.c6y + child.c6 * (child.cy - cell.cy);
+                cell.c6z += child.c6z + child.c6 * (child.cz - cell.cz);
+              }
+            }
+          }
+        }
+      }
+    }
+    m_levels.push_back(coarse);
+  }
+
+  // Une cellule est remplacee par ses multipoles quand tous ses atomes sont
+  // au-dela de la distance de coupure et qu'elle est assez petite vue de l'Helium.
+  size = m_cellSize;
+  for (unsigned int k = 0; k < m_levels.size(); ++k) {
+    const double halfDiagonal = 0.5 * sqrt(3.0) * size;
+    const double distance = std::max(m_cutoff + halfDiagonal, m_MultipoleOpeningRatio * halfDiagonal);
+    m_levels[k].multipoleDistance2 = distance * distance;
+    size *= 2.0;
+  }
+
+  m_far.resize(((nbCells + m_PaddingAtoms - 1) / m_PaddingAtoms) * m_PaddingAtoms);
+}
+
+double CellListPotentialEngine::calculateMoleculePotential(const Vector3D& p, Vector3D& dPot, double& dMax)
+{
+  Sums s;
+
+  // Parcours de l'arbre depuis le niveau le plus grossier : les atomes des
+  // cellules proches sont copies dans m_near, les multipoles des cellules
+  // lointaines dans m_far, pour etre sommes ensuite en une seule boucle.
+  // Les ions induits sont sommes a part, sur les atomes charges.
+  unsigned int nbNear = 0;
+  unsigned int nbFar = 0;
+
+  m_stack.clear();
+  if (!m_levels.empty()) {
+    m_stack.push_back(std::make_pair((int) m_levels.size() - 1, 0u));
+  }
+
+  while (!m_stack.empty()) {
+    const int k = m_stack.back().first;
+    const unsigned int c = m_stack.back().second;
+    m_stack.pop_back();
+
+    const Level& level = m_levels[k];
+    const Cell& cell = level.cells[c];
+    if (cell.nbAtoms == 0) {
+      continue;
+    }
+
+    const double xx = p.x - cell.cx;
+    const double yy = p.y - cell.cy;
+    const double zz = p.z - cell.cz;
+
+    if (xx * xx + yy * yy + zz * zz >= level.multipoleDistance2) {
+      m_far.cx[nbFar] = cell.cx;
+      m_far.cy[nbFar] = cell.cy;
+      m_far.cz[nbFar] = cell.cz;
+      m_far.c6[nbFar] = cell.c6;
+      m_far.c6x[nbFar] = cell.c6x;
+      m_far.c6y[nbFar] = cell.c6y;
+      m_far.c6z[nbFar] = cell.c6z;
+      nbFar++;
+    } else if (k == 0) {
+      for (unsigned int j = m_cellStart[c]; j < m_cellStart[c + 1]; ++j) {
+        m_near.x[nbNear] = m_sorted.x[j];
+        m_near.y[nbNear] = m_sorted.y[j];
+        m_near.z[nbNear] = m_sorted.z[j];
+        m_near.eox4[nbNear] = m_sorted.eox4[j];
+        m_near.rolj6[nbNear] = m_sorted.rolj6[j];
+        m_near.rolj12[nbNear] = m_sorted.rolj12[j];
+        nbNear++;
+      }
+    } else {
+      // Cellule trop proche : on descend dans les cellules filles.
+      const Level& fine = m_levels[k - 1];
+      const int ix = c % level.nx;
+      const int iy = (c / level.nx) % level.ny;
+      const int iz = c / (level.nx * level.ny);
+      for (int jz = 2 * iz; jz < std::min(2 * iz + 2, fine.nz); ++jz) {
+        for (int jy = 2 * iy; jy < std::min(2 * iy + 2, fine.ny); ++jy) {
+          for (int jx = 2 * ix; jx < std::min(2 * ix + 2, fine.nx); ++jx) {
+            m_stack.push_back(std::make_pair(k - 1, (unsigned int) (jx + fine.nx * (jy + fine.ny * jz))));
+          }
+        }
+      }
+    }
+  }
+
+  // Les boucles vectorielles traitent des groupes de 8 : on complete avec
+  // des atomes et des cellules loin et sans coefficients.
+  for (; nbNear % m_PaddingAtoms != 0; ++nbNear) {
+    m_near.x[nbNear] = m_near.y[nbNear] = m_near.z[nbNear] = m_PaddingPosition;
+    m_near.eox4[nbNear] = m_near.rolj6[nbNear] = m_near.rolj12[nbNear] = 0.0;
+  }
+  for (; nbFar % m_PaddingAtoms != 0; ++nbFar) {
+    m_far.cx[nbFar] = m_far.cy[nbFar] = m_far.cz[nbFar] = m_PaddingPosition;
+    m_far.c6[nbFar] = m_far.c6x[nbFar] = m_far.c6y[nbFar] = m_far.c6z[nbFar] = 0.0;
+  }
+
+  // Lennard-Jones des atomes proches, puis ions induits des atomes charges,
+  // avec le noyau de StdPotentialEngine.
+  addSums(m_near.x.data(), m_near.y.data(), m_near.z.data(),
+          m_near.eox4.data(), m_near.rolj6.data(), m_near.rolj12.data(),
+          m_near.charge.data(), nbNear, p, s);
+  addSums(m_charged.x.data(), m_charged.y.data(), m_charged.z.data(),
+          m_charged.eox4.data(), m_charged.rolj6.data(), m_charged.rolj12.data(),
+          m_charged.charge.data(), m_nbPaddedCharged, p, s);
+
+  switch (m_kernel) {
+#ifdef COLLISION_X86_KERNELS
+  case PotentialKernel::AVX2:
+    addMultipoleSumsAVX2(m_far.cx.data(), m_far.cy.data(), m_far.cz.data(),
+                         m_far.c6.data(), m_far.c6x.data(), m_far.c6y.data(), m_far.c6z.data(),
+                         nbFar, p, s.e00, s.dex, s.dey, s.dez);
+    break;
+  case PotentialKernel::AVX512:
+    addMultipoleSumsAVX512(m_far.cx.data(), m_far.cy.data(), m_far.cz.data(),
+                           m_far.c6.data(), m_far.c6x.data(), m_far.c6y.data(), m_far.c6z.data(),
+                           nbFar, p, s.e00, s.dex, s.dey, s.dez);
+    break;
+#endif
+  default:
+    addMultipoleSums(m_far.cx.data(), m_far.cy.data(), m_far.cz.data(),
+                     m_far.c6.data(), m_far.c6x.data(), m_far.c6y.data(), m_far.c6z.data(),
+                     nbFar, p, s.e00, s.dex, s.dey, s.dez);
+    break;
+  }
+
+  dMax = boundDistance(s.r2Min, m_maxROLJ);
+
+  return combineSums(m_ionInducedDipolePotential, s, dPot);
+}
+
+void CellListPotentialEngine::calculateMoleculePotentials(unsigned int n, const Vector3D* q,
+                                                          double* pot, Vector3D* dPot, double* dMax)
+{
+  for (unsigned int l = 0; l < n; ++l) {
+    pot[l] = calculateMoleculePotential(q[l], dPot[l], dMax[l]);
+  }
+}
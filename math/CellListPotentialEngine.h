@@ -0,0 +1,237 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+/**
+ * \file CellListPotentialEngine.h
+ * \author Anthony Breant, Clement Poinsot, Jeremie Pantin, Mohamed Takhtoukh, Thomas Capet
+ * \version 1.0
+ * \date 17 october 2026
+ * \brief Evaluates the potential with a cell list, for large ions.
+ */
+
+#ifndef CELLLISTPOTENTIALENGINE_H
+#define CELLLISTPOTENTIALENGINE_H
+
+#include "StdPotentialEngine.h"
+
+#include "Vector3D.h"
+
+#include <vector>
+
+
+/**
+ * The atoms are sorted in a uniform grid of cubic cells, rebuilt each time
+ * the positions change, but not when the molecule is rotated : the cells stay
+ * in the frame of the molecule. The cells are grouped 2 x 2 x 2 into coarser cells,
+ * level after level.
+ *
+ * Lennard-Jones is summed exactly over the atoms of the cells closer to the
+ * Helium than the cutoff. Beyond, the 12 term is neglected and the 6 terms
+ * of each cell are replaced by their monopole and dipole, the coarsest cells
+ * being used as far as they are small enough seen from the Helium.
+ *
+ * The ion-induced dipole, long-range, is summed exactly over the charged atoms
+ * only, kept in separate arrays.
+ *
+ * The distance to the closest atom stays exact since the cutoff is at least
+ * 2 * maxROLJ.
+ */
+class CellListPotentialEngine : public StdPotentialEngine
+{
+  public:
+    /**
+     * Constructor.
+     * \param pos the positions of the atoms, in meters.
+     * \param eolj the EOLJ of each atom, in joules.
+     * \param rolj the ROLJ of each atom, in meters.
+     * \param charges the charge of each atom.
+     * \param maxROLJ the greatest value of rolj.
+     * \param ionInducedDipolePotential the constant of the ion-induced dipole potential.
+     * \param cutoff the distance under which Lennard-Jones is summed exactly, in meters.
+     * Raised to 2 * maxROLJ if smaller.
+     * \param cellSize the length of the side of a cell, in meters.
+     * \param kernel the kernel of the exact reference.
+     */
+    CellListPotentialEngine(const std::vector<Vector3D>& pos,
+                            const std::vector<double>& eolj,
+                            const std::vector<double>& rolj,
+                            const std::vector<double>& charges,
+                            double maxROLJ,
+                            double ionInducedDipolePotential,
+                            double cutoff,
+                            double cellSize,
+                            PotentialKernel kernel = PotentialKernel::AUTO);
+
+    /**
+     * Destructor.
+     */
+    virtual ~CellListPotentialEngine();
+
+    PotentialEngine* clone() const;
+
+    bool isApproximated() const {
+      return true;
+    }
+
+    void setPositions(const std::vector<Vector3D>& pos);
+
+    /**
+     * \return the cutoff, in meters.
+     */
+    double getCutoff() const {
+      return m_cutoff;
+    }
+
+    /**
+     * \return the length of the side of a cell, in meters.
+     */
+    double getCellSize() const {
+      return m_cellSize;
+    }
+
+  protected:
+    double calculateMoleculePotential(const Vector3D& q, Vector3D& dPot, double& dMax);
+
+    /**
+     * The atoms read differ from one position to another : the positions are
+     * calculated one after the other.
+     */
+    void calculateMoleculePotentials(unsigned int n, const Vector3D* q,
+                                     double* pot, Vector3D* dPot, double* dMax);
+
+  protected:
+    /**
+     * Multipoles of the 6 terms of a cell, relatively to its center.
+     */
+    struct Cell {
+      /// Center of the cell.
+      double cx;
+      double cy;
+      double cz;
+      /// Sum of the 6 terms (4 * EOLJ * ROLJ^6).
+      double c6;
+      /// Dipole of the 6 terms.
+      double c6x;
+      double c6y;
+      double c6z;
+      /// Number of atoms in the cell.
+      unsigned int nbAtoms;
+    };
+
+    /**
+     * A level of the grid : the cells are twice bigger at each level.
+     */
+    struct Level {
+      int nx;
+      int ny;
+      int nz;
+      /// Squared distance to the center from which a cell is replaced by its multipoles.
+      double multipoleDistance2;
+      std::vector<Cell> cells;
+    };
+
+    /**
+     * Atoms, one array per coefficient.
+     */
+    struct Atoms {
+      AlignedVector x;
+      AlignedVector y;
+      AlignedVector z;
+      AlignedVector eox4;
+      AlignedVector rolj6;
+      AlignedVector rolj12;
+      AlignedVector charge;
+
+      void resize(unsigned int n);
+    };
+
+    /**
+     * Multipoles of cells, one array per coefficient.
+     */
+    struct Multipoles {
+      AlignedVector cx;
+      AlignedVector cy;
+      AlignedVector cz;
+      AlignedVector c6;
+      AlignedVector c6x;
+      AlignedVector c6y;
+      AlignedVector c6z;
+
+      void resize(unsigned int n);
+    };
+
+  protected:
+    /**
+     * Ratio between the distance to a cell and its half diagonal
+     * from which the multipoles of the cell are used.
+     */
+    static const double m_MultipoleOpeningRatio;
+
+    /**
+     * Distance under which the atoms are summed exactly.
+     */
+    double m_cutoff;
+
+    /**
+     * Length of the side of a cell.
+     */
+    double m_cellSize;
+
+    /**
+     * Corner of the grid.
+     */
+    Vector3D m_origin;
+
+    /**
+     * First atom of each cell of the finest level in m_sorted.
+     * The last value is the number of atoms.
+     */
+    std::vector<unsigned int> m_cellStart;
+
+    /**
+     * Levels of the grid, from the finest to the coarsest.
+     */
+    std::vector<Level> m_levels;
+
+    /**
+     * Atoms sorted by cell, the cells being sorted along x first.
+     */
+    Atoms m_sorted;
+
+    /**
+     * Index of the charged atoms in the molecule.
+     */
+    std::vector<unsigned int> m_chargedAtoms;
+
+    /**
+     * Charged atoms with null Lennard-Jones coefficients, padded
+     * like the arrays of StdPotentialEngine.
+     */
+    Atoms m_charged;
+    unsigned int m_nbPaddedCharged;
+
+    /**
+     * Buffers of a calculation, kept to avoid allocations : the atoms close
+     * to the Helium, copied contiguously, and the cells replaced by their
+     * multipoles.
+     */
+    Atoms m_near;
+    Multipoles m_far;
+
+    /**
+     * Cells to visit, as (level, index).
+     */
+    std::vector<std::pair<int, unsigned int> > m_stack;
+};
+
+#endif // CELLLISTPOTENTIALENGINE_H
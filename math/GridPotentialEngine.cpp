@@ -0,0 +1,315 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+#include "GridPotentialEngine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+/**
+ * About 1.2 GB of nodes.
+ */
+const unsigned int GridPotentialEngine::m_MaxNumberNodes = 1 << 25;
+
+
+namespace
+{
+  /**
+   * Derivate along an axis of a value of the nodes, in index units,
+   * by central differences (one-sided on the borders of the grid).
+   * \param nodes the nodes of the grid.
+   * \param index the index of the node.
+   * \param stride the distance between two neighbour nodes on the axis.
+   * \param i the position of the node on the axis.
+   * \param n the number of nodes on the axis.
+   * \param value the value to derivate.
+   */
+  template <typename Node>
+  double difference(const std::vector<Node>& nodes, unsigned int index, unsigned int stride,
+                    int i, int n, float Node::* value)
+  {
+    if (i == 0) {
+      return nodes[index + stride].*value - nodes[index].*value;
+    }
+    if (i == n - 1) {
+      return nodes[index].*value - nodes[index - stride].*value;
+    }
+    return 0.5 * (nodes[index + stride].*value - nodes[index - stride].*value);
+  }
+
+  /**
+   * Cubic Hermite functions on [0, 1] and their derivates :
+   * a0, a1 weight the values at 0 and 1, b0, b1 the derivates.
+   */
+  struct Hermite {
+    double a[2];
+    double b[2];
+    double da[2];
+    double db[2];
+
+    explicit Hermite(double t)
+    {
+      const double t2 = t * t;
+      a[0] = (2.0 * t - 3.0) * t2 + 1.0;
+      a[1] = 1.0 - a[0];
+      b[0] = ((t - 2.0) * t + 1.0) * t;
+      b[1] = (t - 1.0) * t2;
+      da[0] = 6.0 * t * (t - 1.0);
+      da[1] = -da[0];
+      db[0] = (3.0 * t - 4.0) * t + 1.0;
+      db[1] = (3.0 * t - 2.0) * t;
+    }
+  };
+}
+
+
+GridPotentialEngine::GridPotentialEngine(const std::vector<Vector3D>& pos,
+                                         const std::vector<double>& eolj,
+                                         const std::vector<double>& rolj,
+                                         const std::vector<double>& charges,
+                                         double maxROLJ,
+                                         double ionInducedDipolePotential,
+                                         double spacing,
+                                         double extent,
+                                         double maxPotential,
+                                         PotentialKernel kernel)
+  : StdPotentialEngine(pos, eolj, rolj, charges, maxROLJ, ionInducedDipolePotential, kernel),
+  m_spacing(spacing), m_extent(extent), m_maxPotential(maxPotential)
+{
+  buildGrid();
+}
+
+GridPotentialEngine::~GridPotentialEngine()
+{
+
+}
+
+PotentialEngine* GridPotentialEngine::clone() const
+{
+  return new GridPotentialEngine(*this);
+}
+
+void GridPotentialEngine::setPositions(const std::vector<Vector3D>& pos)
+{
+  StdPotentialEngine::setPositions(pos);
+  buildGrid();
+}
+
+void GridPotentialEngine::buildGrid()
+{
+  std::shared_ptr<Grid> grid = std::make_shared<Grid>();
+
+  // Boite englobant les atomes et la marge.
+  Vector3D minPos(0.0, 0.0, 0.0);
+  Vector3D maxPos(0.0, 0.0, 0.0);
+  for (unsigned int i = 0; i < m_nbAtoms; ++i) {
+    const Vector3D p(m_x[i], m_y[i], m_z[i]);
+    if (i == 0) {
+      minPos = p;
+      maxPos = p;
+    }
+    minPos = Vector3D(std::min(minPos.x, p.x), std::min(minPos.y, p.y), std::min(minPos.z, p.z));
+    maxPos = Vector3D(std::max(maxPos.x, p.x), std::max(maxPos.y, p.y), std::max(maxPos.z, p.z));
+  }
+
+  const double h = m_spacing;
+  grid->spacing = h;
+  grid->origin = Vector3D(minPos.x - m_extent, minPos.y - m_extent, minPos.z - m_extent);
+  grid->nx = (int) ceil((maxPos.x - minPos.x + 2.0 * m_extent) / h) + 1;
+  grid->ny = (int) ceil((maxPos.y - minPos.y + 2.0 * m_extent) / h) + 1;
+  grid->nz = (int) ceil((maxPos.z - minPos.z + 2.0 * m_extent) / h) + 1;
+
+  const int nx = grid->nx;
+  const int ny = grid->ny;
+  const int nz = grid->nz;
+  if ((double) nx * ny * nz > m_MaxNumberNodes) {
+    throw std::string("The grid of the potential is too large, increase its spacing or reduce its extent.");
+  }
+  std::vector<Node>& nodes = grid->nodes;
+  nodes.resize(nx * ny * nz);
+
+  const unsigned int strideY = nx;
+  const unsigned int strideZ = nx * ny;
+
+  // Potentiel et gradient exacts aux noeuds. Au-dela de maxPotential,
+  // zone que l'Helium n'atteint pas, le potentiel est plafonne.
+  #pragma omp parallel for schedule(dynamic)
+  for (int k = 0; k < nz; ++k) {
+    for (int j = 0; j < ny; ++j) {
+      // Les noeuds d'une ligne sont calcules par paquets avec le noyau de StdPotentialEngine.
+      for (int i = 0; i < nx; i += m_BatchSize) {
+        const unsigned int nbNodes = std::min((unsigned int) (nx - i), m_BatchSize);
+        Vector3D p[m_BatchSize];
+        Vector3D dPot[m_BatchSize];
+        double pot[m_BatchSize];
+        double dMax[m_BatchSize];
+        for (unsigned int l = 0; l < nbNodes; ++l) {
+          p[l] = Vector3D(grid->origin.x + (i + l) * h, grid->origin.y + j * h, grid->origin.z + k * h);
+        }
+        StdPotentialEngine::calculateMoleculePotentials(nbNodes, p, pot, dPot, dMax);
+
+        for (unsigned int l = 0; l < nbNodes; ++l) {
+          Node& node = nodes[k * strideZ + j * strideY + i + l];
+          if (pot[l] < m_maxPotential) {
+            node.pot = pot[l];
+            node.dx = dPot[l].x * h;
+            node.dy = dPot[l].y * h;
+            node.dz = dPot[l].z * h;
+          } else {
+            node.pot = m_maxPotential;
+            node.dx = 0.0;
+            node.dy = 0.0;
+            node.dz = 0.0;
+          }
+          node.dMax = dMax[l];
+        }
+      }
+    }
+  }
+
+  // Derivees croisees par differences des gradients, symetrisees.
+  #pragma omp parallel for
+  for (int k = 0; k < nz; ++k) {
+    for (int j = 0; j < ny; ++j) {
+      for (int i = 0; i < nx; ++i) {
+        unsigned int index = k * strideZ + j * strideY + i;
+        Node& node = nodes[index];
+        node.dxy = 0.5 * (difference(nodes, index, strideY, j, ny, &Node::dx)
+                          + difference(nodes, index, 1, i, nx, &Node::dy));
+        node.dxz = 0.5 * (difference(nodes, index, strideZ, k, nz, &Node::dx)
+                          + difference(nodes, index, 1, i, nx, &Node::dz));
+        node.dyz = 0.5 * (difference(nodes, index, strideZ, k, nz, &Node::dy)
+                          + difference(nodes, index, strideY, j, ny, &Node::dz));
+      }
+    }
+  }
+
+  #pragma omp parallel for
+  for (int k = 0; k < nz; ++k) {
+    for (int j = 0; j < ny; ++j) {
+      for (int i = 0; i < nx; ++i) {
+        unsigned int index = k * strideZ + j * strideY + i;
+        nodes[index].dxyz = (difference(nodes, index, strideZ, k, nz, &Node::dxy)
+                             + difference(nodes, index, strideY, j, ny, &Node::dxz)
+                             + difference(nodes, index, 1, i, nx, &Node::dyz)) / 3.0;
+      }
+    }
+  }
+
+  m_grid = grid;
+}
+
+bool GridPotentialEngine::interpolatePotential(const Vector3D& q, Vector3D& dPot, double& dMax, double& pot) const
+{
+  const Grid& grid = *m_grid;
+  const double invH = 1.0 / grid.spacing;
+
+  // Position en unites de la grille. Les comparaisons ecartent aussi les NaN.
+  const double u = (q.x - grid.origin.x) * invH;
+  const double v = (q.y - grid.origin.y) * invH;
+  const double w = (q.z - grid.origin.z) * invH;
+  if (!(u >= 0.0 && u < grid.nx - 1 && v >= 0.0 && v < grid.ny - 1 && w >= 0.0 && w < grid.nz - 1)) {
+    return false;
+  }
+
+  const int i = (int) u;
+  const int j = (int) v;
+  const int k = (int) w;
+  const Hermite hx(u - i);
+  const Hermite hy(v - j);
+  const Hermite hz(w - k);
+
+  const unsigned int strideY = grid.nx;
+  const unsigned int strideZ = grid.nx * grid.ny;
+  const Node* cell = &grid.nodes[k * strideZ + j * strideY + i];
+
+  // Poids de l'interpolation trilineaire de la distance.
+  const double lx[2] = {1.0 - (u - i), u - i};
+  const double ly[2] = {1.0 - (v - j), v - j};
+  const double lz[2] = {1.0 - (w - k), w - k};
+
+  double e = 0.0;
+  double du = 0.0;
+  double dv = 0.0;
+  double dw = 0.0;
+  double d = 0.0;
+
+  // Somme sur les 8 coins de la cellule, factorisee axe par axe.
+  for (int cz = 0; cz < 2; ++cz) {
+    for (int cy = 0; cy < 2; ++cy) {
+      const Node* row = cell + cz * strideZ + cy * strideY;
+
+      // Facteurs en x, pour les termes en 1, y, z et yz.
+      double p0 = 0.0;
+      double p1 = 0.0;
+      double p2 = 0.0;
+      double p3 = 0.0;
+      double q0 = 0.0;
+      double q1 = 0.0;
+      double q2 = 0.0;
+      double q3 = 0.0;
+      double dx = 0.0;
+      for (int cx = 0; cx < 2; ++cx) {
+        const Node& n = row[cx];
+        p0 += hx.a[cx] * n.pot + hx.b[cx] * n.dx;
+        p1 += hx.a[cx] * n.dy + hx.b[cx] * n.dxy;
+        p2 += hx.a[cx] * n.dz + hx.b[cx] * n.dxz;
+        p3 += hx.a[cx] * n.dyz + hx.b[cx] * n.dxyz;
+        q0 += hx.da[cx] * n.pot + hx.db[cx] * n.dx;
+        q1 += hx.da[cx] * n.dy + hx.db[cx] * n.dxy;
+        q2 += hx.da[cx] * n.dz + hx.db[cx] * n.dxz;
+        q3 += hx.da[cx] * n.dyz + hx.db[cx] * n.dxyz;
+        dx += lx[cx] * n.dMax;
+      }
+
+      const double ay = hy.a[cy];
+      const double by = hy.b[cy];
+      const double az = hz.a[cz];
+      const double bz = hz.b[cz];
+      const double pz0 = ay * p0 + by * p1;
+      const double pz1 = ay * p2 + by * p3;
+
+      e += az * pz0 + bz * pz1;
+      du += az * (ay * q0 + by * q1) + bz * (ay * q2 + by * q3);
+      dv += az * (hy.da[cy] * p0 + hy.db[cy] * p1) + bz * (hy.da[cy] * p2 + hy.db[cy] * p3);
+      dw += hz.da[cz] * pz0 + hz.db[cz] * pz1;
+      d += lz[cz] * ly[cy] * dx;
+    }
+  }
+
+  pot = e;
+  dPot = Vector3D(du * invH, dv * invH, dw * invH);
+  dMax = d;
+
+  return true;
+}
+
+double GridPotentialEngine::calculateMoleculePotential(const Vector3D& q, Vector3D& dPot, double& dMax)
+{
+  double pot;
+  if (!interpolatePotential(q, dPot, dMax, pot)) {
+    // Hors de la grille, somme exacte.
+    pot = StdPotentialEngine::calculateMoleculePotential(q, dPot, dMax);
+  }
+  return pot;
+}
+
+void GridPotentialEngine::calculateMoleculePotentials(unsigned int n, const Vector3D* q,
+                                                      double* pot, Vector3D* dPot, double* dMax)
+{
+  for (unsigned int l = 0; l < n; ++l) {
+    pot[l] = calculateMoleculePotential(q[l], dPot[l], dMax[l]);
+  }
+}
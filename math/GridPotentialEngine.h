@@ -0,0 +1,188 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+/**
+ * \file GridPotentialEngine.h
+ * \author Anthony Breant, Clement Poinsot, Jeremie Pantin, Mohamed Takhtoukh, Thomas Capet
+ * \version 1.0
+ * \date 17 october 2026
+ * \brief Interpolates the potential on a grid precomputed around the molecule.
+ */
+
+#ifndef GRIDPOTENTIALENGINE_H
+#define GRIDPOTENTIALENGINE_H
+
+#include "StdPotentialEngine.h"
+
+#include "Vector3D.h"
+
+#include <memory>
+#include <vector>
+
+
+/**
+ * The potential and its gradient are computed exactly once, on the nodes of
+ * a regular grid covering the molecule and a margin around it. Between the
+ * nodes, the potential is interpolated by tricubic Hermite polynomials, the
+ * gradient being the derivate of the interpolation. Outside the grid, the
+ * potential is summed exactly over the atoms.
+ *
+ * The grid is shared by the clones of the engine.
+ */
+class GridPotentialEngine : public StdPotentialEngine
+{
+  public:
+    /**
+     * Constructor.
+     * \param pos the positions of the atoms, in meters.
+     * \param eolj the EOLJ of each atom, in joules.
+     * \param rolj the ROLJ of each atom, in meters.
+     * \param charges the charge of each atom.
+     * \param maxROLJ the greatest value of rolj.
+     * \param ionInducedDipolePotential the constant of the ion-induced dipole potential.
+     * \param spacing the distance between two nodes of the grid, in meters.
+     * \param extent the margin of the grid around the atoms, in meters.
+     * \param maxPotential the potential stored at the nodes where it is greater,
+     * in joules. Must be far above the energies of the collisions.
+     * \param kernel the kernel used to compute the nodes and outside the grid.
+     */
+    GridPotentialEngine(const std::vector<Vector3D>& pos,
+                        const std::vector<double>& eolj,
+                        const std::vector<double>& rolj,
+                        const std::vector<double>& charges,
+                        double maxROLJ,
+                        double ionInducedDipolePotential,
+                        double spacing,
+                        double extent,
+                        double maxPotential,
+                        PotentialKernel kernel = PotentialKernel::AUTO);
+
+    /**
+     * Destructor.
+     */
+    virtual ~GridPotentialEngine();
+
+    PotentialEngine* clone() const;
+
+    bool isApproximated() const {
+      return true;
+    }
+
+    /**
+     * The positions become the frame of the molecule : the grid is computed
+     * again. A rotation of the molecule keeps the grid.
+     */
+    void setPositions(const std::vector<Vector3D>& pos);
+
+    /**
+     * \return the distance between two nodes of the grid, in meters.
+     */
+    double getSpacing() const {
+      return m_spacing;
+    }
+
+    /**
+     * \return the margin of the grid around the atoms, in meters.
+     */
+    double getExtent() const {
+      return m_extent;
+    }
+
+    /**
+     * \return the number of nodes of the grid.
+     */
+    unsigned int getNumberNodes() const {
+      return m_grid->nodes.size();
+    }
+
+  protected:
+    double calculateMoleculePotential(const Vector3D& q, Vector3D& dPot, double& dMax);
+
+    /**
+     * The positions are interpolated one after the other.
+     */
+    void calculateMoleculePotentials(unsigned int n, const Vector3D* q,
+                                     double* pot, Vector3D* dPot, double* dMax);
+
+    /**
+     * Values at a node. The derivates are multiplied by the spacing
+     * to the power of their order, so that they are all in joules.
+     */
+    struct Node {
+      float pot;
+      float dx;
+      float dy;
+      float dz;
+      float dxy;
+      float dxz;
+      float dyz;
+      float dxyz;
+      /// Distance to the closest atom, bounded by 2 * maxROLJ.
+      float dMax;
+    };
+
+    /**
+     * Nodes of the grid, sorted along x first.
+     */
+    struct Grid {
+      Vector3D origin;
+      double spacing;
+      int nx;
+      int ny;
+      int nz;
+      std::vector<Node> nodes;
+    };
+
+    /**
+     * Computes the grid around the atoms, in the frame of the molecule.
+     */
+    void buildGrid();
+
+    /**
+     * Interpolates the potential in the frame of the molecule.
+     * \param q the position of the Helium in the frame of the molecule.
+     * \param dPot the derivates of the potential in the frame of the molecule.
+     * \param dMax the distance to the closest atom, bounded by 2 * maximal ROLJ.
+     * \param pot the potential.
+     * \return false if q is outside the grid, in which case nothing is set.
+     */
+    bool interpolatePotential(const Vector3D& q, Vector3D& dPot, double& dMax, double& pot) const;
+
+  protected:
+    /**
+     * Greatest number of nodes, to bound the memory used (36 bytes per node).
+     */
+    static const unsigned int m_MaxNumberNodes;
+
+    /**
+     * Distance between two nodes.
+     */
+    double m_spacing;
+
+    /**
+     * Margin of the grid around the atoms.
+     */
+    double m_extent;
+
+    /**
+     * Potential stored at the nodes where it is greater.
+     */
+    double m_maxPotential;
+
+    /**
+     * The grid, shared by the clones.
+     */
+    std::shared_ptr<const Grid> m_grid;
+};
+
+#endif // GRIDPOTENTIALENGINE_H
@@ -25,6 +25,8 @@
 #include <cstdlib>
 
 #include "Vector3D.h"
+#include "RotationMatrix.h"
+#include "RandomStream.h"
 #include "../molecule/Atom.h"
 #include "../molecule/Molecule.h"
 
@@ -59,14 +61,51 @@ class MathLib
     /**
      * Rotates the molecule by random angles on each axis.
      * \param mol the molecule to rotate.
+     * \param stream the random numbers to use.
      */
-    virtual void randomRotation(Molecule* mol) = 0;
+    virtual void randomRotation(Molecule* mol, RandomStream& stream) = 0;
 
     /**
      * Rotates the positions by random angles on each axis.
      * \param pos the positions to rotate.
+     * \param stream the random numbers to use.
      */
-    virtual void randomRotation(const std::vector<Vector3D>& initPos, std::vector<Vector3D>& pos) = 0;
+    virtual void randomRotation(const std::vector<Vector3D>& initPos, std::vector<Vector3D>& pos, RandomStream& stream) = 0;
+
+    /**
+     * Builds the rotation applied by rotate with angles, so that it can be
+     * applied to many positions without trigonometry.
+     * \param angleX the angle of rotation one the X axis.
+     * \param angleY the angle of rotation one the Y axis.
+     * \param angleZ the angle of rotation one the Z axis.
+     * \return the rotation.
+     */
+    virtual RotationMatrix calculateRotationMatrix(double angleX, double angleY, double angleZ) = 0;
+
+    /**
+     * Draws a rotation uniformly distributed over all the rotations.
+     * \param stream the random numbers to use.
+     * \return the rotation.
+     */
+    virtual RotationMatrix randomRotationMatrix(RandomStream& stream) = 0;
+
+    /**
+     * Builds the rotation drawn by randomRotationMatrix from three numbers
+     * between 0 and 1, so that the rotations can follow quasi-random points.
+     * \param u1 the number giving the rotation one the X axis.
+     * \param u2 the number giving the rotation one the Y axis.
+     * \param u3 the number giving the rotation one the Z axis.
+     * \return the rotation.
+     */
+    virtual RotationMatrix calculateUniformRotationMatrix(double u1, double u2, double u3) = 0;
+
+    /**
+     * Rotates the positions by a rotation built once.
+     * \param rotation the rotation.
+     * \param initPos the positions to rotate.
+     * \param pos the positions rotated, as many as initPos.
+     */
+    virtual void rotate(const RotationMatrix& rotation, const std::vector<Vector3D>& initPos, std::vector<Vector3D>& pos) = 0;
 
     /**
     * Calculates the center of mass of a molecule.
@@ -75,6 +114,13 @@ class MathLib
     */
     virtual Vector3D calculateMassCenter(const Molecule& mol) = 0;
 
+    /**
+    * Calculates the center of mass of atoms stored as arrays.
+    * \param data the atoms.
+    * \return the coordinates of the center of mass of the atoms.
+    */
+    virtual Vector3D calculateMassCenter(const MoleculeData& data) = 0;
+
     /**
     * Finds the atom the farthest of the center of mass.
     * \param mol the molecule.
@@ -101,6 +101,12 @@ class Mean
      */
     virtual bool isTMPrintable() = 0;
 
+    /**
+     * Indicates if the structural asymmetry parameter needs to be printed.
+     * \return true if the structural asymmetry parameter needs to be printed, false otherwise.
+     */
+    virtual bool isStructAsymParamPrintable() = 0;
+
     /**
      * Add a result to the results used to calculate the means.
      * \param r the result to add to the list.
@@ -6,8 +6,8 @@
 #include "StdResult.h"
 #include "MathLib.h"
 #include "StdMathLib.h"
-#include "RandomGenerator.h"
 
+#include <algorithm>
 #include <cmath>
 #include <vector>
 #include <string>
@@ -61,9 +61,6 @@ MonoThreadCalculationOperator::~MonoThreadCalculationOperator()
  */
 void MonoThreadCalculationOperator::calculateTM()
 {
-  // On met a jour le CalculationState.
-  m_calculationState->setTMStarted();
-
   // Parametres de mobil2 :
   // t -> temperature (298)
   //    -> StdCalculationOperator::m_Temperature
@@ -83,17 +80,12 @@ void MonoThreadCalculationOperator::calculateTM()
   // Un objet pour manipuler les fonctions mathÃ©matiques.
   MathLib* mathLib = new StdMathLib();
 
-  // Masses.
-  const double m1 = 4.0026;
-  const double m2 = m_molMass;
-
   // Variables de travail.
   Vector3D iPos;
   double dMax = 0.0;
-  const int NbCasesCosX = 500;
-  std::array<double, NbCasesCosX + 1> cosx;
-  std::vector<double> q1st(m_numberPointsVelocity);
-  std::vector<double> q2st(m_numberPointsVelocity);
+  // Q(1)* et Q(2)* de chaque cycle et vitesse.
+  std::vector<double> q1st(m_numberCyclesTM * m_numberPointsVelocity);
+  std::vector<double> q2st(m_numberCyclesTM * m_numberPointsVelocity);
   std::vector<double> om11st(m_numberCyclesTM);
   std::vector<double> om12st(m_numberCyclesTM);
   std::vector<double> om13st(m_numberCyclesTM);
@@ -127,7 +119,6 @@ void MonoThreadCalculationOperator::calculateTM()
     angleY = 2.0 * M_PI - angleY;
   }
   angleY = 2.0 * M_PI - angleY;
-  mathLib->rotate(m_molInitPos, m_molPos, angleX, angleY, angleZ);
 
   // Rotation d'un angle Z.
   double rxy = sqrt(iPos.x * iPos.x + iPos.y * iPos.y);
@@ -136,7 +127,9 @@ void MonoThreadCalculationOperator::calculateTM()
     angleZ = 2.0 * M_PI - angleZ;
   }
   angleZ = 2.0 * M_PI - angleZ;
-  mathLib->rotate(m_molInitPos, m_molPos, angleX, angleY, angleZ);
+  std::vector<Vector3D> axes(m_initAxes);
+  mathLib->rotate(m_initAxes, axes, angleX, angleY, angleZ);
+  m_potentialEngine->setOrientation(axes);
 
 
 
@@ -154,7 +147,7 @@ void MonoThreadCalculationOperator::calculateTM()
   {
     for (int i = 1; i <= irn; ++i) {
       p.x = rMax + m_maxROLJ - (i * ddd);
-      pot = calculatePotentials(m_molPos, p, dPot, dMax);
+      pot = m_potentialEngine->calculatePotential(p, dPot, dMax);
       if (pot <= 0.0) {
         r00.x = p.x;
         if (pot < eMax.x) {
@@ -167,7 +160,7 @@ void MonoThreadCalculationOperator::calculateTM()
     p.x = 0.0;
     for (int i = 1; i <= irn; ++i) {
       p.y = rMax + m_maxROLJ - (i * ddd);
-      pot = calculatePotentials(m_molPos, p, dPot, dMax);
+      pot = m_potentialEngine->calculatePotential(p, dPot, dMax);
       if (pot <= 0.0) {
         r00.y = p.y;
         if (pot < eMax.y) {
@@ -180,7 +173,7 @@ void MonoThreadCalculationOperator::calculateTM()
     p.y = 0.0;
     for (int i = 1; i <= irn; ++i) {
       p.z = rMax + m_maxROLJ - (i * ddd);
-      pot = calculatePotentials(m_molPos, p, dPot, dMax);
+      pot = m_potentialEngine->calculatePotential(p, dPot, dMax);
       if (pot <= 0.0) {
         r00.z = p.z;
         if (pot < eMax.z) {
@@ -192,118 +185,15 @@ void MonoThreadCalculationOperator::calculateTM()
   }
 
 
-  // PrÃ©paration de l'intÃ©gration sur gst.
-  const double tst = m_XkFromMobcal * m_temperature / m_EoFromMobcal;
-  double tst3 = boost::math::pow<3>(tst);
-
-  double dgst = 5.0 * pow(10, -7) * 6.0 * sqrt(tst);
-  double gst = dgst;
-  double sum = 0.0;
-  double sum1 = 0.0;
-  double sum2 = 0.0;
-
-  for (int i = 1; i <= m_numberPointsVelocity; ++i) {
-    sum1 += sqrt(i);
-  }
-
-  double hold1;
-  double hold2;
-  std::vector<double> wgst(m_numberPointsVelocity + 1);
-  std::vector<double> pgst(m_numberPointsVelocity + 1);
-  double gstt;
-
-  for (int i = 1; i <= m_numberPointsVelocity; ++i) {
-    hold1 = sqrt(i);
-    hold2 = sqrt(i - 1);
-    sum2 += hold2;
-    wgst[i] = hold1 / sum1;
-    gstt = tst3 * (sum2 + (hold1 / 2.0)) / sum1;
-
-    while (sum < gstt) {
-      sum += exp(-gst * gst / tst) * boost::math::pow<5>(gst) * dgst;
-      gst = gst + dgst;
-      if (sum > gstt) {
-        pgst[i] = gst - (dgst / 2.0);
-      }
-    }
-  }
-
-
-  // DÃ©termination de b2max.
-  // Ligne 1456.
-  double dbst2 = 1.0;
-  double dbst22 = dbst2 / 10.0;
-  double cmin = 0.0005;
-  double gst2;
-  double v;
-  int ibst;
-  std::vector<double> b2max(m_numberPointsVelocity + 1, 0.0);
-  double bst2;
-  double b;
-  double ang;
-
-  for (int i = m_numberPointsVelocity; i >= 1; --i) {
-    gst2 = boost::math::pow<2>(pgst[i]);
-    v = sqrt((gst2 * m_EoFromMobcal) / (0.5 * m_massConstant));
-    ibst = (int) (rMaxVec.x / m_RoFromMobcal) - 6;
-    if (i < m_numberPointsVelocity) {
-      ibst = (int) (b2max[i + 1] / dbst2) - 6;
-    }
-    if (ibst < 0) {
-      ibst = 0;
-    }
-    // do/while pour le goto 3000 ligne 1490
-    do {
-      bst2 = dbst2 * ibst;
-      b = m_RoFromMobcal * sqrt(bst2);
-      // gsang 1475
-      // Pas besoin d'erat dans l'appel Ã  gsang ?
-      // Pas besoin de d1 ?
-      // istep inutile dans Mobcal ?
-      ang = calculateTrajectory(m_molPos, v, b);
-      cosx[ibst] = 1.0 - cos(ang);
-
-      // C'est le bordel dans les goto
-      // On a une boucle de la ligne 1473 Ã  la ligne 1490 Ã  cause du goto 3000
-      // Le seul moyen de sortir c'est le goto 3020 ligne 1480-1482
-      // On va le symboliser par un break, ici
-      if (ibst >= 4 && cosx[ibst] < cmin
-          && cosx[ibst - 1] < cmin
-          && cosx[ibst - 2] < cmin
-          && cosx[ibst - 3] < cmin
-          && cosx[ibst - 4] < cmin) {
-        break;
-      }
-
-      // Le goto 3010 ligne 1479 sera symbolisÃ© par un if ici.
-      // Comme le goto 3000 est obligatoire, on va boucler.
-      ibst += 1;
-      if (ibst > NbCasesCosX) {
-        // ERREUR
-        throw std::string("Ibst superior to 500.");
-      }
-    } while(true);
-
-    // Ligne 1491, on arrive ici aprÃ¨s le goto 3020 ligne 1482.
-    b2max[i] = (ibst - 5) * dbst2;
-    // Boucle do/while pour le goto 3040 ligne 1495
-    do {
-      b2max[i] += dbst22;
-      b = m_RoFromMobcal * sqrt(b2max[i]);
-      ang = calculateTrajectory(m_molPos, v, b);
-    } while (1.0 - cos(ang) > cmin);
-  }
-  // Fin de la boucle for : continue ligne 1496
+  // Vitesses de chaque temperature, et vitesses ou les trajectoires sont
+  // calculees, communes a toutes les temperatures.
+  const std::vector<VelocityPoints> temperatures = calculateTemperaturesTM();
+  const std::vector<double> pgst = calculateTrajectoryVelocities(temperatures);
 
 
   // On calcule Omega(1, 1)*,  Omega(1, 2)*, Omega(1, 3) et Omega(2, 2)*
   // en intÃ©grant Q(1)* ou Q(2)* sur toutes les orientations et Ã  des
   // vÃ©locitÃ©s initiales relatives.
-  for (int i = 0; i < m_numberPointsVelocity; ++i) {
-    q1st[i] = 0.0;
-    q2st[i] = 0.0;
-  }
-
   for (int ic = 0; ic < m_numberCyclesTM; ++ic) {
     om11st[ic] = 0.0;
     om12st[ic] = 0.0;
@@ -311,10 +201,18 @@ void MonoThreadCalculationOperator::calculateTM()
     om22st[ic] = 0.0;
   }
 
-  // Une variable pour compter le nombre de trajectoires terminees.
-  int countFinishedTrajectories = 0;
+  // Cycles repris d'un point de reprise, sinon determination de b2max.
+  std::vector<double> b2max;
+  int nbCycles = resumeCyclesTM(b2max, om11st, om12st, om13st, om22st, q1st, q2st);
+  if (b2max.empty()) {
+    b2max = calculateB2max(pgst, rMaxVec.x);
+  }
 
-  for (int ic = 0; ic < m_numberCyclesTM; ++ic) {
+  // Les cycles peuvent s'arreter avant m_numberCyclesTM, quand l'erreur
+  // standard visee est atteinte.
+  bool converged = nbCycles > 0 && isTMConverged(om11st, nbCycles);
+  while (!converged && nbCycles < m_numberCyclesTM) {
+    const int ic = nbCycles;
     for (int ig = 0; ig < m_numberPointsVelocity; ++ig) {
       double valpgst = pgst[ig + 1];
       double gst2 = valpgst * valpgst;
@@ -322,119 +220,46 @@ void MonoThreadCalculationOperator::calculateTM()
       double temp1 = 0.0;
       double temp2 = 0.0;
 
-      double rnb;
-      double bst2;
-      double b;
-      double ang;
-      double hold1;
-      double hold2;
       double valb2max = b2max[ig + 1];
 
-      for (int im = 0; im < m_numberPointsMCIntegrationTM; ++im) {
-        rnb = RandomGenerator::getInstance()->getRandomNumber();
-        mathLib->randomRotation(m_molInitPos, m_molPos);
-        bst2 = rnb * valb2max;
-        b = m_RoFromMobcal * sqrt(bst2);
-        ang = calculateTrajectory(m_molPos, v, b);
-        hold1 = 1.0 - cos(ang);
-        hold2 = sin(ang);
-        hold2 *= hold2;
-        temp1 += (hold1 * valb2max);
-        temp2 += (1.5 * hold2 * valb2max);
-
-        // Une trajectoire de plus de terminee.
-        countFinishedTrajectories++;
+      // Les points sont integres par paquets, comme avec plusieurs threads,
+      // pour que les sommes soient les memes.
+      const unsigned int nbPoints = m_numberPointsMCIntegrationTM;
+      const unsigned int chunkSize = getMonteCarloChunkSize();
+      for (unsigned int first = 0; first < nbPoints; first += chunkSize) {
+        double chunkTemp1;
+        double chunkTemp2;
+        calculateMonteCarloPoints(*m_potentialEngine, ic, ig, v, valb2max, first,
+                                  std::min(chunkSize, nbPoints - first), chunkTemp1, chunkTemp2);
+        temp1 += chunkTemp1;
+        temp2 += chunkTemp2;
+
+        // On met a jour le CalculationState puisque des trajectoires ont ete calculees.
+        m_calculationState->addFinishedTrajectories(std::min(chunkSize, nbPoints - first));
       }
 
-      // On met a jour le CalculationState puisque des trajectoires ont ete calculees.
-      m_calculationState->setFinishedTrajectories(countFinishedTrajectories);
-
-
       temp1 /= m_numberPointsMCIntegrationTM;
       temp2 /= m_numberPointsMCIntegrationTM;
 
-      double valwgst = wgst[ig + 1];
-
-      // Variable tampon
-      om11st[ic] += temp1 * valwgst;
-      om12st[ic] += temp1 * valpgst * valpgst * valwgst * (1.0 / (3.0 * tst));
-      om13st[ic] += temp1 * boost::math::pow<4>(valpgst) * valwgst * (1.0 / (12.0 * tst * tst));
-      om22st[ic] += temp2 * valpgst * valpgst * valwgst * (1.0 / (3.0 * tst));
-      q1st[ig] += temp1;
-      q2st[ig] += temp2;
+      q1st[ic * m_numberPointsVelocity + ig] = temp1;
+      q2st[ic * m_numberPointsVelocity + ig] = temp2;
     }
-  }
 
+    // Integration sur les vitesses de la temperature.
+    integrateCycleTM(temperatures[0], pgst, &q1st[ic * m_numberPointsVelocity], &q2st[ic * m_numberPointsVelocity],
+                     om11st[ic], om12st[ic], om13st[ic], om22st[ic]);
 
-  // On calcul les moyennes.
-  // Ligne 1582.
-  hold1 = 0.0;
-  hold2 = 0.0;
-  double temp = 0.0;
-
-  for (int icc = 0; icc < m_numberCyclesTM; ++icc) {
-    temp = 1.0 / (m_mobilityConstant / (sqrt(m_temperature) * om11st[icc] * M_PI * m_RoFromMobcal * m_RoFromMobcal));
-    hold1 += om11st[icc];
-    hold2 += temp;
-  }
-
-  // Moyennes.
-  double mom11st = 0.0;
-  double mom12st = 0.0;
-  double mom13st = 0.0;
-  double mom22st = 0.0;
-  for (int ic = 0; ic < m_numberCyclesTM; ++ic) {
-    mom11st += om11st[ic];
-    mom12st += om12st[ic];
-    mom13st += om13st[ic];
-    mom22st += om22st[ic];
+    ++nbCycles;
+    converged = isTMConverged(om11st, nbCycles);
+    checkpointCyclesTM(b2max, om11st, om12st, om13st, om22st, q1st, q2st, nbCycles);
   }
-  mom11st /= m_numberCyclesTM;
-  mom12st /= m_numberCyclesTM;
-  mom13st /= m_numberCyclesTM;
-  mom22st /= m_numberCyclesTM;
-
-  // Deviation standard.
-  double sdom11st = 0.0;
-  double hold;
-  for (int ic = 0; ic < m_numberCyclesTM; ++ic) {
-      hold = mom11st - om11st[ic];
-      sdom11st += hold * hold;
-  }
-  // Ne sert Ã  rien ? DÃ©viation standard
-  sdom11st = sqrt(sdom11st / m_numberCyclesTM);
-  double cs = mom11st * M_PI * m_RoFromMobcal * m_RoFromMobcal;
-  // sdevpc ne sert Ã  rien ?
-  double sdevpc = 100.0 * sdom11st / mom11st;
-  m_result->setStandardDeviation(sdevpc);
-
-
-  // On utilise les omegas pour obtenir un ordre supÃ©rieur de facteur
-  // de correction pour les mobilitÃ©s.
-  // Ligne 1633.
-  double ayst = mom22st / mom11st;
-  double best = ((5.0 * mom12st) - (4.0 * mom13st)) / mom11st;
-  double cest = mom12st / mom11st;
-  double term = ((4.0 * ayst) / 15.0) + (0.5 * (pow((m2 - m1), 2.0) / (m1 * m2)));
-  double u2 = term - (0.08333 * (2.4 * best + 1.0) * (m1 / m2));
-  double w = m1 / m2;
-  double delta = (pow(((6.0 * cest) - 5.0), 2.0) * w) / (60.0 * (1.0 + u2));
-  double f = 1.0 / (1.0 - delta);
-  double mob = (m_mobilityConstant * f) / (sqrt(m_temperature) * cs);
-
-  // Average TM mobility ;
-  double averageTMMobility = mob;
-  // Inverse average TM mobility :
-  double inverseAverageTMMobility = 1.0 / mob;
-
-  // Average TM cross section.
-  double TMCrossSection = cs * 1.0 * pow(10, 20);
+  saveConvergenceTM(om11st, nbCycles);
 
-  delete mathLib;
 
-  m_result->setTM(TMCrossSection);
+  // Moyennes des cycles, et mobilite corrigee par les omegas d'ordre
+  // superieur.
+  TemperatureTM tm = finishTM(om11st, om12st, om13st, om22st, nbCycles, m_temperature);
+  saveTM(tm, temperatures, pgst, q1st, q2st, nbCycles);
 
-  // On met a jour le CalculationState.
-  m_calculationState->setTMResult(TMCrossSection);
-  m_calculationState->setTMEnded();
+  delete mathLib;
 }
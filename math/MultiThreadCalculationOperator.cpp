@@ -1,15 +1,18 @@
 #include "MultiThreadCalculationOperator.h"
 
 #include "../general/AtomInformations.h"
+#include "../general/GlobalParameters.h"
 #include "../molecule/StdMolecule.h"
 #include "../molecule/StdAtom.h"
 #include "StdResult.h"
 #include "MathLib.h"
 #include "StdMathLib.h"
-#include "RandomGenerator.h"
+#include "WorkStealingScheduler.h"
+#include "ProjectedAreaRasterizer.h"
 
 #include <omp.h>
 
+#include <algorithm>
 #include <cmath>
 #include <vector>
 #include <string>
@@ -17,7 +20,6 @@
 #include <cstdlib>
 
 #include <boost/math/special_functions/pow.hpp>
-#include <boost/multiprecision/miller_rabin.hpp>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -61,14 +63,67 @@ MultiThreadCalculationOperator::~MultiThreadCalculationOperator()
 }
 
 /**
- * Calculate TM and put the results in
+ * Calculate EHSS and PA and put the results in
  * m_result attribute.
  */
-void MultiThreadCalculationOperator::calculateTM()
+void MultiThreadCalculationOperator::calculateEHSSAndPA(const MoleculeData& data)
 {
   // On met a jour le CalculationState.
-  m_calculationState->setTMStarted();
+  m_calculationState->setEHSSStarted();
+  m_calculationState->setPAStarted();
+
+  // Spheres dures des atomes, partagees par les threads : les trajectoires
+  // ne les deplacent pas.
+  std::vector<Vector3D> initPos;
+  initPos.reserve(data.size());
+  for (unsigned int i = 0; i < data.size(); ++i) {
+    initPos.push_back(data.getPosition(i));
+  }
+  SphereBVH bvh(initPos, m_rhsTab);
+
+  // Memes groupes de trajectoires qu'en mono thread : les sommes, faites
+  // dans l'ordre des groupes, ne dependent pas du nombre de threads.
+  const unsigned int nbPoints = m_numberPointsMCIntegrationEHSSPA;
+  const unsigned int chunkSize = m_HardSphereChunkSize;
+  const unsigned int nbChunks = (nbPoints + chunkSize - 1) / chunkSize;
+  std::vector<HardSphereSums> sums(nbChunks);
+
+  WorkStealingScheduler scheduler(std::min(m_maximalNumberThreads, std::max(nbChunks, 1u)));
+  scheduler.run(nbChunks, [&](unsigned int chunk, unsigned int) {
+    const unsigned int first = chunk * chunkSize;
+    calculateHardSphereTrajectories(bvh, first, std::min(chunkSize, nbPoints - first), sums[chunk]);
+  });
+
+  finishEHSSAndPA(bvh, sums);
+}
 
+double MultiThreadCalculationOperator::calculateRasterizedPA(const SphereBVH& bvh)
+{
+  const unsigned int nbOrientations = GlobalParameters::getInstance()->getNbOrientationsPA();
+
+  // Une aire par direction, additionnees dans l'ordre a la fin.
+  std::vector<double> areas(nbOrientations);
+  WorkStealingScheduler scheduler(std::min(m_maximalNumberThreads, std::max(nbOrientations, 1u)));
+  std::vector<ProjectedAreaRasterizer> rasterizers(scheduler.getNumberWorkers(),
+                                                   ProjectedAreaRasterizer(GlobalParameters::getInstance()->getPAPixelSize()));
+  scheduler.run(nbOrientations, [&](unsigned int k, unsigned int worker) {
+    areas[k] = rasterizers[worker].calculateArea(bvh.getX(), bvh.getY(), bvh.getZ(), bvh.getRadius(),
+                                                 ProjectedAreaRasterizer::getDirection(k, nbOrientations));
+  });
+
+  double projection = 0.0;
+  for (unsigned int k = 0; k < nbOrientations; ++k) {
+    projection += areas[k];
+  }
+  return projection / nbOrientations;
+}
+
+/**
+ * Calculate TM and put the results in
+ * m_result attribute.
+ */
+void MultiThreadCalculationOperator::calculateTM()
+{
   // Parametres de mobil2 :
   // t -> temperature (298)
   //    -> StdCalculationOperator::m_Temperature
@@ -87,17 +142,12 @@ void MultiThreadCalculationOperator::calculateTM()
   // Un objet pour manipuler les fonctions mathematiques.
   MathLib* mathLib = new StdMathLib();
 
-  // Masses.
-  const double m1 = 4.0026;
-  const double m2 = m_molMass;
-
   // Variables de travail.
   Vector3D iPos;
   double dMax = 0.0;
-  const int NbCasesCosX = 500;
-  std::array<double, NbCasesCosX + 1> cosx;
-  std::vector<double> q1st(m_numberPointsVelocity);
-  std::vector<double> q2st(m_numberPointsVelocity);
+  // Q(1)* et Q(2)* de chaque cycle et vitesse.
+  std::vector<double> q1st(m_numberCyclesTM * m_numberPointsVelocity);
+  std::vector<double> q2st(m_numberCyclesTM * m_numberPointsVelocity);
   std::vector<double> om11st(m_numberCyclesTM);
   std::vector<double> om12st(m_numberCyclesTM);
   std::vector<double> om13st(m_numberCyclesTM);
@@ -131,7 +181,6 @@ void MultiThreadCalculationOperator::calculateTM()
     angleY = 2.0 * M_PI - angleY;
   }
   angleY = 2.0 * M_PI - angleY;
-  mathLib->rotate(m_molInitPos, m_molPos, angleX, angleY, angleZ);
 
   // Rotation d'un angle Z.
   double rxy = sqrt(iPos.x * iPos.x + iPos.y * iPos.y);
@@ -140,7 +189,9 @@ void MultiThreadCalculationOperator::calculateTM()
     angleZ = 2.0 * M_PI - angleZ;
   }
   angleZ = 2.0 * M_PI - angleZ;
-  mathLib->rotate(m_molInitPos, m_molPos, angleX, angleY, angleZ);
+  std::vector<Vector3D> axes(m_initAxes);
+  mathLib->rotate(m_initAxes, axes, angleX, angleY, angleZ);
+  m_potentialEngine->setOrientation(axes);
 
 
 
@@ -163,7 +214,7 @@ void MultiThreadCalculationOperator::calculateTM()
     #pragma omp for
     for (int i = 1; i <= irn; ++i) {
       p.x = rMax + m_maxROLJ - (i * ddd);
-      pot = calculatePotentials(m_molPos, p, dPot, dMax);
+      pot = m_potentialEngine->calculatePotential(p, dPot, dMax);
       if (pot <= 0.0) {
         r00.x = p.x;
         if (pot < eMax.x) {
@@ -177,7 +228,7 @@ void MultiThreadCalculationOperator::calculateTM()
     #pragma omp for
     for (int i = 1; i <= irn; ++i) {
       p.y = rMax + m_maxROLJ - (i * ddd);
-      pot = calculatePotentials(m_molPos, p, dPot, dMax);
+      pot = m_potentialEngine->calculatePotential(p, dPot, dMax);
       if (pot <= 0.0) {
         r00.y = p.y;
         if (pot < eMax.y) {
@@ -191,7 +242,7 @@ void MultiThreadCalculationOperator::calculateTM()
     #pragma omp for
     for (int i = 1; i <= irn; ++i) {
       p.z = rMax + m_maxROLJ - (i * ddd);
-      pot = calculatePotentials(m_molPos, p, dPot, dMax);
+      pot = m_potentialEngine->calculatePotential(p, dPot, dMax);
       if (pot <= 0.0) {
         r00.z = p.z;
         if (pot < eMax.z) {
@@ -203,114 +254,15 @@ void MultiThreadCalculationOperator::calculateTM()
   }
 
 
-  // Preparation de l'integration sur gst.
-  const double tst = m_XkFromMobcal * m_temperature / m_EoFromMobcal;
-  double tst3 = boost::math::pow<3>(tst);
-
-  double dgst = 5.0 * pow(10, -7) * 6.0 * sqrt(tst);
-  double gst = dgst;
-  double sum = 0.0;
-  double sum1 = 0.0;
-  double sum2 = 0.0;
-
-  for (int i = 1; i <= m_numberPointsVelocity; ++i) {
-    sum1 += sqrt(i);
-  }
-
-  double hold1;
-  double hold2;
-  std::vector<double> wgst(m_numberPointsVelocity + 1);
-  std::vector<double> pgst(m_numberPointsVelocity + 1);
-  double gstt;
-
-  for (int i = 1; i <= m_numberPointsVelocity; ++i) {
-    hold1 = sqrt(i);
-    hold2 = sqrt(i - 1);
-    sum2 += hold2;
-    wgst[i] = hold1 / sum1;
-    gstt = tst3 * (sum2 + (hold1 / 2.0)) / sum1;
-
-    while (sum < gstt) {
-      sum += exp(-gst * gst / tst) * boost::math::pow<5>(gst) * dgst;
-      gst = gst + dgst;
-      if (sum > gstt) {
-        pgst[i] = gst - (dgst / 2.0);
-      }
-    }
-  }
-
-
-  // Determination de b2max.
-  double dbst2 = 1.0;
-  double dbst22 = dbst2 / 10.0;
-  double cmin = 0.0005;
-  double gst2;
-  double v;
-  int ibst;
-  std::vector<double> b2max(m_numberPointsVelocity + 1, 0.0);
-  double bst2;
-  double b;
-  double ang;
-
-  // Definition du nombre de threads : le max possible.
-  if (m_maximalNumberThreads >= m_numberPointsVelocity) {
-    omp_set_num_threads(m_numberPointsVelocity);
-  } else {
-    omp_set_num_threads(m_maximalNumberThreads);
-  }
-  #pragma omp parallel for private(v, gst2, ibst, bst2, b, ang)
-  for (int i = m_numberPointsVelocity; i >= 1; --i) {
-    gst2 = boost::math::pow<2>(pgst[i]);
-    v = sqrt((gst2 * m_EoFromMobcal) / (0.5 * m_massConstant));
-    ibst = (int) (rMaxVec.x / m_RoFromMobcal) - 6;
-    if (i < m_numberPointsVelocity) {
-      ibst = (int) (b2max[i + 1] / dbst2) - 6;
-    }
-    if (ibst < 0) {
-      ibst = 0;
-    }
-
-    do {
-      bst2 = dbst2 * ibst;
-      b = m_RoFromMobcal * sqrt(bst2);
-      // Pas besoin d'erat dans l'appel a gsang ?
-      // Pas besoin de d1 ?
-      // istep inutile dans Mobcal ?
-      ang = calculateTrajectory(m_molPos, v, b);
-      cosx[ibst] = 1.0 - cos(ang);
-
-      if (ibst >= 4 && cosx[ibst] < cmin
-          && cosx[ibst - 1] < cmin
-          && cosx[ibst - 2] < cmin
-          && cosx[ibst - 3] < cmin
-          && cosx[ibst - 4] < cmin) {
-        break;
-      }
-
-      ibst += 1;
-      if (ibst > NbCasesCosX) {
-        // ERREUR
-        throw std::string("Ibst superior to 500.");
-      }
-    } while(true);
-
-    b2max[i] = (ibst - 5) * dbst2;
-    do {
-      b2max[i] += dbst22;
-      b = m_RoFromMobcal * sqrt(b2max[i]);
-      ang = calculateTrajectory(m_molPos, v, b);
-    } while (1.0 - cos(ang) > cmin);
-  }
+  // Vitesses de chaque temperature, et vitesses ou les trajectoires sont
+  // calculees, communes a toutes les temperatures.
+  const std::vector<VelocityPoints> temperatures = calculateTemperaturesTM();
+  const std::vector<double> pgst = calculateTrajectoryVelocities(temperatures);
 
 
   // On calcule Omega(1, 1)*,  Omega(1, 2)*, Omega(1, 3) et Omega(2, 2)*
   // en integrant Q(1)* ou Q(2)* sur toutes les orientations et a des
   // velocites initiales relatives.
-  for (int i = 0; i < m_numberPointsVelocity; ++i) {
-    q1st[i] = 0.0;
-    q2st[i] = 0.0;
-  }
-
   for (int ic = 0; ic < m_numberCyclesTM; ++ic) {
     om11st[ic] = 0.0;
     om12st[ic] = 0.0;
@@ -318,178 +270,107 @@ void MultiThreadCalculationOperator::calculateTM()
     om22st[ic] = 0.0;
   }
 
-  omp_set_nested(1);
-
-  // Une variable pour compter le nombre de trajectoires terminees.
-  int countFinishedTrajectories = 0;
-
-  // Calcul du nombre de threads max pour une boucle imbriquee.
-  MultiThreadCalculationOperator::NumberThread nT = getOptimizedNumberThreads(m_numberCyclesTM);
-  omp_set_num_threads(nT.externLoop);
+  // Trajectoires deja terminees par les gaz precedents.
+  const int finishedBefore = m_calculationState->getNumberFinishedTractories();
 
-  #pragma omp parallel for
-  for (int ic = 0; ic < m_numberCyclesTM; ++ic) {
-    double om11stSum = 0.0;
-    double om12stSum = 0.0;
-    double om13stSum = 0.0;
-    double om22stSum = 0.0;
+  // Cycles repris d'un point de reprise, sinon determination de b2max.
+  std::vector<double> b2max;
+  int nbCycles = resumeCyclesTM(b2max, om11st, om12st, om13st, om22st, q1st, q2st);
+  if (b2max.empty()) {
+    b2max = calculateB2max(pgst, rMaxVec.x);
+  }
 
-    const bool firstThread = (omp_get_thread_num() == 0);
+  // Les trajectoires n'ont pas toutes le meme cout (les petites vitesses
+  // demandent plus de pas) : les boucles sur les cycles, les vitesses et
+  // les points de Monte-Carlo sont aplaties en taches de quelques lots de
+  // trajectoires, reparties entre les threads par vol de taches.
+  const unsigned int nbPoints = m_numberPointsMCIntegrationTM;
+  const unsigned int nbVelocities = m_numberPointsVelocity;
+  const unsigned int chunkSize = getMonteCarloChunkSize();
+  const unsigned int nbChunks = (nbPoints + chunkSize - 1) / chunkSize;
+  const unsigned int nbTasks = m_numberCyclesTM * nbVelocities * nbChunks;
+
+  WorkStealingScheduler scheduler(m_maximalNumberThreads);
+
+  // Sommes de chaque tache, additionnees dans l'ordre a la fin : le resultat
+  // ne depend pas du nombre de threads.
+  std::vector<double> temp1Sums(nbTasks, 0.0);
+  std::vector<double> temp2Sums(nbTasks, 0.0);
+  // Chaque thread travaille sur son propre moteur de potentiel.
+  std::vector<PotentialEngine*> potentialEngines(scheduler.getNumberWorkers());
+  for (unsigned int w = 0; w < scheduler.getNumberWorkers(); ++w) {
+    potentialEngines[w] = m_potentialEngine->clone();
+  }
 
-    omp_set_num_threads(nT.innerLoop);
+  // Sans erreur standard visee ni point de reprise, tous les cycles sont
+  // lances ensemble. Sinon ils sont lances un par un, pour s'arreter des que
+  // l'erreur est atteinte ou enregistrer chaque cycle.
+  const unsigned int tasksPerCycle = nbVelocities * nbChunks;
+  const int cyclesPerRun = m_TMStandardErrorTarget > 0.0 || Checkpoint::getInstance()->isEnabled() ? 1 : m_numberCyclesTM;
+  bool converged = nbCycles > 0 && isTMConverged(om11st, nbCycles);
+  while (!converged && nbCycles < m_numberCyclesTM) {
+    const int firstCycle = nbCycles;
+    const int runCycles = std::min(cyclesPerRun, m_numberCyclesTM - firstCycle);
+    const unsigned int firstTask = firstCycle * tasksPerCycle;
+
+    scheduler.run(runCycles * tasksPerCycle, [&](unsigned int runTask, unsigned int worker) {
+      const unsigned int task = firstTask + runTask;
+      const unsigned int chunk = task % nbChunks;
+      const unsigned int ig = (task / nbChunks) % nbVelocities;
+      const unsigned int ic = task / (nbChunks * nbVelocities);
 
-    #pragma omp parallel for reduction(+:om11stSum,om12stSum,om13stSum,om22stSum)
-    for (int ig = 0; ig < m_numberPointsVelocity; ++ig) {
-      std::vector<Vector3D> molPos(m_molPos);
       double valpgst = pgst[ig + 1];
       double gst2 = valpgst * valpgst;
       double v = sqrt((gst2 * m_EoFromMobcal) / (0.5 * m_massConstant));
-      double temp1 = 0.0;
-      double temp2 = 0.0;
-
-      double rnb;
-      double bst2;
-      double b;
-      double ang;
-      double hold1;
-      double hold2;
-      double valb2max = b2max[ig + 1];
-
-      for (int im = 0; im < m_numberPointsMCIntegrationTM; ++im) {
-        rnb = RandomGenerator::getInstance()->getRandomNumber();
-        mathLib->randomRotation(m_molInitPos, molPos);
-        bst2 = rnb * valb2max;
-        b = m_RoFromMobcal * sqrt(bst2);
-        ang = calculateTrajectory(molPos, v, b);
-        hold1 = 1.0 - cos(ang);
-        hold2 = sin(ang);
-        hold2 *= hold2;
-        temp1 += (hold1 * valb2max);
-        temp2 += (1.5 * hold2 * valb2max);
-
-        // m_numberPointsMCIntegrationTM trajectoires sont terminees.
-        countFinishedTrajectories++;
-
-        if (firstThread && omp_get_thread_num() == 0) {
-          // Seul le thread principal met a jour l'etat.
-          m_calculationState->setFinishedTrajectories(countFinishedTrajectories);
+      const unsigned int first = chunk * chunkSize;
+      const unsigned int n = std::min(chunkSize, nbPoints - first);
+      calculateMonteCarloPoints(*potentialEngines[worker], ic, ig, v, b2max[ig + 1], first, n,
+                                temp1Sums[task], temp2Sums[task]);
+
+      // n trajectoires sont terminees.
+      m_calculationState->addFinishedTrajectories(n);
+    });
+
+    // Reduction des sommes des taches, puis integration sur les vitesses.
+    for (int ic = firstCycle; ic < firstCycle + runCycles; ++ic) {
+      for (unsigned int ig = 0; ig < nbVelocities; ++ig) {
+        double temp1 = 0.0;
+        double temp2 = 0.0;
+        for (unsigned int chunk = 0; chunk < nbChunks; ++chunk) {
+          temp1 += temp1Sums[(ic * nbVelocities + ig) * nbChunks + chunk];
+          temp2 += temp2Sums[(ic * nbVelocities + ig) * nbChunks + chunk];
         }
-      }
+        temp1 /= m_numberPointsMCIntegrationTM;
+        temp2 /= m_numberPointsMCIntegrationTM;
 
-      temp1 /= m_numberPointsMCIntegrationTM;
-      temp2 /= m_numberPointsMCIntegrationTM;
-
-      double valwgst = wgst[ig + 1];
+        q1st[ic * nbVelocities + ig] = temp1;
+        q2st[ic * nbVelocities + ig] = temp2;
+      }
+      integrateCycleTM(temperatures[0], pgst, &q1st[ic * nbVelocities], &q2st[ic * nbVelocities],
+                       om11st[ic], om12st[ic], om13st[ic], om22st[ic]);
 
-      // Variable tampon
-      om11stSum += temp1 * valwgst;
-      om12stSum += temp1 * valpgst * valpgst * valwgst * (1.0 / (3.0 * tst));
-      om13stSum += temp1 * boost::math::pow<4>(valpgst) * valwgst * (1.0 / (12.0 * tst * tst));
-      om22stSum += temp2 * valpgst * valpgst * valwgst * (1.0 / (3.0 * tst));
-      q1st[ig] += temp1;
-      q2st[ig] += temp2;
+      ++nbCycles;
+      converged = isTMConverged(om11st, nbCycles);
+      if (converged) {
+        break;
+      }
     }
+    checkpointCyclesTM(b2max, om11st, om12st, om13st, om22st, q1st, q2st, nbCycles);
+  }
 
-    om11st[ic] = om11stSum;
-    om12st[ic] = om12stSum;
-    om13st[ic] = om13stSum;
-    om22st[ic] = om22stSum;
+  for (unsigned int w = 0; w < scheduler.getNumberWorkers(); ++w) {
+    delete potentialEngines[w];
   }
+  saveConvergenceTM(om11st, nbCycles);
 
   // On remet a jour l'etat.
-  m_calculationState->setFinishedTrajectories(m_numberCyclesTM * m_numberPointsVelocity * m_numberPointsMCIntegrationTM);
-
+  m_calculationState->setFinishedTrajectories(finishedBefore + nbCycles * m_numberPointsVelocity * m_numberPointsMCIntegrationTM);
 
-  // On calcule les moyennes.
-  hold1 = 0.0;
-  hold2 = 0.0;
-  double temp = 0.0;
 
-  for (int icc = 0; icc < m_numberCyclesTM; ++icc) {
-    temp = 1.0 / (m_mobilityConstant / (sqrt(m_temperature) * om11st[icc] * M_PI * m_RoFromMobcal * m_RoFromMobcal));
-    hold1 += om11st[icc];
-    hold2 += temp;
-  }
-
-  // Moyennes.
-  double mom11st = 0.0;
-  double mom12st = 0.0;
-  double mom13st = 0.0;
-  double mom22st = 0.0;
-  for (int ic = 0; ic < m_numberCyclesTM; ++ic) {
-    mom11st += om11st[ic];
-    mom12st += om12st[ic];
-    mom13st += om13st[ic];
-    mom22st += om22st[ic];
-  }
-  mom11st /= m_numberCyclesTM;
-  mom12st /= m_numberCyclesTM;
-  mom13st /= m_numberCyclesTM;
-  mom22st /= m_numberCyclesTM;
-
-  // Deviation standard.
-  double sdom11st = 0.0;
-  double hold;
-  for (int ic = 0; ic < m_numberCyclesTM; ++ic) {
-      hold = mom11st - om11st[ic];
-      sdom11st += hold * hold;
-  }
-  // Ne sert a rien ? Deviation standard
-  sdom11st = sqrt(sdom11st / m_numberCyclesTM);
-  double cs = mom11st * M_PI * m_RoFromMobcal * m_RoFromMobcal;
-  // sdevpc est enregistree pour la deviation standard
-  double sdevpc = 100.0 * sdom11st / mom11st;
-  m_result->setStandardDeviation(sdevpc);
-
-
-  // On utilise les omegas pour obtenir un ordre superieur de facteur
-  // de correction pour les mobilites.
-  double ayst = mom22st / mom11st;
-  double best = ((5.0 * mom12st) - (4.0 * mom13st)) / mom11st;
-  double cest = mom12st / mom11st;
-  double term = ((4.0 * ayst) / 15.0) + (0.5 * (pow((m2 - m1), 2.0) / (m1 * m2)));
-  double u2 = term - (0.08333 * (2.4 * best + 1.0) * (m1 / m2));
-  double w = m1 / m2;
-  double delta = (pow(((6.0 * cest) - 5.0), 2.0) * w) / (60.0 * (1.0 + u2));
-  double f = 1.0 / (1.0 - delta);
-  double mob = (m_mobilityConstant * f) / (sqrt(m_temperature) * cs);
-
-  // Average TM mobility
-  double averageTMMobility = mob;
-  // Inverse average TM mobility
-  double inverseAverageTMMobility = 1.0 / mob;
-
-  // Average TM cross section
-  double TMCrossSection = cs * 1.0 * pow(10, 20);
+  // Moyennes des cycles, et mobilite corrigee par les omegas d'ordre
+  // superieur.
+  TemperatureTM tm = finishTM(om11st, om12st, om13st, om22st, nbCycles, m_temperature);
+  saveTM(tm, temperatures, pgst, q1st, q2st, nbCycles);
 
   delete mathLib;
-
-  m_result->setTM(TMCrossSection);
-
-  // On met a jour le CalculationState.
-  m_calculationState->setTMResult(TMCrossSection);
-  m_calculationState->setTMEnded();
-}
-
-MultiThreadCalculationOperator::NumberThread MultiThreadCalculationOperator::getOptimizedNumberThreads(double maxThreadOnExternLoop) {
-  int nbMaxThreads = m_maximalNumberThreads;
-  // Si c'est un nombre premier, on diminue.
-  while (boost::multiprecision::miller_rabin_test(nbMaxThreads, 25)) {
-    nbMaxThreads--;
-  }
-
-  NumberThread nT;
-
-  int maxThreads = 0;
-
-  for (int i = 1; i <= maxThreadOnExternLoop; ++i) {
-    int n = nbMaxThreads / i;
-    if (i * n >= maxThreads) {
-      maxThreads = i * n;
-      nT.externLoop = i;
-      nT.innerLoop = n;
-    }
-  }
-
-  return nT;
 }
@@ -58,26 +58,33 @@ class MultiThreadCalculationOperator : public StdCalculationOperator
 
   protected:
     /**
-     * Calculates TM and put the results in
-     * m_result attribute.
+     * Calculates EHSS and PA and put the results in
+     * m_result attribute. The trajectories are shared between the threads
+     * by chunks.
+     * \param data the atoms to use for calculation, centered.
      */
-    void calculateTM();
+    void calculateEHSSAndPA(const MoleculeData& data);
 
-  private:
     /**
-     * Used to calculate an optimized number of threads in two
-     * nested loops.
+     * Calculates PA without random numbers, the directions of projection
+     * being shared between the threads.
+     * \param bvh the hard spheres of the atoms.
+     * \return the average projected area, in square angstroms.
      */
-    struct NumberThread {
-      int externLoop;
-      int innerLoop;
-    };
+    double calculateRasterizedPA(const SphereBVH& bvh);
+
+    /**
+     * Calculates TM and put the results in
+     * m_result attribute.
+     */
+    void calculateTM();
 
-  private:
     /**
-     * Calculates the optimized number of threads for two nested loops.
+     * \return the maximal number of threads.
      */
-    NumberThread getOptimizedNumberThreads(double maxThreadOnExternLoop);
+    unsigned int getNumberThreads() const {
+      return m_maximalNumberThreads;
+    }
 
   private:
     /**
@@ -0,0 +1,140 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+/**
+ * \file PotentialEngine.h
+ * \author Anthony Breant, Clement Poinsot, Jeremie Pantin, Mohamed Takhtoukh, Thomas Capet
+ * \version 1.0
+ * \date 17 october 2026
+ * \brief Interface describing the evaluation of the ion-Helium potential used by TM.
+ */
+
+#ifndef POTENTIALENGINE_H
+#define POTENTIALENGINE_H
+
+#include "Vector3D.h"
+
+#include <vector>
+
+/**
+ * Kernels available to evaluate the potential.
+ */
+enum class PotentialKernel {
+  /// Chooses the best kernel supported by the CPU.
+  AUTO,
+  /// Scalar loop, identical to Mobcal. Reference for verification.
+  SCALAR,
+  /// Portable loop vectorized by the compiler (#pragma omp simd).
+  SIMD,
+  /// AVX2 + FMA intrinsics, 4 atoms per iteration.
+  AVX2,
+  /// AVX-512 intrinsics, 8 atoms per iteration.
+  AVX512
+};
+
+/**
+ * Ways to evaluate the potential.
+ */
+enum class PotentialMode {
+  /// Sum over all the atoms.
+  EXACT,
+  /// Lennard-Jones summed over the atoms close to the Helium only (cell list),
+  /// far atoms approximated by multipoles.
+  CELL_LIST,
+  /// Molecule kept fixed, potential interpolated (tricubic) on a grid
+  /// precomputed around it.
+  GRID
+};
+
+class PotentialEngine
+{
+  public:
+    /**
+     * Destructor.
+     */
+    virtual ~PotentialEngine() {};
+
+    /**
+     * Returns a copy of this engine, with its own coordinates.
+     * Used to give each thread its own engine.
+     * \return a pointer to the copy, to destroy by the caller.
+     */
+    virtual PotentialEngine* clone() const = 0;
+
+    /**
+     * \return the kernel effectively used by the engine.
+     */
+    virtual PotentialKernel getKernel() const = 0;
+
+    /**
+     * \return true if the potential is approximated, false if it is the exact sum.
+     */
+    virtual bool isApproximated() const = 0;
+
+    /**
+     * \return the number of atoms of the molecule.
+     */
+    virtual unsigned int getNumberAtoms() const = 0;
+
+    /**
+     * Sets the positions of the atoms, in meters. They become the frame of the
+     * molecule, with no rotation.
+     * \param pos the positions of the atoms, in the same order as the coefficients.
+     */
+    virtual void setPositions(const std::vector<Vector3D>& pos) = 0;
+
+    /**
+     * Rotates the molecule from the last positions given to the engine.
+     * \param axes the images of the X, Y and Z axes by the rotation.
+     */
+    virtual void setOrientation(const std::vector<Vector3D>& axes) = 0;
+
+    /**
+     * \return the smallest coordinate of the atoms on the Y axis.
+     */
+    virtual double getMinY() const = 0;
+
+    /**
+     * \return the greatest coordinate of the atoms on the Y axis.
+     */
+    virtual double getMaxY() const = 0;
+
+    /**
+     * Calculates the potential and the derivates of the potential.
+     * The potential is given by a sum of 6-12 two body Lennard-Jones
+     * interactions and of the ion-induced dipole interaction.
+     * \param p the position of the Helium for the calculation.
+     * \param dPot the derivates of the potential.
+     * \param dMax the distance to the closest atom, bounded by 2 * maximal ROLJ.
+     * \return the potential
+     */
+    virtual double calculatePotential(const Vector3D& p, Vector3D& dPot, double& dMax) = 0;
+
+    /**
+     * Calculates the potential at several positions, each one with its own
+     * orientation of the molecule. The atoms are read once for several
+     * positions, which is faster than calling calculatePotential for each.
+     * The orientation given by setOrientation is not used.
+     * \param n the number of positions.
+     * \param axes the images of the X, Y and Z axes by the rotation of each
+     * position (3 * n vectors).
+     * \param p the positions of the Helium.
+     * \param pot the potentials (n values).
+     * \param dPot the derivates of the potentials (n values).
+     * \param dMax the distances to the closest atom, bounded by 2 * maximal ROLJ (n values).
+     */
+    virtual void calculatePotentials(unsigned int n, const Vector3D* axes, const Vector3D* p,
+                                     double* pot, Vector3D* dPot, double* dMax) = 0;
+};
+
+#endif // POTENTIALENGINE_H
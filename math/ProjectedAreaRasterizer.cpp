@@ -0,0 +1,125 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+#include "ProjectedAreaRasterizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+ProjectedAreaRasterizer::ProjectedAreaRasterizer(double pixelSize)
+  : m_pixelSize(pixelSize)
+{
+
+}
+
+ProjectedAreaRasterizer::~ProjectedAreaRasterizer()
+{
+
+}
+
+Vector3D ProjectedAreaRasterizer::getDirection(unsigned int k, unsigned int n)
+{
+  // Meme aire pour chaque direction : cos(theta) regulierement espace,
+  // phi tournant de l'angle d'or.
+  const double goldenAngle = M_PI * (3.0 - sqrt(5.0));
+  const double cosTheta = (k + 0.5) / n;
+  const double sinTheta = sqrt(1.0 - cosTheta * cosTheta);
+  const double phi = goldenAngle * k;
+  return Vector3D(sinTheta * cos(phi), sinTheta * sin(phi), cosTheta);
+}
+
+double ProjectedAreaRasterizer::calculateArea(const std::vector<double>& x, const std::vector<double>& y, const std::vector<double>& z,
+                                              const std::vector<double>& radius, const Vector3D& direction)
+{
+  const unsigned int nbSpheres = radius.size();
+  if (nbSpheres == 0) {
+    return 0.0;
+  }
+
+  // Base (e1, e2) du plan orthogonal a la direction.
+  Vector3D helper = fabs(direction.x) < 0.9 ? Vector3D(1.0, 0.0, 0.0) : Vector3D(0.0, 1.0, 0.0);
+  Vector3D e1(direction.y * helper.z - direction.z * helper.y,
+              direction.z * helper.x - direction.x * helper.z,
+              direction.x * helper.y - direction.y * helper.x);
+  const double norm = sqrt(e1.x * e1.x + e1.y * e1.y + e1.z * e1.z);
+  e1.x /= norm;
+  e1.y /= norm;
+  e1.z /= norm;
+  const Vector3D e2(direction.y * e1.z - direction.z * e1.y,
+                    direction.z * e1.x - direction.x * e1.z,
+                    direction.x * e1.y - direction.y * e1.x);
+
+  // Projection des centres, et boite englobant les disques.
+  m_u.resize(nbSpheres);
+  m_v.resize(nbSpheres);
+  double umin = 0.0;
+  double umax = 0.0;
+  double vmin = 0.0;
+  double vmax = 0.0;
+  #pragma omp simd reduction(min:umin,vmin) reduction(max:umax,vmax)
+  for (unsigned int i = 0; i < nbSpheres; ++i) {
+    m_u[i] = x[i] * e1.x + y[i] * e1.y + z[i] * e1.z;
+    m_v[i] = x[i] * e2.x + y[i] * e2.y + z[i] * e2.z;
+    umin = std::min(umin, m_u[i] - radius[i]);
+    umax = std::max(umax, m_u[i] + radius[i]);
+    vmin = std::min(vmin, m_v[i] - radius[i]);
+    vmax = std::max(vmax, m_v[i] + radius[i]);
+  }
+
+  const double h = m_pixelSize;
+  const int width = (int) ceil((umax - umin) / h) + 1;
+  const int height = (int) ceil((vmax - vmin) / h) + 1;
+  const int words = (width + 63) / 64;
+  m_bitmap.assign((size_t) words * height, 0);
+
+  // Chaque disque couvre, sur chaque ligne, les pixels dont le centre
+  // umin + (i + 0.5) h est dans [u - demi-corde, u + demi-corde].
+  for (unsigned int s = 0; s < nbSpheres; ++s) {
+    const double r = radius[s];
+    const int firstRow = std::max(0, (int) ceil((m_v[s] - r - vmin) / h - 0.5));
+    const int lastRow = std::min(height - 1, (int) floor((m_v[s] + r - vmin) / h - 0.5));
+    for (int row = firstRow; row <= lastRow; ++row) {
+      const double dv = vmin + (row + 0.5) * h - m_v[s];
+      const double halfChord = sqrt(std::max(r * r - dv * dv, 0.0));
+      const int first = std::max(0, (int) ceil((m_u[s] - halfChord - umin) / h - 0.5));
+      const int last = std::min(width - 1, (int) floor((m_u[s] + halfChord - umin) / h - 0.5));
+      if (first > last) {
+        continue;
+      }
+
+      // Remplissage des bits first a last, mot par mot.
+      uint64_t* line = &m_bitmap[(size_t) row * words];
+      const int firstWord = first >> 6;
+      const int lastWord = last >> 6;
+      const uint64_t firstMask = ~0ULL << (first & 63);
+      const uint64_t lastMask = ~0ULL >> (63 - (last & 63));
+      if (firstWord == lastWord) {
+        line[firstWord] |= firstMask & lastMask;
+      } else {
+        line[firstWord] |= firstMask;
+        for (int w = firstWord + 1; w < lastWord; ++w) {
+          line[w] = ~0ULL;
+        }
+        line[lastWord] |= lastMask;
+      }
+    }
+  }
+
+  // On compte les pixels couverts.
+  unsigned long long covered = 0;
+  for (size_t w = 0; w < m_bitmap.size(); ++w) {
+    covered += __builtin_popcountll(m_bitmap[w]);
+  }
+
+  return covered * h * h;
+}
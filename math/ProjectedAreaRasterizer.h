@@ -0,0 +1,86 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+/**
+ * \file ProjectedAreaRasterizer.h
+ * \author Anthony Breant, Clement Poinsot, Jeremie Pantin, Mohamed Takhtoukh, Thomas Capet
+ * \version 1.0
+ * \date 17 october 2026
+ * \brief Area of the projection of hard spheres, rasterized on a bitmap.
+ */
+
+#ifndef PROJECTEDAREARASTERIZER_H
+#define PROJECTEDAREARASTERIZER_H
+
+#include "Vector3D.h"
+
+#include <cstdint>
+#include <vector>
+
+class ProjectedAreaRasterizer
+{
+  public:
+    /**
+     * Constructs a rasterizer.
+     * \param pixelSize the size of the pixels, in angstroms.
+     */
+    ProjectedAreaRasterizer(double pixelSize);
+
+    /**
+     * Destructor.
+     */
+    virtual ~ProjectedAreaRasterizer();
+
+    /**
+     * Calculates the area of the union of the disks projecting the spheres
+     * on a plane. A pixel is covered if its center is in a disk. The disks
+     * are filled row by row, 64 pixels at a time.
+     * \param x the x coordinates of the centers of the spheres.
+     * \param y the y coordinates of the centers of the spheres.
+     * \param z the z coordinates of the centers of the spheres.
+     * \param radius the radii of the spheres.
+     * \param direction the direction of projection, normalized.
+     * \return the projected area, in square angstroms.
+     */
+    double calculateArea(const std::vector<double>& x, const std::vector<double>& y, const std::vector<double>& z,
+                         const std::vector<double>& radius, const Vector3D& direction);
+
+    /**
+     * Returns a direction of a set of n directions spread evenly over a half
+     * sphere (Fibonacci lattice). A projection along -d is the same as along
+     * d, so averaging over these directions averages over all orientations.
+     * \param k the index of the direction, lower than n.
+     * \param n the number of directions.
+     * \return the direction, normalized.
+     */
+    static Vector3D getDirection(unsigned int k, unsigned int n);
+
+  private:
+    /**
+     * Size of the pixels.
+     */
+    double m_pixelSize;
+
+    /**
+     * Coordinates of the centers projected on the plane.
+     */
+    std::vector<double> m_u;
+    std::vector<double> m_v;
+
+    /**
+     * Pixels, one bit each, row after row.
+     */
+    std::vector<uint64_t> m_bitmap;
+};
+
+#endif // PROJECTEDAREARASTERIZER_H
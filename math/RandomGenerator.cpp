@@ -18,8 +18,16 @@
 RandomGenerator* RandomGenerator::m_instance = new RandomGenerator();
 
 RandomGenerator::RandomGenerator()
+  : m_generator(nullptr)
 {
-  boost::mt19937 rng = boost::mt19937(time(nullptr));
+  setSeed(time(nullptr));
+}
+
+void RandomGenerator::setSeed(unsigned int seed)
+{
+  m_seed = seed;
+  delete m_generator;
+  boost::mt19937 rng = boost::mt19937(seed);
   boost::uniform_01<> unif;
   m_generator = new boost::variate_generator<boost::mt19937, boost::uniform_01<>>(rng, unif);
 }
@@ -50,6 +50,22 @@ class RandomGenerator
       return (*m_generator)();
     }
 
+    /**
+     * Returns the seed of the calculation, also used as key of the
+     * random streams of each geometry.
+     * \return the seed.
+     */
+    unsigned int getSeed() const
+    {
+      return m_seed;
+    }
+
+    /**
+     * Sets the seed of the calculation, to reproduce a calculation.
+     * \param seed the new seed.
+     */
+    void setSeed(unsigned int seed);
+
   private:
     /**
      * Private constructor.
@@ -61,6 +77,11 @@ class RandomGenerator
      * Instance of RandomGenerator.
      */
     static RandomGenerator* m_instance;
+    /**
+     * Seed of the calculation.
+     * Default value : the time at the start.
+     */
+    unsigned int m_seed;
     /**
      * The random number generator.
      */
@@ -0,0 +1,60 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+#include "RandomStream.h"
+
+// Constantes de Philox4x32 (Salmon et al., 2011).
+static const uint32_t PhiloxM0 = 0xD2511F53u;
+static const uint32_t PhiloxM1 = 0xCD9E8D57u;
+static const uint32_t PhiloxW0 = 0x9E3779B9u;
+static const uint32_t PhiloxW1 = 0xBB67AE85u;
+static const int PhiloxRounds = 10;
+
+RandomStream::RandomStream(uint32_t seed, uint32_t geometry, uint32_t i, uint32_t j, uint32_t k)
+  : m_key({{seed, geometry}}), m_counter({{0, i, j, k}}), m_used(4)
+{
+
+}
+
+double RandomStream::getRandomNumber()
+{
+  // Deux mots de 32 bits donnent les 53 bits d'un double.
+  if (m_used > 2) {
+    generateBlock();
+  }
+  uint32_t a = m_block[m_used] >> 5;
+  uint32_t b = m_block[m_used + 1] >> 6;
+  m_used += 2;
+  return (a * 67108864.0 + b) * (1.0 / 9007199254740992.0);
+}
+
+void RandomStream::generateBlock()
+{
+  std::array<uint32_t, 4> c = m_counter;
+  uint32_t k0 = m_key[0];
+  uint32_t k1 = m_key[1];
+  for (int r = 0; r < PhiloxRounds; ++r) {
+    if (r > 0) {
+      k0 += PhiloxW0;
+      k1 += PhiloxW1;
+    }
+    uint64_t p0 = (uint64_t) PhiloxM0 * c[0];
+    uint64_t p1 = (uint64_t) PhiloxM1 * c[2];
+    c = {{(uint32_t) (p1 >> 32) ^ c[1] ^ k0, (uint32_t) p1,
+          (uint32_t) (p0 >> 32) ^ c[3] ^ k1, (uint32_t) p0}};
+  }
+  m_block = c;
+  m_used = 0;
+  // Bloc suivant.
+  m_counter[0]++;
+}
@@ -0,0 +1,78 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+/**
+ * \file RandomStream.h
+ * \author Anthony Breant, Clement Poinsot, Jeremie Pantin, Mohamed Takhtoukh, Thomas Capet
+ * \version 1.0
+ * \date 17 october 2026
+ * \brief Counter-based random numbers (Philox4x32-10), drawn without shared state.
+ */
+
+#ifndef RANDOMSTREAM_H
+#define RANDOMSTREAM_H
+
+#include <array>
+#include <cstdint>
+
+class RandomStream
+{
+  public:
+    /**
+     * Constructs the stream of random numbers identified by a seed, a geometry
+     * and three indices. The numbers only depend on these values, so a stream
+     * gives the same numbers whatever the thread drawing them and whatever the
+     * streams drawn before.
+     * \param seed the seed of the calculation.
+     * \param geometry the index of the geometry.
+     * \param i first index of the stream (for example a cycle).
+     * \param j second index of the stream (for example a velocity).
+     * \param k third index of the stream (for example a Monte-Carlo point).
+     */
+    RandomStream(uint32_t seed, uint32_t geometry, uint32_t i, uint32_t j, uint32_t k);
+
+    /**
+     * Returns a random number between 0 and 1 (1 excluded).
+     * Random generation is uniform, with 53 random bits.
+     */
+    double getRandomNumber();
+
+  private:
+    /**
+     * Calculates the next block of four random words.
+     */
+    void generateBlock();
+
+  private:
+    /**
+     * Key of Philox : the seed and the geometry.
+     */
+    std::array<uint32_t, 2> m_key;
+
+    /**
+     * Counter of Philox : the number of the block, then the indices of the stream.
+     */
+    std::array<uint32_t, 4> m_counter;
+
+    /**
+     * Last block of random words.
+     */
+    std::array<uint32_t, 4> m_block;
+
+    /**
+     * Number of words of m_block already used.
+     */
+    unsigned int m_used;
+};
+
+#endif // RANDOMSTREAM_H
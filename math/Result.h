@@ -22,8 +22,39 @@
 #ifndef RESULT_H
 #define RESULT_H
 
+#include "../general/GlobalParameters.h"
 #include "../molecule/Molecule.h"
 
+#include <vector>
+
+/**
+ * Result of TM at one temperature of a temperature sweep.
+ */
+struct TemperatureTM {
+  /// Temperature, in kelvins.
+  double temperature;
+  /// TM cross-section, in square angstroms.
+  double crossSection;
+  /// Mobility, in m^2/(V.s).
+  double mobility;
+  /// Standard deviation of the cycles, in percents.
+  double stdDeviation;
+};
+
+/**
+ * Result of TM with one of the buffer gases.
+ */
+struct BufferGasTM {
+  /// Buffer gas.
+  BufferGas gas;
+  /// TM cross-section, in square angstroms.
+  double crossSection;
+  /// Mobility, in m^2/(V.s).
+  double mobility;
+  /// Standard deviation of the cycles, in percents.
+  double stdDeviation;
+};
+
 /**
  * Interface describing how to save results.
  */
@@ -73,6 +104,87 @@ class Result {
      */
     virtual int getNumberOfFailedTrajectories() = 0;
 
+    /**
+     * Returns the greatest relative error of the approximated potential,
+     * estimated against the exact sum.
+     * \return the error on the potential, relatively to max(|potential|, kT).
+     */
+    virtual double getPotentialError() = 0;
+
+    /**
+     * Returns the greatest relative error of the derivates of the
+     * approximated potential, estimated against the exact sum.
+     * \return the error on the derivates, relatively to max(|derivates|, kT / angstrom).
+     */
+    virtual double getPotentialGradientError() = 0;
+
+    /**
+     * \return true if TM was calculated with an approximated potential.
+     */
+    virtual bool isPotentialApproximated() = 0;
+
+    /**
+     * Returns the average number of integration steps of a trajectory in TM.
+     * \return the average number of steps per trajectory.
+     */
+    virtual double getAverageNumberSteps() = 0;
+
+    /**
+     * Returns the average number of calculations of the potential during the
+     * integration of a trajectory in TM.
+     * \return the average number of calculations of the potential per trajectory.
+     */
+    virtual double getAverageNumberPotentialCalculations() = 0;
+
+    /**
+     * \return the number of cycles calculated by TM.
+     */
+    virtual int getNumberCyclesTM() = 0;
+
+    /**
+     * Returns the relative standard error of TM, estimated from its cycles.
+     * \return the relative standard error, in percents.
+     */
+    virtual double getStandardError() = 0;
+
+    /**
+     * \return the number of trajectories calculated by the coarse search
+     * of b2max of TM.
+     */
+    virtual int getNumberB2maxTrajectories() = 0;
+
+    /**
+     * \return the number of trajectories of the coarse search of b2max
+     * saved by its warm start, negative if it cost more trajectories.
+     */
+    virtual int getNumberSavedB2maxTrajectories() = 0;
+
+    /**
+     * Returns the relative standard error of EHSS, estimated from the
+     * scramblings of its Sobol points.
+     * \return the relative standard error, in percents.
+     */
+    virtual double getStandardErrorEHSS() = 0;
+
+    /**
+     * Returns the relative standard error of PA, estimated from the
+     * scramblings of its Sobol points.
+     * \return the relative standard error, in percents.
+     */
+    virtual double getStandardErrorPA() = 0;
+
+    /**
+     * \return the results of TM at the temperatures of the sweep, empty
+     * without sweep.
+     */
+    virtual const std::vector<TemperatureTM>& getTemperatureSweep() = 0;
+
+    /**
+     * \return the results of TM with each buffer gas, empty with a single
+     * buffer gas.
+     */
+    virtual const std::vector<BufferGasTM>& getBufferGasesTM() = 0;
+
     /**
      * \return true if EHSS was saved, false in the other case.
      */
@@ -127,6 +239,54 @@ class Result {
      */
     virtual void setNumberOfFailedTrajectories(int nbFailedTraject) = 0;
 
+    /**
+     * Sets the errors of the approximated potential.
+     * Sets isPotentialApproximated() to true.
+     * \param potErr the error on the potential.
+     * \param gradErr the error on the derivates of the potential.
+     */
+    virtual void setPotentialError(double potErr, double gradErr) = 0;
+
+    /**
+     * Sets the averages over the trajectories of TM.
+     * \param nbSteps the average number of integration steps.
+     * \param nbPotentialCalculations the average number of calculations of the potential.
+     */
+    virtual void setTrajectoryStatistics(double nbSteps, double nbPotentialCalculations) = 0;
+
+    /**
+     * Sets the convergence of TM.
+     * \param nbCycles the number of cycles calculated.
+     * \param stdError the relative standard error, in percents.
+     */
+    virtual void setConvergenceTM(int nbCycles, double stdError) = 0;
+
+    /**
+     * Adds trajectories of the coarse search of b2max.
+     * \param calculated the number of trajectories calculated.
+     * \param saved the number of trajectories saved by the warm start.
+     */
+    virtual void addB2maxTrajectories(int calculated, int saved) = 0;
+
+    /**
+     * Sets the relative standard errors of EHSS and PA.
+     * \param ehssError the relative standard error of EHSS, in percents.
+     * \param paError the relative standard error of PA, in percents.
+     */
+    virtual void setStandardErrorsEHSSPA(double ehssError, double paError) = 0;
+
+    /**
+     * Adds the result of TM at a temperature of the sweep.
+     * \param t the result at the temperature.
+     */
+    virtual void addTemperatureTM(const TemperatureTM& t) = 0;
+
+    /**
+     * Adds the result of TM with a buffer gas.
+     * \param g the result with the buffer gas.
+     */
+    virtual void addBufferGasTM(const BufferGasTM& g) = 0;
+
     /**
      * Indicates if EHSS needs to be printed.
      * \param true if EHSS needs to be printed, false otherwise.
@@ -145,6 +305,12 @@ class Result {
      */
     virtual void TMNeedsToBePrinted(bool b) = 0;
 
+    /**
+     * Indicates if the structural asymmetry parameter needs to be printed.
+     * \param true if the structural asymmetry parameter needs to be printed, false otherwise.
+     */
+    virtual void StructAsymParamNeedsToBePrinted(bool b) = 0;
+
     /**
      * Indicates if EHSS needs to be printed.
      * \return true if EHSS needs to be printed, false otherwise.
@@ -163,6 +329,12 @@ class Result {
      */
     virtual bool isTMPrintable() = 0;
 
+    /**
+     * Indicates if the structural asymmetry parameter needs to be printed.
+     * \return true if the structural asymmetry parameter needs to be printed, false otherwise.
+     */
+    virtual bool isStructAsymParamPrintable() = 0;
+
     /**
      * Write the result via the FileWriter.
      */
@@ -0,0 +1,73 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+/**
+ * \file RotationMatrix.h
+ * \author Anthony Breant, Clement Poinsot, Jeremie Pantin, Mohamed Takhtoukh, Thomas Capet
+ * \version 1.0
+ * \date 17 october 2026
+ * \brief A rotation as a 3x3 matrix, built once and applied to many positions.
+ */
+
+#ifndef ROTATIONMATRIX_H
+#define ROTATIONMATRIX_H
+
+#include "Vector3D.h"
+
+class RotationMatrix
+{
+  public:
+    /**
+     * Constructs the identity.
+     */
+    RotationMatrix()
+    {
+      for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+          m[i][j] = (i == j) ? 1.0 : 0.0;
+        }
+      }
+    }
+
+    /**
+     * \return the rotation r then this rotation.
+     */
+    inline RotationMatrix operator * (const RotationMatrix& r) const
+    {
+      RotationMatrix p;
+      for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+          p.m[i][j] = m[i][0] * r.m[0][j] + m[i][1] * r.m[1][j] + m[i][2] * r.m[2][j];
+        }
+      }
+      return p;
+    }
+
+    /**
+     * \return the position v rotated.
+     */
+    inline Vector3D operator * (const Vector3D& v) const
+    {
+      return Vector3D(m[0][0] * v.x + m[0][1] * v.y + m[0][2] * v.z,
+                      m[1][0] * v.x + m[1][1] * v.y + m[1][2] * v.z,
+                      m[2][0] * v.x + m[2][1] * v.y + m[2][2] * v.z);
+    }
+
+  public:
+    /**
+     * Coefficients, m[row][column].
+     */
+    double m[3][3];
+};
+
+#endif // ROTATIONMATRIX_H
@@ -0,0 +1,51 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+#include "RunningMean.h"
+
+RunningMean::RunningMean()
+  : m_nbResults(0), m_sumEHSS(0.0), m_sumPA(0.0), m_sumTM(0.0),
+  m_sumStructAsymParam(0.0), m_sumStandardDeviation(0.0), m_sumNumberOfFailedTrajectories(0.0),
+  m_EHSSSaved(false), m_PASaved(false), m_TMSaved(false), m_EHSSPrintable(false),
+  m_PAPrintable(false), m_TMPrintable(false), m_structAsymParamPrintable(false)
+{
+
+}
+
+RunningMean::~RunningMean()
+{
+
+}
+
+void RunningMean::addResult(Result* r) {
+  if (m_nbResults == 0) {
+    m_EHSSSaved = r->isEHSSSaved();
+    m_PASaved = r->isPASaved();
+    m_TMSaved = r->isTMSaved();
+    m_EHSSPrintable = r->isEHSSPrintable();
+    m_PAPrintable = r->isPAPrintable();
+    m_TMPrintable = r->isTMPrintable();
+    m_structAsymParamPrintable = r->isStructAsymParamPrintable();
+  }
+  m_sumEHSS += r->getEHSS();
+  m_sumPA += r->getPA();
+  m_sumTM += r->getTM();
+  m_sumStructAsymParam += r->getStructAsymParam();
+  m_sumStandardDeviation += r->getStandardDeviation();
+  m_sumNumberOfFailedTrajectories += r->getNumberOfFailedTrajectories();
+  ++m_nbResults;
+}
+
+void RunningMean::accept(class FileWriter& fileWriter) {
+  fileWriter.visitMean(this);
+}
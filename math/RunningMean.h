@@ -0,0 +1,161 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+/**
+ * \file RunningMean.h
+ * \author Anthony Breant, Clement Poinsot, Jeremie Pantin, Mohamed Takhtoukh, Thomas Capet
+ * \version 1.0
+ * \date 17 october 2026
+ * \brief Implements a way of save mean of calculations results, without keeping them.
+ *
+ * The results are summed as soon as they are added, in the same order as
+ * StdMean, so that they can be destroyed while the means are still needed.
+ */
+
+#ifndef RUNNINGMEAN_H
+#define RUNNINGMEAN_H
+
+#include "Mean.h"
+
+#include "../writer/FileWriter.h"
+
+
+class RunningMean : public Mean
+{
+  public:
+    /**
+     * Constructor.
+     */
+    RunningMean();
+
+    /**
+     * Destructor.
+     */
+    virtual ~RunningMean();
+
+    /**
+     * Returns the mean of EHSS results.
+     * \return the mean of EHSS results, or 0 is !isEHSSSaved().
+     */
+    double getMeanEHSS() {return m_sumEHSS / m_nbResults;}
+
+    /**
+     * Returns the mean of PA results.
+     * \return the mean of PA results, or 0 is !isPASaved().
+     */
+    double getMeanPA() {return m_sumPA / m_nbResults;}
+
+    /**
+     * Returns the mean of TM results.
+     * \return the mean of TM results, or 0 is !isTMSaved().
+     */
+    double getMeanTM() {return m_sumTM / m_nbResults;}
+
+    /**
+     * Returns the mean of the structural asymmetry parameters.
+     * \return the mean of the structural asymmetry parameters.
+     */
+    double getMeanStructAsymParam() {return m_sumStructAsymParam / m_nbResults;}
+
+    /**
+     * Returns the mean of the standard deviations.
+     * \return the mean of the standard deviation.
+     */
+    double getMeanStandardDeviation() {return m_sumStandardDeviation / m_nbResults;}
+
+    /**
+     * Returns the mean of the numbers of failed trajectories.
+     * \return the mean of the numbers of failed trajectories.
+     */
+    int getMeanNumberOfFailedTrajectories() {return m_sumNumberOfFailedTrajectories / m_nbResults;}
+
+    /**
+     * \return true if EHSS was saved, false in the other case.
+     */
+    bool isEHSSSaved() {return m_EHSSSaved;}
+
+    /**
+     * \return true if PA was saved, false in the other case.
+     */
+    bool isPASaved() {return m_PASaved;}
+
+    /**
+     * \return true if TM was saved, false in the other case.
+     */
+    bool isTMSaved() {return m_TMSaved;}
+
+    /**
+     * Indicates if EHSS needs to be printed.
+     * \return true if EHSS needs to be printed, false otherwise.
+     */
+    bool isEHSSPrintable() {return m_EHSSPrintable;}
+
+    /**
+     * Indicates if PA needs to be printed.
+     * \return true if PA needs to be printed, false otherwise.
+     */
+    bool isPAPrintable() {return m_PAPrintable;}
+
+    /**
+     * Indicates if TM needs to be printed.
+     * \return true if TM needs to be printed, false otherwise.
+     */
+    bool isTMPrintable() {return m_TMPrintable;}
+
+    /**
+     * Indicates if the structural asymmetry parameter needs to be printed.
+     * \return true if the structural asymmetry parameter needs to be printed, false otherwise.
+     */
+    bool isStructAsymParamPrintable() {return m_structAsymParamPrintable;}
+
+    /**
+     * Adds a result to the sums used to calculate the means.
+     * The result is not kept.
+     * \param r the result to add.
+     */
+    void addResult(Result* r);
+
+    /**
+     * Write the mean object via the FileWriter.
+     */
+    void accept(class FileWriter& fileWriter);
+
+  private:
+    /**
+     * The number of results added.
+     */
+    unsigned int m_nbResults;
+
+    /**
+     * The sums of the results.
+     */
+    double m_sumEHSS;
+    double m_sumPA;
+    double m_sumTM;
+    double m_sumStructAsymParam;
+    double m_sumStandardDeviation;
+    double m_sumNumberOfFailedTrajectories;
+
+    /**
+     * What was saved and needs to be printed, taken from the first result.
+     */
+    bool m_EHSSSaved;
+    bool m_PASaved;
+    bool m_TMSaved;
+    bool m_EHSSPrintable;
+    bool m_PAPrintable;
+    bool m_TMPrintable;
+    bool m_structAsymParamPrintable;
+};
+
+#endif
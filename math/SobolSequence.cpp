@@ -0,0 +1,105 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+#include "SobolSequence.h"
+
+#include <string>
+
+namespace
+{
+  /**
+   * Direction numbers of the first coordinates (Joe and Kuo, 2008), for
+   * the 32 bits of the points.
+   */
+  struct DirectionNumbers {
+    uint32_t v[SobolSequence::m_MaxDimension][32];
+
+    DirectionNumbers() {
+      // Degre, coefficients et premiers entiers m des polynomes primitifs.
+      const unsigned int degrees[] = {1, 2, 3, 3};
+      const unsigned int coefficients[] = {0, 1, 1, 2};
+      const uint32_t m[][3] = {{1, 0, 0}, {1, 3, 0}, {1, 3, 1}, {1, 1, 1}};
+
+      // Premiere coordonnee : suite de van der Corput.
+      for (unsigned int b = 0; b < 32; ++b) {
+        v[0][b] = 1u << (31 - b);
+      }
+      for (unsigned int d = 1; d < SobolSequence::m_MaxDimension; ++d) {
+        const unsigned int s = degrees[d - 1];
+        const unsigned int a = coefficients[d - 1];
+        for (unsigned int b = 0; b < 32; ++b) {
+          if (b < s) {
+            v[d][b] = m[d - 1][b] << (31 - b);
+          } else {
+            v[d][b] = v[d][b - s] ^ (v[d][b - s] >> s);
+            for (unsigned int k = 1; k < s; ++k) {
+              if ((a >> (s - 1 - k)) & 1) {
+                v[d][b] ^= v[d][b - k];
+              }
+            }
+          }
+        }
+      }
+    }
+  };
+
+  const DirectionNumbers directionNumbers;
+
+  uint32_t reverseBits(uint32_t x)
+  {
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+    x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+    return (x >> 16) | (x << 16);
+  }
+
+  /**
+   * Nested uniform scrambling of the digits of x (Burley, 2020) : the
+   * permutation of a digit only depends on the digits before it.
+   */
+  uint32_t scramble(uint32_t x, uint32_t seed)
+  {
+    x = reverseBits(x);
+    x += seed;
+    x ^= x * 0x6C50B47Cu;
+    x ^= x * 0xB82F1E52u;
+    x ^= x * 0xC7AFE638u;
+    x ^= x * 0x8D22F6E6u;
+    return reverseBits(x);
+  }
+}
+
+SobolSequence::SobolSequence(unsigned int dimension, RandomStream& stream)
+  : m_dimension(dimension)
+{
+  if (dimension > m_MaxDimension) {
+    throw std::string("Too many coordinates for the Sobol points.");
+  }
+  for (unsigned int d = 0; d < m_MaxDimension; ++d) {
+    m_scrambleSeeds[d] = (uint32_t) (stream.getRandomNumber() * 4294967296.0);
+  }
+}
+
+void SobolSequence::getPoint(uint32_t index, double* point) const
+{
+  for (unsigned int d = 0; d < m_dimension; ++d) {
+    uint32_t x = 0;
+    for (unsigned int b = 0; b < 32 && (index >> b) != 0; ++b) {
+      if ((index >> b) & 1) {
+        x ^= directionNumbers.v[d][b];
+      }
+    }
+    point[d] = scramble(x, m_scrambleSeeds[d]) * (1.0 / 4294967296.0);
+  }
+}
@@ -0,0 +1,71 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+/**
+ * \file SobolSequence.h
+ * \author Anthony Breant, Clement Poinsot, Jeremie Pantin, Mohamed Takhtoukh, Thomas Capet
+ * \version 1.0
+ * \date 17 october 2026
+ * \brief Scrambled Sobol points, for randomized quasi-Monte-Carlo integration.
+ *
+ * The points of the Sobol sequence fill the unit hypercube more evenly than
+ * random points, so that an integral converges nearly as 1/n instead of
+ * 1/sqrt(n). Each coordinate is scrambled by a random nested permutation of
+ * its digits (Owen scrambling, hashed as Laine and Karras) : the points stay
+ * as even, but each of them is uniformly distributed, so the integrals are
+ * unbiased and independent scramblings give an estimate of their error.
+ */
+
+#ifndef SOBOLSEQUENCE_H
+#define SOBOLSEQUENCE_H
+
+#include "RandomStream.h"
+
+#include <array>
+#include <cstdint>
+
+class SobolSequence
+{
+  public:
+    /**
+     * Maximal number of coordinates of the points.
+     */
+    static const unsigned int m_MaxDimension = 5;
+
+    /**
+     * Constructs a scrambling of the sequence.
+     * \param dimension the number of coordinates of the points, at most m_MaxDimension.
+     * \param stream the random numbers drawing the scrambling of each coordinate.
+     */
+    SobolSequence(unsigned int dimension, RandomStream& stream);
+
+    /**
+     * Calculates a point of the scrambled sequence.
+     * \param index the index of the point in the sequence.
+     * \param point the dimension coordinates of the point, between 0 and 1 (1 excluded).
+     */
+    void getPoint(uint32_t index, double* point) const;
+
+  private:
+    /**
+     * Number of coordinates of the points.
+     */
+    unsigned int m_dimension;
+
+    /**
+     * Seeds of the scrambling of each coordinate.
+     */
+    std::array<uint32_t, m_MaxDimension> m_scrambleSeeds;
+};
+
+#endif // SOBOLSEQUENCE_H
@@ -0,0 +1,207 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+#include "SphereBVH.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+SphereBVH::SphereBVH(const std::vector<Vector3D>& centers, const std::vector<double>& radii)
+  : m_maxRadius(0.0)
+{
+  const unsigned int nbSpheres = centers.size();
+  std::vector<unsigned int> order(nbSpheres);
+  for (unsigned int i = 0; i < nbSpheres; ++i) {
+    order[i] = i;
+    m_maxRadius = std::max(m_maxRadius, radii[i]);
+  }
+
+  if (nbSpheres > 0) {
+    m_nodes.reserve(2 * (nbSpheres / m_LeafSize + 1));
+    build(order, centers, radii, 0, nbSpheres);
+  }
+
+  // Les spheres sont rangees dans l'ordre des feuilles.
+  m_x.resize(nbSpheres);
+  m_y.resize(nbSpheres);
+  m_z.resize(nbSpheres);
+  m_radius.resize(nbSpheres);
+  m_index = order;
+  for (unsigned int i = 0; i < nbSpheres; ++i) {
+    m_x[i] = centers[order[i]].x;
+    m_y[i] = centers[order[i]].y;
+    m_z[i] = centers[order[i]].z;
+    m_radius[i] = radii[order[i]];
+  }
+}
+
+SphereBVH::~SphereBVH()
+{
+
+}
+
+unsigned int SphereBVH::build(std::vector<unsigned int>& order, const std::vector<Vector3D>& centers,
+                              const std::vector<double>& radii, unsigned int first, unsigned int last)
+{
+  const unsigned int index = m_nodes.size();
+  m_nodes.push_back(Node());
+
+  // Boite englobant les spheres, et boite des centres pour le decoupage.
+  Node node;
+  double centerMin[3];
+  double centerMax[3];
+  for (int k = 0; k < 3; ++k) {
+    node.min[k] = centerMin[k] = std::numeric_limits<double>::max();
+    node.max[k] = centerMax[k] = -std::numeric_limits<double>::max();
+  }
+  for (unsigned int i = first; i < last; ++i) {
+    const Vector3D& c = centers[order[i]];
+    const double p[3] = {c.x, c.y, c.z};
+    for (int k = 0; k < 3; ++k) {
+      node.min[k] = std::min(node.min[k], p[k] - radii[order[i]]);
+      node.max[k] = std::max(node.max[k], p[k] + radii[order[i]]);
+      centerMin[k] = std::min(centerMin[k], p[k]);
+      centerMax[k] = std::max(centerMax[k], p[k]);
+    }
+  }
+  node.first = first;
+  node.count = last - first;
+  node.right = 0;
+
+  if (node.count > m_LeafSize) {
+    // On coupe a la mediane, selon l'axe ou les centres s'etendent le plus.
+    int axis = 0;
+    for (int k = 1; k < 3; ++k) {
+      if (centerMax[k] - centerMin[k] > centerMax[axis] - centerMin[axis]) {
+        axis = k;
+      }
+    }
+    const unsigned int middle = first + node.count / 2;
+    std::nth_element(order.begin() + first, order.begin() + middle, order.begin() + last,
+                     [&](unsigned int a, unsigned int b) {
+      const double pa = axis == 0 ? centers[a].x : (axis == 1 ? centers[a].y : centers[a].z);
+      const double pb = axis == 0 ? centers[b].x : (axis == 1 ? centers[b].y : centers[b].z);
+      return pa < pb || (pa == pb && a < b);
+    });
+
+    node.count = 0;
+    build(order, centers, radii, first, middle);
+    node.right = build(order, centers, radii, middle, last);
+  }
+
+  m_nodes[index] = node;
+  return index;
+}
+
+bool SphereBVH::intersectBox(const Node& node, const double origin[3], const double inverse[3],
+                             const double direction[3], double& tNear, double tFar) const
+{
+  for (int k = 0; k < 3; ++k) {
+    if (direction[k] == 0.0) {
+      // Ligne parallele aux faces : elle passe entre elles ou non.
+      if (origin[k] < node.min[k] || origin[k] > node.max[k]) {
+        return false;
+      }
+    } else {
+      double t1 = (node.min[k] - origin[k]) * inverse[k];
+      double t2 = (node.max[k] - origin[k]) * inverse[k];
+      if (t1 > t2) {
+        std::swap(t1, t2);
+      }
+      tNear = std::max(tNear, t1);
+      tFar = std::min(tFar, t2);
+    }
+  }
+  return tNear <= tFar;
+}
+
+int SphereBVH::firstHit(const Vector3D& origin, const Vector3D& direction, bool ahead, double& t) const
+{
+  if (m_nodes.empty()) {
+    return -1;
+  }
+
+  const double o[3] = {origin.x, origin.y, origin.z};
+  const double d[3] = {direction.x, direction.y, direction.z};
+  const double inverse[3] = {1.0 / d[0], 1.0 / d[1], 1.0 / d[2]};
+  const double dixPMoinsSix = pow(10, -6);
+
+  // Une sphere dont le centre est devant l'origine est touchee apres
+  // -rayon : les boites touchees avant ne sont pas parcourues.
+  const double tMin = ahead ? -m_maxRadius - dixPMoinsSix : -std::numeric_limits<double>::max();
+  double best = std::numeric_limits<double>::max();
+  int hit = -1;
+
+  // Parcours en profondeur, le fils le plus proche d'abord.
+  unsigned int stack[64];
+  int top = 0;
+  stack[top++] = 0;
+  while (top > 0) {
+    const Node& node = m_nodes[stack[--top]];
+    double tNear = tMin;
+    if (!intersectBox(node, o, inverse, d, tNear, best)) {
+      continue;
+    }
+
+    if (node.count > 0) {
+      for (unsigned int i = node.first; i < node.first + node.count; ++i) {
+        const double rx = m_x[i] - o[0];
+        const double ry = m_y[i] - o[1];
+        const double rz = m_z[i] - o[2];
+        // p : projection du centre sur la ligne, ras : carre de sa distance
+        // a la ligne.
+        const double p = rx * d[0] + ry * d[1] + rz * d[2];
+        if (ahead && p <= dixPMoinsSix) {
+          continue;
+        }
+        const double px = rx - p * d[0];
+        const double py = ry - p * d[1];
+        const double pz = rz - p * d[2];
+        const double ras = px * px + py * py + pz * pz;
+        const double rhs2 = m_radius[i] * m_radius[i];
+        if (ras <= rhs2) {
+          const double tCol = p - sqrt(rhs2 - ras);
+          if (tCol < best || (tCol == best && hit >= 0 && m_index[i] < m_index[hit])) {
+            best = tCol;
+            hit = i;
+          }
+        }
+      }
+    } else {
+      const unsigned int left = &node - &m_nodes[0] + 1;
+      const unsigned int right = node.right;
+      double tLeft = tMin;
+      double tRight = tMin;
+      const bool hitLeft = intersectBox(m_nodes[left], o, inverse, d, tLeft, best);
+      const bool hitRight = intersectBox(m_nodes[right], o, inverse, d, tRight, best);
+      // Le fils empile en dernier est parcouru en premier.
+      if (hitLeft && hitRight) {
+        if (tLeft <= tRight) {
+          stack[top++] = right;
+          stack[top++] = left;
+        } else {
+          stack[top++] = left;
+          stack[top++] = right;
+        }
+      } else if (hitLeft) {
+        stack[top++] = left;
+      } else if (hitRight) {
+        stack[top++] = right;
+      }
+    }
+  }
+
+  t = best;
+  return hit;
+}
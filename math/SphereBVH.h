@@ -0,0 +1,144 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+/**
+ * \file SphereBVH.h
+ * \author Anthony Breant, Clement Poinsot, Jeremie Pantin, Mohamed Takhtoukh, Thomas Capet
+ * \version 1.0
+ * \date 17 october 2026
+ * \brief Bounding volume hierarchy over hard spheres, to find the first sphere hit by a ray.
+ */
+
+#ifndef SPHEREBVH_H
+#define SPHEREBVH_H
+
+#include "Vector3D.h"
+
+#include <vector>
+
+class SphereBVH
+{
+  public:
+    /**
+     * Builds the hierarchy over spheres.
+     * \param centers the centers of the spheres.
+     * \param radii the radii of the spheres.
+     */
+    SphereBVH(const std::vector<Vector3D>& centers, const std::vector<double>& radii);
+
+    /**
+     * Destructor.
+     */
+    virtual ~SphereBVH();
+
+    /**
+     * \return the number of spheres.
+     */
+    unsigned int getNumberSpheres() const {
+      return m_radius.size();
+    }
+
+    /**
+     * Coordinates and radii of the spheres, in the order of the hierarchy
+     * (not the order given to the constructor).
+     */
+    const std::vector<double>& getX() const {
+      return m_x;
+    }
+    const std::vector<double>& getY() const {
+      return m_y;
+    }
+    const std::vector<double>& getZ() const {
+      return m_z;
+    }
+    const std::vector<double>& getRadius() const {
+      return m_radius;
+    }
+
+    /**
+     * Finds the first sphere hit by the line origin + t * direction. A sphere
+     * is hit at t = p - sqrt(r^2 - d^2), where p is the projection of its
+     * center on the line and d the distance from its center to the line.
+     * If several spheres are hit at the same t, the first given to the
+     * constructor is chosen.
+     * \param origin a point of the line.
+     * \param direction the direction of the line, normalized.
+     * \param ahead if true, only the spheres whose center is ahead of the
+     * origin (p > 10^-6) are considered.
+     * \param t the position of the hit on the line.
+     * \return the index of the sphere hit (in the order of the hierarchy),
+     * or -1 if no sphere is hit.
+     */
+    int firstHit(const Vector3D& origin, const Vector3D& direction, bool ahead, double& t) const;
+
+  private:
+    /**
+     * A box bounding the spheres first to first + count - 1. The left child
+     * of an inner node follows it, the right child is at index right.
+     */
+    struct Node {
+      double min[3];
+      double max[3];
+      unsigned int first;
+      unsigned int count;
+      unsigned int right;
+    };
+
+  private:
+    /**
+     * Builds the node bounding the spheres first to last - 1 of order.
+     * \return the index of the node.
+     */
+    unsigned int build(std::vector<unsigned int>& order, const std::vector<Vector3D>& centers,
+                       const std::vector<double>& radii, unsigned int first, unsigned int last);
+
+    /**
+     * Intersects the line with the box of a node.
+     * \param tNear lowest t considered, then t where the line enters the box.
+     * \param tFar highest t considered.
+     * \return false if the line misses the box between tNear and tFar.
+     */
+    bool intersectBox(const Node& node, const double origin[3], const double inverse[3],
+                      const double direction[3], double& tNear, double tFar) const;
+
+  private:
+    /**
+     * Maximal number of spheres in a leaf.
+     */
+    static const unsigned int m_LeafSize = 4;
+
+    /**
+     * Nodes of the hierarchy, the root first.
+     */
+    std::vector<Node> m_nodes;
+
+    /**
+     * Coordinates and radii of the spheres.
+     */
+    std::vector<double> m_x;
+    std::vector<double> m_y;
+    std::vector<double> m_z;
+    std::vector<double> m_radius;
+
+    /**
+     * Index given to the constructor of each sphere.
+     */
+    std::vector<unsigned int> m_index;
+
+    /**
+     * Largest radius.
+     */
+    double m_maxRadius;
+};
+
+#endif // SPHEREBVH_H
@@ -14,19 +14,27 @@
 #include "StdCalculationOperator.h"
 
 #include "../general/AtomInformations.h"
-#include "../molecule/StdMolecule.h"
-#include "../molecule/StdAtom.h"
+#include "../general/GlobalParameters.h"
+#include "../general/SystemParameters.h"
 #include "StdResult.h"
 #include "MathLib.h"
 #include "StdMathLib.h"
 #include "RandomGenerator.h"
-
+#include "RandomStream.h"
+#include "SobolSequence.h"
+#include "ProjectedAreaRasterizer.h"
+#include "StdPotentialEngine.h"
+#include "CellListPotentialEngine.h"
+#include "GridPotentialEngine.h"
+
+#include <algorithm>
 #include <cmath>
 #include <array>
 #include <vector>
 #include <string>
 #include <iostream>
 #include <cstdlib>
+#include <limits>
 
 #include <boost/math/special_functions/pow.hpp>
 
@@ -36,6 +44,75 @@
 
 #define ANGSTROMTOMETER (1e-10)
 
+namespace
+{
+  /**
+   * Relative standard error of the mean of the n first values, in percents.
+   * \return infinity if n < 2.
+   */
+  double relativeStandardError(const std::vector<double>& values, int n)
+  {
+    if (n < 2) {
+      return std::numeric_limits<double>::infinity();
+    }
+    double mean = 0.0;
+    for (int i = 0; i < n; ++i) {
+      mean += values[i];
+    }
+    mean /= n;
+    double variance = 0.0;
+    for (int i = 0; i < n; ++i) {
+      variance += (values[i] - mean) * (values[i] - mean);
+    }
+    variance /= n - 1;
+    return 100.0 * sqrt(variance / n) / mean;
+  }
+
+  /**
+   * Mass (u) and polarizability (cubic angstroms) of a buffer gas.
+   */
+  void getBufferGasProperties(BufferGas gas, double& mass, double& polarizability)
+  {
+    switch (gas) {
+    case BufferGas::N2:
+    case BufferGas::UFF_N2:
+      mass = 28.0134;
+      polarizability = 1.7403;
+      break;
+    default:
+      mass = 4.0026;
+      polarizability = 0.204956;
+      break;
+    }
+  }
+
+  /**
+   * EOLJ (meV) and ROLJ (angstroms) of an element with a buffer gas.
+   */
+  void getLennardJones(const AtomInformations* atomInf, unsigned short id, BufferGas gas,
+                       double& eolj, double& rolj)
+  {
+    switch (gas) {
+    case BufferGas::N2:
+      eolj = atomInf->getEOLJN2(id);
+      rolj = atomInf->getROLJN2(id);
+      break;
+    case BufferGas::UFF_HE:
+      eolj = atomInf->getEOLJUFFHe(id);
+      rolj = atomInf->getROLJUFFHe(id);
+      break;
+    case BufferGas::UFF_N2:
+      eolj = atomInf->getEOLJUFFN2(id);
+      rolj = atomInf->getROLJUFFN2(id);
+      break;
+    default:
+      eolj = atomInf->getEOLJHe(id);
+      rolj = atomInf->getROLJHe(id);
+      break;
+    }
+  }
+}
+
 /**
  * Maximum of successive reflections followed.
  */
@@ -43,14 +120,6 @@ const int StdCalculationOperator::m_MaxSuccRefl = 30;
 
 
 /// TM
-// dipol in Mobcal.
-// Polarizability of Helium = 0.204956 * 10^-30 m^3.
-// Permitivity of vacuum = 8.854187817 * 10^-12 F.m^-1.
-// xe = 1.60217733 * 10^-19.
-const double StdCalculationOperator::m_IonInducedDipolePotential =
-  (0.204956 * pow(10, -30) / (8.0 * M_PI * 8.854187817 * pow(10, -12)))
-    * pow(1.60217733 * pow(10, -19), 2);
-
 const double StdCalculationOperator::m_XeFromMobcal =
   1.60217733 * pow(10, -19);
 
@@ -72,6 +141,20 @@ const int StdCalculationOperator::m_NbIntegrationStep = 1;
 // cmin dans Mobcal.
 const double StdCalculationOperator::m_MaxImpactParameter = 0.0005;
 
+std::map<std::pair<double, int>, StdCalculationOperator::VelocityPoints> StdCalculationOperator::m_velocityPointsCache;
+std::mutex StdCalculationOperator::m_velocityPointsMutex;
+
+std::map<BufferGas, std::vector<int> > StdCalculationOperator::m_b2maxProfiles;
+std::mutex StdCalculationOperator::m_b2maxProfilesMutex;
+
+// Les vitesses relatives de l'integration restent sous sqrt(20) fois
+// la vitesse thermique.
+const double StdCalculationOperator::m_MaxCollisionEnergy = 20.0;
+
+// Les cellules touchant un noeud plafonne restent au-dessus de l'energie
+// des collisions.
+const double StdCalculationOperator::m_GridMaxPotential = 1000.0;
+
 
 // Constantes globales pour diffeq.
 const double var = 2.97013888888;
@@ -109,6 +192,37 @@ const double amcc[] = {
   -0.55921513665
 };
 
+// Coefficients de Dormand-Prince 5(4) : noeuds, matrice de Runge-Kutta
+// (la derniere ligne donne la solution d'ordre 5) et difference avec
+// la solution d'ordre 4.
+const double dpc[] = {
+  0.0,
+  1.0 / 5.0,
+  3.0 / 10.0,
+  4.0 / 5.0,
+  8.0 / 9.0,
+  1.0,
+  1.0
+};
+const double dpa[7][6] = {
+  {0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+  {1.0 / 5.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+  {3.0 / 40.0, 9.0 / 40.0, 0.0, 0.0, 0.0, 0.0},
+  {44.0 / 45.0, -56.0 / 15.0, 32.0 / 9.0, 0.0, 0.0, 0.0},
+  {19372.0 / 6561.0, -25360.0 / 2187.0, 64448.0 / 6561.0, -212.0 / 729.0, 0.0, 0.0},
+  {9017.0 / 3168.0, -355.0 / 33.0, 46732.0 / 5247.0, 49.0 / 176.0, -5103.0 / 18656.0, 0.0},
+  {35.0 / 384.0, 0.0, 500.0 / 1113.0, 125.0 / 192.0, -2187.0 / 6784.0, 11.0 / 84.0}
+};
+const double dpe[] = {
+  71.0 / 57600.0,
+  0.0,
+  -71.0 / 16695.0,
+  71.0 / 1920.0,
+  -17253.0 / 339200.0,
+  22.0 / 525.0,
+  -1.0 / 40.0
+};
+
 
 
 
@@ -124,18 +238,79 @@ StdCalculationOperator::StdCalculationOperator(CalculationState* calculationStat
                                                double numberPointsMCIntegrationTM,
                                                double energyConservationThreshold,
                                                double numberPointsMCIntegrationEHSSPA)
-  : m_calculationState(calculationState), m_mol(mol), m_maxROLJ(0.0), m_temperature(temperature),
-  m_potentialEnergyStart(potentialEnergyStart), m_numberCyclesTM(numberCyclesTM),
-  m_numberPointsVelocity(numberPointsVelocity), m_numberPointsMCIntegrationTM(numberPointsMCIntegrationTM),
-  m_numberPointsMCIntegrationEHSSPA(numberPointsMCIntegrationEHSSPA), m_timeStepStart(timeStepStart),
+  : m_calculationState(calculationState), m_mol(mol), m_temperature(temperature),
+  m_numberCyclesTM(numberCyclesTM), m_numberPointsVelocity(numberPointsVelocity),
+  m_numberPointsMCIntegrationTM(numberPointsMCIntegrationTM),
+  m_numberPointsMCIntegrationEHSSPA(numberPointsMCIntegrationEHSSPA), m_maxROLJ(0.0),
+  m_asymmetryParameterCalculated(true), m_bufferGases(GlobalParameters::getInstance()->getBufferGases()),
+  m_potentialEnergyStart(potentialEnergyStart), m_timeStepStart(timeStepStart),
   m_potentialEnergyCloseCollision(potentialEnergyCloseCollision),
-  m_timeStepCloseCollision(timeStepCloseCollision), m_energyConservationThreshold(energyConservationThreshold)
+  m_timeStepCloseCollision(timeStepCloseCollision), m_energyConservationThreshold(energyConservationThreshold),
+  m_potentialEngine(nullptr),
+  m_integrator(GlobalParameters::getInstance()->getTrajectoryIntegrator()),
+  m_integratorTolerance(GlobalParameters::getInstance()->getIntegratorTolerance()),
+  m_TMStandardErrorTarget(GlobalParameters::getInstance()->getTMStandardErrorTarget()),
+  m_b2maxWarmStart(GlobalParameters::getInstance()->isB2maxWarmStart()),
+  m_temperatureSweep(GlobalParameters::getInstance()->getTemperatureSweep()),
+  m_samplingMethod(GlobalParameters::getInstance()->getSamplingMethod()),
+  m_nbReplicatesQMC(GlobalParameters::getInstance()->getNbReplicatesQMC()),
+  m_nbIntegratedTrajectories(0), m_nbIntegrationSteps(0), m_nbPotentialCalculations(0),
+  m_nbFailedTrajectories(0), m_seed(RandomGenerator::getInstance()->getSeed()), m_geometryIndex(0),
+  m_checkpointRestored(false)
 {
   m_result = new StdResult(m_mol);
 
+  m_initAxes.push_back(Vector3D(1.0, 0.0, 0.0));
+  m_initAxes.push_back(Vector3D(0.0, 1.0, 0.0));
+  m_initAxes.push_back(Vector3D(0.0, 0.0, 1.0));
+
+  selectBufferGas(0, nullptr);
+}
+
+StdCalculationOperator::~StdCalculationOperator()
+{
+  delete m_potentialEngine;
+
+  // Le résultat perdure car récupéré en amont.
+  m_calculationState->oneCalculationFinished();
+}
+
+std::string StdCalculationOperator::getBufferGasName(BufferGas gas)
+{
+  switch (gas) {
+  case BufferGas::N2:
+    return "n2";
+  case BufferGas::UFF_HE:
+    return "uffhe";
+  case BufferGas::UFF_N2:
+    return "uffn2";
+  default:
+    return "he";
+  }
+}
+
+bool StdCalculationOperator::findBufferGas(const std::string& name, BufferGas& gas)
+{
+  const BufferGas gases[] = {BufferGas::HE, BufferGas::N2, BufferGas::UFF_HE, BufferGas::UFF_N2};
+  for (unsigned int i = 0; i < sizeof(gases) / sizeof(gases[0]); ++i) {
+    if (name == getBufferGasName(gases[i])) {
+      gas = gases[i];
+      return true;
+    }
+  }
+  return false;
+}
+
+void StdCalculationOperator::selectBufferGas(unsigned int index, const MoleculeData* data)
+{
+  m_bufferGasIndex = index;
+  const BufferGas gas = m_bufferGases[index];
+  double polarizability;
+  getBufferGasProperties(gas, m_bufferGasMass, polarizability);
+
   // Calcul de la constante de mobilité.
-  const double m1 = 4.0026;
-  const double m2 = mol->getTotalMass();
+  const double m1 = m_bufferGasMass;
+  const double m2 = m_mol->getTotalMass();
   const double xn = 6.0221367 * boost::math::pow<23>(10);
 
   // mu dans Mobcal.
@@ -147,12 +322,33 @@ StdCalculationOperator::StdCalculationOperator(CalculationState* calculationStat
   m_mobilityConstant *= m_XeFromMobcal / sqrt(m_XkFromMobcal);
   double dens = xn / m_XmvFromMobcal;
   m_mobilityConstant /= dens;
-}
 
-StdCalculationOperator::~StdCalculationOperator()
-{
-  // Le résultat perdure car récupéré en amont.
-  m_calculationState->oneCalculationFinished();
+  // dipol dans Mobcal.
+  // Permitivity of vacuum = 8.854187817 * 10^-12 F.m^-1.
+  // xe = 1.60217733 * 10^-19.
+  m_ionInducedDipolePotential = (polarizability * pow(10, -30) / (8.0 * M_PI * 8.854187817 * pow(10, -12)))
+    * pow(1.60217733 * pow(10, -19), 2);
+
+  if (data == nullptr) {
+    return;
+  }
+
+  // Parametres des atomes avec ce gaz. EOLJ et ROLJ sont convertis en metres.
+  AtomInformations* atomInf = AtomInformations::getInstance();
+  m_EOLJTab.clear();
+  m_ROLJTab.clear();
+  m_maxROLJ = 0.0;
+  for (unsigned int i = 0; i < data->size(); ++i) {
+    double eolj;
+    double rolj;
+    getLennardJones(atomInf, data->getElementId(i), gas, eolj, rolj);
+    m_EOLJTab.push_back(eolj * m_XeFromMobcal * boost::math::pow<-3>(10));
+    rolj *= ANGSTROMTOMETER;
+    m_ROLJTab.push_back(rolj);
+    if (rolj > m_maxROLJ) {
+      m_maxROLJ = rolj;
+    }
+  }
 }
 
 /**
@@ -160,50 +356,36 @@ StdCalculationOperator::~StdCalculationOperator()
  */
 void StdCalculationOperator::runEHSSAndPA()
 {
-  // Préparation d'une molécule pour le calcul, à partir
-  // de la molécule originelle.
+  // EHSS et PA deja calcules avant une interruption.
+  restoreCheckpoint();
+  if (m_checkpoint.hardSpheres) {
+    m_calculationState->setEHSSStarted();
+    m_calculationState->setPAStarted();
+    m_calculationState->setEHSSResult(m_result->getEHSS());
+    m_calculationState->setEHSSEnded();
+    m_calculationState->setPAResult(m_result->getPA());
+    m_calculationState->setPAEnded();
+    return;
+  }
 
-  // Outil mathématique.
-  MathLib* mathLib = new StdMathLib();
-    // Acces aux donnees de la base de donnees.
-  AtomInformations* atomInf = AtomInformations::getInstance();
-  // Centre de masse de la molécule :
-  Vector3D massCenter = mathLib->calculateMassCenter(*m_mol);
+  // Preparation d'une copie des atomes pour le calcul, centree sur le
+  // centre de masse de la molecule originelle.
+  StdMathLib mathLib;
+  MoleculeData data(m_mol->getData());
+  Vector3D massCenter = mathLib.calculateMassCenter(data);
+  data.translate(Vector3D(-massCenter.x, -massCenter.y, -massCenter.z));
 
+  // Enregistrement du RHS pour l'acceleration des calculs.
+  AtomInformations* atomInf = AtomInformations::getInstance();
   m_rhsTab.clear();
+  for (unsigned int i = 0; i < data.size(); ++i) {
+    m_rhsTab.push_back(atomInf->getHSRadius(data.getElementId(i)));
+  }
+
+  calculateEHSSAndPA(data);
 
-  Molecule* newMol = new StdMolecule();
-  // On recupere la vectore des atomes de la molecule à étudier.
-  std::vector<Atom*> atoms = *(m_mol->getAllAtoms());
-  // On parcourt tous les atomes.
-  for (unsigned int i = 0; i < atoms.size(); ++i) {
-    // On extrait la position de l'atome.
-    Vector3D* pos = atoms[i]->getPosition();
-    // On extrait le symbole de l'atome.
-    std::string symb = atoms[i]->getSymbol();
-    // On extrait la charge de l'atome.
-    double charge = atoms[i]->getCharge();
-
-    // Pour chacun des atomes, on va rajouter un nouvelle atome
-    // à la copie de la molécule avec comme position :
-    // x_newMol = (pos.x - massCenter.x) * 10^-10
-    // y_newMol = (pos.y - massCenter.y) * 10^-10
-    // z_newMol = (pos.z - massCenter.z) * 10^-10
-    newMol->addAtom(new StdAtom(new Vector3D((pos->x - massCenter.x),
-                                             (pos->y - massCenter.y),
-                                             (pos->z - massCenter.z)),
-                                symb,
-                                charge));
-
-    // Enregistremen du RHS pour l'accélération des calculs.
-    m_rhsTab.push_back(atomInf->getHSRadius(atoms[i]->getSymbol()));
-  }
-
-  delete mathLib;
-
-  calculateEHSSAndPA(newMol);
-
-  delete newMol;
+  m_checkpoint.hardSpheres = true;
+  saveCheckpoint();
 }
 
 /**
@@ -211,189 +393,248 @@ void StdCalculationOperator::runEHSSAndPA()
  */
 void StdCalculationOperator::runTM()
 {
-  // Preparation d'une molecule pour le calcul, a partir
-  // de la molecule originelle.
+  // TM deja calcule avant une interruption.
+  restoreCheckpoint();
+  if (m_checkpoint.finished) {
+    m_calculationState->setTMStarted();
+    m_calculationState->setTMResult(m_result->getTM());
+    m_calculationState->setTMEnded();
+    return;
+  }
+
+  // Preparation d'une copie des atomes pour le calcul, a partir
+  // de la molecule originelle :
+  // x = (pos.x - massCenter.x) * 10^-10
+  // y = (pos.y - massCenter.y) * -10^-10
+  // z = (pos.z - massCenter.z) * -10^-10
+  StdMathLib mathLib;
+  MoleculeData data(m_mol->getData());
+  Vector3D massCenter = mathLib.calculateMassCenter(data);
+  data.translate(Vector3D(-massCenter.x, -massCenter.y, -massCenter.z));
+  data.scale(ANGSTROMTOMETER, ANGSTROMTOMETER * -1, ANGSTROMTOMETER * -1);
 
-  // Outil mathematique.
-  MathLib* mathLib = new StdMathLib();
-    // Acces aux donnees de la base de donnees.
   AtomInformations* atomInf = AtomInformations::getInstance();
-  // Centre de masse de la molecule :
-  Vector3D massCenter = mathLib->calculateMassCenter(*m_mol);
 
   m_rhsTab.clear();
-
-  Molecule* newMol = new StdMolecule();
-  // On recupere la vectore des atomes de la molecule a etudier.
-  std::vector<Atom*> atoms = *(m_mol->getAllAtoms());
-  // On parcourt tous les atomes.
-  for (unsigned int i = 0; i < atoms.size(); ++i) {
-    // On extrait la position de l'atome.
-    Vector3D* pos = atoms[i]->getPosition();
-    // On extrait le symbole de l'atome.
-    std::string symb = atoms[i]->getSymbol();
-    // On extrait la charge de l'atome.
-    double charge = atoms[i]->getCharge();
-
-    // Pour chacun des atomes, on va rajouter un nouvelle atome
-    // a la copie de la molecule avec comme position :
-    // x_newMol = (pos.x - massCenter.x) * 10^-10
-    // y_newMol = (pos.y - massCenter.y) * 10^-10
-    // z_newMol = (pos.z - massCenter.z) * 10^-10
-    newMol->addAtom(new StdAtom(new Vector3D((pos->x - massCenter.x) * ANGSTROMTOMETER,
-                                             (pos->y - massCenter.y) * ANGSTROMTOMETER * -1,
-                                             (pos->z - massCenter.z) * ANGSTROMTOMETER * -1),
-                                symb,
-                                charge));
-
-    // Enregistremen du RHS pour l'acceleration des calculs.
-    m_rhsTab.push_back(atomInf->getHSRadius(atoms[i]->getSymbol()));
-    // Enregistremen de EOLJ pour l'acceleration des calculs.
-    // Conversion en mÃ¨tres.
-    double eolj = atomInf->getEOLJHe(atoms[i]->getSymbol()) * m_XeFromMobcal * boost::math::pow<-3>(10);
-    m_EOLJTab.push_back(eolj);
-    // Enregistremen de ROLJ pour l'acceleration des calculs.
-    // Conversion en mÃ¨tres.
-    double rolj = atomInf->getROLJHe(atoms[i]->getSymbol()) * ANGSTROMTOMETER;
-    m_ROLJTab.push_back(rolj);
-    if (rolj > m_maxROLJ) {
-      m_maxROLJ = rolj;
-    }
-  }
-
   m_molInitPos.clear();
   m_molPos.clear();
   m_molChg.clear();
 
-  // On ajoute les positions et les charges de la molecule dans les tableaux en attribut.
-  std::vector<Atom*> atoms2 = *(newMol->getAllAtoms());
-  for (int i = 0; i < atoms2.size(); ++i) {
-    m_molInitPos.push_back(*(atoms2[i]->getPosition()));
-    m_molPos.push_back(*(atoms2[i]->getPosition()));
-    m_molChg.push_back(atoms2[i]->getCharge());
+  // On ajoute les positions et les charges des atomes dans les tableaux
+  // en attribut, communs a tous les gaz.
+  for (unsigned int i = 0; i < data.size(); ++i) {
+    m_rhsTab.push_back(atomInf->getHSRadius(data.getElementId(i)));
+    m_molInitPos.push_back(data.getPosition(i));
+    m_molChg.push_back(data.getCharges()[i]);
+  }
+  m_molNbAtoms = data.size();
+  m_molMass = data.getTotalMass();
+
+  // Le parametre d'asymetrie ne depend que des positions.
+  if (m_asymmetryParameterCalculated) {
+    calculateAsymmetryParameter();
+
+    // On enregistre le parametre d'asymetrie dans les resultats.
+    m_result->setStructAsymParam(m_asymmetryParameter);
+  }
+
+  m_nbIntegratedTrajectories = 0;
+  m_nbIntegrationSteps = 0;
+  m_nbPotentialCalculations = 0;
+  m_nbFailedTrajectories = 0;
+
+  // Reprise : les gaz termines avant l'interruption sont dans les resultats,
+  // et les compteurs reprennent a la fin du dernier cycle enregistre.
+  const bool resumed = m_checkpoint.tmStarted;
+  unsigned int firstGas = 0;
+  if (resumed) {
+    firstGas = m_checkpoint.tm.bufferGasIndex;
+    m_nbIntegratedTrajectories = m_checkpoint.tm.nbIntegratedTrajectories;
+    m_nbIntegrationSteps = m_checkpoint.tm.nbIntegrationSteps;
+    m_nbPotentialCalculations = m_checkpoint.tm.nbPotentialCalculations;
+    m_nbFailedTrajectories = m_checkpoint.tm.nbFailedTrajectories;
   }
-  m_molNbAtoms = atoms2.size();
-  m_molMass = newMol->getTotalMass();
 
+  // On met a jour le CalculationState.
+  m_calculationState->setTMStarted();
+  m_calculationState->addFinishedTrajectories(firstGas * m_numberCyclesTM * m_numberPointsVelocity * m_numberPointsMCIntegrationTM);
+
+  // Chaque gaz reprend les memes tirages des orientations et des parametres
+  // d'impact : seuls les parametres des atomes, la masse et la polarisabilite
+  // du gaz changent.
+  try {
+    for (unsigned int k = firstGas; k < m_bufferGases.size(); ++k) {
+      selectBufferGas(k, &data);
+      m_molPos = m_molInitPos;
+
+      // Le moteur de potentiel garde ses propres tableaux de coordonnees.
+      delete m_potentialEngine;
+      m_potentialEngine = createPotentialEngine();
+      if (k == 0 && !resumed && m_potentialEngine->isApproximated()) {
+        estimatePotentialError();
+      }
 
-  delete mathLib;
+      calculateTM();
+    }
+  } catch (...) {
+    // Le thread de progression ne doit pas notifier apres une erreur.
+    m_calculationState->stopReporter();
+    throw;
+  }
 
-  calculateAsymmetryParameter();
+  // Les constantes du premier gaz restent celles des resultats principaux.
+  selectBufferGas(0, &data);
 
-  // On enregistre le parametre d'asymetrie dans les resultats.
-  m_result->setStructAsymParam(m_asymmetryParameter);
+  // On met a jour le CalculationState.
+  m_calculationState->setTMResult(m_result->getTM());
+  m_calculationState->setTMEnded();
 
-  calculateTM();
+  m_result->setNumberOfFailedTrajectories(m_nbFailedTrajectories);
 
-  delete newMol;
+  if (m_nbIntegratedTrajectories > 0) {
+    m_result->setTrajectoryStatistics((double) m_nbIntegrationSteps / m_nbIntegratedTrajectories,
+                                      (double) m_nbPotentialCalculations / m_nbIntegratedTrajectories);
+  }
 }
 
 /**
  * Calculate EHSS and PA and put the results in
  * m_result attribute.
  */
-void StdCalculationOperator::calculateEHSSAndPA(Molecule* mol)
+void StdCalculationOperator::calculateEHSSAndPA(const MoleculeData& data)
 {
   // On met a jour le CalculationState.
   m_calculationState->setEHSSStarted();
   m_calculationState->setPAStarted();
 
-  // Stocke les cosinus des "moitiés" d'angle entre les vecteurs
-  // d'incidence et les vecteurs de reflexion (par collisions
-  // successives le long d'une trajectoire unique).
-  std::array<double, StdCalculationOperator::m_MaxSuccRefl + 1> halfCos;
-  // Initialise le tableau des CCS à zéro.
-  std::array<double, StdCalculationOperator::m_MaxSuccRefl + 1> ccsArray;
-
-  // Initialisation des deux tableaux à 0.
-  for (int i = 0; i < StdCalculationOperator::m_MaxSuccRefl + 1; ++i) {
-    halfCos[i] = 0.0;
-    ccsArray[i] = 0.0;
+  // Spheres dures des atomes, que les trajectoires ne deplacent pas.
+  std::vector<Vector3D> initPos;
+  initPos.reserve(data.size());
+  for (unsigned int i = 0; i < data.size(); ++i) {
+    initPos.push_back(data.getPosition(i));
+  }
+  SphereBVH bvh(initPos, m_rhsTab);
+
+  // Les trajectoires sont calculees par groupes, dont les sommes sont
+  // additionnees dans l'ordre, comme avec plusieurs threads.
+  const unsigned int nbPoints = m_numberPointsMCIntegrationEHSSPA;
+  const unsigned int chunkSize = m_HardSphereChunkSize;
+  const unsigned int nbChunks = (nbPoints + chunkSize - 1) / chunkSize;
+  std::vector<HardSphereSums> sums(nbChunks);
+  for (unsigned int chunk = 0; chunk < nbChunks; ++chunk) {
+    const unsigned int first = chunk * chunkSize;
+    calculateHardSphereTrajectories(bvh, first, std::min(chunkSize, nbPoints - first), sums[chunk]);
   }
 
-  // La projection ("hard-sphere cross-section").
-  double projection = 0.0;
+  finishEHSSAndPA(bvh, sums);
+}
+
+void StdCalculationOperator::calculateHardSphereTrajectories(const SphereBVH& bvh, unsigned int first, unsigned int n, HardSphereSums& sums)
+{
+  const unsigned int nbAtoms = bvh.getNumberSpheres();
+  const double* x = bvh.getX().data();
+  const double* y = bvh.getY().data();
+  const double* z = bvh.getZ().data();
+  const double* rhsTab = bvh.getRadius().data();
+
+  sums.ccs.assign(StdCalculationOperator::m_MaxSuccRefl + 1, 0.0);
+  sums.projection = 0.0;
   // Le plus grand ordre rencontré pour n'importe quelle trajectoire.
-  int highestCollOrder = 1;
+  sums.highestCollOrder = 1;
+
+  // Avec les points de Sobol, la trajectoire i suit le point i / R de la
+  // replique i % R, chacune des R repliques brouillant la suite autrement.
+  const bool sobol = m_samplingMethod == SamplingMethod::SOBOL;
+  const unsigned int nbReplicates = getNumberReplicatesQMC();
+  std::vector<SobolSequence> sobolSequences;
+  if (sobol) {
+    for (unsigned int r = 0; r < nbReplicates; ++r) {
+      RandomStream scrambling(m_seed, m_geometryIndex, m_EHSSPAStream, r, m_ScramblingStream);
+      sobolSequences.push_back(SobolSequence(5, scrambling));
+    }
+    sums.replicateCCS.assign(nbReplicates, 0.0);
+    sums.replicateProjection.assign(nbReplicates, 0.0);
+  }
 
-  // Un objet pour manipuler les fonctions mathématiques.
-  MathLib* mathLib = new StdMathLib();
-
-  // On détermine les extrémités sur l'axe des y et des z de
-  // la boîte.
-  double ymin = 0.0;
-  double ymax = 0.0;
-  double zmin = 0.0;
-  double zmax = 0.0;
-
-  Vector3D pos;
-  double rhs;
-  double y1;
-  double y2;
-  double z1;
-  double z2;
-  double yDim;
-  double zDim;
-  double area;
-  double yRand;
-  double zRand;
+  // Stocke les cosinus des "moitiés" d'angle entre les vecteurs
+  // d'incidence et les vecteurs de reflexion (par collisions
+  // successives le long d'une trajectoire unique).
+  std::vector<double> halfCos(StdCalculationOperator::m_MaxSuccRefl + 1, 0.0);
 
+  // Un objet pour manipuler les fonctions mathématiques.
+  StdMathLib mathLib;
+  const std::vector<Vector3D> initAxes = {Vector3D(1.0, 0.0, 0.0), Vector3D(0.0, 1.0, 0.0), Vector3D(0.0, 0.0, 1.0)};
+  std::vector<Vector3D> axes(initAxes);
 
   // Début de l'intégration de Monte-Carlo.
-  for (int i = 0; i < m_numberPointsMCIntegrationEHSSPA; ++i) {
-    // Rotation aléatoire.
-    mathLib->randomRotation(mol);
-
-    // On recupere la vectore des atomes de la molecule à étudier.
-    std::vector<Atom*> atoms = *(mol->getAllAtoms());
-    // On parcourt tous les atomes.
-    for (unsigned int i = 0; i < atoms.size(); ++i) {
-      // On extrait la position de l'atome.
-      pos = *(atoms[i]->getPosition());
-      // On extrait le RHS de l'atome.
-      rhs = m_rhsTab[i];
-
-      y1 = pos.y + rhs;
-      y2 = pos.y - rhs;
-      z1 = pos.z + rhs;
-      z2 = pos.z - rhs;
-
-      // On actualise les cotés de la boite si on a trouvé une position plus
-      // lointaine que les précédentes.
-      if (y1 > ymax)
-        ymax = y1;
-      if (y2 < ymin)
-        ymin = y2;
-      if (z1 > zmax)
-        zmax = z1;
-      if (z2 < zmin)
-        zmin = z2;
+  for (unsigned int i = first; i < first + n; ++i) {
+    // Nombres aleatoires propres a ce point.
+    RandomStream stream(m_seed, m_geometryIndex, m_EHSSPAStream, 0, i);
+    double u[5];
+    if (sobol) {
+      sobolSequences[i % nbReplicates].getPoint(i / nbReplicates, u);
+    } else {
+      u[0] = stream.getRandomNumber();
+      u[1] = stream.getRandomNumber();
+      u[2] = stream.getRandomNumber();
+    }
+
+    // Rotation aléatoire : images des axes. Plutot que de tourner les
+    // atomes, on tourne le rayon en sens inverse : le rayon suit l'axe des x
+    // du repere tourne, dans lequel un atome p est en
+    // p.x * axes[0] + p.y * axes[1] + p.z * axes[2].
+    mathLib.rotate(mathLib.calculateUniformRotationMatrix(u[0], u[1], u[2]), initAxes, axes);
+    const Vector3D ax = axes[0];
+    const Vector3D ay = axes[1];
+    const Vector3D az = axes[2];
+
+    // On détermine les extrémités sur l'axe des y et des z de
+    // la boîte, dans le repere tourne.
+    double ymin = 0.0;
+    double ymax = 0.0;
+    double zmin = 0.0;
+    double zmax = 0.0;
+    #pragma omp simd reduction(min:ymin,zmin) reduction(max:ymax,zmax)
+    for (unsigned int a = 0; a < nbAtoms; ++a) {
+      const double ya = x[a] * ax.y + y[a] * ay.y + z[a] * az.y;
+      const double za = x[a] * ax.z + y[a] * ay.z + z[a] * az.z;
+      ymax = std::max(ymax, ya + rhsTab[a]);
+      ymin = std::min(ymin, ya - rhsTab[a]);
+      zmax = std::max(zmax, za + rhsTab[a]);
+      zmin = std::min(zmin, za - rhsTab[a]);
     }
 
     // yDim et zDim sont les longueurs des cotés de la boite.
-    yDim = ymax - ymin;
-    zDim = zmax - zmin;
+    double yDim = ymax - ymin;
+    double zDim = zmax - zmin;
     // L'aire de la boite.
-    area = yDim * zDim;
+    double area = yDim * zDim;
 
     // On tire des coordonnées aléatoires dans la boite.
-    yRand = ymin + yDim * RandomGenerator::getInstance()->getRandomNumber();
-    zRand = zmin + zDim * RandomGenerator::getInstance()->getRandomNumber();
-
-    // Le vecteur d'incidence initial (colinéaire à l'axe des x).
-    Vector3D vecIncidInit(1.0, 0.0, 0.0);
+    if (!sobol) {
+      u[3] = stream.getRandomNumber();
+      u[4] = stream.getRandomNumber();
+    }
+    double yRand = ymin + yDim * u[3];
+    double zRand = zmin + zDim * u[4];
+
+    // Le rayon (0, yRand, zRand) + t (1, 0, 0) du repere tourne, dans le
+    // repere des atomes.
+    Vector3D origin(ax.y * yRand + ax.z * zRand, ay.y * yRand + ay.z * zRand, az.y * yRand + az.z * zRand);
+    Vector3D direction(ax.x, ay.x, az.x);
+    const Vector3D initialDirection(direction);
     bool kp = false;
 
     for (int refl = 1; refl <= StdCalculationOperator::m_MaxSuccRefl; ++refl) {
-      che(mol, refl, halfCos[refl], halfCos[refl - 1], yRand, zRand, kp, vecIncidInit);
+      che(bvh, refl, halfCos[refl], halfCos[refl - 1], origin, direction, kp, initialDirection);
 
       // Si l'inclusion du prochain ordre de collision n'a pas changé
       // l'angle d'indice/de réflexion (c'est à dire qu'il n'y a eu aucune
       // collision, on arrête de suivre cette trajectoire.
       if (halfCos[refl] == halfCos[refl - 1]) {
         // Si nécessaire, on met à jour highestCollOrder.
-        if (refl - 1 > highestCollOrder) {
-          highestCollOrder = refl - 1;
+        if (refl - 1 > sums.highestCollOrder) {
+          sums.highestCollOrder = refl - 1;
         }
 
         // Construit tous les prochains cosinus d'angles d'incidence/
@@ -405,8 +646,8 @@ void StdCalculationOperator::calculateEHSSAndPA(Molecule* mol)
         // On sort du for.
         break;
       } else {
-        if(refl > highestCollOrder) {
-          highestCollOrder = refl;
+        if(refl > sums.highestCollOrder) {
+          sums.highestCollOrder = refl;
         }
       }
     }
@@ -414,13 +655,37 @@ void StdCalculationOperator::calculateEHSSAndPA(Molecule* mol)
     // On ajoute les contributions de la trajectoire aux calculs de CCS
     // pour tous les ordres.
     for (int refl = 1; refl <= StdCalculationOperator::m_MaxSuccRefl; ++refl) {
-      ccsArray[refl] += area * halfCos[refl] * halfCos[refl];
+      sums.ccs[refl] += area * halfCos[refl] * halfCos[refl];
     }
 
     if (kp) {
-      projection += area;
+      sums.projection += area;
+    }
+    if (sobol) {
+      const double ccs = area * halfCos[StdCalculationOperator::m_MaxSuccRefl] * halfCos[StdCalculationOperator::m_MaxSuccRefl];
+      sums.replicateCCS[i % nbReplicates] += ccs;
+      sums.replicateProjection[i % nbReplicates] += kp ? area : 0.0;
     }
   }
+}
+
+void StdCalculationOperator::finishEHSSAndPA(const SphereBVH& bvh, const std::vector<HardSphereSums>& sums)
+{
+  // Initialise le tableau des CCS à zéro.
+  std::vector<double> ccsArray(StdCalculationOperator::m_MaxSuccRefl + 1, 0.0);
+  // La projection ("hard-sphere cross-section").
+  double projection = 0.0;
+  // Le plus grand ordre rencontré pour n'importe quelle trajectoire.
+  int highestCollOrder = 1;
+
+  for (unsigned int c = 0; c < sums.size(); ++c) {
+    for (int refl = 1; refl <= StdCalculationOperator::m_MaxSuccRefl; ++refl) {
+      ccsArray[refl] += sums[c].ccs[refl];
+    }
+    projection += sums[c].projection;
+    highestCollOrder = std::max(highestCollOrder, sums[c].highestCollOrder);
+  }
+
   // Fin de l'intégration de Monte-Carlo.
   // On normalise toutes les CCS et la projection.
   for (int i = 1; i <= highestCollOrder; ++i) {
@@ -428,6 +693,11 @@ void StdCalculationOperator::calculateEHSSAndPA(Molecule* mol)
   }
   projection /= m_numberPointsMCIntegrationEHSSPA;
 
+  // La projection des trajectoires est remplacee par l'aire rasterisee.
+  if (GlobalParameters::getInstance()->getPAMethod() == PAMethod::RASTER) {
+    projection = calculateRasterizedPA(bvh);
+  }
+
   double averagePACS = projection;
   double averagePAMobility = StdCalculationOperator::m_mobilityConstant / (sqrt(m_temperature) * averagePACS);
   double averageEHSSCS = ccsArray[highestCollOrder];
@@ -437,152 +707,84 @@ void StdCalculationOperator::calculateEHSSAndPA(Molecule* mol)
   m_result->setEHSS(averageEHSSCS);
   m_result->setPA(averagePACS);
 
+  // Erreurs estimees par l'ecart entre les repliques des points de Sobol.
+  if (m_samplingMethod == SamplingMethod::SOBOL) {
+    const unsigned int nbReplicates = getNumberReplicatesQMC();
+    std::vector<double> replicateEHSS(nbReplicates, 0.0);
+    std::vector<double> replicatePA(nbReplicates, 0.0);
+    for (unsigned int r = 0; r < nbReplicates; ++r) {
+      for (unsigned int c = 0; c < sums.size(); ++c) {
+        replicateEHSS[r] += sums[c].replicateCCS[r];
+        replicatePA[r] += sums[c].replicateProjection[r];
+      }
+      // Les trajectoires i telles que i % nbReplicates == r.
+      const unsigned int nbPoints = m_numberPointsMCIntegrationEHSSPA / nbReplicates
+                                    + (r < (unsigned int) m_numberPointsMCIntegrationEHSSPA % nbReplicates ? 1 : 0);
+      replicateEHSS[r] /= 0.5 * nbPoints;
+      replicatePA[r] /= nbPoints;
+    }
+    // PA rasterisee : pas de points aleatoires, donc pas d'erreur.
+    double paError = 0.0;
+    if (GlobalParameters::getInstance()->getPAMethod() != PAMethod::RASTER) {
+      paError = relativeStandardError(replicatePA, nbReplicates);
+    }
+    m_result->setStandardErrorsEHSSPA(relativeStandardError(replicateEHSS, nbReplicates), paError);
+  }
+
   // On met a jour le CalculationState.
   m_calculationState->setEHSSResult(averageEHSSCS);
   m_calculationState->setEHSSEnded();
   m_calculationState->setPAResult(averagePACS);
   m_calculationState->setPAEnded();
-
-  delete mathLib;
 }
 
-void StdCalculationOperator::che(Molecule* mol, int refl, double& halfCos, double cop, double& yRand, double& zRand, bool& kp, Vector3D& initialIncidenceVector)
+double StdCalculationOperator::calculateRasterizedPA(const SphereBVH& bvh)
 {
-  // If this is a secondary collision, the incident vector lies on the
-  // x axis in transformed coordinates.
-  if (refl != 1) {
-    yRand = 0.0;
-    zRand = 0.0;
-  }
-
-  // xl est un grand nombre.
-  double xl = pow(10, 6);
-  // L'atome avec lequel la collision il y a (ou null si
-  // il n'y a pas eu de collision).
-  Atom* collidingAtom = nullptr;
-
-  // Variables de travail.
-  Vector3D* pos;
-  double yImp;
-  double zImp;
-  double ras;
-  double dev;
-  double rhs;
-  double xCol;
-
-  double dixPMoinsSix = pow(10, -6);
-
-  // On recupere la vectore des atomes de la molecule à étudier.
-  std::vector<Atom*> atoms = *(mol->getAllAtoms());
-  unsigned int atomsSize = atoms.size();
-  // On parcourt tous les atomes.
-  for (unsigned int i = 0; i < atomsSize; ++i) {
-    // On extrait la position de l'atome.
-    pos = atoms[i]->getPosition();
-
-    if (pos->x > dixPMoinsSix || refl == 1) {
-      // yImp et zImp sont les coordonnées des points d'impact pour
-      // l'atome, en respectant ses propres coordonnées (si un tel
-      // point existe).
-      yImp = yRand - pos->y;
-      zImp = zRand - pos->z;
-      // dev est le paramètre d'impact.
-      ras = (yImp * yImp) + (zImp * zImp);
-      dev = sqrt(ras);
-
-      // Le rayon de sphere dure de l'atome.
-      rhs = m_rhsTab[i];
-
-      // Si une collision avec l'atome est detectee.
-      if (dev <= rhs) {
-        // On cherche la coordonnée de collision sur l'axe des X.
-        xCol = pos->x - sqrt((rhs * rhs) - ras);
-
-        // On cherche le plus petit xCol (la collision qui arrive
-        // en première).
-        if (xCol < xl) {
-          xl = xCol;
-          collidingAtom = atoms[i];
-        }
-      }
-    }
+  const unsigned int nbOrientations = GlobalParameters::getInstance()->getNbOrientationsPA();
+  ProjectedAreaRasterizer rasterizer(GlobalParameters::getInstance()->getPAPixelSize());
+
+  double projection = 0.0;
+  for (unsigned int k = 0; k < nbOrientations; ++k) {
+    projection += rasterizer.calculateArea(bvh.getX(), bvh.getY(), bvh.getZ(), bvh.getRadius(),
+                                           ProjectedAreaRasterizer::getDirection(k, nbOrientations));
   }
+  return projection / nbOrientations;
+}
 
-  // Si il y a eu collision, alors xVec, yVec et zVec sont
-  // les vecteurs allant du centre de l'atome de la collision
-  // jusqu'au point de la collision.
-  if (collidingAtom != nullptr) {
+void StdCalculationOperator::che(const SphereBVH& bvh, int refl, double& halfCos, double cop, Vector3D& origin, Vector3D& direction,
+                                 bool& kp, const Vector3D& initialDirection)
+{
+  // On cherche la premiere collision le long du rayon. Apres une premiere
+  // collision, le rayon part du point de collision et seuls les atomes
+  // devant lui comptent.
+  double xl = 0.0;
+  const int collidingAtom = bvh.firstHit(origin, direction, refl != 1, xl);
+
+  // Si il y a eu collision, on reflechit le rayon sur l'atome touche.
+  if (collidingAtom >= 0) {
     kp = true;
 
-    // On extrait la position de l'atome de la collision.
-    Vector3D posCol = *(collidingAtom->getPosition());
-
-    double xVec = xl - posCol.x;
-    double yVec = yRand - posCol.y;
-    double zVec = zRand - posCol.z;
-
-    // Transforme toutes les coordonnees par un mouvement
-    // parallèle pour le point de collision soit à (0, 0, 0).
-    for (unsigned int i = 0; i < atomsSize; ++i) {
-      pos = atoms[i]->getPosition();
-      pos->x = pos->x - xl;
-      pos->y = pos->y - yRand;
-      pos->z = pos->z - zRand;
-    }
-
-    // Transforme les coordonnes de tous les atomes de façon
-    // à ce que le vecteur de direction de la particule réfléchie
-    // soit collinéaire à l'axe des X.
-    // (A noter : le nombre de telles transformations est infini,
-    // donc la direction sur les axes des x et z est arbitraire).
-    // Les cosinus des directions du rayon arrivant sont aussi
-    // transformés.
-    // xve1, xve2 et xve3 sont les vecteurs de direction du rayon
-    // réfléchi dans le système de coordonnées du rayon arrivant.
-
-    // On évalue les éléments de la matrice de transformation.
-    double xxVec = 2.0 * xVec * xVec;
-    double xyVec = 2.0 * xVec * yVec;
-    double xzVec = 2.0 * xVec * zVec;
-    double xyz = xyVec * xzVec;
-
-    // Le rayon de sphere dure de l'atome.
-    double rhs = AtomInformations::getInstance()->getHSRadius(collidingAtom->getSymbol());
-    double rhs2 = rhs * rhs;
-    double rad2 = rhs2 - xxVec;
-    double ad1 = rad2 * rad2 + xyVec * xyVec;
-    double adr1 = sqrt(ad1);
-    double adr2 = sqrt(ad1 * ad1 + xyz * xyz + xzVec * xzVec * rad2 * rad2);
-
-    double xve1 = 1.0 - 2.0 * xVec * xVec / rhs2;
-    double xve2 = -xyVec / rhs2;
-    double xve3 = -xzVec / rhs2;
-
-    double yve1 = xyVec / adr1;
-    double yve2 = rad2 / adr1;
-    double yve3 = 0.0;
-
-    double zve1 = rad2 * xzVec / adr2;
-    double zve2 = -xyz / adr2;
-    double zve3 = ad1 / adr2;
-
-    // Transforme les coordonnées et les cosinus de direction du rayon arrivant.
-    for (unsigned int i = 0; i < atomsSize; ++i) {
-      pos = atoms[i]->getPosition();
-      double xne = xve1 * pos->x + xve2 * pos->y + xve3 * pos->z;
-      double yne = yve1 * pos->x + yve2 * pos->y + yve3 * pos->z;
-      double zne = zve1 * pos->x + zve2 * pos->y + zve3 * pos->z;
-      pos->x = xne;
-      pos->y = yne;
-      pos->z = zne;
-    }
-    // La même pour le vecteur d'incidence.
-    double xne = xve1 * initialIncidenceVector.x + xve2 * initialIncidenceVector.y + xve3 * initialIncidenceVector.z;
-    double yne = yve1 * initialIncidenceVector.x + yve2 * initialIncidenceVector.y + yve3 * initialIncidenceVector.z;
-    double zne = zve1 * initialIncidenceVector.x + zve2 * initialIncidenceVector.y + zve3 * initialIncidenceVector.z;
-    initialIncidenceVector.x = xne;
-    initialIncidenceVector.y = yne;
-    initialIncidenceVector.z = zne;
+    // Le point de collision.
+    origin.x += xl * direction.x;
+    origin.y += xl * direction.y;
+    origin.z += xl * direction.z;
+
+    // La normale a la sphere au point de collision.
+    const double rhs = bvh.getRadius()[collidingAtom];
+    const double xNorm = (origin.x - bvh.getX()[collidingAtom]) / rhs;
+    const double yNorm = (origin.y - bvh.getY()[collidingAtom]) / rhs;
+    const double zNorm = (origin.z - bvh.getZ()[collidingAtom]) / rhs;
+
+    // Direction reflechie, normalisee pour ne pas deriver au fil des
+    // collisions.
+    const double dn = direction.x * xNorm + direction.y * yNorm + direction.z * zNorm;
+    direction.x -= 2.0 * dn * xNorm;
+    direction.y -= 2.0 * dn * yNorm;
+    direction.z -= 2.0 * dn * zNorm;
+    const double norm = sqrt(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+    direction.x /= norm;
+    direction.y /= norm;
+    direction.z /= norm;
 
     // Calcule halfCos : le cosinus de l'angle entre le rayon incident
     // et la normal à un plan imaginaire, la reflection résultante serait
@@ -590,7 +792,9 @@ void StdCalculationOperator::che(Molecule* mol, int refl, double& halfCos, doubl
     // (Calculate cof - the cosine of the angle between the incident ray
     //  and the normal to an imaginary plane, the reflection from which
     //  would be equivalent to the actual multibody reflection.)
-    halfCos = cos((M_PI - acos(initialIncidenceVector.x)) / 2.0);
+    double cosIncid = initialDirection.x * direction.x + initialDirection.y * direction.y + initialDirection.z * direction.z;
+    cosIncid = std::max(-1.0, std::min(1.0, cosIncid));
+    halfCos = cos((M_PI - acos(cosIncid)) / 2.0);
   } else {
     // Si il n'y a pas eu de collision, le cosinus n'a pas changé.
     halfCos = cop;
@@ -605,165 +809,204 @@ void StdCalculationOperator::che(Molecule* mol, int refl, double& halfCos, doubl
 void StdCalculationOperator::calculateAsymmetryParameter()
 {
   // Outil mathematique.
-  MathLib* mathLib = new StdMathLib();
-
-  double angleX = 0.0;
-  m_asymmetryParameter = 0.0;
-
-  // Variables de travail.
+  StdMathLib mathLib;
+
+  // La somme des distances au centre ne depend pas de l'orientation : elle
+  // est calculee une fois. Apres une rotation m, la distance d'un atome a
+  // l'axe des X est sqrt(r^2 - s^2), s etant sa coordonnee sur l'axe porte
+  // par la premiere ligne de m.
+  std::vector<double> x(m_molNbAtoms);
+  std::vector<double> y(m_molNbAtoms);
+  std::vector<double> z(m_molNbAtoms);
+  std::vector<double> r2(m_molNbAtoms);
   double xyzSum = 0.0;
-  double yzSum = 0.0;
-  double yzTemp;
-  double hold;
+  for (unsigned int i = 0; i < m_molNbAtoms; ++i) {
+    x[i] = m_molInitPos[i].x;
+    y[i] = m_molInitPos[i].y;
+    z[i] = m_molInitPos[i].z;
+    r2[i] = x[i] * x[i] + y[i] * y[i] + z[i] * z[i];
+    xyzSum += sqrt(r2[i]);
+  }
 
-  // On tourne la molecule completement autour de deux axes.
-  for (double angleY = 0.0; angleY < 360.0; angleY += 2.0) {
-    for (double angleZ = 0.0; angleZ < 360.0; angleZ += 2.0) {
-      mathLib->rotate(m_molInitPos, m_molPos, angleX, angleY, angleZ);
-      xyzSum = 0.0;
-      yzSum = 0.0;
-
-      for (unsigned int i = 0; i < m_molNbAtoms; ++i) {
-        Vector3D pos = m_molPos[i];
-        yzTemp = pos.y * pos.y + pos.z * pos.z;
-        xyzSum += sqrt(pos.x * pos.x + yzTemp);
-        yzSum += sqrt(yzTemp);
-      }
+  // On tourne la molecule completement autour de deux axes : les matrices
+  // sont calculees une fois pour toutes.
+  const int nbAngles = 180;
+  const int nbOrientations = nbAngles * nbAngles;
+  std::vector<Vector3D> axes(nbOrientations);
+  for (int iy = 0; iy < nbAngles; ++iy) {
+    for (int iz = 0; iz < nbAngles; ++iz) {
+      RotationMatrix m = mathLib.calculateRotationMatrix(0.0, 2.0 * iy, 2.0 * iz);
+      axes[iy * nbAngles + iz] = Vector3D(m.m[0][0], m.m[0][1], m.m[0][2]);
+    }
+  }
 
-      hold = ((M_PI / 4.0) * xyzSum) / yzSum;
-      if (hold > m_asymmetryParameter) {
-        m_asymmetryParameter = hold;
-      }
+  const double* px = x.data();
+  const double* py = y.data();
+  const double* pz = z.data();
+  const double* pr2 = r2.data();
+  const unsigned int nbAtoms = m_molNbAtoms;
+  double asymmetryParameter = 0.0;
+  #pragma omp parallel for num_threads(getNumberThreads()) reduction(max:asymmetryParameter)
+  for (int o = 0; o < nbOrientations; ++o) {
+    const double ax = axes[o].x;
+    const double ay = axes[o].y;
+    const double az = axes[o].z;
+    double yzSum = 0.0;
+    #pragma omp simd reduction(+:yzSum)
+    for (unsigned int i = 0; i < nbAtoms; ++i) {
+      double s = px[i] * ax + py[i] * ay + pz[i] * az;
+      yzSum += sqrt(std::max(pr2[i] - s * s, 0.0));
     }
+
+    double hold = ((M_PI / 4.0) * xyzSum) / yzSum;
+    asymmetryParameter = std::max(asymmetryParameter, hold);
   }
 
-  delete mathLib;
+  m_asymmetryParameter = asymmetryParameter;
 }
 
 /**
- * Calculates the potential and the derivates of the potential.
- * The potential is given by a sum of 6-12 two body ...
- * \param p the position for the calculation
- * \param dPot the derivates of the potential
- * \return the potential
+ * Creates the engine evaluating the potential on the positions in
+ * m_molPos, with the kernel asked in SystemParameters.
  */
-double StdCalculationOperator::calculatePotentials(std::vector<Vector3D>& molPos, const Vector3D& p, Vector3D& dPot, double& dMax)
+PotentialEngine* StdCalculationOperator::createPotentialEngine() const
 {
-  // Variables de travail.
-  Vector3D rPos(0.0, 0.0, 0.0);
-  double e00 = 0.0;
-  double de00 = 0.0;
-  Vector3D de00Vec(0.0, 0.0, 0.0);
-
-  double xx = 0.0;
-  double xx2 = 0.0;
-  double yy = 0.0;
-  double yy2 = 0.0;
-  double zz = 0.0;
-  double zz2 = 0.0;
-  double rxyz = 0.0;
-  double rxyz2 = 0.0;
-  double rxyz3 = 0.0;
-  double rxyz5 = 0.0;
-  double rxyz6 = 0.0;
-  double rxyz8 = 0.0;
-  double rxyz12 = 0.0;
-  double rxyz14 = 0.0;
-  double eox4 = 0.0;
-  double rolj6 = 0.0;
-  double rolj12 = 0.0;
-  double charge = 0.0;
-  double rxyz3i = 0.0;
-  double rxyz5i = 0.0;
-  double sum1 = 0.0;
-  double sum2 = 0.0;
-  double sum3 = 0.0;
-  double sum4 = 0.0;
-  double sum5 = 0.0;
-  double sum6 = 0.0;
+  PotentialKernel kernel = SystemParameters::getInstance()->getPotentialKernel();
+
+  if (GlobalParameters::getInstance()->getPotentialMode() == PotentialMode::CELL_LIST) {
+    return new CellListPotentialEngine(m_molPos,
+                                       m_EOLJTab,
+                                       m_ROLJTab,
+                                       m_molChg,
+                                       m_maxROLJ,
+                                       m_ionInducedDipolePotential,
+                                       GlobalParameters::getInstance()->getCellListCutoff() * ANGSTROMTOMETER,
+                                       GlobalParameters::getInstance()->getCellListCellSize() * ANGSTROMTOMETER,
+                                       kernel);
+  }
 
-  // Resultat.
-  double pot = 0.0;
+  if (GlobalParameters::getInstance()->getPotentialMode() == PotentialMode::GRID) {
+    // Le potentiel est plafonne bien au-dessus des energies de collision,
+    // a la plus haute temperature.
+    double temperature = m_temperature;
+    for (unsigned int i = 0; i < m_temperatureSweep.size(); ++i) {
+      temperature = std::max(temperature, m_temperatureSweep[i]);
+    }
+    return new GridPotentialEngine(m_molPos,
+                                   m_EOLJTab,
+                                   m_ROLJTab,
+                                   m_molChg,
+                                   m_maxROLJ,
+                                   m_ionInducedDipolePotential,
+                                   GlobalParameters::getInstance()->getGridSpacing() * ANGSTROMTOMETER,
+                                   GlobalParameters::getInstance()->getGridExtent() * ANGSTROMTOMETER,
+                                   m_GridMaxPotential * m_XkFromMobcal * temperature,
+                                   kernel);
+  }
 
-  dMax = 2.0 * m_maxROLJ;
+  return new StdPotentialEngine(m_molPos,
+                                m_EOLJTab,
+                                m_ROLJTab,
+                                m_molChg,
+                                m_maxROLJ,
+                                m_ionInducedDipolePotential,
+                                kernel);
+}
 
-  // On parcourt tous les atomes.
+void StdCalculationOperator::estimatePotentialError()
+{
+  StdPotentialEngine exact(m_molPos,
+                           m_EOLJTab,
+                           m_ROLJTab,
+                           m_molChg,
+                           m_maxROLJ,
+                           m_ionInducedDipolePotential,
+                           SystemParameters::getInstance()->getPotentialKernel());
+
+  // Generateur a part, pour ne pas changer les tirages du calcul.
+  boost::mt19937 engine(0);
+  boost::variate_generator<boost::mt19937&, boost::uniform_01<> > random(engine, boost::uniform_01<>());
+
+  double rMax = 0.0;
   for (unsigned int i = 0; i < m_molNbAtoms; ++i) {
-    // La position de l'atome.
-    Vector3D pos = molPos[i];
-
-    xx = p.x - pos.x;
-    xx2 = boost::math::pow<2>(xx);
-    yy = p.y - pos.y;
-    yy2 = boost::math::pow<2>(yy);
-    zz = p.z - pos.z;
-    zz2 = boost::math::pow<2>(zz);
-    rxyz2 = xx2 + yy2 + zz2;
-    rxyz = sqrt(rxyz2);
-
-    if (rxyz < dMax) {
-      dMax = rxyz;
-    }
-
-    rxyz3=rxyz2*rxyz;
-    rxyz5=rxyz3*rxyz2;
-    rxyz6=rxyz5*rxyz;
-    rxyz8=rxyz5*rxyz3;
-    rxyz12=rxyz6*rxyz6;
-    rxyz14=rxyz12*rxyz2;
-
-    // Puissances de Lennard-Jones.
-    eox4 = (4.0 * m_EOLJTab[i]);
-    rolj6 = boost::math::pow<6>(m_ROLJTab[i]);
-    rolj12 = rolj6 * rolj6;
-
-    // Potentiel de Lennard-Jones.
-    e00 += eox4 * ((rolj12 / rxyz12)
-        - (rolj6 / rxyz6));
-
-    // Derives du potentiel de Lennard-Jones.
-    de00 = eox4 * (((6.0 * rolj6) / rxyz8)
-        - ((12.0 * rolj12) / rxyz14));
-    de00Vec.x += de00 * xx;
-    de00Vec.y += de00 * yy;
-    de00Vec.z += de00 * zz;
-
-    // Potentiel des ions induits.
-    charge = m_molChg[i];
-    if (charge != 0.0) {
-      rxyz3i = charge / rxyz3;
-      rxyz5i = -3.0 * charge / rxyz5;
-      rPos.x += xx * rxyz3i;
-      rPos.y += yy * rxyz3i;
-      rPos.z += zz * rxyz3i;
-      // Derives des ions induits.
-      sum1 += rxyz3i + (xx2 * rxyz5i);
-      sum2 += xx * yy * rxyz5i;
-      sum3 += xx * zz * rxyz5i;
-      sum4 += rxyz3i + (yy2 * rxyz5i);
-      sum5 += yy * zz * rxyz5i;
-      sum6 += rxyz3i + (zz2 * rxyz5i);
-    }
-  }
-
-  pot = e00 - (m_IonInducedDipolePotential
-    * (rPos.x * rPos.x + rPos.y * rPos.y + rPos.z * rPos.z));
-  dPot.x = de00Vec.x - (m_IonInducedDipolePotential
-    * ((2.0 * rPos.x * sum1) + (2.0 * rPos.y * sum2) + (2.0 * rPos.z * sum3)));
-  dPot.y = de00Vec.y - (m_IonInducedDipolePotential
-    * ((2.0 * rPos.x * sum2) + (2.0 * rPos.y * sum4) + (2.0 * rPos.z * sum5)));
-  dPot.z = de00Vec.z - (m_IonInducedDipolePotential
-    * ((2.0 * rPos.x * sum3) + (2.0 * rPos.y * sum5) + (2.0 * rPos.z * sum6)));
+    rMax = std::max(rMax, sqrt(m_molPos[i].x * m_molPos[i].x + m_molPos[i].y * m_molPos[i].y + m_molPos[i].z * m_molPos[i].z));
+  }
 
-  return pot;
+  // Zone ou l'approximation change : coupure de la liste de cellules,
+  // ou marge de la grille (les points au-dela sont calcules exactement).
+  double margin = GlobalParameters::getInstance()->getCellListCutoff() * ANGSTROMTOMETER;
+  if (GlobalParameters::getInstance()->getPotentialMode() == PotentialMode::GRID) {
+    margin = GlobalParameters::getInstance()->getGridExtent() * ANGSTROMTOMETER;
+  }
+
+  // Les erreurs sont rapportees a kT (et kT par angstrom) pour ne pas etre
+  // dominees par les points ou le potentiel est presque nul.
+  const double kT = m_XkFromMobcal * m_temperature;
+  const int nbPoints = 2000;
+  double potentialError = 0.0;
+  double gradientError = 0.0;
+
+  for (int i = 0; i < nbPoints; ++i) {
+    // Direction au hasard.
+    double cosTheta = 2.0 * random() - 1.0;
+    double sinTheta = sqrt(1.0 - cosTheta * cosTheta);
+    double phi = 2.0 * M_PI * random();
+    Vector3D dir(sinTheta * cos(phi), sinTheta * sin(phi), cosTheta);
+
+    // Un point sur deux au contact d'un atome, les autres dans une sphere
+    // englobant la molecule et la zone de coupure.
+    Vector3D p;
+    if (i % 2 == 0) {
+      unsigned int atom = std::min((unsigned int) (random() * m_molNbAtoms), m_molNbAtoms - 1);
+      double d = (0.8 + 1.7 * random()) * m_ROLJTab[atom];
+      p = Vector3D(m_molPos[atom].x + d * dir.x, m_molPos[atom].y + d * dir.y, m_molPos[atom].z + d * dir.z);
+    } else {
+      double d = (rMax + 2.0 * margin) * cbrt(random());
+      p = Vector3D(d * dir.x, d * dir.y, d * dir.z);
+    }
+
+    Vector3D dPotExact;
+    Vector3D dPot;
+    double dMax;
+    double potExact = exact.calculatePotential(p, dPotExact, dMax);
+    double pot = m_potentialEngine->calculatePotential(p, dPot, dMax);
+
+    // Point hors d'atteinte de l'Helium.
+    if (potExact > m_MaxCollisionEnergy * kT) {
+      continue;
+    }
+
+    potentialError = std::max(potentialError, fabs(pot - potExact) / std::max(fabs(potExact), kT));
+    double gradientDiff = sqrt(boost::math::pow<2>(dPot.x - dPotExact.x)
+                               + boost::math::pow<2>(dPot.y - dPotExact.y)
+                               + boost::math::pow<2>(dPot.z - dPotExact.z));
+    double gradient = sqrt(dPotExact.x * dPotExact.x + dPotExact.y * dPotExact.y + dPotExact.z * dPotExact.z);
+    gradientError = std::max(gradientError, gradientDiff / std::max(gradient, kT / ANGSTROMTOMETER));
+  }
+
+  m_result->setPotentialError(potentialError, gradientError);
 }
 
 // Dans Mobcal, il y a erat. Mais apparemment, elle est seulement utilise en interne
 // de gsang, donc retiree ici.
 // d1 inutile dans Mobcal ?
 // istep inutile dans Mobcal ?
-double StdCalculationOperator::calculateTrajectory(std::vector<Vector3D>& molPos, double v, double b)
+double StdCalculationOperator::calculateTrajectory(PotentialEngine& potentialEngine, double v, double b)
 {
+  // Integrateur adaptatif : une trajectoire seule, avec l'orientation du moteur.
+  if (m_integrator == TrajectoryIntegrator::DORMAND_PRINCE) {
+    Trajectory t;
+    t.index = 0;
+    t.axes = nullptr;
+    if (startTrajectory(potentialEngine, v, b, t)) {
+      while (advanceTrajectory(t)) {
+        evaluateTrajectory(potentialEngine, t);
+      }
+      countTrajectory(t.ns, t.nbPotentialCalculations);
+    }
+    return t.ang;
+  }
+
   Vector3D vVec(0.0, -v, 0.0);
 
   // Normalement en parametres.
@@ -782,81 +1025,23 @@ double StdCalculationOperator::calculateTrajectory(std::vector<Vector3D>& molPos
 
 
   // On calcule le pas entre chaque point de la trajectoire
-  double top;
-  if (v >= 3000.0) {
-    top = 2.5;
-  } else if (v >= 2000.0) {
-    top = 10.0 - ((v - 2000.0) * 7.5 * boost::math::pow<-3>(10));
-  } else if (v >= 1000.0) {
-    top = 10.0;
-  } else {
-    top = (v / 95.2381) - 0.5;
-  }
-
-  double dt1 = (top * m_timeStepStart * 1.0 * boost::math::pow<-11>(10)) / v;
-  double dt2 = dt1 * m_timeStepCloseCollision;
+  double dt1;
+  double dt2;
+  calculateTimeSteps(v, dt1, dt2);
   double dt = dt1;
 
   // On calcule le point de depart de la trajectoire.
   double e0 = 0.5 * m_massConstant * v * v;
   // Variable pour x, y et z dans Mobcal.
   Vector3D xyz(b, 0.0, 0.0);
-
-  double yMin = 0.0;
-  double yMax = 0.0;
-  for (unsigned int i = 0; i < m_molNbAtoms; ++i) {
-    Vector3D pos = molPos[i];
-    if (pos.y > yMax) {
-      yMax = pos.y;
-    }
-    if (pos.y < yMin) {
-      yMin = pos.y;
-    }
-  }
-  // Conversion en metres
-  yMax /= 1.0 * ANGSTROMTOMETER;
-  yMin /= 1.0 * ANGSTROMTOMETER;
-  int iyMin = (int) yMin - 1;
-  int iyMax = (int) yMax + 1;
-
-  int id2 = iyMax;
-  xyz.y = id2 * 1.0 * ANGSTROMTOMETER;
-  Vector3D dpot(0.0, 0.0, 0.0);
-  double pot = calculatePotentials(molPos, xyz, dpot, dMax);
-
-  if (fabs(pot / e0) <= m_potentialEnergyStart) {
-    do {
-      id2 -= 1.0;
-      xyz.y = id2 * 1.0 * ANGSTROMTOMETER;
-      pot = calculatePotentials(molPos, xyz, dpot, dMax);
-      if (id2 < iyMin) {
-        ang = 0.0;
-        erat = 1.0;
-        // On retourne
-        return ang;
-      }
-
-      xyz.y = id2 * 1.0 * ANGSTROMTOMETER;
-      pot = calculatePotentials(molPos, xyz, dpot, dMax);
-    } while (fabs(pot / e0) < m_potentialEnergyStart);
-  } else {
-
-    do {
-      id2 += 10.0;
-      xyz.y = id2 * 1.0 * ANGSTROMTOMETER;
-      pot = calculatePotentials(molPos, xyz, dpot, dMax);
-    } while (fabs(pot / e0) > m_potentialEnergyStart);
-
-
-    do {
-      id2 -= 1.0;
-      xyz.y = id2 * 1.0 * ANGSTROMTOMETER;
-      pot = calculatePotentials(molPos, xyz, dpot, dMax);
-    } while(fabs(pot / e0) < m_potentialEnergyStart);
+  double pot;
+  if (!findStartingPoint(potentialEngine, e0, xyz, pot, dMax)) {
+    ang = 0.0;
+    erat = 1.0;
+    // On retourne
+    return ang;
   }
 
-
-  xyz.y = id2 * 1.0 * ANGSTROMTOMETER;
   etot = e0 + pot;
 
   // Coordonnees initiales et momentum.
@@ -869,7 +1054,8 @@ double StdCalculationOperator::calculateTrajectory(std::vector<Vector3D>& molPos
   double tim = 0.0;
 
   // Initialise les derivees du temps des coordonnees et du momentum.
-  pot = calculateHamilton(molPos, w, dw, dMax);
+  pot = calculateHamilton(potentialEngine, w, dw, dMax);
+  int nbPotentialCalculations = 1;
   int ns = 0;
   int nw = 0;
   std::array<std::array<double, 6>, 6> arrayDouble = {{0.0}};
@@ -882,7 +1068,9 @@ double StdCalculationOperator::calculateTrajectory(std::vector<Vector3D>& molPos
     do {
       do {
         do {
-          pot = calculateRKandAM(molPos, l, tim, dt, w, dw, arrayDouble, dMax, hVar, hcVar);
+          // Runge-Kutta : 10 calculs du potentiel, Adams-Moulton : 2.
+          nbPotentialCalculations += (l >= 0) ? 10 : 2;
+          pot = calculateRKandAM(potentialEngine, l, tim, dt, w, dw, arrayDouble, dMax, hVar, hcVar);
           nw += 1;
         } while (nw != m_NbIntegrationStep);
         ns += nw;
@@ -894,6 +1082,7 @@ double StdCalculationOperator::calculateTrajectory(std::vector<Vector3D>& molPos
           e = 0.5 * m_massConstant * (dw[0] * dw[0] + dw[2] * dw[2] + dw[4] * dw[4]);
           erat = (e + pot) / etot;
           // istep inutile
+          countTrajectory(ns, nbPotentialCalculations);
           return ang;
         }
 
@@ -911,6 +1100,7 @@ double StdCalculationOperator::calculateTrajectory(std::vector<Vector3D>& molPos
       }
     } while(fabs(pot / e0) > m_potentialEnergyStart);
   } while (ns < 50);
+  countTrajectory(ns, nbPotentialCalculations);
 
 
   // On determine l'angle de deviation
@@ -931,47 +1121,636 @@ double StdCalculationOperator::calculateTrajectory(std::vector<Vector3D>& molPos
     // Energie conservee.
     return ang;
   } else {
-    m_result->setNumberOfFailedTrajectories(m_result->getNumberOfFailedTrajectories() + 1);
+    #pragma omp atomic
+    m_nbFailedTrajectories++;
     // Energie non conservee, on retourne quoi ?
     return ang;
   }
 }
 
-/**
- * Defines Hamilton's equations of motion ad the time derivates of
- * the coordinates and momenta.
- * \return the potential
- */
-double StdCalculationOperator::calculateHamilton(std::vector<Vector3D>& molPos, std::array<double, 6>& w, std::array<double, 6>& dw, double& dMax)
+unsigned int StdCalculationOperator::getNumberReplicatesQMC() const
 {
-  // Dans les equations d'Hamilton, les derivees des coordonnees selon le temps
-  // sont les conjugues divises par la masse.
-  dw[0] = w[1] / m_massConstant;
-  dw[2] = w[3] / m_massConstant;
-  dw[4] = w[5] / m_massConstant;
-  // Les equations d'Hamilton pour les derivees du momentum selon le temps
-  // sont evaluees en utilisation les derivees des coordonnees.
-  // Ce sont des derivees analytiques.
-  Vector3D dPot(0.0, 0.0, 0.0);
-  double pot = calculatePotentials(molPos, Vector3D(w[0], w[2], w[4]), dPot, dMax);
-  dw[1] = -dPot.x;
-  dw[3] = -dPot.y;
-  dw[5] = -dPot.z;
+  // Chaque replique a au moins un point.
+  return std::max(1u, std::min(m_nbReplicatesQMC, (unsigned int) m_numberPointsMCIntegrationEHSSPA));
+}
 
-  return pot;
+unsigned int StdCalculationOperator::getMonteCarloChunkSize() const
+{
+  return std::max(1u, m_ChunkBatches * SystemParameters::getInstance()->getTrajectoryBatchSize());
 }
 
-/**
- * Integration method. Uses 5th order Runge-Kutta-Gill to initiate and 5th order
- * Adams-Moulton predictor-corrector to propagate.
- * \return the potential
- */
-double StdCalculationOperator::calculateRKandAM(std::vector<Vector3D>& molPos, int& l, double& tim, double& dt, std::array<double, 6>& w, std::array<double, 6>& dw, std::array<std::array<double, 6>, 6>& arrayDouble, double& dMax, double& hVar, double& hcVar)
+bool StdCalculationOperator::isTMConverged(const std::vector<double>& om11st, int nbCycles)
 {
-  // pot inutile a mon avis
-  double pot = 0.0;
-  double q[6];
-  double savw[6];
+  if (m_TMStandardErrorTarget <= 0.0) {
+    return false;
+  }
+
+  // Estimation courante, comme a la fin de TM.
+  double mom11st = 0.0;
+  for (int ic = 0; ic < nbCycles; ++ic) {
+    mom11st += om11st[ic];
+  }
+  mom11st /= nbCycles;
+  const double cs = mom11st * M_PI * m_RoFromMobcal * m_RoFromMobcal * 1.0 * pow(10, 20);
+  const double error = relativeStandardError(om11st, nbCycles);
+  m_calculationState->setTMCycleEnded(nbCycles, cs, error);
+
+  return nbCycles >= m_MinimalNumberCyclesTM && error <= m_TMStandardErrorTarget;
+}
+
+void StdCalculationOperator::saveConvergenceTM(const std::vector<double>& om11st, int nbCycles)
+{
+  // Seul le premier gaz donne les resultats principaux.
+  if (m_bufferGasIndex == 0) {
+    m_result->setConvergenceTM(nbCycles, relativeStandardError(om11st, nbCycles));
+  }
+}
+
+int StdCalculationOperator::resumeCyclesTM(std::vector<double>& b2max, std::vector<double>& om11st,
+                                           std::vector<double>& om12st, std::vector<double>& om13st,
+                                           std::vector<double>& om22st, std::vector<double>& q1st,
+                                           std::vector<double>& q2st)
+{
+  const TMCheckpoint& tm = m_checkpoint.tm;
+  if (!m_checkpoint.tmStarted || tm.bufferGasIndex != m_bufferGasIndex) {
+    return 0;
+  }
+
+  const int nbCycles = tm.nbCycles;
+  b2max = tm.b2max;
+  std::copy(tm.om11st.begin(), tm.om11st.end(), om11st.begin());
+  std::copy(tm.om12st.begin(), tm.om12st.end(), om12st.begin());
+  std::copy(tm.om13st.begin(), tm.om13st.end(), om13st.begin());
+  std::copy(tm.om22st.begin(), tm.om22st.end(), om22st.begin());
+  std::copy(tm.q1st.begin(), tm.q1st.end(), q1st.begin());
+  std::copy(tm.q2st.begin(), tm.q2st.end(), q2st.begin());
+
+  // Les trajectoires de ces cycles sont terminees.
+  m_calculationState->addFinishedTrajectories(nbCycles * m_numberPointsVelocity * m_numberPointsMCIntegrationTM);
+  return nbCycles;
+}
+
+void StdCalculationOperator::checkpointCyclesTM(const std::vector<double>& b2max, const std::vector<double>& om11st,
+                                                const std::vector<double>& om12st, const std::vector<double>& om13st,
+                                                const std::vector<double>& om22st, const std::vector<double>& q1st,
+                                                const std::vector<double>& q2st, int nbCycles)
+{
+  if (!Checkpoint::getInstance()->isEnabled()) {
+    return;
+  }
+
+  TMCheckpoint& tm = m_checkpoint.tm;
+  tm.bufferGasIndex = m_bufferGasIndex;
+  tm.nbCycles = nbCycles;
+  tm.b2max = b2max;
+  tm.om11st.assign(om11st.begin(), om11st.begin() + nbCycles);
+  tm.om12st.assign(om12st.begin(), om12st.begin() + nbCycles);
+  tm.om13st.assign(om13st.begin(), om13st.begin() + nbCycles);
+  tm.om22st.assign(om22st.begin(), om22st.begin() + nbCycles);
+  tm.q1st.assign(q1st.begin(), q1st.begin() + nbCycles * m_numberPointsVelocity);
+  tm.q2st.assign(q2st.begin(), q2st.begin() + nbCycles * m_numberPointsVelocity);
+  tm.nbIntegratedTrajectories = m_nbIntegratedTrajectories;
+  tm.nbIntegrationSteps = m_nbIntegrationSteps;
+  tm.nbPotentialCalculations = m_nbPotentialCalculations;
+  tm.nbFailedTrajectories = m_nbFailedTrajectories;
+  m_checkpoint.tmStarted = true;
+  saveCheckpoint();
+}
+
+void StdCalculationOperator::restoreCheckpoint()
+{
+  if (m_checkpointRestored) {
+    return;
+  }
+  m_checkpointRestored = true;
+
+  if (!Checkpoint::getInstance()->find(m_geometryIndex, m_checkpoint)) {
+    m_checkpoint.nbAtoms = m_mol->getAtomNumber();
+    m_checkpoint.finished = false;
+    m_checkpoint.hardSpheres = false;
+    m_checkpoint.tmStarted = false;
+    return;
+  }
+
+  if (m_checkpoint.nbAtoms != m_mol->getAtomNumber()) {
+    throw std::string("The geometries are not the ones of the checkpoint file.");
+  }
+  Checkpoint::readResult(m_checkpoint.result, m_result);
+}
+
+void StdCalculationOperator::saveCheckpoint()
+{
+  if (!Checkpoint::getInstance()->isEnabled()) {
+    return;
+  }
+  m_checkpoint.result = Checkpoint::writeResult(m_result);
+  Checkpoint::getInstance()->save(m_geometryIndex, m_checkpoint);
+}
+
+StdCalculationOperator::VelocityPoints StdCalculationOperator::calculateVelocityPoints(double temperature) const
+{
+  // Les vitesses ne dependent que de la temperature et de leur nombre : elles
+  // sont calculees une fois pour toutes les geometries.
+  std::lock_guard<std::mutex> lock(m_velocityPointsMutex);
+  const std::pair<double, int> key(temperature, m_numberPointsVelocity);
+  std::map<std::pair<double, int>, VelocityPoints>::const_iterator it = m_velocityPointsCache.find(key);
+  if (it != m_velocityPointsCache.end()) {
+    return it->second;
+  }
+
+  VelocityPoints points;
+  points.temperature = temperature;
+  points.pgst.assign(m_numberPointsVelocity + 1, 0.0);
+  points.wgst.assign(m_numberPointsVelocity + 1, 0.0);
+
+  const double tst = m_XkFromMobcal * temperature / m_EoFromMobcal;
+  double tst3 = boost::math::pow<3>(tst);
+
+  double dgst = 5.0 * pow(10, -7) * 6.0 * sqrt(tst);
+  double gst = dgst;
+  double sum = 0.0;
+  double sum1 = 0.0;
+  double sum2 = 0.0;
+
+  for (int i = 1; i <= m_numberPointsVelocity; ++i) {
+    sum1 += sqrt(i);
+  }
+
+  double hold1;
+  double hold2;
+  double gstt;
+
+  for (int i = 1; i <= m_numberPointsVelocity; ++i) {
+    hold1 = sqrt(i);
+    hold2 = sqrt(i - 1);
+    sum2 += hold2;
+    points.wgst[i] = hold1 / sum1;
+    gstt = tst3 * (sum2 + (hold1 / 2.0)) / sum1;
+
+    while (sum < gstt) {
+      sum += exp(-gst * gst / tst) * boost::math::pow<5>(gst) * dgst;
+      gst = gst + dgst;
+      if (sum > gstt) {
+        points.pgst[i] = gst - (dgst / 2.0);
+      }
+    }
+  }
+
+  m_velocityPointsCache.insert(std::make_pair(key, points));
+  return points;
+}
+
+std::vector<StdCalculationOperator::VelocityPoints> StdCalculationOperator::calculateTemperaturesTM() const
+{
+  std::vector<VelocityPoints> temperatures;
+  temperatures.push_back(calculateVelocityPoints(m_temperature));
+  for (unsigned int i = 0; i < m_temperatureSweep.size(); ++i) {
+    if (m_temperatureSweep[i] == m_temperature) {
+      temperatures.push_back(temperatures[0]);
+    } else {
+      temperatures.push_back(calculateVelocityPoints(m_temperatureSweep[i]));
+    }
+  }
+  return temperatures;
+}
+
+std::vector<double> StdCalculationOperator::calculateTrajectoryVelocities(const std::vector<VelocityPoints>& temperatures) const
+{
+  const VelocityPoints* lowest = &temperatures[0];
+  const VelocityPoints* highest = &temperatures[0];
+  for (unsigned int k = 1; k < temperatures.size(); ++k) {
+    if (temperatures[k].temperature < lowest->temperature) {
+      lowest = &temperatures[k];
+    }
+    if (temperatures[k].temperature > highest->temperature) {
+      highest = &temperatures[k];
+    }
+  }
+  if (lowest == highest) {
+    return lowest->pgst;
+  }
+
+  // Les vitesses d'une temperature sont proportionnelles a sqrt(T) : les
+  // premieres vitesses suivent celles de la plus basse temperature, les
+  // dernieres celles de la plus haute, en passant de l'une a l'autre en
+  // echelle logarithmique.
+  std::vector<double> velocities(m_numberPointsVelocity + 1, 0.0);
+  for (int i = 1; i <= m_numberPointsVelocity; ++i) {
+    const double s = m_numberPointsVelocity > 1 ? (i - 1) / (m_numberPointsVelocity - 1.0) : 0.5;
+    velocities[i] = pow(lowest->pgst[i], 1.0 - s) * pow(highest->pgst[i], s);
+  }
+  return velocities;
+}
+
+namespace
+{
+  /**
+   * Interpolates linearly the values y, known at the increasing x (from
+   * index 1), at xi. Outside of x, the nearest value is taken.
+   */
+  double interpolate(const std::vector<double>& x, const double* y, double xi)
+  {
+    const int n = x.size() - 1;
+    if (xi <= x[1]) {
+      return y[0];
+    }
+    if (xi >= x[n]) {
+      return y[n - 1];
+    }
+    const int i = std::upper_bound(x.begin() + 1, x.end(), xi) - x.begin();
+    const double t = (xi - x[i - 1]) / (x[i] - x[i - 1]);
+    return y[i - 2] + t * (y[i - 1] - y[i - 2]);
+  }
+}
+
+void StdCalculationOperator::integrateCycleTM(const VelocityPoints& points, const std::vector<double>& velocities,
+                                              const double* q1, const double* q2,
+                                              double& om11, double& om12, double& om13, double& om22) const
+{
+  const double tst = m_XkFromMobcal * points.temperature / m_EoFromMobcal;
+  const bool interpolated = velocities != points.pgst;
+
+  for (int ig = 0; ig < m_numberPointsVelocity; ++ig) {
+    double valpgst = points.pgst[ig + 1];
+    double valwgst = points.wgst[ig + 1];
+    double temp1 = q1[ig];
+    double temp2 = q2[ig];
+    if (interpolated) {
+      temp1 = interpolate(velocities, q1, valpgst);
+      temp2 = interpolate(velocities, q2, valpgst);
+    }
+
+    om11 += temp1 * valwgst;
+    om12 += temp1 * valpgst * valpgst * valwgst * (1.0 / (3.0 * tst));
+    om13 += temp1 * boost::math::pow<4>(valpgst) * valwgst * (1.0 / (12.0 * tst * tst));
+    om22 += temp2 * valpgst * valpgst * valwgst * (1.0 / (3.0 * tst));
+  }
+}
+
+TemperatureTM StdCalculationOperator::finishTM(const std::vector<double>& om11st, const std::vector<double>& om12st,
+                                               const std::vector<double>& om13st, const std::vector<double>& om22st,
+                                               int nbCycles, double temperature) const
+{
+  // Masses.
+  const double m1 = m_bufferGasMass;
+  const double m2 = m_molMass;
+
+  // Moyennes.
+  double mom11st = 0.0;
+  double mom12st = 0.0;
+  double mom13st = 0.0;
+  double mom22st = 0.0;
+  for (int ic = 0; ic < nbCycles; ++ic) {
+    mom11st += om11st[ic];
+    mom12st += om12st[ic];
+    mom13st += om13st[ic];
+    mom22st += om22st[ic];
+  }
+  mom11st /= nbCycles;
+  mom12st /= nbCycles;
+  mom13st /= nbCycles;
+  mom22st /= nbCycles;
+
+  // Deviation standard.
+  double sdom11st = 0.0;
+  double hold;
+  for (int ic = 0; ic < nbCycles; ++ic) {
+      hold = mom11st - om11st[ic];
+      sdom11st += hold * hold;
+  }
+  sdom11st = sqrt(sdom11st / nbCycles);
+  double cs = mom11st * M_PI * m_RoFromMobcal * m_RoFromMobcal;
+  double sdevpc = 100.0 * sdom11st / mom11st;
+
+  // On utilise les omegas pour obtenir un ordre superieur de facteur
+  // de correction pour les mobilites.
+  double ayst = mom22st / mom11st;
+  double best = ((5.0 * mom12st) - (4.0 * mom13st)) / mom11st;
+  double cest = mom12st / mom11st;
+  double term = ((4.0 * ayst) / 15.0) + (0.5 * (pow((m2 - m1), 2.0) / (m1 * m2)));
+  double u2 = term - (0.08333 * (2.4 * best + 1.0) * (m1 / m2));
+  double w = m1 / m2;
+  double delta = (pow(((6.0 * cest) - 5.0), 2.0) * w) / (60.0 * (1.0 + u2));
+  double f = 1.0 / (1.0 - delta);
+  double mob = (m_mobilityConstant * f) / (sqrt(temperature) * cs);
+
+  TemperatureTM result;
+  result.temperature = temperature;
+  result.crossSection = cs * 1.0 * pow(10, 20);
+  result.mobility = mob;
+  result.stdDeviation = sdevpc;
+  return result;
+}
+
+void StdCalculationOperator::finishTemperatureSweep(const std::vector<VelocityPoints>& temperatures, const std::vector<double>& velocities,
+                                                    const std::vector<double>& q1, const std::vector<double>& q2, int nbCycles)
+{
+  // La premiere temperature est m_temperature, deja donnee par le calcul.
+  for (unsigned int k = 1; k < temperatures.size(); ++k) {
+    std::vector<double> om11st(nbCycles, 0.0);
+    std::vector<double> om12st(nbCycles, 0.0);
+    std::vector<double> om13st(nbCycles, 0.0);
+    std::vector<double> om22st(nbCycles, 0.0);
+    for (int ic = 0; ic < nbCycles; ++ic) {
+      integrateCycleTM(temperatures[k], velocities, &q1[ic * m_numberPointsVelocity], &q2[ic * m_numberPointsVelocity],
+                       om11st[ic], om12st[ic], om13st[ic], om22st[ic]);
+    }
+    m_result->addTemperatureTM(finishTM(om11st, om12st, om13st, om22st, nbCycles, temperatures[k].temperature));
+  }
+}
+
+void StdCalculationOperator::saveTM(const TemperatureTM& tm, const std::vector<VelocityPoints>& temperatures,
+                                    const std::vector<double>& velocities, const std::vector<double>& q1,
+                                    const std::vector<double>& q2, int nbCycles)
+{
+  if (m_bufferGases.size() > 1) {
+    BufferGasTM gasTM;
+    gasTM.gas = m_bufferGases[m_bufferGasIndex];
+    gasTM.crossSection = tm.crossSection;
+    gasTM.mobility = tm.mobility;
+    gasTM.stdDeviation = tm.stdDeviation;
+    m_result->addBufferGasTM(gasTM);
+  }
+
+  // Seul le premier gaz donne les resultats principaux.
+  if (m_bufferGasIndex > 0) {
+    return;
+  }
+
+  m_result->setStandardDeviation(tm.stdDeviation);
+  if (!m_temperatureSweep.empty()) {
+    finishTemperatureSweep(temperatures, velocities, q1, q2, nbCycles);
+  }
+  m_result->setTM(tm.crossSection);
+}
+
+void StdCalculationOperator::calculateMonteCarloPoints(PotentialEngine& potentialEngine, unsigned int ic, unsigned int ig,
+                                                       double v, double b2max, unsigned int first, unsigned int n,
+                                                       double& temp1, double& temp2)
+{
+  StdMathLib mathLib;
+  std::vector<Vector3D> axes(m_initAxes);
+
+  // Avec les points de Sobol, (b, orientation) suit les points im de la
+  // suite, brouillee differemment a chaque cycle : les cycles sont des
+  // repliques independantes, dont l'ecart donne toujours l'erreur.
+  const bool sobol = m_samplingMethod == SamplingMethod::SOBOL;
+  RandomStream scrambling(m_seed, m_geometryIndex, ic, ig, m_ScramblingStream);
+  SobolSequence sobolSequence(4, scrambling);
+
+  // Les parametres d'impact et orientations sont tires, chaque point ayant
+  // ses propres nombres aleatoires, puis les trajectoires sont integrees ensemble.
+  std::vector<double> bs(n);
+  std::vector<Vector3D> orientations(3 * n);
+  std::vector<double> angs(n);
+  for (unsigned int im = 0; im < n; ++im) {
+    double rnb;
+    if (sobol) {
+      double u[4];
+      sobolSequence.getPoint(first + im, u);
+      rnb = u[0];
+      mathLib.rotate(mathLib.calculateUniformRotationMatrix(u[1], u[2], u[3]), m_initAxes, axes);
+    } else {
+      RandomStream stream(m_seed, m_geometryIndex, ic, ig, first + im);
+      rnb = stream.getRandomNumber();
+      mathLib.randomRotation(m_initAxes, axes, stream);
+    }
+    std::copy(axes.begin(), axes.end(), orientations.begin() + 3 * im);
+    bs[im] = m_RoFromMobcal * sqrt(rnb * b2max);
+  }
+  calculateTrajectories(potentialEngine, v, n, bs.data(), orientations.data(), angs.data());
+
+  temp1 = 0.0;
+  temp2 = 0.0;
+  for (unsigned int im = 0; im < n; ++im) {
+    double hold1 = 1.0 - cos(angs[im]);
+    double hold2 = sin(angs[im]);
+    hold2 *= hold2;
+    temp1 += (hold1 * b2max);
+    temp2 += (1.5 * hold2 * b2max);
+  }
+}
+
+std::vector<double> StdCalculationOperator::calculateB2max(const std::vector<double>& pgst, double rMax)
+{
+  const double dbst2 = 1.0;
+  const double dbst22 = dbst2 / 10.0;
+  const BufferGas gas = m_bufferGases[m_bufferGasIndex];
+  std::vector<double> b2max(m_numberPointsVelocity + 1, 0.0);
+
+  // Recherches de la geometrie precedente, pour le demarrage a chaud.
+  std::vector<int> guesses;
+  if (m_b2maxWarmStart) {
+    std::lock_guard<std::mutex> lock(m_b2maxProfilesMutex);
+    std::map<BufferGas, std::vector<int> >::const_iterator it = m_b2maxProfiles.find(gas);
+    if (it != m_b2maxProfiles.end() && it->second.size() == b2max.size()) {
+      guesses = it->second;
+    }
+  }
+  std::vector<int> profile(m_numberPointsVelocity + 1, -1);
+  int nbTrajectories = 0;
+  int nbSaved = 0;
+
+  // Chaque vitesse part du parametre d'impact maximal de la precedente,
+  // comme dans Mobcal : les vitesses sont traitees dans l'ordre.
+  for (int i = m_numberPointsVelocity; i >= 1; --i) {
+    double gst2 = boost::math::pow<2>(pgst[i]);
+    double v = sqrt((gst2 * m_EoFromMobcal) / (0.5 * m_massConstant));
+    int first = (int) (rMax / m_RoFromMobcal) - 6;
+    if (i < m_numberPointsVelocity) {
+      first = (int) (b2max[i + 1] / dbst2) - 6;
+    }
+    if (first < 0) {
+      first = 0;
+    }
+
+    int nbVelocityTrajectories = 0;
+    int ibst = searchImpactParameterLimit(v, first, guesses.empty() ? -1 : guesses[i], nbVelocityTrajectories);
+    profile[i] = ibst;
+    nbTrajectories += nbVelocityTrajectories;
+    // Sans demarrage a chaud, toutes les trajectoires de first a ibst.
+    nbSaved += (ibst - first + 1) - nbVelocityTrajectories;
+
+    // Affinage, au dixieme.
+    b2max[i] = (ibst - 5) * dbst2;
+    double ang;
+    do {
+      b2max[i] += dbst22;
+      double b = m_RoFromMobcal * sqrt(b2max[i]);
+      ang = calculateTrajectory(*m_potentialEngine, v, b);
+    } while (1.0 - cos(ang) > m_MaxImpactParameter);
+  }
+
+  if (m_b2maxWarmStart) {
+    std::lock_guard<std::mutex> lock(m_b2maxProfilesMutex);
+    m_b2maxProfiles[gas] = profile;
+  }
+  m_result->addB2maxTrajectories(nbTrajectories, nbSaved);
+
+  return b2max;
+}
+
+int StdCalculationOperator::searchImpactParameterLimit(double v, int first, int guess, int& nbTrajectories)
+{
+  const double dbst2 = 1.0;
+
+  // 1 - cos(angle de deviation) a chaque ibst, negatif si pas calcule.
+  // Vide a chaque vitesse : les deviations d'une autre vitesse, ou jamais
+  // calculees, ne sont jamais lues, contrairement a la recherche de Mobcal.
+  std::vector<double> cosx(m_MaxImpactParameterStep + 1, -1.0);
+  auto deviation = [&](int ibst) {
+    if (cosx[ibst] < 0.0) {
+      double bst2 = dbst2 * ibst;
+      double b = m_RoFromMobcal * sqrt(bst2);
+      double ang = calculateTrajectory(*m_potentialEngine, v, b);
+      cosx[ibst] = 1.0 - cos(ang);
+      ++nbTrajectories;
+    }
+    return cosx[ibst];
+  };
+
+  // Premier ibst dont les 5 trajectoires jusqu'a lui sont a tester.
+  int firstLimit = first + 4;
+  int ibst = first;
+
+  // Une trajectoire deviee sur 5, en descendant depuis la supposition,
+  // exclut toutes les series de 5 trajectoires avant elle : la recherche
+  // reprend alors a la supposition, sinon elle repart de first.
+  if (guess >= 0) {
+    guess = std::min(std::max(guess, firstLimit), m_MaxImpactParameterStep);
+    bool excluded = true;
+    for (int j = guess - 5; j >= first && excluded; j -= 5) {
+      excluded = deviation(j) >= m_MaxImpactParameter;
+    }
+    if (excluded) {
+      firstLimit = guess;
+      ibst = guess - 4;
+    }
+  }
+
+  do {
+    deviation(ibst);
+    if (ibst >= firstLimit && cosx[ibst] < m_MaxImpactParameter
+        && cosx[ibst - 1] < m_MaxImpactParameter
+        && cosx[ibst - 2] < m_MaxImpactParameter
+        && cosx[ibst - 3] < m_MaxImpactParameter
+        && cosx[ibst - 4] < m_MaxImpactParameter) {
+      return ibst;
+    }
+
+    ibst += 1;
+    if (ibst > m_MaxImpactParameterStep) {
+      throw std::string("Ibst superior to 500.");
+    }
+  } while (true);
+}
+
+void StdCalculationOperator::calculateTimeSteps(double v, double& dt1, double& dt2) const
+{
+  // On calcule le pas entre chaque point de la trajectoire
+  double top;
+  if (v >= 3000.0) {
+    top = 2.5;
+  } else if (v >= 2000.0) {
+    top = 10.0 - ((v - 2000.0) * 7.5 * boost::math::pow<-3>(10));
+  } else if (v >= 1000.0) {
+    top = 10.0;
+  } else {
+    top = (v / 95.2381) - 0.5;
+  }
+
+  dt1 = (top * m_timeStepStart * 1.0 * boost::math::pow<-11>(10)) / v;
+  dt2 = dt1 * m_timeStepCloseCollision;
+}
+
+bool StdCalculationOperator::findStartingPoint(PotentialEngine& potentialEngine, double e0, Vector3D& xyz, double& pot, double& dMax)
+{
+  double yMin = 0.0;
+  double yMax = 0.0;
+  if (potentialEngine.getMaxY() > yMax) {
+    yMax = potentialEngine.getMaxY();
+  }
+  if (potentialEngine.getMinY() < yMin) {
+    yMin = potentialEngine.getMinY();
+  }
+  // Conversion en metres
+  yMax /= 1.0 * ANGSTROMTOMETER;
+  yMin /= 1.0 * ANGSTROMTOMETER;
+  int iyMin = (int) yMin - 1;
+  int iyMax = (int) yMax + 1;
+
+  int id2 = iyMax;
+  xyz.y = id2 * 1.0 * ANGSTROMTOMETER;
+  Vector3D dpot(0.0, 0.0, 0.0);
+  pot = potentialEngine.calculatePotential(xyz, dpot, dMax);
+
+  if (fabs(pot / e0) <= m_potentialEnergyStart) {
+    do {
+      id2 -= 1.0;
+      xyz.y = id2 * 1.0 * ANGSTROMTOMETER;
+      pot = potentialEngine.calculatePotential(xyz, dpot, dMax);
+      if (id2 < iyMin) {
+        return false;
+      }
+
+      xyz.y = id2 * 1.0 * ANGSTROMTOMETER;
+      pot = potentialEngine.calculatePotential(xyz, dpot, dMax);
+    } while (fabs(pot / e0) < m_potentialEnergyStart);
+  } else {
+
+    do {
+      id2 += 10.0;
+      xyz.y = id2 * 1.0 * ANGSTROMTOMETER;
+      pot = potentialEngine.calculatePotential(xyz, dpot, dMax);
+    } while (fabs(pot / e0) > m_potentialEnergyStart);
+
+
+    do {
+      id2 -= 1.0;
+      xyz.y = id2 * 1.0 * ANGSTROMTOMETER;
+      pot = potentialEngine.calculatePotential(xyz, dpot, dMax);
+    } while(fabs(pot / e0) < m_potentialEnergyStart);
+  }
+
+  xyz.y = id2 * 1.0 * ANGSTROMTOMETER;
+  return true;
+}
+
+/**
+ * Defines Hamilton's equations of motion ad the time derivates of
+ * the coordinates and momenta.
+ * \return the potential
+ */
+double StdCalculationOperator::calculateHamilton(PotentialEngine& potentialEngine, std::array<double, 6>& w, std::array<double, 6>& dw, double& dMax)
+{
+  // Dans les equations d'Hamilton, les derivees des coordonnees selon le temps
+  // sont les conjugues divises par la masse.
+  dw[0] = w[1] / m_massConstant;
+  dw[2] = w[3] / m_massConstant;
+  dw[4] = w[5] / m_massConstant;
+  // Les equations d'Hamilton pour les derivees du momentum selon le temps
+  // sont evaluees en utilisation les derivees des coordonnees.
+  // Ce sont des derivees analytiques.
+  Vector3D dPot(0.0, 0.0, 0.0);
+  double pot = potentialEngine.calculatePotential(Vector3D(w[0], w[2], w[4]), dPot, dMax);
+  dw[1] = -dPot.x;
+  dw[3] = -dPot.y;
+  dw[5] = -dPot.z;
+
+  return pot;
+}
+
+/**
+ * Integration method. Uses 5th order Runge-Kutta-Gill to initiate and 5th order
+ * Adams-Moulton predictor-corrector to propagate.
+ * \return the potential
+ */
+double StdCalculationOperator::calculateRKandAM(PotentialEngine& potentialEngine, int& l, double& tim, double& dt, std::array<double, 6>& w, std::array<double, 6>& dw, std::array<std::array<double, 6>, 6>& arrayDouble, double& dMax, double& hVar, double& hcVar)
+{
+  // pot inutile a mon avis
+  double pot = 0.0;
+  double q[6];
+  double savw[6];
   double savdw[6];
   double r;
 
@@ -994,7 +1773,7 @@ double StdCalculationOperator::calculateRKandAM(std::vector<Vector3D>& molPos, i
         if (pow(-1.0, (j + 1)) > 0.0) {
           tim += 0.5 * dt;
         }
-        pot = calculateHamilton(molPos, w, dw, dMax);
+        pot = calculateHamilton(potentialEngine, w, dw, dMax);
 
         for (int i = 0; i < 6; ++i) {
           dw[i] *= dt;
@@ -1003,7 +1782,7 @@ double StdCalculationOperator::calculateRKandAM(std::vector<Vector3D>& molPos, i
           q[i] = q[i] + 3.0 * r + c[j] * dw[i];
         }
       }
-      pot = calculateHamilton(molPos, w, dw, dMax);
+      pot = calculateHamilton(potentialEngine, w, dw, dMax);
     }
 
     if (l - 6 >= 0) {
@@ -1029,7 +1808,7 @@ double StdCalculationOperator::calculateRKandAM(std::vector<Vector3D>& molPos, i
     }
     tim += dt;
 
-    pot = calculateHamilton(molPos, w, dw, dMax);
+    pot = calculateHamilton(potentialEngine, w, dw, dMax);
     for (int j = 0; j < 6; ++j) {
       arrayDouble[5][j] = acst * dw[j];
       for (int i = 0; i < 4; ++i) {
@@ -1040,7 +1819,399 @@ double StdCalculationOperator::calculateRKandAM(std::vector<Vector3D>& molPos, i
       w[j] = savw[j] + hcVar * (arrayDouble[4][j] + arrayDouble[5][j]);
     }
 
-    pot = calculateHamilton(molPos, w, dw, dMax);
+    pot = calculateHamilton(potentialEngine, w, dw, dMax);
     return pot;
   }
 }
+
+void StdCalculationOperator::calculateTrajectories(PotentialEngine& potentialEngine, double v, unsigned int n,
+                                                   const double* b, const Vector3D* axes, double* ang)
+{
+  const unsigned int nbLanes = std::min(n, SystemParameters::getInstance()->getTrajectoryBatchSize());
+
+  // Une trajectoire a la fois.
+  if (nbLanes <= 1) {
+    std::vector<Vector3D> orientation(3);
+    for (unsigned int i = 0; i < n; ++i) {
+      orientation.assign(&axes[3 * i], &axes[3 * i + 3]);
+      potentialEngine.setOrientation(orientation);
+      ang[i] = calculateTrajectory(potentialEngine, v, b[i]);
+    }
+    return;
+  }
+
+  std::vector<Trajectory> trajectories(nbLanes);
+  std::vector<bool> active(nbLanes, false);
+
+  // Trajectoires qui attendent leur potentiel, avec leurs positions et orientations.
+  std::vector<unsigned int> waiting(nbLanes);
+  std::vector<Vector3D> waitingAxes(3 * nbLanes);
+  std::vector<Vector3D> p(nbLanes);
+  std::vector<Vector3D> dPot(nbLanes);
+  std::vector<double> pot(nbLanes);
+  std::vector<double> dMax(nbLanes);
+
+  unsigned int next = 0;
+  unsigned int nbWaiting;
+  do {
+    nbWaiting = 0;
+    for (unsigned int k = 0; k < nbLanes; ++k) {
+      Trajectory& t = trajectories[k];
+
+      // Une trajectoire terminee est remplacee par la suivante.
+      bool needsPotential = active[k] && advanceTrajectory(t);
+      while (!needsPotential) {
+        if (active[k]) {
+          ang[t.index] = t.ang;
+          active[k] = false;
+          countTrajectory(t.ns, t.nbPotentialCalculations);
+        }
+        if (next == n) {
+          break;
+        }
+
+        t.index = next;
+        t.axes = &axes[3 * next];
+        active[k] = startTrajectory(potentialEngine, v, b[next], t);
+        if (!active[k]) {
+          ang[next] = t.ang;
+        }
+        next++;
+        needsPotential = active[k] && advanceTrajectory(t);
+      }
+
+      if (needsPotential) {
+        waiting[nbWaiting] = k;
+        waitingAxes[3 * nbWaiting] = t.axes[0];
+        waitingAxes[3 * nbWaiting + 1] = t.axes[1];
+        waitingAxes[3 * nbWaiting + 2] = t.axes[2];
+        p[nbWaiting] = Vector3D(t.w[0], t.w[2], t.w[4]);
+        nbWaiting++;
+      }
+    }
+
+    if (nbWaiting > 0) {
+      potentialEngine.calculatePotentials(nbWaiting, waitingAxes.data(), p.data(),
+                                          pot.data(), dPot.data(), dMax.data());
+
+      // Equations d'Hamilton, comme dans calculateHamilton.
+      for (unsigned int i = 0; i < nbWaiting; ++i) {
+        Trajectory& t = trajectories[waiting[i]];
+        t.dw[0] = t.w[1] / m_massConstant;
+        t.dw[2] = t.w[3] / m_massConstant;
+        t.dw[4] = t.w[5] / m_massConstant;
+        t.dw[1] = -dPot[i].x;
+        t.dw[3] = -dPot[i].y;
+        t.dw[5] = -dPot[i].z;
+        t.pot = pot[i];
+        t.dMax = dMax[i];
+        t.evaluated = true;
+        t.nbPotentialCalculations++;
+      }
+    }
+  } while (nbWaiting > 0);
+}
+
+bool StdCalculationOperator::startTrajectory(PotentialEngine& potentialEngine, double v, double b, Trajectory& t)
+{
+  // L'orientation sert aux bornes sur Y de la recherche du point de depart.
+  // Sans axes, celle du moteur est gardee.
+  if (t.axes != nullptr) {
+    std::vector<Vector3D> orientation(t.axes, t.axes + 3);
+    potentialEngine.setOrientation(orientation);
+  }
+
+  t.v = v;
+  t.ang = 0.0;
+  calculateTimeSteps(v, t.dt1, t.dt2);
+  t.dt = t.dt1;
+
+  t.e0 = 0.5 * m_massConstant * v * v;
+  Vector3D xyz(b, 0.0, 0.0);
+  if (!findStartingPoint(potentialEngine, t.e0, xyz, t.pot, t.dMax)) {
+    return false;
+  }
+  t.etot = t.e0 + t.pot;
+
+  // Coordonnees initiales et momentum, l'Helium allant selon -Y.
+  t.w[0] = xyz.x;
+  t.w[1] = 0.0;
+  t.w[2] = xyz.y;
+  t.w[3] = -v * m_massConstant;
+  t.w[4] = xyz.z;
+  t.w[5] = 0.0;
+
+  for (int i = 0; i < 6; ++i) {
+    t.arrayDouble[i].fill(0.0);
+  }
+  t.q.fill(0.0);
+  t.l = 0;
+  t.hVar = 0.0;
+  t.hcVar = 0.0;
+  t.ns = 0;
+  t.nw = 0;
+  t.nbRejected = 0;
+  t.nbPotentialCalculations = 0;
+  t.stage = 0;
+  // Les derivees initiales restent a calculer.
+  t.evaluated = false;
+
+  return true;
+}
+
+bool StdCalculationOperator::advanceTrajectory(Trajectory& t)
+{
+  if (m_integrator == TrajectoryIntegrator::DORMAND_PRINCE) {
+    return advanceTrajectoryDormandPrince(t);
+  }
+
+  while (true) {
+    // Un pas de calculateRKandAM. Le potentiel n'est calcule que si les
+    // coordonnees ont change depuis le dernier calcul.
+    if (t.l >= 0) {
+      // Runge-Kutta : deux demi-etapes de 5 calculs du potentiel.
+      if (t.stage == 0) {
+        if (t.l == 0) {
+          t.q.fill(0.0);
+          t.hVar = t.dt * var;
+          t.hcVar = t.dt * cvar;
+          t.dt *= 0.5;
+        }
+        t.l += 1;
+        t.stage = 1;
+      }
+
+      while (t.stage <= 10) {
+        if (!t.evaluated) {
+          return true;
+        }
+        // Le cinquieme calcul de chaque demi-etape ne deplace pas l'Helium.
+        const int j = (t.stage - 1) % 5;
+        if (j < 4) {
+          for (int i = 0; i < 6; ++i) {
+            t.dw[i] *= t.dt;
+            double r = a[j] * (t.dw[i] - b[j] * t.q[i]);
+            t.w[i] += r;
+            t.q[i] = t.q[i] + 3.0 * r + c[j] * t.dw[i];
+          }
+          t.evaluated = false;
+        }
+        t.stage++;
+      }
+
+      if (t.l - 6 >= 0) {
+        t.l = -1;
+        t.dt *= 2.0;
+      } else {
+        for (int j = 0; j < 6; ++j) {
+          t.arrayDouble[t.l - 1][j] = t.dw[j];
+        }
+      }
+    } else {
+      // Adams-Moulton : prediction puis correction.
+      if (t.stage == 0) {
+        for (int j = 0; j < 6; ++j) {
+          t.savw[j] = t.w[j];
+          t.savdw[j] = t.dw[j];
+          t.arrayDouble[5][j] = t.savdw[j];
+
+          for (int i = 0; i < 5; ++i) {
+            t.arrayDouble[5][j] += ampc[i] * t.arrayDouble[i][j];
+          }
+          t.w[j] += t.arrayDouble[5][j] * t.hVar;
+        }
+        t.evaluated = false;
+        t.stage = 1;
+      }
+      if (!t.evaluated) {
+        return true;
+      }
+
+      if (t.stage == 1) {
+        for (int j = 0; j < 6; ++j) {
+          t.arrayDouble[5][j] = acst * t.dw[j];
+          for (int i = 0; i < 4; ++i) {
+            t.arrayDouble[i][j] = t.arrayDouble[i + 1][j];
+            t.arrayDouble[5][j] += t.arrayDouble[i][j] * amcc[i];
+          }
+          t.arrayDouble[4][j] = t.savdw[j];
+          t.w[j] = t.savw[j] + t.hcVar * (t.arrayDouble[4][j] + t.arrayDouble[5][j]);
+        }
+        t.evaluated = false;
+        t.stage = 2;
+        return true;
+      }
+    }
+    t.stage = 0;
+
+    // Memes tests que calculateTrajectory.
+    t.nw += 1;
+    if (t.nw != m_NbIntegrationStep) {
+      continue;
+    }
+    t.ns += t.nw;
+    t.nw = 0;
+
+    // On verifie si on a "perdu" la trajectoire (trop d'essais)
+    if (t.ns > 30000) {
+      t.ang = M_PI / 2.0;
+      return false;
+    }
+
+    // On verifie si la trajectoire est terminee.
+    if (t.dMax < m_maxROLJ) {
+      continue;
+    }
+    if (fabs(t.pot / t.e0) > m_potentialEnergyCloseCollision && t.dt == t.dt1) {
+      t.dt = t.dt2;
+      t.l = 0;
+    }
+    if (fabs(t.pot / t.e0) < m_potentialEnergyCloseCollision && t.dt == t.dt2) {
+      t.dt = t.dt1;
+      t.l = 0;
+    }
+    if (fabs(t.pot / t.e0) > m_potentialEnergyStart || t.ns < 50) {
+      continue;
+    }
+
+    finishTrajectory(t);
+    return false;
+  }
+}
+
+bool StdCalculationOperator::advanceTrajectoryDormandPrince(Trajectory& t)
+{
+  while (true) {
+    // Derivees demandees et pas encore calculees.
+    if (!t.evaluated) {
+      return true;
+    }
+
+    if (t.stage == 0) {
+      // Debut d'un pas : les derivees au point de depart sont celles de la
+      // fin du pas precedent (FSAL).
+      t.savw = t.w;
+      t.k[0] = t.dw;
+      t.savPot = t.pot;
+      t.savDMax = t.dMax;
+    } else {
+      t.k[t.stage] = t.dw;
+    }
+
+    // Etages suivants, un calcul du potentiel chacun.
+    // Le dernier donne la solution d'ordre 5 et ses derivees.
+    if (t.stage < 6) {
+      t.stage++;
+      for (int i = 0; i < 6; ++i) {
+        double sum = 0.0;
+        for (int j = 0; j < t.stage; ++j) {
+          sum += dpa[t.stage][j] * t.k[j][i];
+        }
+        t.w[i] = t.savw[i] + t.dt * sum;
+      }
+      t.evaluated = false;
+      return true;
+    }
+    t.stage = 0;
+
+    // Erreur estimee par la difference avec la solution d'ordre 4, relative
+    // aux coordonnees (au moins 1 angstrom) et aux momenta (au moins celui
+    // de depart).
+    double err = 0.0;
+    for (int i = 0; i < 6; ++i) {
+      double sum = 0.0;
+      for (int j = 0; j < 7; ++j) {
+        sum += dpe[j] * t.k[j][i];
+      }
+      double ref = (i % 2 == 0) ? 1.0 * boost::math::pow<-10>(10) : m_massConstant * t.v;
+      double sc = m_integratorTolerance * std::max(std::max(fabs(t.savw[i]), fabs(t.w[i])), ref);
+      err += (t.dt * sum / sc) * (t.dt * sum / sc);
+    }
+    err = sqrt(err / 6.0);
+
+    // Nouveau pas, borne pour que l'Helium ne traverse pas un atome.
+    double factor = (err > 0.0) ? 0.9 * pow(err, -0.2) : 5.0;
+    factor = std::min(std::max(factor, 0.2), 5.0);
+    if (err > 1.0 || t.nw > 0) {
+      factor = std::min(factor, 1.0);
+    }
+    double speed = sqrt(t.w[1] * t.w[1] + t.w[3] * t.w[3] + t.w[5] * t.w[5]) / m_massConstant;
+
+    if (err > 1.0) {
+      // Pas rejete : on repart du debut du pas.
+      t.w = t.savw;
+      t.dw = t.k[0];
+      t.pot = t.savPot;
+      t.dMax = t.savDMax;
+      t.nbRejected++;
+      t.nw++;
+      t.dt *= factor;
+    } else {
+      t.ns++;
+      t.nw = 0;
+      t.dt *= factor;
+    }
+    if (speed > 0.0) {
+      t.dt = std::min(t.dt, m_maxROLJ / speed);
+    }
+
+    // On verifie si on a "perdu" la trajectoire (trop d'essais)
+    if (t.ns + t.nbRejected > 30000) {
+      t.ang = M_PI / 2.0;
+      return false;
+    }
+    if (err > 1.0) {
+      continue;
+    }
+
+    // On verifie si la trajectoire est terminee : loin des atomes, potentiel
+    // sous sw1 et l'Helium s'eloignant de la molecule.
+    if (t.dMax < m_maxROLJ) {
+      continue;
+    }
+    if (fabs(t.pot / t.e0) > m_potentialEnergyStart
+        || t.w[0] * t.w[1] + t.w[2] * t.w[3] + t.w[4] * t.w[5] <= 0.0) {
+      continue;
+    }
+
+    finishTrajectory(t);
+    return false;
+  }
+}
+
+void StdCalculationOperator::finishTrajectory(Trajectory& t)
+{
+  // On determine l'angle de deviation
+  double num = t.dw[2] * (-t.v);
+  double den = t.v * sqrt(t.dw[0] * t.dw[0] + t.dw[2] * t.dw[2] + t.dw[4] * t.dw[4]);
+  if (t.dw[0] > 0.0) {
+    t.ang = acos(num / den);
+  } else if (t.dw[0] < 0.0) {
+    t.ang = -acos(num / den);
+  }
+
+  // On verifie la conservation de l'energie.
+  double e = 0.5 * m_massConstant * (t.dw[0] * t.dw[0] + t.dw[2] * t.dw[2] + t.dw[4] * t.dw[4]);
+  double erat = (e + t.pot) / t.etot;
+  if (!(erat < 2.0 - (m_energyConservationThreshold / 100.0) && erat > m_energyConservationThreshold / 100.0)) {
+    #pragma omp atomic
+    m_nbFailedTrajectories++;
+  }
+}
+
+void StdCalculationOperator::evaluateTrajectory(PotentialEngine& potentialEngine, Trajectory& t)
+{
+  t.pot = calculateHamilton(potentialEngine, t.w, t.dw, t.dMax);
+  t.evaluated = true;
+  t.nbPotentialCalculations++;
+}
+
+void StdCalculationOperator::countTrajectory(int nbSteps, int nbPotentialCalculations)
+{
+  #pragma omp atomic
+  m_nbIntegratedTrajectories++;
+  #pragma omp atomic
+  m_nbIntegrationSteps += nbSteps;
+  #pragma omp atomic
+  m_nbPotentialCalculations += nbPotentialCalculations;
+}
@@ -23,11 +23,19 @@
 #define STDCALCULATIONOPERATOR_H
 
 #include "CalculationOperator.h"
+#include "PotentialEngine.h"
+#include "SphereBVH.h"
 
+#include "../general/Checkpoint.h"
+#include "../general/GlobalParameters.h"
 #include "../molecule/Molecule.h"
 #include "Vector3D.h"
 
 #include <array>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
 #include <vector>
 
 
@@ -82,19 +90,108 @@ class StdCalculationOperator : public CalculationOperator
      */
     void runTM();
 
+    /**
+     * Sets the index of the geometry among those calculated. With the seed,
+     * it identifies the random numbers drawn for this geometry.
+     * \param index the index of the geometry.
+     */
+    void setGeometryIndex(unsigned int index) {
+      m_geometryIndex = index;
+    }
+
+    /**
+     * Indicates if yes or no, the structural asymmetry parameter should be
+     * calculated by runTM.
+     * \param b true if the structural asymmetry parameter should be calculated.
+     */
+    void setAsymmetryParameterCalculated(bool b) {
+      m_asymmetryParameterCalculated = b;
+    }
+
+  public:
+    /**
+     * \param gas a buffer gas.
+     * \return the name of gas, as given on the command line.
+     */
+    static std::string getBufferGasName(BufferGas gas);
+
+    /**
+     * Finds the buffer gas named name.
+     * \param name the name of the buffer gas (he, n2, uffhe, uffn2).
+     * \param gas the buffer gas found.
+     * \return true if name is a known buffer gas.
+     */
+    static bool findBufferGas(const std::string& name, BufferGas& gas);
 
   protected:
     // EHSS et PA
     /**
      * Calculates EHSS and PA and put the results in
      * m_result attribute.
+     * \param data the atoms to use for calculation, centered.
+     */
+    virtual void calculateEHSSAndPA(const MoleculeData& data);
+
+    /**
+     * Sums of the trajectories of EHSS and PA.
+     */
+    struct HardSphereSums {
+      /// Sums of the cross-sections for each order of collision.
+      std::vector<double> ccs;
+      /// Sum of the projections.
+      double projection;
+      /// Greatest order of collision met.
+      int highestCollOrder;
+      /// With Sobol points, sums of the cross-sections at the last order
+      /// and of the projections for each scrambling.
+      std::vector<double> replicateCCS;
+      std::vector<double> replicateProjection;
+    };
+
+    /**
+     * Calculates the trajectories first to first + n - 1 of EHSS and PA.
+     * Each trajectory is a ray in a random direction, drawn with its own
+     * random stream, so the sums only depend on the trajectories asked, not
+     * on the thread. The atoms are never moved, so the hierarchy is shared
+     * by all the threads.
+     * \param bvh the hard spheres of the atoms, centered on the center of mass.
+     * \param first the first trajectory.
+     * \param n the number of trajectories.
+     * \param sums the sums of the trajectories.
+     */
+    void calculateHardSphereTrajectories(const SphereBVH& bvh, unsigned int first, unsigned int n, HardSphereSums& sums);
+
+    /**
+     * Adds the sums of the groups of trajectories of EHSS and PA, in order,
+     * and puts the cross-sections in m_result. With the rasterized PA, the
+     * projection of the trajectories is replaced by calculateRasterizedPA.
+     * \param bvh the hard spheres of the atoms.
+     * \param sums the sums of each group of trajectories.
      */
-    void calculateEHSSAndPA(Molecule* mol);
+    void finishEHSSAndPA(const SphereBVH& bvh, const std::vector<HardSphereSums>& sums);
 
     /**
-     * Guides hard sphere scattering trajectory.
+     * Calculates PA without random numbers: the projected area of the hard
+     * spheres is rasterized for each direction of a fixed set and averaged.
+     * \param bvh the hard spheres of the atoms.
+     * \return the average projected area, in square angstroms.
      */
-    void che(Molecule* mol, int refl, double& halfCos, double cop, double& yRand, double& zRand, bool& kp, Vector3D& initialIncidenceVector);
+    virtual double calculateRasterizedPA(const SphereBVH& bvh);
+
+    /**
+     * Guides hard sphere scattering trajectory: finds the next collision of
+     * the ray and reflects it on the atom hit.
+     * \param bvh the hard spheres of the atoms.
+     * \param refl the order of the collision.
+     * \param halfCos the cosine of half the angle between the initial and the reflected rays.
+     * \param cop halfCos before this collision.
+     * \param origin the origin of the ray, moved to the collision.
+     * \param direction the direction of the ray, reflected by the collision.
+     * \param kp set to true if the ray hits an atom.
+     * \param initialDirection the direction of the ray before the first collision.
+     */
+    void che(const SphereBVH& bvh, int refl, double& halfCos, double cop, Vector3D& origin, Vector3D& direction,
+             bool& kp, const Vector3D& initialDirection);
 
   protected:
     /**
@@ -118,33 +215,421 @@ class StdCalculationOperator : public CalculationOperator
     void calculateAsymmetryParameter();
 
     /**
-     * Calculates the potential and the derivates of the potential.
-     * The potential is given by a sum of 6-12 two body ...
-     * \param p the position for the calculation
-     * \param dPot the derivates of the potential
-     * \return the potential
+     * Selects the buffer gas of TM : the Lennard-Jones parameters of the
+     * atoms are read in its columns, and the constants depending on its mass
+     * and polarizability are calculated.
+     * \param index the index of the buffer gas in m_bufferGases.
+     * \param data the atoms of the molecule, or nullptr to only calculate
+     * the constants.
+     */
+    void selectBufferGas(unsigned int index, const MoleculeData* data);
+
+    /**
+     * \return the number of threads the calculations can use.
+     */
+    virtual unsigned int getNumberThreads() const {
+      return 1;
+    }
+
+    /**
+     * Creates the engine evaluating the potential on the positions in
+     * m_molPos, in the mode asked in GlobalParameters and with the kernel
+     * asked in SystemParameters.
+     * \return the engine, to destroy by the caller.
      */
-    double calculatePotentials(std::vector<Vector3D>& molPos, const Vector3D& p, Vector3D& dPot, double& dMax);
+    PotentialEngine* createPotentialEngine() const;
+
+    /**
+     * Compares m_potentialEngine to the exact sum on random points around
+     * the molecule, and puts the greatest errors in m_result.
+     */
+    void estimatePotentialError();
 
     /**
      * Calculates a trajectory.
+     * \param potentialEngine the engine holding the positions of the atoms.
      * \return angle of deviation
      */
-    double calculateTrajectory(std::vector<Vector3D>& molPos, double v, double b);
+    double calculateTrajectory(PotentialEngine& potentialEngine, double v, double b);
+
+    /**
+     * Calculates n trajectories at the same velocity. Up to getTrajectoryBatchSize()
+     * trajectories are integrated together, step after step, their potentials
+     * being calculated together by the engine. A finished trajectory is replaced
+     * by the next one.
+     * \param potentialEngine the engine holding the positions of the atoms.
+     * Its orientation is changed.
+     * \param v the velocity.
+     * \param n the number of trajectories.
+     * \param b the impact parameter of each trajectory.
+     * \param axes the orientation of the molecule for each trajectory (3 * n
+     * vectors, images of the X, Y and Z axes).
+     * \param ang the angles of deviation (n values).
+     */
+    void calculateTrajectories(PotentialEngine& potentialEngine, double v, unsigned int n,
+                               const double* b, const Vector3D* axes, double* ang);
+
+    /**
+     * \return the number of points of the Monte-Carlo integration of TM method
+     * integrated together by calculateMonteCarloPoints.
+     */
+    unsigned int getMonteCarloChunkSize() const;
+
+    /**
+     * \return the number of scramblings of the Sobol points of EHSS/PA,
+     * each of them having at least one point.
+     */
+    unsigned int getNumberReplicatesQMC() const;
+
+    /**
+     * Velocities of the integration of TM at one temperature, with their
+     * weights, from index 1.
+     */
+    struct VelocityPoints {
+      /// The temperature.
+      double temperature;
+      /// Reduced velocities.
+      std::vector<double> pgst;
+      /// Weights of the velocities.
+      std::vector<double> wgst;
+    };
+
+    /**
+     * Calculates the m_numberPointsVelocity velocities of TM at a
+     * temperature, as Mobcal : each of them stands for a same part of the
+     * distribution of the velocities.
+     * \param temperature the temperature.
+     * \return the velocities and their weights.
+     */
+    VelocityPoints calculateVelocityPoints(double temperature) const;
+
+    /**
+     * Calculates the velocities of each temperature of TM : m_temperature,
+     * then the temperatures of the sweep.
+     * \return the velocities of each temperature.
+     */
+    std::vector<VelocityPoints> calculateTemperaturesTM() const;
+
+    /**
+     * Returns the velocities where the trajectories of TM are calculated.
+     * Without sweep, they are the velocities of m_temperature. With a sweep,
+     * they go from the velocities of the lowest temperature to the ones of
+     * the highest, so that they are shared by all the temperatures.
+     * \param temperatures the velocities of each temperature.
+     * \return the reduced velocities, from index 1.
+     */
+    std::vector<double> calculateTrajectoryVelocities(const std::vector<VelocityPoints>& temperatures) const;
+
+    /**
+     * Integrates Q(1)* and Q(2)* of a cycle over the velocities of a
+     * temperature, adding the terms to the Omegas. With a sweep, Q(1)* and
+     * Q(2)* are interpolated from the velocities of the trajectories.
+     * \param points the velocities of the temperature.
+     * \param velocities the velocities of the trajectories, from index 1.
+     * \param q1 the Q(1)* of the cycle at each velocity of the trajectories.
+     * \param q2 the Q(2)* of the cycle at each velocity of the trajectories.
+     * \param om11 Omega(1, 1)* of the cycle.
+     * \param om12 Omega(1, 2)* of the cycle.
+     * \param om13 Omega(1, 3)* of the cycle.
+     * \param om22 Omega(2, 2)* of the cycle.
+     */
+    void integrateCycleTM(const VelocityPoints& points, const std::vector<double>& velocities,
+                          const double* q1, const double* q2,
+                          double& om11, double& om12, double& om13, double& om22) const;
+
+    /**
+     * Averages the Omegas of the cycles and calculates the cross-section and
+     * the mobility, corrected with the higher order Omegas.
+     * \param om11st Omega(1, 1)* of each cycle.
+     * \param om12st Omega(1, 2)* of each cycle.
+     * \param om13st Omega(1, 3)* of each cycle.
+     * \param om22st Omega(2, 2)* of each cycle.
+     * \param nbCycles the number of cycles calculated.
+     * \param temperature the temperature.
+     * \return the cross-section (square angstroms), mobility and standard
+     * deviation of the cycles.
+     */
+    TemperatureTM finishTM(const std::vector<double>& om11st, const std::vector<double>& om12st,
+                           const std::vector<double>& om13st, const std::vector<double>& om22st,
+                           int nbCycles, double temperature) const;
+
+    /**
+     * Calculates TM at each temperature of the sweep from the Q(1)* and Q(2)*
+     * of all the cycles, and adds the results to m_result.
+     * \param temperatures the velocities of each temperature.
+     * \param velocities the velocities of the trajectories, from index 1.
+     * \param q1 the Q(1)* of each cycle and velocity of the trajectories.
+     * \param q2 the Q(2)* of each cycle and velocity of the trajectories.
+     * \param nbCycles the number of cycles calculated.
+     */
+    void finishTemperatureSweep(const std::vector<VelocityPoints>& temperatures, const std::vector<double>& velocities,
+                                const std::vector<double>& q1, const std::vector<double>& q2, int nbCycles);
+
+    /**
+     * Saves the result of TM with the selected buffer gas in m_result. The
+     * first buffer gas gives the main results and the temperature sweep.
+     * \param tm the result at m_temperature.
+     * \param temperatures the velocities of each temperature.
+     * \param velocities the velocities of the trajectories, from index 1.
+     * \param q1 the Q(1)* of each cycle and velocity of the trajectories.
+     * \param q2 the Q(2)* of each cycle and velocity of the trajectories.
+     * \param nbCycles the number of cycles calculated.
+     */
+    void saveTM(const TemperatureTM& tm, const std::vector<VelocityPoints>& temperatures,
+                const std::vector<double>& velocities, const std::vector<double>& q1,
+                const std::vector<double>& q2, int nbCycles);
+
+    /**
+     * Reports the estimate of TM after a cycle, when the cycles stop at
+     * a target of the relative standard error.
+     * \param om11st the Omega(1, 1)* of each cycle.
+     * \param nbCycles the number of cycles calculated.
+     * \return true if the relative standard error of the mean of the
+     * Omega(1, 1)* is under the target, the next cycles being useless.
+     */
+    bool isTMConverged(const std::vector<double>& om11st, int nbCycles);
+
+    /**
+     * Saves the number of cycles calculated by TM and the relative standard
+     * error of the mean of their Omega(1, 1)* in m_result.
+     */
+    void saveConvergenceTM(const std::vector<double>& om11st, int nbCycles);
+
+    /**
+     * Takes the cycles of TM saved in the checkpoint of the geometry for
+     * the buffer gas being calculated, with b2max.
+     * \param b2max b2max at each velocity, left empty if no cycle is taken.
+     * \param om11st the Omega(1, 1)* of each cycle.
+     * \param om12st the Omega(1, 2)* of each cycle.
+     * \param om13st the Omega(1, 3)* of each cycle.
+     * \param om22st the Omega(2, 2)* of each cycle.
+     * \param q1st the Q(1)* of each cycle and velocity.
+     * \param q2st the Q(2)* of each cycle and velocity.
+     * \return the number of cycles taken, 0 if TM starts from the beginning.
+     */
+    int resumeCyclesTM(std::vector<double>& b2max, std::vector<double>& om11st, std::vector<double>& om12st,
+                       std::vector<double>& om13st, std::vector<double>& om22st,
+                       std::vector<double>& q1st, std::vector<double>& q2st);
+
+    /**
+     * Saves the cycles of TM done for the buffer gas being calculated in
+     * the checkpoint of the geometry, if the progression is saved.
+     * \param b2max b2max at each velocity.
+     * \param om11st the Omega(1, 1)* of each cycle.
+     * \param om12st the Omega(1, 2)* of each cycle.
+     * \param om13st the Omega(1, 3)* of each cycle.
+     * \param om22st the Omega(2, 2)* of each cycle.
+     * \param q1st the Q(1)* of each cycle and velocity.
+     * \param q2st the Q(2)* of each cycle and velocity.
+     * \param nbCycles the number of cycles done.
+     */
+    void checkpointCyclesTM(const std::vector<double>& b2max, const std::vector<double>& om11st,
+                            const std::vector<double>& om12st, const std::vector<double>& om13st,
+                            const std::vector<double>& om22st, const std::vector<double>& q1st,
+                            const std::vector<double>& q2st, int nbCycles);
+
+    /**
+     * Takes the results saved in the checkpoint of the geometry, once, before
+     * the first calculation.
+     */
+    void restoreCheckpoint();
+
+    /**
+     * Saves m_checkpoint, with the results known, if the progression is saved.
+     */
+    void saveCheckpoint();
+
+    /**
+     * Integrates points of the Monte-Carlo integration of TM method, at a
+     * cycle and a velocity. The impact parameter and the orientation of a point
+     * are drawn from its own random stream, so the sums only depend on the
+     * points asked, not on the thread nor on the points integrated before.
+     * \param potentialEngine the engine holding the positions of the atoms.
+     * \param ic the cycle.
+     * \param ig the velocity, from 0.
+     * \param v the velocity.
+     * \param b2max the maximal impact parameter (squared, reduced) at this velocity.
+     * \param first the first point.
+     * \param n the number of points.
+     * \param temp1 the sum of the terms of Q(1)* of the points.
+     * \param temp2 the sum of the terms of Q(2)* of the points.
+     */
+    void calculateMonteCarloPoints(PotentialEngine& potentialEngine, unsigned int ic, unsigned int ig,
+                                   double v, double b2max, unsigned int first, unsigned int n,
+                                   double& temp1, double& temp2);
+
+    /**
+     * Determines b2max at each velocity as Mobcal : a coarse search finds the
+     * reduced impact parameter squared after which the trajectories are
+     * no more deviated, then it is refined. With the warm start, the coarse
+     * search of each velocity is guessed from the previous geometry.
+     * \param pgst the reduced velocities, from index 1.
+     * \param rMax the greatest coordinate of the potential well on the X axis.
+     * \return the maximal impact parameter (squared, reduced) at each velocity,
+     * from index 1.
+     */
+    std::vector<double> calculateB2max(const std::vector<double>& pgst, double rMax);
+
+    /**
+     * Coarse search of b2max at a velocity : finds the first ibst from first
+     * such that the trajectories at the impact parameters sqrt(ibst - 4) to
+     * sqrt(ibst) are not deviated. A guess is verified without calculating
+     * all the trajectories before it : one trajectory out of 5 is enough to
+     * exclude the 5 consecutive ones, so the result does not depend on the
+     * guess. The 5 trajectories are always calculated at this velocity, from
+     * first : the search of Mobcal, used before, kept the deviations of the
+     * previous velocity and, below first + 4, also read deviations never
+     * calculated. Its ibst, thus b2max and TM, may differ from the ones found
+     * here.
+     * \param v the velocity.
+     * \param first the first ibst.
+     * \param guess the guessed ibst, negative if none.
+     * \param nbTrajectories incremented by the number of trajectories calculated.
+     * \return the ibst found.
+     */
+    int searchImpactParameterLimit(double v, int first, int guess, int& nbTrajectories);
+
+    /**
+     * Calculates the time steps of the trajectories.
+     * \param v the velocity.
+     * \param dt1 the time step far from the molecule.
+     * \param dt2 the time step close to a collision.
+     */
+    void calculateTimeSteps(double v, double& dt1, double& dt2) const;
+
+    /**
+     * Searches on the Y axis the point where the trajectory starts.
+     * \param potentialEngine the engine holding the positions of the atoms.
+     * \param e0 the kinetic energy of the Helium.
+     * \param xyz the starting point, whose x is the impact parameter.
+     * \param pot the potential at the starting point.
+     * \param dMax the distance to the closest atom.
+     * \return false if the Helium does not meet the molecule.
+     */
+    bool findStartingPoint(PotentialEngine& potentialEngine, double e0, Vector3D& xyz, double& pot, double& dMax);
 
     /**
      * Defines Hamilton's equations of motion ad the time derivates of
      * the coordinates and momenta.
      * \return the potential
      */
-    double calculateHamilton(std::vector<Vector3D>& molPos, std::array<double, 6>& w, std::array<double, 6>& dw, double& dMax);
+    double calculateHamilton(PotentialEngine& potentialEngine, std::array<double, 6>& w, std::array<double, 6>& dw, double& dMax);
 
     /**
      * Integration method. Uses 5th order Runge-Kutta-Gill to initiate and 5th order
      * Adams-Moulton predictor-corrector to propagate.
      * \return the potential
      */
-    double calculateRKandAM(std::vector<Vector3D>& molPos, int& l, double& tim, double& dt, std::array<double, 6>& w, std::array<double, 6>& dw, std::array<std::array<double, 6>, 6>& arrayDouble, double& dMax, double& hVar, double& hcVar);
+    double calculateRKandAM(PotentialEngine& potentialEngine, int& l, double& tim, double& dt, std::array<double, 6>& w, std::array<double, 6>& dw, std::array<std::array<double, 6>, 6>& arrayDouble, double& dMax, double& hVar, double& hcVar);
+
+
+
+  protected:
+    /**
+     * State of a trajectory integrated with others by calculateTrajectories.
+     * The steps of calculateRKandAM are cut at each calculation of the
+     * potential, so that the trajectories wait for the others.
+     */
+    struct Trajectory {
+      /// Index of the trajectory in calculateTrajectories.
+      unsigned int index;
+      /// Orientation of the molecule.
+      const Vector3D* axes;
+      /// Coordinates, momenta and their time derivates.
+      std::array<double, 6> w;
+      std::array<double, 6> dw;
+      std::array<std::array<double, 6>, 6> arrayDouble;
+      /// Work arrays of Runge-Kutta and Adams-Moulton.
+      std::array<double, 6> q;
+      std::array<double, 6> savw;
+      std::array<double, 6> savdw;
+      /// Variables of calculateRKandAM.
+      int l;
+      double dt;
+      double hVar;
+      double hcVar;
+      /// Time steps far from and close to a collision.
+      double dt1;
+      double dt2;
+      /// Number of steps done, and since the last test of the end (number of
+      /// consecutive rejected steps with Dormand-Prince).
+      int ns;
+      int nw;
+      /// Calculation of the potential in the current step, 0 if the step is not begun.
+      int stage;
+      /// True if dw, pot and dMax are calculated at the current coordinates.
+      bool evaluated;
+      double pot;
+      double dMax;
+      /// Kinetic and total energies at the start.
+      double e0;
+      double etot;
+      /// Velocity.
+      double v;
+      /// Angle of deviation, once the trajectory is finished.
+      double ang;
+      /// Stages of Dormand-Prince, and the potential at the start of the step.
+      std::array<std::array<double, 6>, 7> k;
+      double savPot;
+      double savDMax;
+      /// Number of steps rejected by Dormand-Prince.
+      int nbRejected;
+      /// Number of calculations of the potential.
+      int nbPotentialCalculations;
+    };
+
+    /**
+     * Puts a trajectory at its starting point.
+     * \param potentialEngine the engine holding the positions of the atoms.
+     * Its orientation is changed.
+     * \param v the velocity.
+     * \param b the impact parameter.
+     * \param t the trajectory, whose index and axes are set.
+     * \return false if the Helium does not meet the molecule, in which case
+     * the angle of deviation is 0.
+     */
+    bool startTrajectory(PotentialEngine& potentialEngine, double v, double b, Trajectory& t);
+
+    /**
+     * Integrates a trajectory until its potential must be calculated or until
+     * it is finished. Same steps and tests as calculateTrajectory.
+     * \param t the trajectory, whose dw, pot and dMax are set if evaluated is true.
+     * \return true if the potential must be calculated at the coordinates of t,
+     * false if the trajectory is finished.
+     */
+    bool advanceTrajectory(Trajectory& t);
+
+    /**
+     * Integrates a trajectory with Dormand-Prince 5(4), the time step being
+     * adapted to keep the estimated error under m_integratorTolerance.
+     * The trajectory ends when the Helium goes away from the molecule and
+     * the potential is under sw1.
+     * \param t the trajectory, whose dw, pot and dMax are set if evaluated is true.
+     * \return true if the potential must be calculated at the coordinates of t,
+     * false if the trajectory is finished.
+     */
+    bool advanceTrajectoryDormandPrince(Trajectory& t);
+
+    /**
+     * Calculates the angle of deviation of a finished trajectory and
+     * verifies the conservation of the energy.
+     * \param t the trajectory.
+     */
+    void finishTrajectory(Trajectory& t);
+
+    /**
+     * Calculates the potential of a trajectory with the orientation of the engine.
+     * \param potentialEngine the engine holding the positions of the atoms.
+     * \param t the trajectory, whose dw, pot and dMax are set.
+     */
+    void evaluateTrajectory(PotentialEngine& potentialEngine, Trajectory& t);
+
+    /**
+     * Adds a trajectory to the statistics given in m_result.
+     * \param nbSteps the number of integration steps of the trajectory.
+     * \param nbPotentialCalculations the number of calculations of the potential.
+     */
+    void countTrajectory(int nbSteps, int nbPotentialCalculations);
 
 
 
@@ -155,15 +640,15 @@ class StdCalculationOperator : public CalculationOperator
      */
     static const int m_MaxSuccRefl;
 
+    /**
+     * Number of trajectories of EHSS and PA calculated together.
+     */
+    static const unsigned int m_HardSphereChunkSize = 1024;
+
 
 
   protected:
     // TM
-    /**
-     * Constant for ion-induced dipole potential.
-     */
-    static const double m_IonInducedDipolePotential;
-
     /**
      * xe from Mobcal.
      */
@@ -200,6 +685,60 @@ class StdCalculationOperator : public CalculationOperator
      */
     static const double m_MaxImpactParameter;
 
+    /**
+     * Energy, in kT, above the energies of the collisions : the Helium
+     * does not reach the points where the potential is greater.
+     */
+    static const double m_MaxCollisionEnergy;
+
+    /**
+     * Potential, in kT, above which the grid of the potential is capped.
+     */
+    static const double m_GridMaxPotential;
+
+    /**
+     * Number of batches of trajectories integrated together by
+     * calculateMonteCarloPoints.
+     */
+    static const unsigned int m_ChunkBatches = 4;
+
+    /**
+     * Number of cycles of TM calculated before the standard error is
+     * trusted to stop the cycles.
+     */
+    static const int m_MinimalNumberCyclesTM = 3;
+
+    /**
+     * First index of the random streams of EHSS and PA methods, above the
+     * cycles of TM method.
+     */
+    static const unsigned int m_EHSSPAStream = 0xFFFFFFFFu;
+
+    /**
+     * Last index of the random streams scrambling the Sobol points, above
+     * the Monte-Carlo points.
+     */
+    static const unsigned int m_ScramblingStream = 0xFFFFFFFFu;
+
+    /**
+     * Greatest ibst of the coarse search of b2max.
+     */
+    static const int m_MaxImpactParameterStep = 500;
+
+    /**
+     * Velocities of TM already calculated, by temperature and number of
+     * velocities : they are the same for all the geometries.
+     */
+    static std::map<std::pair<double, int>, VelocityPoints> m_velocityPointsCache;
+    static std::mutex m_velocityPointsMutex;
+
+    /**
+     * Results of the coarse search of b2max of the last geometry calculated,
+     * for each buffer gas and velocity. Guesses of the warm start.
+     */
+    static std::map<BufferGas, std::vector<int> > m_b2maxProfiles;
+    static std::mutex m_b2maxProfilesMutex;
+
 
 
   protected:
@@ -252,12 +791,12 @@ class StdCalculationOperator : public CalculationOperator
   protected:
     // TM
     /**
-     * EOLJ for Helium values.
+     * EOLJ values of the buffer gas.
      */
     std::vector<double> m_EOLJTab;
 
     /**
-     * ROLJ for Helium values.
+     * ROLJ values of the buffer gas.
      */
     std::vector<double> m_ROLJTab;
 
@@ -271,6 +810,28 @@ class StdCalculationOperator : public CalculationOperator
      */
     double m_asymmetryParameter;
 
+    /**
+     * Indicates if the structural asymmetry parameter is calculated by runTM.
+     */
+    bool m_asymmetryParameterCalculated;
+
+    /**
+     * Buffer gases of TM, and the index of the one being calculated.
+     */
+    std::vector<BufferGas> m_bufferGases;
+    unsigned int m_bufferGasIndex;
+
+    /**
+     * Mass of the buffer gas (m1 in Mobcal).
+     */
+    double m_bufferGasMass;
+
+    /**
+     * Constant for ion-induced dipole potential, from the polarizability
+     * of the buffer gas.
+     */
+    double m_ionInducedDipolePotential;
+
     /**
      * Mass constant (mu in Mobcal).
      */
@@ -316,6 +877,12 @@ class StdCalculationOperator : public CalculationOperator
      */
     std::vector<Vector3D> m_molPos;
 
+    /**
+     * X, Y and Z axes. Their images by a rotation give the orientation
+     * of the molecule to the engine of potential.
+     */
+    std::vector<Vector3D> m_initAxes;
+
     /**
      * Number of atoms in the molecule. For calculations.
      */
@@ -330,6 +897,69 @@ class StdCalculationOperator : public CalculationOperator
      * Mass of the molecule. For calculations.
      */
     double m_molMass;
+
+    /**
+     * Engine evaluating the potential on m_molPos. For calculations.
+     */
+    PotentialEngine* m_potentialEngine;
+
+    /**
+     * Integrator of the trajectories, and its tolerance if adaptive.
+     */
+    TrajectoryIntegrator m_integrator;
+    double m_integratorTolerance;
+
+    /**
+     * Relative standard error of TM under which the cycles stop, in
+     * percents, 0 to calculate all of them.
+     */
+    double m_TMStandardErrorTarget;
+
+    /**
+     * Indicates if the search of b2max starts from the previous geometry.
+     */
+    bool m_b2maxWarmStart;
+
+    /**
+     * Temperatures at which TM is also calculated, empty without sweep.
+     */
+    std::vector<double> m_temperatureSweep;
+
+    /**
+     * Sampling of the trajectories of TM and EHSS/PA.
+     */
+    SamplingMethod m_samplingMethod;
+
+    /**
+     * Number of scramblings of the Sobol points of EHSS/PA.
+     */
+    unsigned int m_nbReplicatesQMC;
+
+    /**
+     * Trajectories integrated, with their steps and calculations of the
+     * potential. For the statistics of m_result.
+     */
+    unsigned long long m_nbIntegratedTrajectories;
+    unsigned long long m_nbIntegrationSteps;
+    unsigned long long m_nbPotentialCalculations;
+
+    /**
+     * Number of trajectories which did not conserve the energy.
+     */
+    int m_nbFailedTrajectories;
+
+    /**
+     * Seed of the random streams, and index of the geometry.
+     */
+    unsigned int m_seed;
+    unsigned int m_geometryIndex;
+
+    /**
+     * Progression of the geometry, saved to resume the calculations, and
+     * an indicator of its restoration in m_result.
+     */
+    GeometryCheckpoint m_checkpoint;
+    bool m_checkpointRestored;
 };
 
 #endif
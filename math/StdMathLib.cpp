@@ -140,49 +140,114 @@ void StdMathLib::rotate(const std::vector<Vector3D>& initPos, std::vector<Vector
   }
 }
 
-void StdMathLib::randomRotation(Molecule* mol)
+void StdMathLib::randomRotation(Molecule* mol, RandomStream& stream)
 {
   // Définition des angles aléatoires.
-  double angleX = 2.0 * M_PI * RandomGenerator::getInstance()->getRandomNumber();
-  double angleY = asin(RandomGenerator::getInstance()->getRandomNumber() * 2.0 - 1.0) + M_PI / 2.0;
-  double angleZ = 2.0 * M_PI * RandomGenerator::getInstance()->getRandomNumber();
+  double angleX = 2.0 * M_PI * stream.getRandomNumber();
+  double angleY = asin(stream.getRandomNumber() * 2.0 - 1.0) + M_PI / 2.0;
+  double angleZ = 2.0 * M_PI * stream.getRandomNumber();
   // Rotation.
   rotate(mol, angleX, angleY, angleZ);
 }
 
-void StdMathLib::randomRotation(const std::vector<Vector3D>& initPos, std::vector<Vector3D>& pos)
+void StdMathLib::randomRotation(const std::vector<Vector3D>& initPos, std::vector<Vector3D>& pos, RandomStream& stream)
 {
-  // Définition des angles aléatoires.
-  double angleX = 2.0 * M_PI * RandomGenerator::getInstance()->getRandomNumber();
-  double angleY = asin(RandomGenerator::getInstance()->getRandomNumber() * 2.0 - 1.0) + M_PI / 2.0;
-  double angleZ = 2.0 * M_PI * RandomGenerator::getInstance()->getRandomNumber();
   // Rotation.
-  rotate(initPos, pos, angleX, angleY, angleZ);
+  rotate(randomRotationMatrix(stream), initPos, pos);
+}
+
+RotationMatrix StdMathLib::calculateRotationMatrix(double angleX, double angleY, double angleZ)
+{
+  // Les trois rotations de rotate : autour de Z d'un angle X, dans le plan
+  // (z, y) d'un angle Y, puis autour de Z d'un angle Z.
+  RotationMatrix rx;
+  rx.m[0][0] = cos(angleX);
+  rx.m[0][1] = -sin(angleX);
+  rx.m[1][0] = sin(angleX);
+  rx.m[1][1] = cos(angleX);
+
+  RotationMatrix ry;
+  ry.m[1][1] = cos(angleY);
+  ry.m[1][2] = sin(angleY);
+  ry.m[2][1] = -sin(angleY);
+  ry.m[2][2] = cos(angleY);
+
+  RotationMatrix rz;
+  rz.m[0][0] = cos(angleZ);
+  rz.m[0][1] = -sin(angleZ);
+  rz.m[1][0] = sin(angleZ);
+  rz.m[1][1] = cos(angleZ);
+
+  return rz * (ry * rx);
+}
+
+RotationMatrix StdMathLib::randomRotationMatrix(RandomStream& stream)
+{
+  double u1 = stream.getRandomNumber();
+  double u2 = stream.getRandomNumber();
+  double u3 = stream.getRandomNumber();
+  return calculateUniformRotationMatrix(u1, u2, u3);
+}
+
+RotationMatrix StdMathLib::calculateUniformRotationMatrix(double u1, double u2, double u3)
+{
+  // Définition des angles : cos(angleY) est uniforme, la rotation est donc
+  // uniforme.
+  double angleX = 2.0 * M_PI * u1;
+  double angleY = asin(u2 * 2.0 - 1.0) + M_PI / 2.0;
+  double angleZ = 2.0 * M_PI * u3;
+  return calculateRotationMatrix(angleX, angleY, angleZ);
+}
+
+void StdMathLib::rotate(const RotationMatrix& rotation, const std::vector<Vector3D>& initPos, std::vector<Vector3D>& pos)
+{
+  const double m00 = rotation.m[0][0], m01 = rotation.m[0][1], m02 = rotation.m[0][2];
+  const double m10 = rotation.m[1][0], m11 = rotation.m[1][1], m12 = rotation.m[1][2];
+  const double m20 = rotation.m[2][0], m21 = rotation.m[2][1], m22 = rotation.m[2][2];
+
+  // Les Vector3D se suivent en memoire : x, y, z, x, y, z...
+  static_assert(sizeof(Vector3D) == 3 * sizeof(double), "Vector3D must only hold x, y and z.");
+  const unsigned int n = initPos.size();
+  if (n == 0) {
+    return;
+  }
+  const double* in = &initPos[0].x;
+  double* out = &pos[0].x;
+  #pragma omp simd
+  for (unsigned int i = 0; i < n; ++i) {
+    const double x = in[3 * i];
+    const double y = in[3 * i + 1];
+    const double z = in[3 * i + 2];
+    out[3 * i] = m00 * x + m01 * y + m02 * z;
+    out[3 * i + 1] = m10 * x + m11 * y + m12 * z;
+    out[3 * i + 2] = m20 * x + m21 * y + m22 * z;
+  }
 }
 
 Vector3D StdMathLib::calculateMassCenter(const Molecule& mol)
 {
+  return calculateMassCenter(mol.getData());
+}
+
+Vector3D StdMathLib::calculateMassCenter(const MoleculeData& data)
+{
+  const MoleculeData::Array& masses = data.getMasses();
+  const MoleculeData::Array& px = data.getX();
+  const MoleculeData::Array& py = data.getY();
+  const MoleculeData::Array& pz = data.getZ();
   double mass = 0.0;
   double x = 0.0;
   double y = 0.0;
   double z = 0.0;
-  // On recupere la vectore des atomes de la molecule.
-  std::vector<Atom*>* atoms = mol.getAllAtoms();
-
-  // Pour récupérer les informations globales sur les atomes.
-  AtomInformations* atomInformations = AtomInformations::getInstance();
 
-  // Pour tous les atomes de la molecule ...
-  for (auto it = atoms->begin(); it != atoms->end(); ++it) {
-    // On extrait la masse de l'atome.
-    double m = atomInformations->getAtomicMass((*it)->getSymbol());
-    // On extrait la position de l'atome.
-    Vector3D* pos = (*it)->getPosition();
-    // On somme tout ça.
+  // Pour tous les atomes de la molecule, dans l'ordre, pour garder
+  // les memes arrondis.
+  for (unsigned int i = 0; i < data.size(); ++i) {
+    const double m = masses[i];
     mass += m;
-    x += pos->x * m;
-    y += pos->y * m;
-    z += pos->z * m;
+    x += px[i] * m;
+    y += py[i] * m;
+    z += pz[i] * m;
   }
 
   return Vector3D(x / mass, y / mass, z / mass);
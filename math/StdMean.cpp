@@ -100,6 +100,13 @@ bool StdMean::isTMPrintable() {
   return m_listResults[0]->isTMPrintable();
 }
 
+bool StdMean::isStructAsymParamPrintable() {
+  if (m_listResults.size() == 0) {
+    return false;
+  }
+  return m_listResults[0]->isStructAsymParamPrintable();
+}
+
 void StdMean::accept(class FileWriter& fileWriter) {
   fileWriter.visitMean(this);
 }
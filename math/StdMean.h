@@ -111,6 +111,12 @@ class StdMean : public Mean
      */
     bool isTMPrintable();
 
+    /**
+     * Indicates if the structural asymmetry parameter needs to be printed.
+     * \return true if the structural asymmetry parameter needs to be printed, false otherwise.
+     */
+    bool isStructAsymParamPrintable();
+
     /**
      * Add a result to the results used to calculate the means.
      * \param r the result to add to the list.
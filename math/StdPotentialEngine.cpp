@@ -0,0 +1,1068 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+#include "StdPotentialEngine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <boost/math/special_functions/pow.hpp>
+
+// Les noyaux AVX2 et AVX-512 ne sont compiles que pour x86 avec GCC/Clang :
+// ils sont actives fonction par fonction, le reste du programme reste
+// compile pour le processeur de base.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define COLLISION_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+// Atomes fictifs : assez loin pour ne jamais etre l'atome le plus proche, assez pres pour
+// que r^14 ne depasse pas la capacite d'un double.
+const double StdPotentialEngine::m_PaddingPosition = 1e20;
+
+const unsigned int StdPotentialEngine::m_PaddingAtoms = 8;
+
+
+StdPotentialEngine::StdPotentialEngine(const std::vector<Vector3D>& pos,
+                                       const std::vector<double>& eolj,
+                                       const std::vector<double>& rolj,
+                                       const std::vector<double>& charges,
+                                       double maxROLJ,
+                                       double ionInducedDipolePotential,
+                                       PotentialKernel kernel)
+  : m_kernel(resolveKernel(kernel)), m_nbAtoms(pos.size()),
+  m_maxROLJ(maxROLJ), m_ionInducedDipolePotential(ionInducedDipolePotential),
+  m_minY(0.0), m_maxY(0.0)
+{
+  // On arrondit au multiple de 8 superieur pour que les noyaux vectoriels
+  // n'aient pas de fin de boucle a traiter.
+  m_nbPaddedAtoms = ((m_nbAtoms + m_PaddingAtoms - 1) / m_PaddingAtoms) * m_PaddingAtoms;
+
+  // Les atomes fictifs sont loin et ont des coefficients nuls.
+  m_x.assign(m_nbPaddedAtoms, m_PaddingPosition);
+  m_y.assign(m_nbPaddedAtoms, m_PaddingPosition);
+  m_z.assign(m_nbPaddedAtoms, m_PaddingPosition);
+  m_eox4.assign(m_nbPaddedAtoms, 0.0);
+  m_rolj6.assign(m_nbPaddedAtoms, 0.0);
+  m_rolj12.assign(m_nbPaddedAtoms, 0.0);
+  m_charge.assign(m_nbPaddedAtoms, 0.0);
+
+  // Precalcul des puissances de Lennard-Jones.
+  for (unsigned int i = 0; i < m_nbAtoms; ++i) {
+    m_eox4[i] = 4.0 * eolj[i];
+    m_rolj6[i] = boost::math::pow<6>(rolj[i]);
+    m_rolj12[i] = m_rolj6[i] * m_rolj6[i];
+    m_charge[i] = charges[i];
+  }
+
+  setPositions(pos);
+}
+
+StdPotentialEngine::~StdPotentialEngine()
+{
+
+}
+
+StdPotentialEngine::Sums::Sums()
+  : e00(0.0), dex(0.0), dey(0.0), dez(0.0), rx(0.0), ry(0.0), rz(0.0),
+  sum1(0.0), sum2(0.0), sum3(0.0), sum4(0.0), sum5(0.0), sum6(0.0),
+  r2Min(std::numeric_limits<double>::max())
+{
+
+}
+
+double StdPotentialEngine::combineSums(double ionInducedDipolePotential, const Sums& s, Vector3D& dPot)
+{
+  dPot.x = s.dex - (ionInducedDipolePotential
+    * ((2.0 * s.rx * s.sum1) + (2.0 * s.ry * s.sum2) + (2.0 * s.rz * s.sum3)));
+  dPot.y = s.dey - (ionInducedDipolePotential
+    * ((2.0 * s.rx * s.sum2) + (2.0 * s.ry * s.sum4) + (2.0 * s.rz * s.sum5)));
+  dPot.z = s.dez - (ionInducedDipolePotential
+    * ((2.0 * s.rx * s.sum3) + (2.0 * s.ry * s.sum5) + (2.0 * s.rz * s.sum6)));
+
+  return s.e00 - (ionInducedDipolePotential * (s.rx * s.rx + s.ry * s.ry + s.rz * s.rz));
+}
+
+double StdPotentialEngine::boundDistance(double r2Min, double maxROLJ)
+{
+  // Comme dans Mobcal, la distance est bornee par 2 * ROLJ maximal.
+  double rMin = sqrt(r2Min);
+  if (rMin < 2.0 * maxROLJ) {
+    return rMin;
+  }
+  return 2.0 * maxROLJ;
+}
+
+PotentialEngine* StdPotentialEngine::clone() const
+{
+  return new StdPotentialEngine(*this);
+}
+
+void StdPotentialEngine::setPositions(const std::vector<Vector3D>& pos)
+{
+  for (unsigned int i = 0; i < m_nbAtoms; ++i) {
+    m_x[i] = pos[i].x;
+    m_y[i] = pos[i].y;
+    m_z[i] = pos[i].z;
+  }
+
+  // Les positions deviennent le repere de la molecule.
+  std::vector<Vector3D> axes;
+  axes.push_back(Vector3D(1.0, 0.0, 0.0));
+  axes.push_back(Vector3D(0.0, 1.0, 0.0));
+  axes.push_back(Vector3D(0.0, 0.0, 1.0));
+  setOrientation(axes);
+}
+
+void StdPotentialEngine::setOrientation(const std::vector<Vector3D>& axes)
+{
+  m_axes = axes;
+
+  // Seules les ordonnees des atomes tournes sont necessaires.
+  m_minY = 0.0;
+  m_maxY = 0.0;
+  for (unsigned int i = 0; i < m_nbAtoms; ++i) {
+    double y = axes[0].y * m_x[i] + axes[1].y * m_y[i] + axes[2].y * m_z[i];
+    if (i == 0 || y > m_maxY) {
+      m_maxY = y;
+    }
+    if (i == 0 || y < m_minY) {
+      m_minY = y;
+    }
+  }
+}
+
+double StdPotentialEngine::calculatePotential(const Vector3D& p, Vector3D& dPot, double& dMax)
+{
+  Vector3D dq;
+  double pot = calculateMoleculePotential(toMoleculeFrame(m_axes.data(), p), dq, dMax);
+  dPot = toLaboratoryFrame(m_axes.data(), dq);
+  return pot;
+}
+
+void StdPotentialEngine::calculatePotentials(unsigned int n, const Vector3D* axes, const Vector3D* p,
+                                             double* pot, Vector3D* dPot, double* dMax)
+{
+  Vector3D q[m_BatchSize];
+  Vector3D dq[m_BatchSize];
+
+  for (unsigned int i = 0; i < n; i += m_BatchSize) {
+    unsigned int nbPositions = std::min(n - i, m_BatchSize);
+    for (unsigned int l = 0; l < nbPositions; ++l) {
+      q[l] = toMoleculeFrame(&axes[3 * (i + l)], p[i + l]);
+    }
+
+    calculateMoleculePotentials(nbPositions, q, &pot[i], dq, &dMax[i]);
+
+    for (unsigned int l = 0; l < nbPositions; ++l) {
+      dPot[i + l] = toLaboratoryFrame(&axes[3 * (i + l)], dq[l]);
+    }
+  }
+}
+
+double StdPotentialEngine::calculateReferencePotential(const Vector3D& p, Vector3D& dPot, double& dMax) const
+{
+  Vector3D dq;
+  double pot = calculateMoleculeReferencePotential(toMoleculeFrame(m_axes.data(), p), dq, dMax);
+  dPot = toLaboratoryFrame(m_axes.data(), dq);
+  return pot;
+}
+
+double StdPotentialEngine::calculateMoleculePotential(const Vector3D& q, Vector3D& dPot, double& dMax)
+{
+  if (m_kernel == PotentialKernel::SCALAR) {
+    return calculateMoleculeReferencePotential(q, dPot, dMax);
+  }
+
+  Sums s;
+  addSums(m_x.data(), m_y.data(), m_z.data(), m_eox4.data(), m_rolj6.data(), m_rolj12.data(),
+          m_charge.data(), m_nbPaddedAtoms, q, s);
+
+  dMax = boundDistance(s.r2Min, m_maxROLJ);
+
+  return combineSums(m_ionInducedDipolePotential, s, dPot);
+}
+
+void StdPotentialEngine::calculateMoleculePotentials(unsigned int n, const Vector3D* q,
+                                                     double* pot, Vector3D* dPot, double* dMax)
+{
+  if (m_kernel == PotentialKernel::SCALAR || n == 1) {
+    for (unsigned int l = 0; l < n; ++l) {
+      pot[l] = StdPotentialEngine::calculateMoleculePotential(q[l], dPot[l], dMax[l]);
+    }
+    return;
+  }
+
+  // Les positions inutilisees sont placees loin des atomes et des atomes fictifs.
+  alignas(64) double px[m_BatchSize];
+  alignas(64) double py[m_BatchSize];
+  alignas(64) double pz[m_BatchSize];
+  for (unsigned int l = 0; l < m_BatchSize; ++l) {
+    px[l] = (l < n) ? q[l].x : -m_PaddingPosition;
+    py[l] = (l < n) ? q[l].y : -m_PaddingPosition;
+    pz[l] = (l < n) ? q[l].z : -m_PaddingPosition;
+  }
+
+  // Avec 4 positions au plus, le noyau AVX2 ne calcule pas de positions inutilisees.
+  Sums s[m_BatchSize];
+  if (m_kernel == PotentialKernel::AVX512 && n > 4) {
+    addBatchSumsAVX512(m_x.data(), m_y.data(), m_z.data(), m_eox4.data(), m_rolj6.data(), m_rolj12.data(),
+                       m_charge.data(), m_nbAtoms, px, py, pz, n, s);
+  } else if (m_kernel == PotentialKernel::AVX2 || m_kernel == PotentialKernel::AVX512) {
+    addBatchSumsAVX2(m_x.data(), m_y.data(), m_z.data(), m_eox4.data(), m_rolj6.data(), m_rolj12.data(),
+                     m_charge.data(), m_nbAtoms, px, py, pz, n, s);
+  } else {
+    addBatchSumsSIMD(m_x.data(), m_y.data(), m_z.data(), m_eox4.data(), m_rolj6.data(), m_rolj12.data(),
+                     m_charge.data(), m_nbAtoms, px, py, pz, n, s);
+  }
+
+  for (unsigned int l = 0; l < n; ++l) {
+    dMax[l] = boundDistance(s[l].r2Min, m_maxROLJ);
+    pot[l] = combineSums(m_ionInducedDipolePotential, s[l], dPot[l]);
+  }
+}
+
+void StdPotentialEngine::distributeBatchSums(const double* acc, unsigned int nbPositions, Sums* s)
+{
+  for (unsigned int l = 0; l < nbPositions; ++l) {
+    s[l].e00 += acc[0 * m_BatchSize + l];
+    s[l].dex += acc[1 * m_BatchSize + l];
+    s[l].dey += acc[2 * m_BatchSize + l];
+    s[l].dez += acc[3 * m_BatchSize + l];
+    s[l].rx += acc[4 * m_BatchSize + l];
+    s[l].ry += acc[5 * m_BatchSize + l];
+    s[l].rz += acc[6 * m_BatchSize + l];
+    s[l].sum1 += acc[7 * m_BatchSize + l];
+    s[l].sum2 += acc[8 * m_BatchSize + l];
+    s[l].sum3 += acc[9 * m_BatchSize + l];
+    s[l].sum4 += acc[10 * m_BatchSize + l];
+    s[l].sum5 += acc[11 * m_BatchSize + l];
+    s[l].sum6 += acc[12 * m_BatchSize + l];
+    if (acc[13 * m_BatchSize + l] < s[l].r2Min) {
+      s[l].r2Min = acc[13 * m_BatchSize + l];
+    }
+  }
+}
+
+void StdPotentialEngine::addSums(const double* x, const double* y, const double* z,
+                                 const double* eox4, const double* rolj6, const double* rolj12,
+                                 const double* charge, unsigned int n,
+                                 const Vector3D& p, Sums& s) const
+{
+  switch (m_kernel) {
+  case PotentialKernel::AVX2:
+    addSumsAVX2(x, y, z, eox4, rolj6, rolj12, charge, n, p, s);
+    break;
+  case PotentialKernel::AVX512:
+    addSumsAVX512(x, y, z, eox4, rolj6, rolj12, charge, n, p, s);
+    break;
+  default:
+    addSumsSIMD(x, y, z, eox4, rolj6, rolj12, charge, n, p, s);
+    break;
+  }
+}
+
+/**
+ * Scalar kernel, operation by operation the same as Mobcal.
+ */
+double StdPotentialEngine::calculateMoleculeReferencePotential(const Vector3D& p, Vector3D& dPot, double& dMax) const
+{
+  // Variables de travail.
+  Vector3D rPos(0.0, 0.0, 0.0);
+  double e00 = 0.0;
+  double de00 = 0.0;
+  Vector3D de00Vec(0.0, 0.0, 0.0);
+
+  double xx, xx2, yy, yy2, zz, zz2;
+  double rxyz, rxyz2, rxyz3, rxyz5, rxyz6, rxyz8, rxyz12, rxyz14;
+  double charge, rxyz3i, rxyz5i;
+  double sum1 = 0.0;
+  double sum2 = 0.0;
+  double sum3 = 0.0;
+  double sum4 = 0.0;
+  double sum5 = 0.0;
+  double sum6 = 0.0;
+
+  dMax = 2.0 * m_maxROLJ;
+
+  // On parcourt tous les atomes.
+  for (unsigned int i = 0; i < m_nbAtoms; ++i) {
+    xx = p.x - m_x[i];
+    xx2 = xx * xx;
+    yy = p.y - m_y[i];
+    yy2 = yy * yy;
+    zz = p.z - m_z[i];
+    zz2 = zz * zz;
+    rxyz2 = xx2 + yy2 + zz2;
+    rxyz = sqrt(rxyz2);
+
+    if (rxyz < dMax) {
+      dMax = rxyz;
+    }
+
+    rxyz3 = rxyz2 * rxyz;
+    rxyz5 = rxyz3 * rxyz2;
+    rxyz6 = rxyz5 * rxyz;
+    rxyz8 = rxyz5 * rxyz3;
+    rxyz12 = rxyz6 * rxyz6;
+    rxyz14 = rxyz12 * rxyz2;
+
+    // Potentiel de Lennard-Jones.
+    e00 += m_eox4[i] * ((m_rolj12[i] / rxyz12) - (m_rolj6[i] / rxyz6));
+
+    // Derives du potentiel de Lennard-Jones.
+    de00 = m_eox4[i] * (((6.0 * m_rolj6[i]) / rxyz8) - ((12.0 * m_rolj12[i]) / rxyz14));
+    de00Vec.x += de00 * xx;
+    de00Vec.y += de00 * yy;
+    de00Vec.z += de00 * zz;
+
+    // Potentiel des ions induits.
+    charge = m_charge[i];
+    if (charge != 0.0) {
+      rxyz3i = charge / rxyz3;
+      rxyz5i = -3.0 * charge / rxyz5;
+      rPos.x += xx * rxyz3i;
+      rPos.y += yy * rxyz3i;
+      rPos.z += zz * rxyz3i;
+      // Derives des ions induits.
+      sum1 += rxyz3i + (xx2 * rxyz5i);
+      sum2 += xx * yy * rxyz5i;
+      sum3 += xx * zz * rxyz5i;
+      sum4 += rxyz3i + (yy2 * rxyz5i);
+      sum5 += yy * zz * rxyz5i;
+      sum6 += rxyz3i + (zz2 * rxyz5i);
+    }
+  }
+
+  Sums s;
+  s.e00 = e00;
+  s.dex = de00Vec.x;
+  s.dey = de00Vec.y;
+  s.dez = de00Vec.z;
+  s.rx = rPos.x;
+  s.ry = rPos.y;
+  s.rz = rPos.z;
+  s.sum1 = sum1;
+  s.sum2 = sum2;
+  s.sum3 = sum3;
+  s.sum4 = sum4;
+  s.sum5 = sum5;
+  s.sum6 = sum6;
+
+  return combineSums(m_ionInducedDipolePotential, s, dPot);
+}
+
+/**
+ * Portable kernel, vectorized by the compiler. Works on the inverse powers
+ * of the distance : one division and one square root per atom.
+ */
+void StdPotentialEngine::addSumsSIMD(const double* x, const double* y, const double* z,
+                                     const double* eox4, const double* rolj6, const double* rolj12,
+                                     const double* charge, unsigned int n,
+                                     const Vector3D& p, Sums& s)
+{
+  const double px = p.x;
+  const double py = p.y;
+  const double pz = p.z;
+
+  double e00 = 0.0;
+  double dex = 0.0;
+  double dey = 0.0;
+  double dez = 0.0;
+  double rx = 0.0;
+  double ry = 0.0;
+  double rz = 0.0;
+  double sum1 = 0.0;
+  double sum2 = 0.0;
+  double sum3 = 0.0;
+  double sum4 = 0.0;
+  double sum5 = 0.0;
+  double sum6 = 0.0;
+  double r2Min = s.r2Min;
+
+  #pragma omp simd aligned(x, y, z, eox4, rolj6, rolj12, charge : 64) \
+    reduction(+:e00, dex, dey, dez, rx, ry, rz, sum1, sum2, sum3, sum4, sum5, sum6) \
+    reduction(min:r2Min)
+  for (unsigned int i = 0; i < n; ++i) {
+    const double xx = px - x[i];
+    const double yy = py - y[i];
+    const double zz = pz - z[i];
+    const double xx2 = xx * xx;
+    const double yy2 = yy * yy;
+    const double zz2 = zz * zz;
+    const double r2 = xx2 + yy2 + zz2;
+    r2Min = (r2 < r2Min) ? r2 : r2Min;
+
+    // Puissances inverses de la distance.
+    const double inv1 = 1.0 / sqrt(r2);
+    const double inv2 = inv1 * inv1;
+    const double inv3 = inv2 * inv1;
+    const double inv5 = inv3 * inv2;
+    const double inv6 = inv2 * inv2 * inv2;
+    const double inv8 = inv6 * inv2;
+    const double inv12 = inv6 * inv6;
+    const double inv14 = inv12 * inv2;
+
+    // Lennard-Jones.
+    e00 += eox4[i] * (rolj12[i] * inv12 - rolj6[i] * inv6);
+    const double de00 = eox4[i] * (6.0 * rolj6[i] * inv8 - 12.0 * rolj12[i] * inv14);
+    dex += de00 * xx;
+    dey += de00 * yy;
+    dez += de00 * zz;
+
+    // Ions induits, nuls pour les atomes sans charge.
+    const double q3 = charge[i] * inv3;
+    const double q5 = -3.0 * charge[i] * inv5;
+    rx += xx * q3;
+    ry += yy * q3;
+    rz += zz * q3;
+    sum1 += q3 + xx2 * q5;
+    sum2 += xx * yy * q5;
+    sum3 += xx * zz * q5;
+    sum4 += q3 + yy2 * q5;
+    sum5 += yy * zz * q5;
+    sum6 += q3 + zz2 * q5;
+  }
+
+  s.e00 += e00;
+  s.dex += dex;
+  s.dey += dey;
+  s.dez += dez;
+  s.rx += rx;
+  s.ry += ry;
+  s.rz += rz;
+  s.sum1 += sum1;
+  s.sum2 += sum2;
+  s.sum3 += sum3;
+  s.sum4 += sum4;
+  s.sum5 += sum5;
+  s.sum6 += sum6;
+  s.r2Min = r2Min;
+}
+
+
+/**
+ * Portable batch kernel : for each atom, the m_BatchSize positions are
+ * computed by a loop vectorized by the compiler.
+ */
+void StdPotentialEngine::addBatchSumsSIMD(const double* x, const double* y, const double* z,
+                                          const double* eox4, const double* rolj6, const double* rolj12,
+                                          const double* charge, unsigned int n,
+                                          const double* px, const double* py, const double* pz,
+                                          unsigned int nbPositions, Sums* s)
+{
+  // Accumulateurs ranges par somme puis par position.
+  alignas(64) double acc[14 * m_BatchSize];
+  for (unsigned int k = 0; k < 13 * m_BatchSize; ++k) {
+    acc[k] = 0.0;
+  }
+  for (unsigned int l = 0; l < m_BatchSize; ++l) {
+    acc[13 * m_BatchSize + l] = std::numeric_limits<double>::max();
+  }
+
+  double* e00 = &acc[0 * m_BatchSize];
+  double* dex = &acc[1 * m_BatchSize];
+  double* dey = &acc[2 * m_BatchSize];
+  double* dez = &acc[3 * m_BatchSize];
+  double* rx = &acc[4 * m_BatchSize];
+  double* ry = &acc[5 * m_BatchSize];
+  double* rz = &acc[6 * m_BatchSize];
+  double* sum1 = &acc[7 * m_BatchSize];
+  double* sum2 = &acc[8 * m_BatchSize];
+  double* sum3 = &acc[9 * m_BatchSize];
+  double* sum4 = &acc[10 * m_BatchSize];
+  double* sum5 = &acc[11 * m_BatchSize];
+  double* sum6 = &acc[12 * m_BatchSize];
+  double* r2Min = &acc[13 * m_BatchSize];
+
+  for (unsigned int i = 0; i < n; ++i) {
+    const double xi = x[i];
+    const double yi = y[i];
+    const double zi = z[i];
+    const double eox4i = eox4[i];
+    const double rolj6i = rolj6[i];
+    const double rolj12i = rolj12[i];
+    const double chargei = charge[i];
+
+    #pragma omp simd aligned(px, py, pz : 64)
+    for (unsigned int l = 0; l < m_BatchSize; ++l) {
+      const double xx = px[l] - xi;
+      const double yy = py[l] - yi;
+      const double zz = pz[l] - zi;
+      const double xx2 = xx * xx;
+      const double yy2 = yy * yy;
+      const double zz2 = zz * zz;
+      const double r2 = xx2 + yy2 + zz2;
+      r2Min[l] = (r2 < r2Min[l]) ? r2 : r2Min[l];
+
+      // Puissances inverses de la distance.
+      const double inv1 = 1.0 / sqrt(r2);
+      const double inv2 = inv1 * inv1;
+      const double inv3 = inv2 * inv1;
+      const double inv5 = inv3 * inv2;
+      const double inv6 = inv2 * inv2 * inv2;
+      const double inv8 = inv6 * inv2;
+      const double inv12 = inv6 * inv6;
+      const double inv14 = inv12 * inv2;
+
+      // Lennard-Jones.
+      e00[l] += eox4i * (rolj12i * inv12 - rolj6i * inv6);
+      const double de00 = eox4i * (6.0 * rolj6i * inv8 - 12.0 * rolj12i * inv14);
+      dex[l] += de00 * xx;
+      dey[l] += de00 * yy;
+      dez[l] += de00 * zz;
+
+      // Ions induits.
+      const double q3 = chargei * inv3;
+      const double q5 = -3.0 * chargei * inv5;
+      rx[l] += xx * q3;
+      ry[l] += yy * q3;
+      rz[l] += zz * q3;
+      sum1[l] += q3 + xx2 * q5;
+      sum2[l] += xx * yy * q5;
+      sum3[l] += xx * zz * q5;
+      sum4[l] += q3 + yy2 * q5;
+      sum5[l] += yy * zz * q5;
+      sum6[l] += q3 + zz2 * q5;
+    }
+  }
+
+  distributeBatchSums(acc, nbPositions, s);
+}
+
+#ifdef COLLISION_X86_KERNELS
+
+namespace
+{
+  __attribute__((target("avx2")))
+  inline double horizontalSum(__m256d v)
+  {
+    __m128d s = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+  }
+
+  __attribute__((target("avx2")))
+  inline double horizontalMin(__m256d v)
+  {
+    __m128d s = _mm_min_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_min_sd(s, _mm_unpackhi_pd(s, s)));
+  }
+}
+
+/**
+ * AVX2 kernel : 4 atoms per iteration.
+ */
+__attribute__((target("avx2,fma")))
+void StdPotentialEngine::addSumsAVX2(const double* x, const double* y, const double* z,
+                                     const double* eox4, const double* rolj6, const double* rolj12,
+                                     const double* charge, unsigned int n,
+                                     const Vector3D& p, Sums& s)
+{
+  const __m256d px = _mm256_set1_pd(p.x);
+  const __m256d py = _mm256_set1_pd(p.y);
+  const __m256d pz = _mm256_set1_pd(p.z);
+  const __m256d one = _mm256_set1_pd(1.0);
+  const __m256d six = _mm256_set1_pd(6.0);
+  const __m256d twelve = _mm256_set1_pd(12.0);
+  const __m256d minusThree = _mm256_set1_pd(-3.0);
+
+  __m256d e00 = _mm256_setzero_pd();
+  __m256d dex = _mm256_setzero_pd();
+  __m256d dey = _mm256_setzero_pd();
+  __m256d dez = _mm256_setzero_pd();
+  __m256d rx = _mm256_setzero_pd();
+  __m256d ry = _mm256_setzero_pd();
+  __m256d rz = _mm256_setzero_pd();
+  __m256d sum1 = _mm256_setzero_pd();
+  __m256d sum2 = _mm256_setzero_pd();
+  __m256d sum3 = _mm256_setzero_pd();
+  __m256d sum4 = _mm256_setzero_pd();
+  __m256d sum5 = _mm256_setzero_pd();
+  __m256d sum6 = _mm256_setzero_pd();
+  __m256d r2Min = _mm256_set1_pd(s.r2Min);
+
+  for (unsigned int i = 0; i < n; i += 4) {
+    const __m256d xx = _mm256_sub_pd(px, _mm256_load_pd(&x[i]));
+    const __m256d yy = _mm256_sub_pd(py, _mm256_load_pd(&y[i]));
+    const __m256d zz = _mm256_sub_pd(pz, _mm256_load_pd(&z[i]));
+    const __m256d xx2 = _mm256_mul_pd(xx, xx);
+    const __m256d yy2 = _mm256_mul_pd(yy, yy);
+    const __m256d zz2 = _mm256_mul_pd(zz, zz);
+    const __m256d r2 = _mm256_add_pd(_mm256_add_pd(xx2, yy2), zz2);
+    r2Min = _mm256_min_pd(r2Min, r2);
+
+    // Puissances inverses de la distance.
+    const __m256d inv1 = _mm256_div_pd(one, _mm256_sqrt_pd(r2));
+    const __m256d inv2 = _mm256_mul_pd(inv1, inv1);
+    const __m256d inv3 = _mm256_mul_pd(inv2, inv1);
+    const __m256d inv5 = _mm256_mul_pd(inv3, inv2);
+    const __m256d inv6 = _mm256_mul_pd(_mm256_mul_pd(inv2, inv2), inv2);
+    const __m256d inv8 = _mm256_mul_pd(inv6, inv2);
+    const __m256d inv12 = _mm256_mul_pd(inv6, inv6);
+    const __m256d inv14 = _mm256_mul_pd(inv12, inv2);
+
+    // Lennard-Jones.
+    const __m256d eox4i = _mm256_load_pd(&eox4[i]);
+    const __m256d rolj6i = _mm256_load_pd(&rolj6[i]);
+    const __m256d rolj12i = _mm256_load_pd(&rolj12[i]);
+    e00 = _mm256_fmadd_pd(eox4i, _mm256_fmsub_pd(rolj12i, inv12, _mm256_mul_pd(rolj6i, inv6)), e00);
+    const __m256d de00 = _mm256_mul_pd(eox4i,
+      _mm256_fmsub_pd(_mm256_mul_pd(six, rolj6i), inv8, _mm256_mul_pd(_mm256_mul_pd(twelve, rolj12i), inv14)));
+    dex = _mm256_fmadd_pd(de00, xx, dex);
+    dey = _mm256_fmadd_pd(de00, yy, dey);
+    dez = _mm256_fmadd_pd(de00, zz, dez);
+
+    // Ions induits.
+    const __m256d chargei = _mm256_load_pd(&charge[i]);
+    const __m256d q3 = _mm256_mul_pd(chargei, inv3);
+    const __m256d q5 = _mm256_mul_pd(_mm256_mul_pd(minusThree, chargei), inv5);
+    rx = _mm256_fmadd_pd(xx, q3, rx);
+    ry = _mm256_fmadd_pd(yy, q3, ry);
+    rz = _mm256_fmadd_pd(zz, q3, rz);
+    sum1 = _mm256_add_pd(sum1, _mm256_fmadd_pd(xx2, q5, q3));
+    sum2 = _mm256_fmadd_pd(_mm256_mul_pd(xx, yy), q5, sum2);
+    sum3 = _mm256_fmadd_pd(_mm256_mul_pd(xx, zz), q5, sum3);
+    sum4 = _mm256_add_pd(sum4, _mm256_fmadd_pd(yy2, q5, q3));
+    sum5 = _mm256_fmadd_pd(_mm256_mul_pd(yy, zz), q5, sum5);
+    sum6 = _mm256_add_pd(sum6, _mm256_fmadd_pd(zz2, q5, q3));
+  }
+
+  s.e00 += horizontalSum(e00);
+  s.dex += horizontalSum(dex);
+  s.dey += horizontalSum(dey);
+  s.dez += horizontalSum(dez);
+  s.rx += horizontalSum(rx);
+  s.ry += horizontalSum(ry);
+  s.rz += horizontalSum(rz);
+  s.sum1 += horizontalSum(sum1);
+  s.sum2 += horizontalSum(sum2);
+  s.sum3 += horizontalSum(sum3);
+  s.sum4 += horizontalSum(sum4);
+  s.sum5 += horizontalSum(sum5);
+  s.sum6 += horizontalSum(sum6);
+  s.r2Min = horizontalMin(r2Min);
+}
+
+/**
+ * AVX-512 kernel : 8 atoms per iteration.
+ */
+__attribute__((target("avx512f")))
+void StdPotentialEngine::addSumsAVX512(const double* x, const double* y, const double* z,
+                                       const double* eox4, const double* rolj6, const double* rolj12,
+                                       const double* charge, unsigned int n,
+                                       const Vector3D& p, Sums& s)
+{
+  const __m512d px = _mm512_set1_pd(p.x);
+  const __m512d py = _mm512_set1_pd(p.y);
+  const __m512d pz = _mm512_set1_pd(p.z);
+  const __m512d one = _mm512_set1_pd(1.0);
+  const __m512d six = _mm512_set1_pd(6.0);
+  const __m512d twelve = _mm512_set1_pd(12.0);
+  const __m512d minusThree = _mm512_set1_pd(-3.0);
+
+  __m512d e00 = _mm512_setzero_pd();
+  __m512d dex = _mm512_setzero_pd();
+  __m512d dey = _mm512_setzero_pd();
+  __m512d dez = _mm512_setzero_pd();
+  __m512d rx = _mm512_setzero_pd();
+  __m512d ry = _mm512_setzero_pd();
+  __m512d rz = _mm512_setzero_pd();
+  __m512d sum1 = _mm512_setzero_pd();
+  __m512d sum2 = _mm512_setzero_pd();
+  __m512d sum3 = _mm512_setzero_pd();
+  __m512d sum4 = _mm512_setzero_pd();
+  __m512d sum5 = _mm512_setzero_pd();
+  __m512d sum6 = _mm512_setzero_pd();
+  __m512d r2Min = _mm512_set1_pd(s.r2Min);
+
+  for (unsigned int i = 0; i < n; i += 8) {
+    const __m512d xx = _mm512_sub_pd(px, _mm512_load_pd(&x[i]));
+    const __m512d yy = _mm512_sub_pd(py, _mm512_load_pd(&y[i]));
+    const __m512d zz = _mm512_sub_pd(pz, _mm512_load_pd(&z[i]));
+    const __m512d xx2 = _mm512_mul_pd(xx, xx);
+    const __m512d yy2 = _mm512_mul_pd(yy, yy);
+    const __m512d zz2 = _mm512_mul_pd(zz, zz);
+    const __m512d r2 = _mm512_add_pd(_mm512_add_pd(xx2, yy2), zz2);
+    r2Min = _mm512_min_pd(r2Min, r2);
+
+    // Puissances inverses de la distance.
+    const __m512d inv1 = _mm512_div_pd(one, _mm512_sqrt_pd(r2));
+    const __m512d inv2 = _mm512_mul_pd(inv1, inv1);
+    const __m512d inv3 = _mm512_mul_pd(inv2, inv1);
+    const __m512d inv5 = _mm512_mul_pd(inv3, inv2);
+    const __m512d inv6 = _mm512_mul_pd(_mm512_mul_pd(inv2, inv2), inv2);
+    const __m512d inv8 = _mm512_mul_pd(inv6, inv2);
+    const __m512d inv12 = _mm512_mul_pd(inv6, inv6);
+    const __m512d inv14 = _mm512_mul_pd(inv12, inv2);
+
+    // Lennard-Jones.
+    const __m512d eox4i = _mm512_load_pd(&eox4[i]);
+    const __m512d rolj6i = _mm512_load_pd(&rolj6[i]);
+    const __m512d rolj12i = _mm512_load_pd(&rolj12[i]);
+    e00 = _mm512_fmadd_pd(eox4i, _mm512_fmsub_pd(rolj12i, inv12, _mm512_mul_pd(rolj6i, inv6)), e00);
+    const __m512d de00 = _mm512_mul_pd(eox4i,
+      _mm512_fmsub_pd(_mm512_mul_pd(six, rolj6i), inv8, _mm512_mul_pd(_mm512_mul_pd(twelve, rolj12i), inv14)));
+    dex = _mm512_fmadd_pd(de00, xx, dex);
+    dey = _mm512_fmadd_pd(de00, yy, dey);
+    dez = _mm512_fmadd_pd(de00, zz, dez);
+
+    // Ions induits.
+    const __m512d chargei = _mm512_load_pd(&charge[i]);
+    const __m512d q3 = _mm512_mul_pd(chargei, inv3);
+    const __m512d q5 = _mm512_mul_pd(_mm512_mul_pd(minusThree, chargei), inv5);
+    rx = _mm512_fmadd_pd(xx, q3, rx);
+    ry = _mm512_fmadd_pd(yy, q3, ry);
+    rz = _mm512_fmadd_pd(zz, q3, rz);
+    sum1 = _mm512_add_pd(sum1, _mm512_fmadd_pd(xx2, q5, q3));
+    sum2 = _mm512_fmadd_pd(_mm512_mul_pd(xx, yy), q5, sum2);
+    sum3 = _mm512_fmadd_pd(_mm512_mul_pd(xx, zz), q5, sum3);
+    sum4 = _mm512_add_pd(sum4, _mm512_fmadd_pd(yy2, q5, q3));
+    sum5 = _mm512_fmadd_pd(_mm512_mul_pd(yy, zz), q5, sum5);
+    sum6 = _mm512_add_pd(sum6, _mm512_fmadd_pd(zz2, q5, q3));
+  }
+
+  s.e00 += _mm512_reduce_add_pd(e00);
+  s.dex += _mm512_reduce_add_pd(dex);
+  s.dey += _mm512_reduce_add_pd(dey);
+  s.dez += _mm512_reduce_add_pd(dez);
+  s.rx += _mm512_reduce_add_pd(rx);
+  s.ry += _mm512_reduce_add_pd(ry);
+  s.rz += _mm512_reduce_add_pd(rz);
+  s.sum1 += _mm512_reduce_add_pd(sum1);
+  s.sum2 += _mm512_reduce_add_pd(sum2);
+  s.sum3 += _mm512_reduce_add_pd(sum3);
+  s.sum4 += _mm512_reduce_add_pd(sum4);
+  s.sum5 += _mm512_reduce_add_pd(sum5);
+  s.sum6 += _mm512_reduce_add_pd(sum6);
+  s.r2Min = _mm512_reduce_min_pd(r2Min);
+}
+
+/**
+ * AVX2 batch kernel : 4 positions per register, the atoms being read once
+ * for each group of 4 positions.
+ */
+__attribute__((target("avx2,fma")))
+void StdPotentialEngine::addBatchSumsAVX2(const double* x, const double* y, const double* z,
+                                          const double* eox4, const double* rolj6, const double* rolj12,
+                                          const double* charge, unsigned int n,
+                                          const double* px, const double* py, const double* pz,
+                                          unsigned int nbPositions, Sums* s)
+{
+  const __m256d one = _mm256_set1_pd(1.0);
+  const __m256d six = _mm256_set1_pd(6.0);
+  const __m256d twelve = _mm256_set1_pd(12.0);
+  const __m256d minusThree = _mm256_set1_pd(-3.0);
+
+  alignas(64) double acc[14 * m_BatchSize];
+
+  // Une passe par groupe de 4 positions : 2 x 14 accumulateurs ne tiennent
+  // pas dans les 16 registres.
+  for (unsigned int l = 0; l < nbPositions; l += 4) {
+    const __m256d pxl = _mm256_load_pd(&px[l]);
+    const __m256d pyl = _mm256_load_pd(&py[l]);
+    const __m256d pzl = _mm256_load_pd(&pz[l]);
+
+    __m256d e00 = _mm256_setzero_pd();
+    __m256d dex = _mm256_setzero_pd();
+    __m256d dey = _mm256_setzero_pd();
+    __m256d dez = _mm256_setzero_pd();
+    __m256d rx = _mm256_setzero_pd();
+    __m256d ry = _mm256_setzero_pd();
+    __m256d rz = _mm256_setzero_pd();
+    __m256d sum1 = _mm256_setzero_pd();
+    __m256d sum2 = _mm256_setzero_pd();
+    __m256d sum3 = _mm256_setzero_pd();
+    __m256d sum4 = _mm256_setzero_pd();
+    __m256d sum5 = _mm256_setzero_pd();
+    __m256d sum6 = _mm256_setzero_pd();
+    __m256d r2Min = _mm256_set1_pd(std::numeric_limits<double>::max());
+
+    for (unsigned int i = 0; i < n; ++i) {
+      const __m256d xx = _mm256_sub_pd(pxl, _mm256_broadcast_sd(&x[i]));
+      const __m256d yy = _mm256_sub_pd(pyl, _mm256_broadcast_sd(&y[i]));
+      const __m256d zz = _mm256_sub_pd(pzl, _mm256_broadcast_sd(&z[i]));
+      const __m256d xx2 = _mm256_mul_pd(xx, xx);
+      const __m256d yy2 = _mm256_mul_pd(yy, yy);
+      const __m256d zz2 = _mm256_mul_pd(zz, zz);
+      const __m256d r2 = _mm256_add_pd(_mm256_add_pd(xx2, yy2), zz2);
+      r2Min = _mm256_min_pd(r2Min, r2);
+
+      // Puissances inverses de la distance.
+      const __m256d inv1 = _mm256_div_pd(one, _mm256_sqrt_pd(r2));
+      const __m256d inv2 = _mm256_mul_pd(inv1, inv1);
+      const __m256d inv3 = _mm256_mul_pd(inv2, inv1);
+      const __m256d inv5 = _mm256_mul_pd(inv3, inv2);
+      const __m256d inv6 = _mm256_mul_pd(_mm256_mul_pd(inv2, inv2), inv2);
+      const __m256d inv8 = _mm256_mul_pd(inv6, inv2);
+      const __m256d inv12 = _mm256_mul_pd(inv6, inv6);
+      const __m256d inv14 = _mm256_mul_pd(inv12, inv2);
+
+      // Lennard-Jones.
+      const __m256d eox4i = _mm256_broadcast_sd(&eox4[i]);
+      const __m256d rolj6i = _mm256_broadcast_sd(&rolj6[i]);
+      const __m256d rolj12i = _mm256_broadcast_sd(&rolj12[i]);
+      e00 = _mm256_fmadd_pd(eox4i, _mm256_fmsub_pd(rolj12i, inv12, _mm256_mul_pd(rolj6i, inv6)), e00);
+      const __m256d de00 = _mm256_mul_pd(eox4i,
+        _mm256_fmsub_pd(_mm256_mul_pd(six, rolj6i), inv8, _mm256_mul_pd(_mm256_mul_pd(twelve, rolj12i), inv14)));
+      dex = _mm256_fmadd_pd(de00, xx, dex);
+      dey = _mm256_fmadd_pd(de00, yy, dey);
+      dez = _mm256_fmadd_pd(de00, zz, dez);
+
+      // Ions induits.
+      const __m256d chargei = _mm256_broadcast_sd(&charge[i]);
+      const __m256d q3 = _mm256_mul_pd(chargei, inv3);
+      const __m256d q5 = _mm256_mul_pd(_mm256_mul_pd(minusThree, chargei), inv5);
+      rx = _mm256_fmadd_pd(xx, q3, rx);
+      ry = _mm256_fmadd_pd(yy, q3, ry);
+      rz = _mm256_fmadd_pd(zz, q3, rz);
+      sum1 = _mm256_add_pd(sum1, _mm256_fmadd_pd(xx2, q5, q3));
+      sum2 = _mm256_fmadd_pd(_mm256_mul_pd(xx, yy), q5, sum2);
+      sum3 = _mm256_fmadd_pd(_mm256_mul_pd(xx, zz), q5, sum3);
+      sum4 = _mm256_add_pd(sum4, _mm256_fmadd_pd(yy2, q5, q3));
+      sum5 = _mm256_fmadd_pd(_mm256_mul_pd(yy, zz), q5, sum5);
+      sum6 = _mm256_add_pd(sum6, _mm256_fmadd_pd(zz2, q5, q3));
+    }
+
+    _mm256_store_pd(&acc[0 * m_BatchSize + l], e00);
+    _mm256_store_pd(&acc[1 * m_BatchSize + l], dex);
+    _mm256_store_pd(&acc[2 * m_BatchSize + l], dey);
+    _mm256_store_pd(&acc[3 * m_BatchSize + l], dez);
+    _mm256_store_pd(&acc[4 * m_BatchSize + l], rx);
+    _mm256_store_pd(&acc[5 * m_BatchSize + l], ry);
+    _mm256_store_pd(&acc[6 * m_BatchSize + l], rz);
+    _mm256_store_pd(&acc[7 * m_BatchSize + l], sum1);
+    _mm256_store_pd(&acc[8 * m_BatchSize + l], sum2);
+    _mm256_store_pd(&acc[9 * m_BatchSize + l], sum3);
+    _mm256_store_pd(&acc[10 * m_BatchSize + l], sum4);
+    _mm256_store_pd(&acc[11 * m_BatchSize + l], sum5);
+    _mm256_store_pd(&acc[12 * m_BatchSize + l], sum6);
+    _mm256_store_pd(&acc[13 * m_BatchSize + l], r2Min);
+  }
+
+  distributeBatchSums(acc, nbPositions, s);
+}
+
+/**
+ * AVX-512 batch kernel : the 8 positions in one register, the coefficients
+ * of each atom being broadcast.
+ */
+__attribute__((target("avx512f")))
+void StdPotentialEngine::addBatchSumsAVX512(const double* x, const double* y, const double* z,
+                                            const double* eox4, const double* rolj6, const double* rolj12,
+                                            const double* charge, unsigned int n,
+                                            const double* px, const double* py, const double* pz,
+                                            unsigned int nbPositions, Sums* s)
+{
+  const __m512d pxl = _mm512_load_pd(px);
+  const __m512d pyl = _mm512_load_pd(py);
+  const __m512d pzl = _mm512_load_pd(pz);
+  const __m512d one = _mm512_set1_pd(1.0);
+  const __m512d six = _mm512_set1_pd(6.0);
+  const __m512d twelve = _mm512_set1_pd(12.0);
+  const __m512d minusThree = _mm512_set1_pd(-3.0);
+
+  __m512d e00 = _mm512_setzero_pd();
+  __m512d dex = _mm512_setzero_pd();
+  __m512d dey = _mm512_setzero_pd();
+  __m512d dez = _mm512_setzero_pd();
+  __m512d rx = _mm512_setzero_pd();
+  __m512d ry = _mm512_setzero_pd();
+  __m512d rz = _mm512_setzero_pd();
+  __m512d sum1 = _mm512_setzero_pd();
+  __m512d sum2 = _mm512_setzero_pd();
+  __m512d sum3 = _mm512_setzero_pd();
+  __m512d sum4 = _mm512_setzero_pd();
+  __m512d sum5 = _mm512_setzero_pd();
+  __m512d sum6 = _mm512_setzero_pd();
+  __m512d r2Min = _mm512_set1_pd(std::numeric_limits<double>::max());
+
+  for (unsigned int i = 0; i < n; ++i) {
+    const __m512d xx = _mm512_sub_pd(pxl, _mm512_set1_pd(x[i]));
+    const __m512d yy = _mm512_sub_pd(pyl, _mm512_set1_pd(y[i]));
+    const __m512d zz = _mm512_sub_pd(pzl, _mm512_set1_pd(z[i]));
+    const __m512d xx2 = _mm512_mul_pd(xx, xx);
+    const __m512d yy2 = _mm512_mul_pd(yy, yy);
+    const __m512d zz2 = _mm512_mul_pd(zz, zz);
+    const __m512d r2 = _mm512_add_pd(_mm512_add_pd(xx2, yy2), zz2);
+    r2Min = _mm512_min_pd(r2Min, r2);
+
+    // Puissances inverses de la distance.
+    const __m512d inv1 = _mm512_div_pd(one, _mm512_sqrt_pd(r2));
+    const __m512d inv2 = _mm512_mul_pd(inv1, inv1);
+    const __m512d inv3 = _mm512_mul_pd(inv2, inv1);
+    const __m512d inv5 = _mm512_mul_pd(inv3, inv2);
+    const __m512d inv6 = _mm512_mul_pd(_mm512_mul_pd(inv2, inv2), inv2);
+    const __m512d inv8 = _mm512_mul_pd(inv6, inv2);
+    const __m512d inv12 = _mm512_mul_pd(inv6, inv6);
+    const __m512d inv14 = _mm512_mul_pd(inv12, inv2);
+
+    // Lennard-Jones.
+    const __m512d eox4i = _mm512_set1_pd(eox4[i]);
+    const __m512d rolj6i = _mm512_set1_pd(rolj6[i]);
+    const __m512d rolj12i = _mm512_set1_pd(rolj12[i]);
+    e00 = _mm512_fmadd_pd(eox4i, _mm512_fmsub_pd(rolj12i, inv12, _mm512_mul_pd(rolj6i, inv6)), e00);
+    const __m512d de00 = _mm512_mul_pd(eox4i,
+      _mm512_fmsub_pd(_mm512_mul_pd(six, rolj6i), inv8, _mm512_mul_pd(_mm512_mul_pd(twelve, rolj12i), inv14)));
+    dex = _mm512_fmadd_pd(de00, xx, dex);
+    dey = _mm512_fmadd_pd(de00, yy, dey);
+    dez = _mm512_fmadd_pd(de00, zz, dez);
+
+    // Ions induits.
+    const __m512d chargei = _mm512_set1_pd(charge[i]);
+    const __m512d q3 = _mm512_mul_pd(chargei, inv3);
+    const __m512d q5 = _mm512_mul_pd(_mm512_mul_pd(minusThree, chargei), inv5);
+    rx = _mm512_fmadd_pd(xx, q3, rx);
+    ry = _mm512_fmadd_pd(yy, q3, ry);
+    rz = _mm512_fmadd_pd(zz, q3, rz);
+    sum1 = _mm512_add_pd(sum1, _mm512_fmadd_pd(xx2, q5, q3));
+    sum2 = _mm512_fmadd_pd(_mm512_mul_pd(xx, yy), q5, sum2);
+    sum3 = _mm512_fmadd_pd(_mm512_mul_pd(xx, zz), q5, sum3);
+    sum4 = _mm512_add_pd(sum4, _mm512_fmadd_pd(yy2, q5, q3));
+    sum5 = _mm512_fmadd_pd(_mm512_mul_pd(yy, zz), q5, sum5);
+    sum6 = _mm512_add_pd(sum6, _mm512_fmadd_pd(zz2, q5, q3));
+  }
+
+  alignas(64) double acc[14 * m_BatchSize];
+  _mm512_store_pd(&acc[0 * m_BatchSize], e00);
+  _mm512_store_pd(&acc[1 * m_BatchSize], dex);
+  _mm512_store_pd(&acc[2 * m_BatchSize], dey);
+  _mm512_store_pd(&acc[3 * m_BatchSize], dez);
+  _mm512_store_pd(&acc[4 * m_BatchSize], rx);
+  _mm512_store_pd(&acc[5 * m_BatchSize], ry);
+  _mm512_store_pd(&acc[6 * m_BatchSize], rz);
+  _mm512_store_pd(&acc[7 * m_BatchSize], sum1);
+  _mm512_store_pd(&acc[8 * m_BatchSize], sum2);
+  _mm512_store_pd(&acc[9 * m_BatchSize], sum3);
+  _mm512_store_pd(&acc[10 * m_BatchSize], sum4);
+  _mm512_store_pd(&acc[11 * m_BatchSize], sum5);
+  _mm512_store_pd(&acc[12 * m_BatchSize], sum6);
+  _mm512_store_pd(&acc[13 * m_BatchSize], r2Min);
+
+  distributeBatchSums(acc, nbPositions, s);
+}
+
+#else
+
+// Sans noyaux x86, resolveKernel ne choisit jamais AVX2 ou AVX-512.
+void StdPotentialEngine::addSumsAVX2(const double* x, const double* y, const double* z,
+                                     const double* eox4, const double* rolj6, const double* rolj12,
+                                     const double* charge, unsigned int n,
+                                     const Vector3D& p, Sums& s)
+{
+  addSumsSIMD(x, y, z, eox4, rolj6, rolj12, charge, n, p, s);
+}
+
+void StdPotentialEngine::addSumsAVX512(const double* x, const double* y, const double* z,
+                                       const double* eox4, const double* rolj6, const double* rolj12,
+                                       const double* charge, unsigned int n,
+                                       const Vector3D& p, Sums& s)
+{
+  addSumsSIMD(x, y, z, eox4, rolj6, rolj12, charge, n, p, s);
+}
+
+void StdPotentialEngine::addBatchSumsAVX2(const double* x, const double* y, const double* z,
+                                          const double* eox4, const double* rolj6, const double* rolj12,
+                                          const double* charge, unsigned int n,
+                                          const double* px, const double* py, const double* pz,
+                                          unsigned int nbPositions, Sums* s)
+{
+  addBatchSumsSIMD(x, y, z, eox4, rolj6, rolj12, charge, n, px, py, pz, nbPositions, s);
+}
+
+void StdPotentialEngine::addBatchSumsAVX512(const double* x, const double* y, const double* z,
+                                            const double* eox4, const double* rolj6, const double* rolj12,
+                                            const double* charge, unsigned int n,
+                                            const double* px, const double* py, const double* pz,
+                                            unsigned int nbPositions, Sums* s)
+{
+  addBatchSumsSIMD(x, y, z, eox4, rolj6, rolj12, charge, n, px, py, pz, nbPositions, s);
+}
+
+#endif
+
+
+bool StdPotentialEngine::isKernelSupported(PotentialKernel kernel)
+{
+  switch (kernel) {
+  case PotentialKernel::SCALAR:
+  case PotentialKernel::SIMD:
+    return true;
+#ifdef COLLISION_X86_KERNELS
+  case PotentialKernel::AVX2:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  case PotentialKernel::AVX512:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f");
+#endif
+  default:
+    return false;
+  }
+}
+
+PotentialKernel StdPotentialEngine::getBestKernel()
+{
+  if (isKernelSupported(PotentialKernel::AVX512)) {
+    return PotentialKernel::AVX512;
+  }
+  if (isKernelSupported(PotentialKernel::AVX2)) {
+    return PotentialKernel::AVX2;
+  }
+  return PotentialKernel::SIMD;
+}
+
+PotentialKernel StdPotentialEngine::resolveKernel(PotentialKernel kernel)
+{
+  if (kernel == PotentialKernel::AUTO || !isKernelSupported(kernel)) {
+    return getBestKernel();
+  }
+  return kernel;
+}
+
+std::string StdPotentialEngine::getKernelName(PotentialKernel kernel)
+{
+  switch (kernel) {
+  case PotentialKernel::SCALAR:
+    return "scalar";
+  case PotentialKernel::SIMD:
+    return "simd";
+  case PotentialKernel::AVX2:
+    return "avx2";
+  case PotentialKernel::AVX512:
+    return "avx512";
+  default:
+    return "auto";
+  }
+}
+
+bool StdPotentialEngine::findKernel(const std::string& name, PotentialKernel& kernel)
+{
+  const PotentialKernel kernels[] = {
+    PotentialKernel::AUTO,
+    PotentialKernel::SCALAR,
+    PotentialKernel::SIMD,
+    PotentialKernel::AVX2,
+    PotentialKernel::AVX512
+  };
+
+  for (PotentialKernel k : kernels) {
+    if (getKernelName(k) == name) {
+      kernel = k;
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,371 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+/**
+ * \file StdPotentialEngine.h
+ * \author Anthony Breant, Clement Poinsot, Jeremie Pantin, Mohamed Takhtoukh, Thomas Capet
+ * \version 1.0
+ * \date 17 october 2026
+ * \brief Evaluates the potential on aligned arrays with a kernel chosen from the CPU's features.
+ */
+
+#ifndef STDPOTENTIALENGINE_H
+#define STDPOTENTIALENGINE_H
+
+#include "PotentialEngine.h"
+
+#include "Vector3D.h"
+
+#include <string>
+#include <vector>
+
+#include <boost/align/aligned_allocator.hpp>
+
+
+class StdPotentialEngine : public PotentialEngine
+{
+  public:
+    /**
+     * Constructor.
+     * \param pos the positions of the atoms, in meters.
+     * \param eolj the EOLJ of each atom, in joules.
+     * \param rolj the ROLJ of each atom, in meters.
+     * \param charges the charge of each atom.
+     * \param maxROLJ the greatest value of rolj.
+     * \param ionInducedDipolePotential the constant of the ion-induced dipole potential.
+     * \param kernel the kernel to use. If not supported by the CPU, the best supported one is used.
+     */
+    StdPotentialEngine(const std::vector<Vector3D>& pos,
+                       const std::vector<double>& eolj,
+                       const std::vector<double>& rolj,
+                       const std::vector<double>& charges,
+                       double maxROLJ,
+                       double ionInducedDipolePotential,
+                       PotentialKernel kernel = PotentialKernel::AUTO);
+
+    /**
+     * Destructor.
+     */
+    virtual ~StdPotentialEngine();
+
+    virtual PotentialEngine* clone() const;
+
+    PotentialKernel getKernel() const {
+      return m_kernel;
+    }
+
+    virtual bool isApproximated() const {
+      return false;
+    }
+
+    unsigned int getNumberAtoms() const {
+      return m_nbAtoms;
+    }
+
+    /**
+     * The positions become the frame of the molecule, with no rotation.
+     */
+    virtual void setPositions(const std::vector<Vector3D>& pos);
+
+    /**
+     * Only the axes are kept : the Helium is brought into the frame of the
+     * molecule at each calculation, and the gradient back.
+     */
+    void setOrientation(const std::vector<Vector3D>& axes);
+
+    double getMinY() const {
+      return m_minY;
+    }
+
+    double getMaxY() const {
+      return m_maxY;
+    }
+
+    double calculatePotential(const Vector3D& p, Vector3D& dPot, double& dMax);
+
+    void calculatePotentials(unsigned int n, const Vector3D* axes, const Vector3D* p,
+                             double* pot, Vector3D* dPot, double* dMax);
+
+    /**
+     * Calculates the potential with the scalar kernel, whatever the kernel
+     * of the engine. Used as reference to verify the other kernels.
+     * \param p the position of the Helium for the calculation.
+     * \param dPot the derivates of the potential.
+     * \param dMax the distance to the closest atom, bounded by 2 * maximal ROLJ.
+     * \return the potential
+     */
+    double calculateReferencePotential(const Vector3D& p, Vector3D& dPot, double& dMax) const;
+
+  public:
+    /**
+     * \return the best kernel supported by the CPU.
+     */
+    static PotentialKernel getBestKernel();
+
+    /**
+     * \param kernel the kernel to test.
+     * \return true if the CPU can run kernel.
+     */
+    static bool isKernelSupported(PotentialKernel kernel);
+
+    /**
+     * Returns the kernel which will be used when kernel is asked.
+     * \param kernel the asked kernel.
+     * \return kernel if supported, the best supported kernel otherwise.
+     */
+    static PotentialKernel resolveKernel(PotentialKernel kernel);
+
+    /**
+     * \param kernel a kernel.
+     * \return the name of kernel, as given on the command line.
+     */
+    static std::string getKernelName(PotentialKernel kernel);
+
+    /**
+     * Finds the kernel named name.
+     * \param name the name of the kernel (auto, scalar, simd, avx2, avx512).
+     * \param kernel the kernel found.
+     * \return true if name is a known kernel.
+     */
+    static bool findKernel(const std::string& name, PotentialKernel& kernel);
+
+  protected:
+    /**
+     * Position of the atoms added to fill the arrays.
+     */
+    static const double m_PaddingPosition;
+
+    /**
+     * Number of atoms handled by the widest vector instruction. The arrays
+     * are filled up to a multiple of this number.
+     */
+    static const unsigned int m_PaddingAtoms;
+
+    /**
+     * Number of positions calculated together by the batch kernels.
+     */
+    static const unsigned int m_BatchSize = 8;
+
+    /**
+     * Aligned vector of doubles, so that a cache line holds 8 coordinates.
+     */
+    typedef std::vector<double, boost::alignment::aligned_allocator<double, 64> > AlignedVector;
+
+    /**
+     * Sums over the atoms, from which the potential and its derivates are computed.
+     */
+    struct Sums {
+      /// Lennard-Jones and its derivates.
+      double e00;
+      double dex;
+      double dey;
+      double dez;
+      /// Field of the charges.
+      double rx;
+      double ry;
+      double rz;
+      /// Derivates of the field of the charges.
+      double sum1;
+      double sum2;
+      double sum3;
+      double sum4;
+      double sum5;
+      double sum6;
+      /// Smallest squared distance to an atom.
+      double r2Min;
+
+      /**
+       * Null sums.
+       */
+      Sums();
+    };
+
+    /**
+     * \param axes the images of the X, Y and Z axes by the rotation of the molecule.
+     * \param p a position in the frame of the laboratory.
+     * \return p in the frame of the molecule.
+     */
+    static Vector3D toMoleculeFrame(const Vector3D* axes, const Vector3D& p) {
+      return Vector3D(axes[0].x * p.x + axes[0].y * p.y + axes[0].z * p.z,
+                      axes[1].x * p.x + axes[1].y * p.y + axes[1].z * p.z,
+                      axes[2].x * p.x + axes[2].y * p.y + axes[2].z * p.z);
+    }
+
+    /**
+     * \param axes the images of the X, Y and Z axes by the rotation of the molecule.
+     * \param v a vector in the frame of the molecule.
+     * \return v in the frame of the laboratory.
+     */
+    static Vector3D toLaboratoryFrame(const Vector3D* axes, const Vector3D& v) {
+      return Vector3D(axes[0].x * v.x + axes[1].x * v.y + axes[2].x * v.z,
+                      axes[0].y * v.x + axes[1].y * v.y + axes[2].y * v.z,
+                      axes[0].z * v.x + axes[1].z * v.y + axes[2].z * v.z);
+    }
+
+    /**
+     * Calculates the potential in the frame of the molecule. Overloaded by the
+     * approximations.
+     * \param q the position of the Helium in the frame of the molecule.
+     * \param dPot the derivates of the potential, in the frame of the molecule.
+     * \param dMax the distance to the closest atom, bounded by 2 * maximal ROLJ.
+     * \return the potential
+     */
+    virtual double calculateMoleculePotential(const Vector3D& q, Vector3D& dPot, double& dMax);
+
+    /**
+     * Calculates the potential at n <= m_BatchSize positions in the frame of
+     * the molecule, the atoms being read once for all the positions.
+     */
+    virtual void calculateMoleculePotentials(unsigned int n, const Vector3D* q,
+                                             double* pot, Vector3D* dPot, double* dMax);
+
+    /**
+     * Scalar kernel in the frame of the molecule.
+     */
+    double calculateMoleculeReferencePotential(const Vector3D& q, Vector3D& dPot, double& dMax) const;
+
+    /**
+     * Combines the sums over the atoms to get the potential and its derivates.
+     * \return the potential.
+     */
+    static double combineSums(double ionInducedDipolePotential, const Sums& s, Vector3D& dPot);
+
+    /**
+     * \param r2Min the smallest squared distance to an atom.
+     * \return the distance to the closest atom, bounded by 2 * maxROLJ.
+     */
+    static double boundDistance(double r2Min, double maxROLJ);
+
+    /**
+     * Adds the contributions of n atoms to s, with the kernel of the engine.
+     * The arrays are aligned on 64 bytes and n is a multiple of m_PaddingAtoms.
+     */
+    void addSums(const double* x, const double* y, const double* z,
+                 const double* eox4, const double* rolj6, const double* rolj12,
+                 const double* charge, unsigned int n,
+                 const Vector3D& p, Sums& s) const;
+
+    /**
+     * Kernels.
+     */
+    static void addSumsSIMD(const double* x, const double* y, const double* z,
+                            const double* eox4, const double* rolj6, const double* rolj12,
+                            const double* charge, unsigned int n,
+                            const Vector3D& p, Sums& s);
+    static void addSumsAVX2(const double* x, const double* y, const double* z,
+                            const double* eox4, const double* rolj6, const double* rolj12,
+                            const double* charge, unsigned int n,
+                            const Vector3D& p, Sums& s);
+    static void addSumsAVX512(const double* x, const double* y, const double* z,
+                              const double* eox4, const double* rolj6, const double* rolj12,
+                              const double* charge, unsigned int n,
+                              const Vector3D& p, Sums& s);
+
+    /**
+     * Adds accumulators of the batch kernels to the sums of each position.
+     * \param acc the accumulators, m_BatchSize values for each sum, in the
+     * order of the fields of Sums.
+     * \param nbPositions the number of positions used.
+     * \param s the sums of the positions.
+     */
+    static void distributeBatchSums(const double* acc, unsigned int nbPositions, Sums* s);
+
+    /**
+     * Batch kernels : adds the contributions of n atoms to the sums of
+     * nbPositions <= m_BatchSize positions, the positions being in the vector
+     * registers and the atoms read one after the other. px, py and pz hold
+     * m_BatchSize coordinates, the unused ones far from the atoms.
+     */
+    static void addBatchSumsSIMD(const double* x, const double* y, const double* z,
+                                 const double* eox4, const double* rolj6, const double* rolj12,
+                                 const double* charge, unsigned int n,
+                                 const double* px, const double* py, const double* pz,
+                                 unsigned int nbPositions, Sums* s);
+    static void addBatchSumsAVX2(const double* x, const double* y, const double* z,
+                                 const double* eox4, const double* rolj6, const double* rolj12,
+                                 const double* charge, unsigned int n,
+                                 const double* px, const double* py, const double* pz,
+                                 unsigned int nbPositions, Sums* s);
+    static void addBatchSumsAVX512(const double* x, const double* y, const double* z,
+                                   const double* eox4, const double* rolj6, const double* rolj12,
+                                   const double* charge, unsigned int n,
+                                   const double* px, const double* py, const double* pz,
+                                   unsigned int nbPositions, Sums* s);
+
+  protected:
+    /**
+     * The kernel used.
+     */
+    PotentialKernel m_kernel;
+
+    /**
+     * Number of atoms of the molecule.
+     */
+    unsigned int m_nbAtoms;
+
+    /**
+     * Number of atoms rounded up to a multiple of 8. The extra atoms are
+     * placed far away and have null coefficients.
+     */
+    unsigned int m_nbPaddedAtoms;
+
+    /**
+     * Coordinates of the atoms, in the frame of the molecule.
+     */
+    AlignedVector m_x;
+    AlignedVector m_y;
+    AlignedVector m_z;
+
+    /**
+     * 4 * EOLJ of each atom.
+     */
+    AlignedVector m_eox4;
+
+    /**
+     * ROLJ^6 of each atom.
+     */
+    AlignedVector m_rolj6;
+
+    /**
+     * ROLJ^12 of each atom.
+     */
+    AlignedVector m_rolj12;
+
+    /**
+     * Charge of each atom.
+     */
+    AlignedVector m_charge;
+
+    /**
+     * ROLJ maximum.
+     */
+    double m_maxROLJ;
+
+    /**
+     * Constant for ion-induced dipole potential.
+     */
+    double m_ionInducedDipolePotential;
+
+    /**
+     * Images of the X, Y and Z axes by the rotation of the molecule.
+     */
+    std::vector<Vector3D> m_axes;
+
+    /**
+     * Smallest and greatest coordinates of the rotated atoms on the Y axis.
+     */
+    double m_minY;
+    double m_maxY;
+};
+
+#endif // STDPOTENTIALENGINE_H
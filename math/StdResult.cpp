@@ -17,8 +17,12 @@ StdResult::StdResult(Molecule* mol)
   : m_mol(mol), m_ehssResult(0.0), m_ehssSaved(false),
     m_ehssPrinted(true), m_paResult(0.0),
     m_paSaved(false), m_paPrinted(true), m_tmResult(0.0),
-    m_tmSaved(false), m_tmPrinted(true), m_asymParam(0.0),
-    m_stdDeviation(0.0), m_nbFailedTraject(0)
+    m_tmSaved(false), m_tmPrinted(true), m_asymParamPrinted(true), m_asymParam(0.0),
+    m_stdDeviation(0.0), m_nbFailedTraject(0), m_potentialError(0.0),
+    m_potentialGradientError(0.0), m_potentialApproximated(false),
+    m_averageNbSteps(0.0), m_averageNbPotentialCalculations(0.0),
+    m_nbCyclesTM(0), m_stdError(0.0), m_nbB2maxTrajectories(0), m_nbSavedB2maxTrajectories(0),
+    m_stdErrorEHSS(0.0), m_stdErrorPA(0.0)
 {
 
 }
@@ -80,6 +80,87 @@ class StdResult : public Result
      */
     int getNumberOfFailedTrajectories() {return m_nbFailedTraject;}
 
+    /**
+     * Returns the greatest relative error of the approximated potential,
+     * estimated against the exact sum.
+     * \return the error on the potential, relatively to max(|potential|, kT).
+     */
+    double getPotentialError() {return m_potentialError;}
+
+    /**
+     * Returns the greatest relative error of the derivates of the
+     * approximated potential, estimated against the exact sum.
+     * \return the error on the derivates, relatively to max(|derivates|, kT / angstrom).
+     */
+    double getPotentialGradientError() {return m_potentialGradientError;}
+
+    /**
+     * \return true if TM was calculated with an approximated potential.
+     */
+    bool isPotentialApproximated() {return m_potentialApproximated;}
+
+    /**
+     * Returns the average number of integration steps of a trajectory in TM.
+     * \return the average number of steps per trajectory.
+     */
+    double getAverageNumberSteps() {return m_averageNbSteps;}
+
+    /**
+     * Returns the average number of calculations of the potential during the
+     * integration of a trajectory in TM.
+     * \return the average number of calculations of the potential per trajectory.
+     */
+    double getAverageNumberPotentialCalculations() {return m_averageNbPotentialCalculations;}
+
+    /**
+     * \return the number of cycles calculated by TM.
+     */
+    int getNumberCyclesTM() {return m_nbCyclesTM;}
+
+    /**
+     * Returns the relative standard error of TM, estimated from its cycles.
+     * \return the relative standard error, in percents.
+     */
+    double getStandardError() {return m_stdError;}
+
+    /**
+     * \return the number of trajectories calculated by the coarse search
+     * of b2max of TM.
+     */
+    int getNumberB2maxTrajectories() {return m_nbB2maxTrajectories;}
+
+    /**
+     * \return the number of trajectories of the coarse search of b2max
+     * saved by its warm start, negative if it cost more trajectories.
+     */
+    int getNumberSavedB2maxTrajectories() {return m_nbSavedB2maxTrajectories;}
+
+    /**
+     * Returns the relative standard error of EHSS, estimated from the
+     * scramblings of its Sobol points.
+     * \return the relative standard error, in percents.
+     */
+    double getStandardErrorEHSS() {return m_stdErrorEHSS;}
+
+    /**
+     * Returns the relative standard error of PA, estimated from the
+     * scramblings of its Sobol points.
+     * \return the relative standard error, in percents.
+     */
+    double getStandardErrorPA() {return m_stdErrorPA;}
+
+    /**
+     * \return the results of TM at the temperatures of the sweep, empty
+     * without sweep.
+     */
+    const std::vector<TemperatureTM>& getTemperatureSweep() {return m_temperatureSweep;}
+
+    /**
+     * \return the results of TM with each buffer gas, empty with a single
+     * buffer gas.
+     */
+    const std::vector<BufferGasTM>& getBufferGasesTM() {return m_bufferGasesTM;}
+
     /**
      * \return true if EHSS was saved, false in the other case.
      */
@@ -151,6 +232,74 @@ class StdResult : public Result
       m_nbFailedTraject = nbFailedTraject;
     }
 
+    /**
+     * Sets the errors of the approximated potential.
+     * Sets isPotentialApproximated() to true.
+     * \param potErr the error on the potential.
+     * \param gradErr the error on the derivates of the potential.
+     */
+    void setPotentialError(double potErr, double gradErr) {
+      m_potentialError = potErr;
+      m_potentialGradientError = gradErr;
+      m_potentialApproximated = true;
+    }
+
+    /**
+     * Sets the averages over the trajectories of TM.
+     * \param nbSteps the average number of integration steps.
+     * \param nbPotentialCalculations the average number of calculations of the potential.
+     */
+    void setTrajectoryStatistics(double nbSteps, double nbPotentialCalculations) {
+      m_averageNbSteps = nbSteps;
+      m_averageNbPotentialCalculations = nbPotentialCalculations;
+    }
+
+    /**
+     * Sets the convergence of TM.
+     * \param nbCycles the number of cycles calculated.
+     * \param stdError the relative standard error, in percents.
+     */
+    void setConvergenceTM(int nbCycles, double stdError) {
+      m_nbCyclesTM = nbCycles;
+      m_stdError = stdError;
+    }
+
+    /**
+     * Adds trajectories of the coarse search of b2max.
+     * \param calculated the number of trajectories calculated.
+     * \param saved the number of trajectories saved by the warm start.
+     */
+    void addB2maxTrajectories(int calculated, int saved) {
+      m_nbB2maxTrajectories += calculated;
+      m_nbSavedB2maxTrajectories += saved;
+    }
+
+    /**
+     * Sets the relative standard errors of EHSS and PA.
+     * \param ehssError the relative standard error of EHSS, in percents.
+     * \param paError the relative standard error of PA, in percents.
+     */
+    void setStandardErrorsEHSSPA(double ehssError, double paError) {
+      m_stdErrorEHSS = ehssError;
+      m_stdErrorPA = paError;
+    }
+
+    /**
+     * Adds the result of TM at a temperature of the sweep.
+     * \param t the result at the temperature.
+     */
+    void addTemperatureTM(const TemperatureTM& t) {
+      m_temperatureSweep.push_back(t);
+    }
+
+    /**
+     * Adds the result of TM with a buffer gas.
+     * \param g the result with the buffer gas.
+     */
+    void addBufferGasTM(const BufferGasTM& g) {
+      m_bufferGasesTM.push_back(g);
+    }
+
     /**
      * Indicates if EHSS needs to be printed.
      * \param true if EHSS needs to be printed, false otherwise.
@@ -169,6 +318,12 @@ class StdResult : public Result
      */
     void TMNeedsToBePrinted(bool b) {m_tmPrinted = b;}
 
+    /**
+     * Indicates if the structural asymmetry parameter needs to be printed.
+     * \param true if the structural asymmetry parameter needs to be printed, false otherwise.
+     */
+    void StructAsymParamNeedsToBePrinted(bool b) {m_asymParamPrinted = b;}
+
     /**
      * Indicates if EHSS needs to be printed.
      * \return true if EHSS needs to be printed, false otherwise.
@@ -187,6 +342,12 @@ class StdResult : public Result
      */
     bool isTMPrintable() {return m_tmPrinted;}
 
+    /**
+     * Indicates if the structural asymmetry parameter needs to be printed.
+     * \return true if the structural asymmetry parameter needs to be printed, false otherwise.
+     */
+    bool isStructAsymParamPrintable() {return m_asymParamPrinted;}
+
     /**
      * Write the result via the FileWriter.
      */
@@ -243,6 +404,11 @@ class StdResult : public Result
      */
     bool m_tmPrinted;
 
+    /**
+     * Indicates if the structural asymmetry parameter needs to be printed.
+     */
+    bool m_asymParamPrinted;
+
     /**
      * The structural asymmetry parameter.
      */
@@ -257,6 +423,52 @@ class StdResult : public Result
      * The number of failed trajectories.
      */
     int m_nbFailedTraject;
+
+    /**
+     * Errors of the approximated potential.
+     */
+    double m_potentialError;
+    double m_potentialGradientError;
+
+    /**
+     * True if TM was calculated with an approximated potential.
+     */
+    bool m_potentialApproximated;
+
+    /**
+     * Averages over the trajectories of TM.
+     */
+    double m_averageNbSteps;
+    double m_averageNbPotentialCalculations;
+
+    /**
+     * Convergence of TM : cycles calculated and relative standard error.
+     */
+    int m_nbCyclesTM;
+    double m_stdError;
+
+    /**
+     * Trajectories of the coarse search of b2max : calculated, and saved
+     * by its warm start.
+     */
+    int m_nbB2maxTrajectories;
+    int m_nbSavedB2maxTrajectories;
+
+    /**
+     * Relative standard errors of EHSS and PA.
+     */
+    double m_stdErrorEHSS;
+    double m_stdErrorPA;
+
+    /**
+     * Results of TM at the temperatures of the sweep.
+     */
+    std::vector<TemperatureTM> m_temperatureSweep;
+
+    /**
+     * Results of TM with each buffer gas.
+     */
+    std::vector<BufferGasTM> m_bufferGasesTM;
 };
 
 #endif // STDRESULT_H
@@ -0,0 +1,81 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+#include "WorkStealingScheduler.h"
+
+#include <omp.h>
+
+#include <algorithm>
+
+WorkStealingScheduler::WorkStealingScheduler(unsigned int nbWorkers)
+  : m_nbWorkers(std::max(nbWorkers, 1u)), m_queues(std::max(nbWorkers, 1u))
+{
+
+}
+
+WorkStealingScheduler::~WorkStealingScheduler()
+{
+
+}
+
+void WorkStealingScheduler::run(unsigned int nbTasks, const std::function<void(unsigned int, unsigned int)>& task)
+{
+  // Chaque worker recoit un bloc contigu de taches.
+  for (unsigned int w = 0; w < m_nbWorkers; ++w) {
+    unsigned int first = (unsigned int) ((unsigned long long) nbTasks * w / m_nbWorkers);
+    unsigned int last = (unsigned int) ((unsigned long long) nbTasks * (w + 1) / m_nbWorkers);
+    m_queues[w].tasks.clear();
+    for (unsigned int t = first; t < last; ++t) {
+      m_queues[w].tasks.push_back(t);
+    }
+  }
+
+  // Les taches ne creent pas d'autres taches : un worker qui ne trouve plus
+  // rien a faire, ni chez lui ni chez les autres, peut s'arreter.
+  #pragma omp parallel num_threads(m_nbWorkers)
+  {
+    const unsigned int worker = omp_get_thread_num();
+    unsigned int t;
+    while (pop(worker, t) || steal(worker, t)) {
+      task(t, worker);
+    }
+  }
+}
+
+bool WorkStealingScheduler::pop(unsigned int worker, unsigned int& task)
+{
+  Queue& queue = m_queues[worker];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.tasks.empty()) {
+    return false;
+  }
+  task = queue.tasks.front();
+  queue.tasks.pop_front();
+  return true;
+}
+
+bool WorkStealingScheduler::steal(unsigned int worker, unsigned int& task)
+{
+  // On parcourt les autres workers a partir du suivant, pour ne pas tous
+  // voler le meme.
+  for (unsigned int i = 1; i < m_nbWorkers; ++i) {
+    Queue& queue = m_queues[(worker + i) % m_nbWorkers];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = queue.tasks.back();
+      queue.tasks.pop_back();
+      return true;
+    }
+  }
+  return false;
+}
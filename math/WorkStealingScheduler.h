@@ -0,0 +1,102 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+/**
+ * \file WorkStealingScheduler.h
+ * \author Anthony Breant, Clement Poinsot, Jeremie Pantin, Mohamed Takhtoukh, Thomas Capet
+ * \version 1.0
+ * \date 17 october 2026
+ * \brief Runs independent tasks of uneven cost on a pool of threads.
+ */
+
+#ifndef WORKSTEALINGSCHEDULER_H
+#define WORKSTEALINGSCHEDULER_H
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+class WorkStealingScheduler
+{
+  public:
+    /**
+     * Constructs a scheduler.
+     * \param nbWorkers the number of threads running the tasks (at least 1).
+     */
+    WorkStealingScheduler(unsigned int nbWorkers);
+
+    /**
+     * Destructor.
+     */
+    virtual ~WorkStealingScheduler();
+
+    /**
+     * \return the number of threads running the tasks.
+     */
+    unsigned int getNumberWorkers() const {
+      return m_nbWorkers;
+    }
+
+    /**
+     * Runs the tasks 0 to nbTasks - 1 and returns once they are all done.
+     * Each worker starts with a contiguous block of tasks, which it runs
+     * in order. A worker without tasks takes the last task of the block of
+     * another worker, so that no thread stays idle while tasks remain.
+     * \param nbTasks the number of tasks.
+     * \param task the function running a task, called with the index of the
+     * task and the index of the worker (lower than getNumberWorkers()).
+     */
+    void run(unsigned int nbTasks, const std::function<void(unsigned int, unsigned int)>& task);
+
+  private:
+    /**
+     * Tasks waiting to be run by a worker.
+     */
+    struct Queue {
+      std::mutex mutex;
+      std::deque<unsigned int> tasks;
+      /// Keeps the queues of two workers on different cache lines.
+      char padding[64];
+    };
+
+  private:
+    /**
+     * Takes the next task of a worker.
+     * \param worker the index of the worker.
+     * \param task the task taken.
+     * \return false if the worker has no more tasks.
+     */
+    bool pop(unsigned int worker, unsigned int& task);
+
+    /**
+     * Takes a task of another worker.
+     * \param worker the index of the worker looking for a task.
+     * \param task the task taken.
+     * \return false if no worker has tasks left.
+     */
+    bool steal(unsigned int worker, unsigned int& task);
+
+  private:
+    /**
+     * Number of threads running the tasks.
+     */
+    unsigned int m_nbWorkers;
+
+    /**
+     * Tasks of each worker.
+     */
+    std::vector<Queue> m_queues;
+};
+
+#endif // WORKSTEALINGSCHEDULER_H
@@ -23,6 +23,7 @@
 #define MOLECULE_H
 
 #include "Atom.h"
+#include "MoleculeData.h"
 #include "../math/Vector3D.h"
 
 #include <vector>
@@ -55,6 +56,12 @@ class Molecule {
      */
     virtual std::vector<Atom*>* getAllAtoms() const = 0;
 
+    /**
+     * \return the atoms as contiguous arrays, to loop over them without
+     * going through the Atom objects.
+     */
+    virtual const MoleculeData& getData() const = 0;
+
     /**
      * \param c a coordinate
      * \return the atom from the specified position.
@@ -78,6 +85,23 @@ class Molecule {
      */
     virtual void addAtom(Atom* a) = 0;
 
+    /**
+     * Adds an atom on the molecule, without allocating an Atom.
+     * \param symbol the symbol of the atom.
+     * \param x the position on the X axis.
+     * \param y the position on the Y axis.
+     * \param z the position on the Z axis.
+     * \param charge the charge of the atom.
+     */
+    virtual void addAtom(const std::string& symbol, double x, double y, double z, double charge) = 0;
+
+    /**
+     * Replaces the charge of the atom i.
+     * \param i the index of the atom, in order of addition.
+     * \param charge the new charge.
+     */
+    virtual void setCharge(unsigned int i, double charge) = 0;
+
     /**
      * Deletes the specified atom.
      * \param a a pointer on an atom.
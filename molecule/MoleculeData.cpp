@@ -0,0 +1,111 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+#include "MoleculeData.h"
+
+#include "../general/AtomInformations.h"
+
+#include <sstream>
+
+MoleculeData::MoleculeData()
+{
+
+}
+
+void MoleculeData::reserve(unsigned int n)
+{
+  m_x.reserve(n);
+  m_y.reserve(n);
+  m_z.reserve(n);
+  m_charges.reserve(n);
+  m_masses.reserve(n);
+  m_elementIds.reserve(n);
+}
+
+void MoleculeData::clear()
+{
+  m_x.clear();
+  m_y.clear();
+  m_z.clear();
+  m_charges.clear();
+  m_masses.clear();
+  m_elementIds.clear();
+}
+
+void MoleculeData::addAtom(const std::string& symbol, double x, double y, double z, double charge)
+{
+  AtomInformations* atomInf = AtomInformations::getInstance();
+  if (!atomInf->isExistingSymbol(symbol)) {
+    std::ostringstream oss;
+    oss << symbol << " is not an existing symbol for an atom.";
+    throw oss.str();
+  }
+  addAtom(atomInf->getElementId(symbol), x, y, z, charge);
+}
+
+void MoleculeData::addAtom(unsigned short elementId, double x, double y, double z, double charge)
+{
+  double mass = AtomInformations::getInstance()->getAtomicMass(elementId);
+  m_x.push_back(x);
+  m_y.push_back(y);
+  m_z.push_back(z);
+  m_charges.push_back(charge);
+  m_masses.push_back(mass);
+  m_elementIds.push_back(elementId);
+}
+
+void MoleculeData::removeAtom(unsigned int i)
+{
+  m_x.erase(m_x.begin() + i);
+  m_y.erase(m_y.begin() + i);
+  m_z.erase(m_z.begin() + i);
+  m_charges.erase(m_charges.begin() + i);
+  m_masses.erase(m_masses.begin() + i);
+  m_elementIds.erase(m_elementIds.begin() + i);
+}
+
+void MoleculeData::translate(const Vector3D& t)
+{
+  const unsigned int n = size();
+  #pragma omp simd
+  for (unsigned int i = 0; i < n; ++i) {
+    m_x[i] += t.x;
+    m_y[i] += t.y;
+    m_z[i] += t.z;
+  }
+}
+
+void MoleculeData::scale(double sx, double sy, double sz)
+{
+  const unsigned int n = size();
+  #pragma omp simd
+  for (unsigned int i = 0; i < n; ++i) {
+    m_x[i] *= sx;
+    m_y[i] *= sy;
+    m_z[i] *= sz;
+  }
+}
+
+const std::string& MoleculeData::getSymbol(unsigned int i) const
+{
+  return AtomInformations::getInstance()->getElementSymbol(m_elementIds[i]);
+}
+
+double MoleculeData::getTotalMass() const
+{
+  double m = 0.0;
+  for (unsigned int i = 0; i < size(); ++i) {
+    m += m_masses[i];
+  }
+  return m;
+}
@@ -0,0 +1,168 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+/**
+ * \file MoleculeData.h
+ * \author Anthony Breant, Clement Poinsot, Jeremie Pantin, Mohamed Takhtoukh, Thomas Capet
+ * \version 1.0
+ * \date 17 october 2026
+ * \brief The atoms of a molecule stored as contiguous arrays.
+ *
+ * Each property of the atoms has its own array, aligned on a cache line,
+ * so that the readers fill a molecule and the operators loop over it without
+ * one allocation per atom. Every atom only keeps the id of its element in
+ * AtomInformations.
+ */
+
+#ifndef MOLECULEDATA_H
+#define MOLECULEDATA_H
+
+#include "../math/AlignedAllocator.h"
+#include "../math/Vector3D.h"
+
+#include <string>
+#include <vector>
+
+class MoleculeData
+{
+  public:
+    typedef std::vector<double, AlignedAllocator<double> > Array;
+
+    /**
+     * Creates an empty molecule.
+     */
+    MoleculeData();
+
+    /**
+     * \return the number of atoms.
+     */
+    unsigned int size() const {return m_elementIds.size();}
+
+    /**
+     * \return true if there is no atom.
+     */
+    bool empty() const {return m_elementIds.empty();}
+
+    /**
+     * Reserves the arrays for n atoms.
+     */
+    void reserve(unsigned int n);
+
+    /**
+     * Removes all the atoms and elements.
+     */
+    void clear();
+
+    /**
+     * Adds an atom at the end of the arrays.
+     * \param symbol the symbol of the atom, it must be known by AtomInformations.
+     * \param x the position on the X axis.
+     * \param y the position on the Y axis.
+     * \param z the position on the Z axis.
+     * \param charge the charge of the atom.
+     */
+    void addAtom(const std::string& symbol, double x, double y, double z, double charge);
+
+    /**
+     * Adds an atom at the end of the arrays.
+     * \param elementId the id of the element of the atom, in AtomInformations.
+     */
+    void addAtom(unsigned short elementId, double x, double y, double z, double charge);
+
+    /**
+     * Removes the atom i, the next atoms are shifted.
+     */
+    void removeAtom(unsigned int i);
+
+    /**
+     * Replaces the charge of the atom i.
+     */
+    void setCharge(unsigned int i, double charge) {m_charges[i] = charge;}
+
+    /**
+     * Moves all the atoms of t.
+     */
+    void translate(const Vector3D& t);
+
+    /**
+     * Multiplies the coordinates of all the atoms, axis by axis.
+     */
+    void scale(double sx, double sy, double sz);
+
+    /**
+     * \return the position of the atom i.
+     */
+    Vector3D getPosition(unsigned int i) const {return Vector3D(m_x[i], m_y[i], m_z[i]);}
+
+    /**
+     * \return the coordinates of all the atoms, axis by axis.
+     */
+    const Array& getX() const {return m_x;}
+    const Array& getY() const {return m_y;}
+    const Array& getZ() const {return m_z;}
+
+    /**
+     * \return the charges of all the atoms.
+     */
+    const Array& getCharges() const {return m_charges;}
+
+    /**
+     * \return the masses of all the atoms.
+     */
+    const Array& getMasses() const {return m_masses;}
+
+    /**
+     * \return the element id of all the atoms.
+     */
+    const std::vector<unsigned short>& getElementIds() const {return m_elementIds;}
+
+    /**
+     * \return the element id of the atom i.
+     */
+    unsigned short getElementId(unsigned int i) const {return m_elementIds[i];}
+
+    /**
+     * \return the symbol of the atom i.
+     */
+    const std::string& getSymbol(unsigned int i) const;
+
+    /**
+     * \return the mass of the molecule.
+     */
+    double getTotalMass() const;
+
+  private:
+    /**
+     * Coordinates of the atoms.
+     */
+    Array m_x;
+    Array m_y;
+    Array m_z;
+
+    /**
+     * Charges of the atoms.
+     */
+    Array m_charges;
+
+    /**
+     * Masses of the atoms, copied from their element.
+     */
+    Array m_masses;
+
+    /**
+     * Element of the atoms, their atomic number.
+     */
+    std::vector<unsigned short> m_elementIds;
+};
+
+#endif // MOLECULEDATA_H
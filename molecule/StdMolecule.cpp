@@ -18,11 +18,14 @@
  */
 
 #include "StdMolecule.h"
+#include "StdAtom.h"
 
 #include "../general/AtomInformations.h"
 
+#include <algorithm>
 #include <sstream>
 #include <map>
+#include <utility>
 
 
 /**
@@ -34,24 +37,41 @@ const std::string intToString(int number);
 
 
 StdMolecule::StdMolecule()
-  : m_name("")
+  : m_atoms(nullptr), m_name("")
 {
-  m_atoms = new std::vector<Atom*>();
+
+}
+
+StdMolecule::StdMolecule(MoleculeData&& data)
+  : m_data(std::move(data)), m_atoms(nullptr), m_name("")
+{
+  // Les positions ne seront hachees qu'a la premiere modification.
+  removeDuplicatedPositions();
 }
 
 StdMolecule::~StdMolecule() {
-  delete m_atoms;
+  if (m_atoms != nullptr) {
+    for (unsigned int i = 0; i < m_atoms->size(); ++i) {
+      delete (*m_atoms)[i];
+    }
+    delete m_atoms;
+  }
 }
 
 std::string StdMolecule::getName()
 {
   // On reconstruit le nom seulement si on n'en a pas.
   if (m_name == "") {
-    // La map qui va contenir les symboles et leur nombre d'occurence.
+    const MoleculeData& data = getData();
+    // Nombre d'occurences de chaque element, puis tri par symbole.
+    std::map<unsigned short, int> idOcc;
+    for (unsigned int i = 0; i < data.size(); ++i) {
+      idOcc[data.getElementId(i)]++;
+    }
+    AtomInformations* atomInf = AtomInformations::getInstance();
     std::map<std::string, int> symbOcc;
-    // On rempli la map avec tous les atomes.
-    for (unsigned int i = 0; i < m_atoms->size(); ++i) {
-      symbOcc[m_atoms->at(i)->getSymbol()]++;
+    for (auto it = idOcc.begin(); it != idOcc.end(); ++it) {
+      symbOcc[atomInf->getElementSymbol(it->first)] = it->second;
     }
     // La map est remplie, on construit la chaine.
     for (auto it = symbOcc.begin(); it != symbOcc.end(); ++it) {
@@ -65,16 +85,33 @@ std::string StdMolecule::getName()
 
 double StdMolecule::getTotalMass() const
 {
-  double m = 0.0;
-  AtomInformations* aI = AtomInformations::getInstance();
-  for (std::vector<Atom*>::iterator i = m_atoms->begin(); i != m_atoms->end(); ++i) {
-      m += aI->getAtomicMass((*i)->getSymbol());
+  return getData().getTotalMass();
+}
+
+std::vector<Atom*>* StdMolecule::getAllAtoms() const
+{
+  // Les objets ne sont construits qu'a la premiere demande.
+  if (m_atoms == nullptr) {
+    m_atoms = new std::vector<Atom*>();
+    m_atoms->reserve(m_data.size());
+    for (unsigned int i = 0; i < m_data.size(); ++i) {
+      m_atoms->push_back(new StdAtom(new Vector3D(m_data.getPosition(i)),
+                                     m_data.getSymbol(i),
+                                     m_data.getCharges()[i]));
+    }
   }
-  return m;
+  return m_atoms;
+}
+
+const MoleculeData& StdMolecule::getData() const
+{
+  synchronize();
+  return m_data;
 }
 
 Atom* StdMolecule::getAtom(const Vector3D& c) const {
-  for (std::vector<Atom*>::iterator i = m_atoms->begin(); i != m_atoms->end(); ++i) {
+  std::vector<Atom*>* atoms = getAllAtoms();
+  for (std::vector<Atom*>::iterator i = atoms->begin(); i != atoms->end(); ++i) {
     if (*((*i)->getPosition()) == c) {
       return *i;
     }
@@ -84,52 +121,150 @@ Atom* StdMolecule::getAtom(const Vector3D& c) const {
 
 void StdMolecule::toInitialPosition()
 {
+  // Sans objets, les tableaux n'ont jamais quitte la position initiale.
+  if (m_atoms == nullptr) {
+    return;
+  }
   for (std::vector<Atom*>::iterator i = m_atoms->begin(); i != m_atoms->end(); ++i) {
-    (*i)->setPosition((*i)->getInitialPosition());
+    (*i)->setPosition(new Vector3D(*((*i)->getInitialPosition())));
   }
 }
 
 void StdMolecule::addAtom(Atom* a) {
-  for (std::vector<Atom*>::iterator i = m_atoms->begin(); i != m_atoms->end(); ++i) {
-    if (*((*i)->getPosition()) == *(a->getPosition())) {
-      return;
-    }
+  getAllAtoms();
+  synchronize();
+  buildPositions();
+  Vector3D* pos = a->getPosition();
+  if (!m_positions.insert(*pos).second) {
+    return;
   }
+  m_data.addAtom(a->getSymbol(), pos->x, pos->y, pos->z, a->getCharge());
   m_atoms->push_back(a);
 
   // Modification de la molcule, nom remis  zro.
   m_name = "";
 }
 
-void StdMolecule::deleteAtom(Atom* a) {
-  for (std::vector<Atom*>::iterator i = m_atoms->begin(); i != m_atoms->end(); ++i) {
-    if (*((*i)->getPosition()) == *(a->getPosition())) {
-      m_atoms->erase(i);
-      return;
-    }
+void StdMolecule::addAtom(const std::string& symbol, double x, double y, double z, double charge) {
+  synchronize();
+  buildPositions();
+  Vector3D pos(x, y, z);
+  if (m_positions.count(pos) > 0) {
+    return;
+  }
+  m_data.addAtom(symbol, x, y, z, charge);
+  m_positions.insert(pos);
+  if (m_atoms != nullptr) {
+    m_atoms->push_back(new StdAtom(new Vector3D(pos), symbol, charge));
   }
-
-  std::ostringstream oss;
-  oss << "Atom at position " << *(a->getPosition()) << " not found";
-  throw oss.str();
 
   // Modification de la molcule, nom remis  zro.
   m_name = "";
 }
 
+void StdMolecule::setCharge(unsigned int i, double charge) {
+  m_data.setCharge(i, charge);
+  if (m_atoms != nullptr) {
+    (*m_atoms)[i]->setCharge(charge);
+  }
+}
+
+void StdMolecule::deleteAtom(Atom* a) {
+  // Copie : l'atome peut etre celui libere.
+  Vector3D c = *(a->getPosition());
+  deleteAtom(c);
+}
+
 void StdMolecule::deleteAtom(const Vector3D& c) {
-  for (std::vector<Atom*>::iterator i = m_atoms->begin(); i != m_atoms->end(); ++i) {
-    if (*((*i)->getPosition()) == c) {
-      i = m_atoms->erase(i);
+  synchronize();
+  buildPositions();
+  for (unsigned int i = 0; i < m_data.size(); ++i) {
+    if (m_data.getPosition(i) == c) {
+      m_data.removeAtom(i);
+      m_positions.erase(c);
+      if (m_atoms != nullptr) {
+        delete (*m_atoms)[i];
+        m_atoms->erase(m_atoms->begin() + i);
+      }
+
+      // Modification de la molcule, nom remis  zro.
+      m_name = "";
       return;
     }
   }
   std::ostringstream oss;
   oss << "Atom at position " << c << " not found";
   throw oss.str();
+}
 
-  // Modification de la molcule, nom remis  zro.
-  m_name = "";
+void StdMolecule::synchronize() const
+{
+  // Les atomes ont pu etre modifies a travers les objets.
+  if (m_atoms == nullptr) {
+    return;
+  }
+  m_data.clear();
+  m_positions.clear();
+  for (unsigned int i = 0; i < m_atoms->size(); ++i) {
+    Atom* a = (*m_atoms)[i];
+    Vector3D* pos = a->getPosition();
+    m_data.addAtom(a->getSymbol(), pos->x, pos->y, pos->z, a->getCharge());
+    m_positions.insert(*pos);
+  }
+}
+
+void StdMolecule::buildPositions() const
+{
+  // Aucune position n'est en double : l'ensemble est complet s'il a
+  // autant d'elements qu'il y a d'atomes.
+  if (m_positions.size() == m_data.size()) {
+    return;
+  }
+  m_positions.clear();
+  m_positions.reserve(m_data.size());
+  for (unsigned int i = 0; i < m_data.size(); ++i) {
+    m_positions.insert(m_data.getPosition(i));
+  }
+}
+
+void StdMolecule::removeDuplicatedPositions()
+{
+  // Tri des atomes par position, a egalite par indice : dans un groupe
+  // de positions egales, seul le premier atome est garde.
+  const MoleculeData::Array& x = m_data.getX();
+  const MoleculeData::Array& y = m_data.getY();
+  const MoleculeData::Array& z = m_data.getZ();
+  std::vector<unsigned int> order(m_data.size());
+  for (unsigned int i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) {
+    if (x[a] != x[b]) return x[a] < x[b];
+    if (y[a] != y[b]) return y[a] < y[b];
+    if (z[a] != z[b]) return z[a] < z[b];
+    return a < b;
+  });
+
+  std::vector<bool> duplicated(order.size(), false);
+  bool found = false;
+  for (unsigned int k = 1; k < order.size(); ++k) {
+    if (x[order[k]] == x[order[k - 1]] && y[order[k]] == y[order[k - 1]] && z[order[k]] == z[order[k - 1]]) {
+      duplicated[order[k]] = true;
+      found = true;
+    }
+  }
+  if (!found) {
+    return;
+  }
+
+  MoleculeData unique;
+  unique.reserve(m_data.size());
+  for (unsigned int i = 0; i < m_data.size(); ++i) {
+    if (!duplicated[i]) {
+      unique.addAtom(m_data.getElementId(i), x[i], y[i], z[i], m_data.getCharges()[i]);
+    }
+  }
+  m_data = std::move(unique);
 }
 
 /**
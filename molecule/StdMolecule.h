@@ -24,8 +24,11 @@
 
 #include "Atom.h"
 #include "Molecule.h"
+#include "MoleculeData.h"
 #include "../math/Vector3D.h"
 
+#include <functional>
+#include <unordered_set>
 #include <vector>
 #include <string>
 
@@ -36,6 +39,13 @@ class StdMolecule : public Molecule {
      */
     StdMolecule();
 
+    /**
+     * Creates a molecule from atoms already stored as arrays. As with
+     * addAtom, an atom at the position of a previous one is ignored.
+     * \param data the atoms, moved into the molecule.
+     */
+    StdMolecule(MoleculeData&& data);
+
     /**
      * Releases allocates resources.
      */
@@ -49,7 +59,7 @@ class StdMolecule : public Molecule {
     /**
      * \return the total number of atom forming molecule composition.
      */
-    unsigned int getAtomNumber() const {return m_atoms->size();}
+    unsigned int getAtomNumber() const {return m_data.size();}
 
     /**
      * \return the mass of the molecule.
@@ -57,9 +67,16 @@ class StdMolecule : public Molecule {
     double getTotalMass() const;
 
     /**
-     * \return a pointer on atom collection.
+     * \return a pointer on atom collection. The Atom objects are only built
+     * at the first call, from then on they are the reference and getData()
+     * follows the changes made through them.
+     */
+    std::vector<Atom*>* getAllAtoms() const;
+
+    /**
+     * \return the atoms as contiguous arrays.
      */
-    std::vector<Atom*>* getAllAtoms() const {return m_atoms;}
+    const MoleculeData& getData() const;
 
     /**
      * \param c a coordinate
@@ -79,13 +96,24 @@ class StdMolecule : public Molecule {
     void setName(std::string n) {m_name = n;}
 
     /**
-     * Adds an atom on the molecule.
+     * Adds an atom on the molecule, the molecule releases it.
      * \param a a pointer on an atom.
      */
     void addAtom(Atom* a);
 
     /**
-     * Deletes the specified atom.
+     * Adds an atom on the molecule, without allocating an Atom.
+     * An atom at the position of another one is ignored.
+     */
+    void addAtom(const std::string& symbol, double x, double y, double z, double charge);
+
+    /**
+     * Replaces the charge of the atom i.
+     */
+    void setCharge(unsigned int i, double charge);
+
+    /**
+     * Deletes the atom at the position of the specified atom, and releases it.
      * \param a a pointer on an atom.
      */
     void deleteAtom(Atom* a);
@@ -98,9 +126,45 @@ class StdMolecule : public Molecule {
 
   private:
     /**
-     * Atoms part of the molecule.
+     * Hash of a position, for the search of duplicated atoms.
+     */
+    struct PositionHash
+    {
+      size_t operator () (const Vector3D& v) const
+      {
+        std::hash<double> h;
+        return h(v.x) ^ (h(v.y) * 31) ^ (h(v.z) * 961);
+      }
+    };
+
+    /**
+     * Refreshes the arrays from the Atom objects, if they were built.
+     */
+    void synchronize() const;
+
+    /**
+     * Fills m_positions with the positions of the atoms, if not done yet.
+     */
+    void buildPositions() const;
+
+    /**
+     * Removes the atoms at the position of a previous atom.
+     */
+    void removeDuplicatedPositions();
+
+  private:
+    /**
+     * Atoms part of the molecule, as arrays.
+     */
+    mutable MoleculeData m_data;
+    /**
+     * Positions of the atoms, to find duplicates in constant time.
+     */
+    mutable std::unordered_set<Vector3D, PositionHash> m_positions;
+    /**
+     * Atoms part of the molecule, as objects, built on demand.
      */
-    std::vector<Atom*>* m_atoms;
+    mutable std::vector<Atom*>* m_atoms;
     /**
      * Molecule's name.
      */
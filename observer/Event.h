@@ -43,6 +43,8 @@ enum class ObservableEvent {
   EHSS_ENDED,
   /// Launched when a calculation by PA method ends.
   PA_ENDED,
+  /// Launched when a cycle of TM method ends, with the current estimate.
+  TM_CYCLE_ENDED,
   /// Launched when a calculation by TM method ends.
   TM_ENDED,
   /// Launched when a calculation is finished.
@@ -0,0 +1,76 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+#include "OrderedObserver.h"
+
+#include "state/CalculationState.h"
+
+OrderedObserver::OrderedObserver(const std::vector<Observer*>& observers, const std::vector<Molecule*>& geometries)
+  : m_observers(observers), m_pendingNotifications(geometries.size()),
+  m_finished(geometries.size(), false), m_current(0)
+{
+  for (unsigned int i = 0; i < geometries.size(); ++i) {
+    m_indexes.insert(std::make_pair(geometries[i], i));
+  }
+}
+
+OrderedObserver::~OrderedObserver()
+{
+
+}
+
+void OrderedObserver::update(ObservableEvent cond, Observable* obs)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  CalculationState* cS = dynamic_cast<CalculationState*>(obs);
+  auto index = cS == nullptr ? m_indexes.end() : m_indexes.find(cS->getMolecule());
+  if (index == m_indexes.end()) {
+    // Notification d'aucune geometrie : rien a ordonner.
+    forward(cond, obs);
+    return;
+  }
+
+  const unsigned int i = index->second;
+  if (cond == ObservableEvent::ONE_CALCULATION_FINISHED) {
+    m_finished[i] = true;
+  }
+  if (i != m_current) {
+    // La geometrie attend son tour, seule sa progression est perdue.
+    if (cond != ObservableEvent::TRAJECTORY_NUMBER_UPDATE && cond != ObservableEvent::TM_CYCLE_ENDED) {
+      m_pendingNotifications[i].push_back(std::make_pair(cond, obs));
+    }
+    return;
+  }
+
+  forward(cond, obs);
+
+  // Les geometries suivantes, deja terminees ou non, rattrapent leur retard.
+  while (m_current < m_finished.size() && m_finished[m_current]) {
+    ++m_current;
+    if (m_current < m_finished.size()) {
+      std::vector<std::pair<ObservableEvent, Observable*> > pending;
+      pending.swap(m_pendingNotifications[m_current]);
+      for (auto it = pending.begin(); it != pending.end(); ++it) {
+        forward(it->first, it->second);
+      }
+    }
+  }
+}
+
+void OrderedObserver::forward(ObservableEvent cond, Observable* obs)
+{
+  for (auto it = m_observers.begin(); it != m_observers.end(); ++it) {
+    (*it)->update(cond, obs);
+  }
+}
@@ -0,0 +1,99 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+/**
+ * \file OrderedObserver.h
+ * \author Anthony Breant, Clement Poinsot, Jeremie Pantin, Mohamed Takhtoukh, Thomas Capet
+ * \version 1.0
+ * \date 17 october 2026
+ * \brief Forwards the notifications of geometries calculated at the same
+ * time, in the order of the geometries.
+ *
+ * The notifications of the first unfinished geometry are forwarded at once.
+ * Those of the next geometries are kept until it is finished, that is until
+ * its ONE_CALCULATION_FINISHED notification, so that the observers receive
+ * them as if the geometries were calculated one after the other. The
+ * progression and the cycles of TM of a geometry kept waiting are not
+ * forwarded.
+ */
+
+#ifndef ORDEREDOBSERVER_H
+#define ORDEREDOBSERVER_H
+
+#include "Observer.h"
+#include "../molecule/Molecule.h"
+
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class OrderedObserver : public Observer
+{
+  public:
+    /**
+     * Constructor.
+     * \param observers the observers to notify.
+     * \param geometries the geometries, in the order of their notifications.
+     */
+    OrderedObserver(const std::vector<Observer*>& observers, const std::vector<Molecule*>& geometries);
+
+    /**
+     * Destructor.
+     */
+    virtual ~OrderedObserver();
+
+    /**
+     * Forwards or keeps the notification of a CalculationState.
+     * Can be called by several threads at once.
+     * \param cond the condition that triggered the notification.
+     * \param obs the CalculationState which triggered the call.
+     */
+    void update(ObservableEvent cond, Observable* obs);
+
+  private:
+    /**
+     * Notifies all the observers.
+     */
+    void forward(ObservableEvent cond, Observable* obs);
+
+  private:
+    /**
+     * The observers to notify.
+     */
+    std::vector<Observer*> m_observers;
+
+    /**
+     * The index of each geometry.
+     */
+    std::unordered_map<Molecule*, unsigned int> m_indexes;
+
+    /**
+     * The notifications kept for each geometry.
+     */
+    std::vector<std::vector<std::pair<ObservableEvent, Observable*> > > m_pendingNotifications;
+
+    /**
+     * Indicates the geometries whose calculations are finished.
+     */
+    std::vector<bool> m_finished;
+
+    /**
+     * The first unfinished geometry.
+     */
+    unsigned int m_current;
+
+    std::mutex m_mutex;
+};
+
+#endif // ORDEREDOBSERVER_H
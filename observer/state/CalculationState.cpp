@@ -1,29 +1,82 @@
 #include "CalculationState.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 
 CalculationState::CalculationState(Molecule* molecule, int totalTrajectories)
-  : m_molecule(molecule), m_finishedTMTrajectories(0),
+  : m_molecule(molecule), m_finishedTMTrajectories(0), m_notifiedPercentage(0),
+  m_progressRate(10.0), m_reporterStopped(true),
   m_totalTMTrajectories(totalTrajectories), m_hasEHSSStarted(false),
   m_hasEHSSEnded(false), m_hasPAStarted(false), m_hasPAEnded(false),
-  m_hasTMStarted(false), m_hasTMEnded(false)
+  m_hasTMStarted(false), m_hasTMEnded(false), m_EHSSResult(0.0), m_PAResult(0.0),
+  m_TMResult(0.0), m_nbTMCycles(0), m_TMCycleResult(0.0), m_TMCycleStandardError(0.0)
 {
 
 }
 
 CalculationState::~CalculationState()
 {
+  // Le thread de progression ne doit pas survivre a l'etat.
+  stopReporter();
+}
+
+void CalculationState::setTMStarted()
+{
+  m_hasTMStarted = true;
+  // Notification des observateurs.
+  notifyObservers(ObservableEvent::TM_STARTED);
+
+  // La progression est notifiee par un autre thread, en dehors du calcul.
+  m_notifiedPercentage = std::floor(getPercentageFinishedTrajectories());
+  // Un seul thread, meme si TM est demarre deux fois.
+  if (!m_reporter.joinable()) {
+    m_reporterStopped = false;
+    m_reporter = std::thread(&CalculationState::reportProgress, this);
+  }
+}
+
+void CalculationState::setTMEnded()
+{
+  stopReporter();
+  // Derniere progression, avant la fin.
+  notifyProgress();
 
+  m_hasTMEnded = true;
+  // Notification des observateurs.
+  notifyObservers(ObservableEvent::TM_ENDED);
+}
+
+void CalculationState::stopReporter()
+{
+  if (m_reporter.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(m_reporterMutex);
+      m_reporterStopped = true;
+    }
+    m_reporterCondition.notify_all();
+    m_reporter.join();
+  }
+}
+
+void CalculationState::reportProgress()
+{
+  const std::chrono::duration<double> period(1.0 / std::max(m_progressRate, 0.001));
+  std::unique_lock<std::mutex> lock(m_reporterMutex);
+  while (!m_reporterCondition.wait_for(lock, period, [this]{ return m_reporterStopped; })) {
+    lock.unlock();
+    notifyProgress();
+    lock.lock();
+  }
 }
 
-void CalculationState::setFinishedTrajectories(int n)
+void CalculationState::notifyProgress()
 {
-  int oldPercentage = std::floor(getPercentageFinishedTrajectories());
-  m_finishedTMTrajectories = n;
   int newPercentage = std::floor(getPercentageFinishedTrajectories());
 
   // On ne notifie que si le pourcentage a augmente d'au moins 1%.
-  if (newPercentage != oldPercentage) {
+  if (newPercentage != m_notifiedPercentage) {
+    m_notifiedPercentage = newPercentage;
     notifyObservers(ObservableEvent::TRAJECTORY_NUMBER_UPDATE);
   }
 }
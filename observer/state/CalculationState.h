@@ -26,6 +26,11 @@
 #include "../Observable.h"
 #include "../../molecule/Molecule.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 
 class CalculationState : public Observable
 {
@@ -53,14 +58,14 @@ class CalculationState : public Observable
      * \return the percentage of trajectories finished.
      */
     double getPercentageFinishedTrajectories() const {
-      return ((double) m_finishedTMTrajectories / (double) m_totalTMTrajectories) * 100.0;
+      return ((double) getNumberFinishedTractories() / (double) m_totalTMTrajectories) * 100.0;
     }
 
     /**
      * \return the number of finished trajectories.
      */
     int getNumberFinishedTractories() const {
-      return m_finishedTMTrajectories;
+      return m_finishedTMTrajectories.load(std::memory_order_relaxed);
     }
 
     /**
@@ -114,9 +119,31 @@ class CalculationState : public Observable
 
     /**
      * Sets the number of trajectories finished to n.
+     * The observers are notified by the reporter thread.
      * \param n the number of trajectories finished by the TM calculations.
      */
-    void setFinishedTrajectories(int n);
+    void setFinishedTrajectories(int n) {
+      m_finishedTMTrajectories.store(n, std::memory_order_relaxed);
+    }
+
+    /**
+     * Adds n trajectories to the finished ones. Lock-free, can be called
+     * by all the threads of the calculation.
+     * The observers are notified by the reporter thread.
+     * \param n the number of trajectories just finished.
+     */
+    void addFinishedTrajectories(int n) {
+      m_finishedTMTrajectories.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    /**
+     * Sets the number of notifications of the progression per second, while
+     * TM calculations run.
+     * \param rate the new number of notifications per second.
+     */
+    void setProgressRate(double rate) {
+      m_progressRate = rate;
+    }
 
     /**
      * Indicates that EHSS calculations have started.
@@ -157,20 +184,18 @@ class CalculationState : public Observable
     /**
      * Indicates that EHSS calculations have started.
      */
-    void setTMStarted() {
-      m_hasTMStarted = true;
-      // Notification des observateurs.
-      notifyObservers(ObservableEvent::TM_STARTED);
-    }
+    void setTMStarted();
 
     /**
      * Indicates that EHSS calculations have ended.
      */
-    void setTMEnded() {
-      m_hasTMEnded = true;
-      // Notification des observateurs.
-      notifyObservers(ObservableEvent::TM_ENDED);
-    }
+    void setTMEnded();
+
+    /**
+     * Stops the thread notifying the progression of TM calculations, when
+     * they end or fail.
+     */
+    void stopReporter();
 
     /**
      * Sets the EHSS result.
@@ -217,10 +242,59 @@ class CalculationState : public Observable
       return m_TMResult;
     }
 
+    /**
+     * Sets the estimate of TM after a cycle, then notifies the observers.
+     * \param nbCycles the number of cycles calculated.
+     * \param r the TM result estimated from these cycles.
+     * \param stdError its relative standard error, in percents, infinite
+     * after the first cycle.
+     */
+    void setTMCycleEnded(int nbCycles, double r, double stdError) {
+      m_nbTMCycles = nbCycles;
+      m_TMCycleResult = r;
+      m_TMCycleStandardError = stdError;
+      // Notification des observateurs.
+      notifyObservers(ObservableEvent::TM_CYCLE_ENDED);
+    }
+
+    /**
+     * \return the number of cycles of TM calculated.
+     */
+    int getNumberTMCycles() const {
+      return m_nbTMCycles;
+    }
+
+    /**
+     * \return the TM result estimated from the cycles calculated.
+     */
+    double getTMCycleResult() const {
+      return m_TMCycleResult;
+    }
+
+    /**
+     * \return the relative standard error of getTMCycleResult(), in percents.
+     */
+    double getTMCycleStandardError() const {
+      return m_TMCycleStandardError;
+    }
+
     void oneCalculationFinished() {
       notifyObservers(ObservableEvent::ONE_CALCULATION_FINISHED);
     }
 
+  private:
+    /**
+     * Notifies the observers at m_progressRate while TM calculations run,
+     * each time the percentage of finished trajectories gains 1%.
+     */
+    void reportProgress();
+
+    /**
+     * Notifies the observers if the percentage of finished trajectories
+     * gained 1% since the last notification.
+     */
+    void notifyProgress();
+
   private:
     /**
      * The molecule on which the calculations are proceeded.
@@ -228,9 +302,35 @@ class CalculationState : public Observable
     Molecule* m_molecule;
 
     /**
-     * The number of trajectories finished in TM calculation.
+     * The number of trajectories finished in TM calculation. Updated by all
+     * the threads, so alone on its cache line.
+     */
+    char m_paddingBefore[64];
+    std::atomic<int> m_finishedTMTrajectories;
+    char m_paddingAfter[64];
+
+    /**
+     * The percentage of trajectories finished at the last notification.
+     */
+    int m_notifiedPercentage;
+
+    /**
+     * Number of notifications of the progression per second.
+     * Default value : 10.
+     */
+    double m_progressRate;
+
+    /**
+     * Thread notifying the progression, while TM calculations run.
+     */
+    std::thread m_reporter;
+
+    /**
+     * Wakes the reporter up when TM calculations end.
      */
-    int m_finishedTMTrajectories;
+    std::mutex m_reporterMutex;
+    std::condition_variable m_reporterCondition;
+    bool m_reporterStopped;
 
     /**
      * The total number of trajectories which will be calculated with TM method.
@@ -281,6 +381,13 @@ class CalculationState : public Observable
      * The TM result.
      */
     double m_TMResult;
+
+    /**
+     * The estimate of TM after the last cycle.
+     */
+    int m_nbTMCycles;
+    double m_TMCycleResult;
+    double m_TMCycleStandardError;
 };
 
 #endif
@@ -25,8 +25,6 @@
 #include "../lib/boost/tokenizer.hpp"
 #include "../molecule/Molecule.h"
 #include "../molecule/StdMolecule.h"
-#include "../molecule/Atom.h"
-#include "../molecule/StdAtom.h"
 
 // BUILDER
 ChgChargesReader::ChgChargesReader(std::string filename) {
@@ -82,7 +80,7 @@ std::vector<Molecule*>* ChgChargesReader::loadResources(std::vector<Molecule*>*
         }
 
         // On controle le symbole atomique.
-        if ((*(*molGeometries)[i]->getAllAtoms())[j]->getSymbol() != tokens[0]) {
+        if ((*molGeometries)[i]->getData().getSymbol(j) != tokens[0]) {
           std::ostringstream oss;
           oss << "Invalid symbol in " << m_filename << " : " << line;
           throw oss.str();
@@ -106,10 +104,9 @@ std::vector<Molecule*>* ChgChargesReader::loadResources(std::vector<Molecule*>*
 
     for (int i = 0; i < geometriesNb; i++) {
         Molecule* mol = (*molGeometries)[i];
-        std::vector<Atom*> atoms = *(mol->getAllAtoms());
         std::vector<double> charges = chargesVector[i];
         for (int j = 0; j < atomsNb; j++) {
-            atoms[j]->setCharge(charges[j]);
+            mol->setCharge(j, charges[j]);
         }
     }
 
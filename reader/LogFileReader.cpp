@@ -23,7 +23,6 @@
 #include "../lib/boost/tokenizer.hpp"
 
 #include "../molecule/StdMolecule.h"
-#include "../molecule/StdAtom.h"
 
 #include "../general/AtomInformations.h"
 
@@ -168,9 +167,7 @@ std::vector<Molecule*>* LogFileReader::loadResources() {
             throw std::string("LogFileReader(loadResources) : error for searching atoms.");
             return nullptr;
           }
-          newMol->addAtom(new StdAtom(
-              new Vector3D(pos[0], pos[1], pos[2]), symbol, 0.0)
-          );
+          newMol->addAtom(symbol, pos[0], pos[1], pos[2], 0.0);
         }
       } else {
         file.close();
@@ -206,9 +203,7 @@ std::vector<Molecule*>* LogFileReader::loadResources() {
             pos[k-1] = strtod((*itLine).c_str(), nullptr);
             ++itLine;
           }
-          newMol->addAtom(new StdAtom(
-              new Vector3D(pos[0], pos[1], pos[2]), symbol, 0.0)
-          );
+          newMol->addAtom(symbol, pos[0], pos[1], pos[2], 0.0);
         }
         // We test if file is valid.
         while (std::getline(reFile, line)) {
@@ -255,9 +250,7 @@ std::vector<Molecule*>* LogFileReader::loadResources() {
           pos[k-1] = strtod((*itLine).c_str(), nullptr);
           ++itLine;
         }
-        newMol->addAtom(new StdAtom(
-            new Vector3D(pos[0], pos[1], pos[2]), symbol, 0.0)
-        );
+        newMol->addAtom(symbol, pos[0], pos[1], pos[2], 0.0);
       }
 
       isPopOption = findPopOption(commandLine);
@@ -318,7 +311,7 @@ std::string LogFileReader::findPopOption(std::string commandLine) {
   else {
     int j = 0;
     const char *c_string = commandLine.c_str();
-    for (foundPopEnd = found+1; commandLine[foundPopEnd] != ' '; foundPopEnd++){
+    for (foundPopEnd = found+1; foundPopEnd < (int) commandLine.length() && commandLine[foundPopEnd] != ' '; foundPopEnd++){
       popOptionCommand += c_string[foundPopEnd];
       j++;
     }
@@ -388,8 +381,7 @@ void LogFileReader::chargeLoading(std::string isPopOption, std::ifstream &file,
           return;
         }
       // Extract of apt charges
-      for (std::vector<Atom*>::iterator it = newMol->getAllAtoms()->begin();
-          it != newMol->getAllAtoms()->end(); it++) {
+      for (unsigned int a = 0; a < newMol->getAtomNumber(); ++a) {
 
         boost::char_separator<char> sep(" \t");
         boost::tokenizer<boost::char_separator<char>> tokchargeLine(line, sep);
@@ -397,7 +389,7 @@ void LogFileReader::chargeLoading(std::string isPopOption, std::ifstream &file,
 
         for (auto i = 0; i < 2; i++) ++itChrg;
 
-        (*it)->setCharge(strtod((*itChrg).c_str(), nullptr));
+        newMol->setCharge(a, strtod((*itChrg).c_str(), nullptr));
 
         if (!(std::getline(file, line))) {
           throw std::string("LogFileReader(loadResources) : freq error file.");
@@ -418,8 +410,7 @@ void LogFileReader::chargeLoading(std::string isPopOption, std::ifstream &file,
               return;
             }
           // Extract of apt charges
-          for (std::vector<Atom*>::iterator it = newMol->getAllAtoms()->begin();
-              it != newMol->getAllAtoms()->end(); it++) {
+          for (unsigned int a = 0; a < newMol->getAtomNumber(); ++a) {
 
             boost::char_separator<char> sep(" \t");
             boost::tokenizer<boost::char_separator<char>> tokchargeLine(line, sep);
@@ -427,7 +418,7 @@ void LogFileReader::chargeLoading(std::string isPopOption, std::ifstream &file,
 
             for (auto i = 0; i < 2; i++) ++itChrg;
 
-            (*it)->setCharge(strtod((*itChrg).c_str(), nullptr));
+            newMol->setCharge(a, strtod((*itChrg).c_str(), nullptr));
 
             if (!(std::getline(file, line))) {
               throw std::string("LogFileReader(loadResources) : freq error file.");
@@ -461,15 +452,14 @@ void LogFileReader::chargeLoading(std::string isPopOption, std::ifstream &file,
           }
         }
         // Extract of apt charges
-        for (std::vector<Atom*>::iterator it = newMol->getAllAtoms()->begin();
-            it != newMol->getAllAtoms()->end(); it++) {
+        for (unsigned int a = 0; a < newMol->getAtomNumber(); ++a) {
 
           boost::tokenizer<boost::char_separator<char>> tokchargeLine(line, sep);
           boost::tokenizer<boost::char_separator<char>>::iterator itChrg = tokchargeLine.begin();
 
           for (auto i = 0; i < 2; i++) ++itChrg;
 
-          (*it)->setCharge(strtod((*itChrg).c_str(), nullptr));
+          newMol->setCharge(a, strtod((*itChrg).c_str(), nullptr));
 
           if (!(std::getline(file, line))) {
             throw std::string("LogFileReader(loadResources) : hirshfeld error file.");
@@ -506,14 +496,13 @@ void LogFileReader::chargeLoading(std::string isPopOption, std::ifstream &file,
           }
         }
         // Extract of charges
-        for (std::vector<Atom*>::iterator it = newMol->getAllAtoms()->begin();
-            it != newMol->getAllAtoms()->end(); it++) {
+        for (unsigned int a = 0; a < newMol->getAtomNumber(); ++a) {
 
           boost::tokenizer<boost::char_separator<char>> tokchargeLine(line, sep);
           boost::tokenizer<boost::char_separator<char>>::iterator itChrg = tokchargeLine.begin();
           for (auto i = 0; i < 2; i++) ++itChrg;
 
-          (*it)->setCharge(strtod((*itChrg).c_str(), nullptr));
+          newMol->setCharge(a, strtod((*itChrg).c_str(), nullptr));
 
           if (!(std::getline(file, line))) {
             throw std::string("LogFileReader(loadResources) : npa/nbo error file.");
@@ -535,14 +524,13 @@ void LogFileReader::chargeLoading(std::string isPopOption, std::ifstream &file,
           }
         }
         // Extract of charges
-        for (std::vector<Atom*>::iterator it = newMol->getAllAtoms()->begin();
-            it != newMol->getAllAtoms()->end(); it++) {
+        for (unsigned int a = 0; a < newMol->getAtomNumber(); ++a) {
 
           boost::tokenizer<boost::char_separator<char>> tokchargeLine(line, sep);
           boost::tokenizer<boost::char_separator<char>>::iterator itChrg = tokchargeLine.begin();
           for (auto i = 0; i < 2; i++) ++itChrg;
 
-          (*it)->setCharge(strtod((*itChrg).c_str(), nullptr));
+          newMol->setCharge(a, strtod((*itChrg).c_str(), nullptr));
 
           if (!(std::getline(file, line))) {
             throw std::string("LogFileReader(loadResources) : npa/nbo error file.");
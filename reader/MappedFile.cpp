@@ -0,0 +1,72 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+#include "MappedFile.h"
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& filename)
+  : m_data(nullptr), m_size(0)
+{
+#ifndef _WIN32
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+      m_size = st.st_size;
+      if (m_size == 0) {
+        close(fd);
+        return;
+      }
+      void* p = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p != MAP_FAILED) {
+        // Le fichier est lu une seule fois, du debut a la fin.
+        madvise(p, m_size, MADV_SEQUENTIAL);
+        close(fd);
+        m_data = static_cast<const char*>(p);
+        return;
+      }
+    }
+    close(fd);
+  }
+#endif
+
+  // Pas de projection possible : copie du fichier en memoire.
+  std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!file) {
+    std::ostringstream oss;
+    oss << "Cannot open file " << filename << ".";
+    throw oss.str();
+  }
+  m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  m_size = m_buffer.size();
+  m_data = m_buffer.empty() ? nullptr : &m_buffer[0];
+}
+
+MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+  if (m_buffer.empty() && m_data != nullptr) {
+    munmap(const_cast<char*>(m_data), m_size);
+  }
+#endif
+}
@@ -0,0 +1,74 @@
+/*
+ * Collision-Code
+ * Free software to calculate collision cross-section with Helium.
+ * Université de Rouen
+ * 2016
+ *
+ * Anthony BREANT
+ * Clement POINSOT
+ * Jeremie PANTIN
+ * Mohamed TAKHTOUKH
+ * Thomas CAPET
+ */
+
+/**
+ * \file MappedFile.h
+ * \author Anthony Breant, Clement Poinsot, Jeremie Pantin, Mohamed Takhtoukh, Thomas Capet
+ * \version 1.0
+ * \date 17 october 2026
+ * \brief Read-only view on the whole content of a file, mapped in memory.
+ */
+
+#ifndef __MAPPEDFILE_H
+#define __MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class MappedFile {
+  public:
+    /**
+     * Maps the file. Throws an exception if it can't be opened.
+     * \param filename the name of the file.
+     */
+    MappedFile(const std::string& filename);
+
+    /**
+     * Unmaps the file.
+     */
+    virtual ~MappedFile();
+
+    /**
+     * \return the first character of the file.
+     */
+    const char* begin() const {return m_data;}
+
+    /**
+     * \return the character after the last one of the file.
+     */
+    const char* end() const {return m_data + m_size;}
+
+    /**
+     * \return the size of the file, in bytes.
+     */
+    size_t size() const {return m_size;}
+
+  private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator = (const MappedFile&);
+
+  private:
+    /**
+     * Content of the file.
+     */
+    const char* m_data;
+    size_t m_size;
+
+    /**
+     * Copy of the file where it can't be mapped.
+     */
+    std::vector<char> m_buffer;
+};
+
+#endif
@@ -14,24 +14,25 @@
 #include "MfjFileReader.h"
 
 #include <iostream>
-#include <fstream>
 #include <cstdlib>
+#include <utility>
 #include <string>
 #include <sstream>
 
-#include "../lib/boost/tokenizer.hpp"
-
 #include "../molecule/StdMolecule.h"
-#include "../molecule/StdAtom.h"
 #include "../general/AtomInformations.h"
 
 // BUILDER
-MfjFileReader::MfjFileReader(std::string filename) {
+MfjFileReader::MfjFileReader(std::string filename)
+  : m_file(nullptr), m_cursor(nullptr), m_geometriesNb(0), m_atomsNb(0), m_corrections(1.0),
+  m_charge(0.0), m_chargesInFile(false), m_geometriesRead(0), m_lineNb(0) {
   setFileName(filename);
 }
 
 // DESTRUCTOR
-MfjFileReader::~MfjFileReader() {}
+MfjFileReader::~MfjFileReader() {
+  close();
+}
 
 // COMMANDS
 void MfjFileReader::setFileName(std::string filename) {
@@ -47,154 +48,320 @@ void MfjFileReader::setFileName(std::string filename) {
   m_filename = filename;
 }
 
-std::vector<Molecule*>* MfjFileReader::loadResources() {
-  std::ifstream file(m_filename.c_str(), std::ios::in);
+namespace
+{
+  /**
+   * Puissances de 10 representees exactement par un double.
+   */
+  const double EXACT_POWERS_OF_TEN[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+
+  /**
+   * Reads the next line of [p, end), like std::getline.
+   * \return false at the end of the buffer.
+   */
+  inline bool nextLine(const char*& p, const char* end, const char*& lineBegin, const char*& lineEnd)
+  {
+    if (p >= end) {
+      return false;
+    }
+    lineBegin = p;
+    while (p < end && *p != '\n') {
+      ++p;
+    }
+    lineEnd = p;
+    if (p < end) {
+      ++p;
+    }
+    return true;
+  }
 
-  std::vector<Molecule*>* moleculevector = new std::vector<Molecule*>();
+  /**
+   * Reads the next token of [p, end) separated by spaces or tabulations.
+   * \return false if there is no more token.
+   */
+  inline bool nextToken(const char*& p, const char* end, const char*& tokenBegin, const char*& tokenEnd)
+  {
+    while (p < end && (*p == ' ' || *p == '\t')) {
+      ++p;
+    }
+    if (p == end) {
+      return false;
+    }
+    tokenBegin = p;
+    while (p < end && *p != ' ' && *p != '\t') {
+      ++p;
+    }
+    tokenEnd = p;
+    return true;
+  }
 
-  AtomInformations* aI = AtomInformations::getInstance();
+  /**
+   * Converts a decimal number with at most 15 significant digits and a
+   * small exponent. The mantissa and the power of ten are then both
+   * exact, so their product or quotient is correctly rounded, like
+   * strtod.
+   * \return false if the token must be converted by the slow path.
+   */
+  inline bool parseDouble(const char* p, const char* end, double& value)
+  {
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+      negative = *p == '-';
+      ++p;
+    }
 
-  if (file) {
-    std::string line;
-    std::string label;
-    std::string unitLength;
-    std::string chargeDistribution;
-    std::string molName;
-    std::string molNameTmp;
+    unsigned long long mantissa = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+    bool digits = false;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+      digits = true;
+      if (mantissa != 0 || *p != '0') {
+        mantissa = mantissa * 10 + (*p - '0');
+        ++significantDigits;
+      }
+    }
+    if (p < end && *p == '.') {
+      for (++p; p < end && *p >= '0' && *p <= '9'; ++p) {
+        digits = true;
+        if (mantissa != 0 || *p != '0') {
+          mantissa = mantissa * 10 + (*p - '0');
+          ++significantDigits;
+        }
+        --exponent;
+      }
+    }
+    if (!digits || significantDigits > 15) {
+      return false;
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+      ++p;
+      bool negativeExponent = false;
+      if (p < end && (*p == '-' || *p == '+')) {
+        negativeExponent = *p == '-';
+        ++p;
+      }
+      if (p == end || *p < '0' || *p > '9') {
+        return false;
+      }
+      int e = 0;
+      for (; p < end && *p >= '0' && *p <= '9' && e < 1000; ++p) {
+        e = e * 10 + (*p - '0');
+      }
+      exponent += negativeExponent ? -e : e;
+    }
+    // Seul un retour chariot peut suivre le nombre.
+    if (p < end && *p != '\r') {
+      return false;
+    }
 
-    int lineNb = 1;
-    if (!(std::getline(file, label))) {
-        std::ostringstream oss;
-        oss << "Empty file : " << m_filename << ".";
-        throw oss.str();
+    if (mantissa == 0) {
+      value = negative ? -0.0 : 0.0;
+      return true;
+    }
+    if (exponent < -22 || exponent > 22) {
+      return false;
     }
-    lineNb++;
+    value = (double) mantissa;
+    if (exponent < 0) {
+      value /= EXACT_POWERS_OF_TEN[-exponent];
+    } else {
+      value *= EXACT_POWERS_OF_TEN[exponent];
+    }
+    if (negative) {
+      value = -value;
+    }
+    return true;
+  }
 
-    std::getline(file, line);
-    int geometriesNb = atoi(line.c_str());
-    lineNb++;
+  /**
+   * Converts the beginning of a token in integer, like atoi.
+   */
+  inline int parseInt(const char* p, const char* end)
+  {
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+      negative = *p == '-';
+      ++p;
+    }
+    int n = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+      n = n * 10 + (*p - '0');
+    }
+    return negative ? -n : n;
+  }
+}
 
-    std::getline(file, line);
-    int atomsNb = atoi(line.c_str());
-    lineNb++;
+std::vector<Molecule*>* MfjFileReader::loadResources() {
+  std::vector<Molecule*>* moleculevector = new std::vector<Molecule*>();
 
-    std::getline(file, unitLength);
-    lineNb++;
+  moleculevector->reserve(open());
+  while (Molecule* newMol = readNextGeometry()) {
+    moleculevector->push_back(newMol);
+  }
+  close();
 
-    std::getline(file, chargeDistribution);
-    lineNb++;
+  return moleculevector;
+}
 
-    std::getline(file, line);
-    double correcter = strtod(line.c_str(), nullptr);
-    const double bohrRadiusToAngstrom = 0.5291772108;
-    double corrections = correcter;
+int MfjFileReader::open() {
+  close();
 
-    if (unitLength == "au") {
-        corrections *= bohrRadiusToAngstrom;
-    }
+  // Le fichier est parcouru en place, sans copie ligne par ligne.
+  m_file = new MappedFile(m_filename);
+  const char* p = m_file->begin();
+  const char* end = m_file->end();
 
-    double charge;
-    if (chargeDistribution == "equal") {
-        charge = 1.0 / atomsNb;
-    } else {
-        charge = 0.0;
-    }
+  const char* lineBegin;
+  const char* lineEnd;
 
-    for (int i = 0; i < geometriesNb; i++) {
-      Molecule* newMol = new StdMolecule();
+  std::string line;
+  std::string label;
+  std::string unitLength;
+  std::string chargeDistribution;
 
-      for (int j = 0; j < atomsNb; j++) {
-        lineNb++;
-        if (!std::getline(file, line)) {
-            std::ostringstream oss;
-            oss << "Don't contain the right number of atoms in at least one molecule in " << m_filename << ".";
-            throw oss.str();
-        }
-        double x, y, z; /* Les valeurs recuperees sont en angstrom /!\ */
-        int symbol;
-        boost::char_separator<char> sep("\t ");
-
-        boost::tokenizer<boost::char_separator<char>> tokenizeParam(line, sep);
-        boost::tokenizer<boost::char_separator<char>>::iterator param = tokenizeParam.begin();
-
-        int colNb = 1;
-        if (param == tokenizeParam.end()) {
-            std::ostringstream oss;
-            oss << "Invalid data on line " << lineNb << " column " << colNb << " in " << m_filename << ".";
-            throw oss.str();
-        }
-        x = convertToDouble((*(param)).c_str()) * corrections;
-        colNb++;
-        param++;
-
-        if (param == tokenizeParam.end()) {
-            std::ostringstream oss;
-            oss << "Invalid data on line " << lineNb << " column " << colNb << " in " << m_filename << ".";
-            throw oss.str();
-        }
-        y = convertToDouble((*(param)).c_str()) * corrections;
-        colNb++;
-        param++;
-
-        if (param == tokenizeParam.end()) {
-            std::ostringstream oss;
-            oss << "Invalid data on line " << lineNb << " column " << colNb << " in " << m_filename << ".";
-            throw oss.str();
-        }
-        z = convertToDouble((*(param)).c_str()) * corrections;
-        colNb++;
-        param++;
-
-        if (param == tokenizeParam.end()) {
-            std::ostringstream oss;
-            oss << "Invalid data on line " << lineNb << " column " << colNb << " in " << m_filename << ".";
-            throw oss.str();
-        }
-        symbol = atoi((*(param)).c_str());
-        colNb++;
-        param++;
-
-        if (chargeDistribution == "calc") {
-            if (param == tokenizeParam.end()) {
-                std::ostringstream oss;
-                oss << "Invalid data on line " << lineNb << " column " << colNb << " in " << m_filename << ".";
-                throw oss.str();
-            }
-            charge = convertToDouble((*(param)).c_str());
-        }
-        newMol->addAtom(new StdAtom(new Vector3D(x, y, z), aI->getSymbol(symbol), charge));
-      }
+  // Les lignes d'en-tete sont copiees, pour etre lues comme avant.
+  m_lineNb = 1;
+  if (!nextLine(p, end, lineBegin, lineEnd)) {
+      std::ostringstream oss;
+      oss << "Empty file : " << m_filename << ".";
+      throw oss.str();
+  }
+  label.assign(lineBegin, lineEnd);
+  m_lineNb++;
 
-      if (i < geometriesNb - 1) {
-        std::getline(file, line); // Eat blank line
-        lineNb++;
-      }
+  if (nextLine(p, end, lineBegin, lineEnd)) {
+    line.assign(lineBegin, lineEnd);
+  }
+  m_geometriesNb = atoi(line.c_str());
+  m_lineNb++;
 
-      if (molName.size() == 0) {
-          molName = newMol->getName();
-      } else {
-          molNameTmp = newMol->getName();
-          if (molName != molNameTmp) {
-              std::ostringstream oss;
-              oss << "Invalid vector of atoms in " << m_filename << ".";
-              throw oss.str();
-          }
-      }
+  if (nextLine(p, end, lineBegin, lineEnd)) {
+    line.assign(lineBegin, lineEnd);
+  }
+  m_atomsNb = atoi(line.c_str());
+  m_lineNb++;
 
-      moleculevector->push_back(newMol);
-    }
+  if (nextLine(p, end, lineBegin, lineEnd)) {
+    unitLength.assign(lineBegin, lineEnd);
+  }
+  m_lineNb++;
+
+  if (nextLine(p, end, lineBegin, lineEnd)) {
+    chargeDistribution.assign(lineBegin, lineEnd);
+  }
+  m_lineNb++;
+
+  if (nextLine(p, end, lineBegin, lineEnd)) {
+    line.assign(lineBegin, lineEnd);
+  }
+  double correcter = strtod(line.c_str(), nullptr);
+  const double bohrRadiusToAngstrom = 0.5291772108;
+  m_corrections = correcter;
+
+  if (unitLength == "au") {
+      m_corrections *= bohrRadiusToAngstrom;
+  }
+
+  if (chargeDistribution == "equal") {
+      m_charge = 1.0 / m_atomsNb;
   } else {
-    std::ostringstream oss;
-    oss << "Cannot open file " << m_filename << ".";
-    throw oss.str();
+      m_charge = 0.0;
   }
+  m_chargesInFile = chargeDistribution == "calc";
 
-  file.close();
+  m_cursor = p;
+  m_geometriesRead = 0;
+  m_molName.clear();
 
-  return moleculevector;
+  return m_geometriesNb < 0 ? 0 : m_geometriesNb;
 }
 
+Molecule* MfjFileReader::readNextGeometry() {
+  if (m_file == nullptr || m_geometriesRead >= m_geometriesNb) {
+    return nullptr;
+  }
+
+  AtomInformations* aI = AtomInformations::getInstance();
+
+  const char* p = m_cursor;
+  const char* end = m_file->end();
+  const char* lineBegin;
+  const char* lineEnd;
+  const char* tokenBegin;
+  const char* tokenEnd;
+
+  // Les atomes sont ecrits directement dans les tableaux de la geometrie.
+  MoleculeData data;
+  data.reserve(m_atomsNb);
+
+  double charge = m_charge;
+  for (int j = 0; j < m_atomsNb; j++) {
+    m_lineNb++;
+    if (!nextLine(p, end, lineBegin, lineEnd)) {
+        std::ostringstream oss;
+        oss << "Don't contain the right number of atoms in at least one molecule in " << m_filename << ".";
+        throw oss.str();
+    }
+    double values[4]; /* Les valeurs recuperees sont en angstrom /!\ */
+    int symbol;
+    const char* q = lineBegin;
+
+    // x, y, z, masse et, si demandee, charge.
+    const int colsNb = m_chargesInFile ? 5 : 4;
+    for (int colNb = 1; colNb <= colsNb; colNb++) {
+      if (!nextToken(q, lineEnd, tokenBegin, tokenEnd)) {
+          std::ostringstream oss;
+          oss << "Invalid data on line " << m_lineNb << " column " << colNb << " in " << m_filename << ".";
+          throw oss.str();
+      }
+      if (colNb == 4) {
+        symbol = parseInt(tokenBegin, tokenEnd);
+      } else {
+        double& v = values[colNb == 5 ? 3 : colNb - 1];
+        if (!parseDouble(tokenBegin, tokenEnd, v)) {
+          v = convertToDouble(std::string(tokenBegin, tokenEnd));
+        }
+      }
+    }
+    if (m_chargesInFile) {
+      charge = values[3];
+    }
+    data.addAtom(aI->getElementIdFromMass(symbol),
+                 values[0] * m_corrections,
+                 values[1] * m_corrections,
+                 values[2] * m_corrections,
+                 charge);
+  }
+
+  m_geometriesRead++;
+  if (m_geometriesRead < m_geometriesNb) {
+    nextLine(p, end, lineBegin, lineEnd); // Eat blank line
+    m_lineNb++;
+  }
+  m_cursor = p;
+
+  Molecule* newMol = new StdMolecule(std::move(data));
+  if (m_molName.size() == 0) {
+      m_molName = newMol->getName();
+  } else if (m_molName != newMol->getName()) {
+      delete newMol;
+      std::ostringstream oss;
+      oss << "Invalid vector of atoms in " << m_filename << ".";
+      throw oss.str();
+  }
 
+  return newMol;
+}
+
+void MfjFileReader::close() {
+  delete m_file;
+  m_file = nullptr;
+  m_cursor = nullptr;
+}
 
 double MfjFileReader::convertToDouble(const std::string& s)
 {
@@ -23,6 +23,7 @@
 #define __MFJFILEREADER_H
 
 #include "FileReader.h"
+#include "MappedFile.h"
 
 class MfjFileReader : public FileReader {
   public:
@@ -54,6 +55,24 @@ class MfjFileReader : public FileReader {
      */
     std::vector<Molecule*>* loadResources();
 
+    /**
+     * Opens the actual file and reads its header, so that its geometries
+     * can be read one after the other by readNextGeometry().
+     * \return the number of geometries announced by the file.
+     */
+    int open();
+
+    /**
+     * Reads the next geometry of the file opened by open().
+     * \return the geometry read, or nullptr if all geometries have been read.
+     */
+    Molecule* readNextGeometry();
+
+    /**
+     * Closes the file opened by open().
+     */
+    void close();
+
   private:
     /**
      * Converts a string in double.
@@ -66,6 +85,32 @@ class MfjFileReader : public FileReader {
      * Name of file to work with.
      */
     std::string m_filename;
+
+    /**
+     * The file opened by open(), and the position of the next geometry in it.
+     */
+    MappedFile* m_file;
+    const char* m_cursor;
+
+    /**
+     * Values of the header of the opened file.
+     */
+    int m_geometriesNb;
+    int m_atomsNb;
+    double m_corrections;
+    double m_charge;
+    bool m_chargesInFile;
+
+    /**
+     * Number of geometries and lines read in the opened file.
+     */
+    int m_geometriesRead;
+    int m_lineNb;
+
+    /**
+     * Name of the first geometry, the next ones must have the same atoms.
+     */
+    std::string m_molName;
 };
 
 #endif
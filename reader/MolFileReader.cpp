@@ -22,7 +22,6 @@
 #include "../lib/boost/tokenizer.hpp"
 
 #include "../molecule/StdMolecule.h"
-#include "../molecule/StdAtom.h"
 
 #include "../general/AtomInformations.h"
 
@@ -98,23 +97,23 @@ std::vector<Molecule*>* MolFileReader::loadResources() {
 
           auto symb = AtomInformations::getInstance()->getAtomicNumber(*param);
 
-          newMol->addAtom(new StdAtom(new Vector3D(x, y, z), symbol, 0.0));
+          newMol->addAtom(symbol, x, y, z, 0.0);
           std::getline(file, line);
         }
         break;
       }
     }
 
-    if (newMol->getAllAtoms()->empty()) {
+    if (newMol->getAtomNumber() == 0) {
       std::ostringstream oss;
       oss << "Empty file : " << m_filename << ".";
       throw oss.str();
     }
 
     // Rpartition des charges homogne.
-    std::vector<Atom*> atoms = *(newMol->getAllAtoms());
-    for (int i = 0; i < atoms.size(); ++i) {
-      atoms[i]->setCharge(1.0 / atoms.size());
+    const unsigned int atomsNb = newMol->getAtomNumber();
+    for (unsigned int i = 0; i < atomsNb; ++i) {
+      newMol->setCharge(i, 1.0 / atomsNb);
     }
 
     moleculevector->push_back(newMol);
@@ -22,7 +22,6 @@
 #include <boost/tokenizer.hpp>
 
 #include "../molecule/StdMolecule.h"
-#include "../molecule/StdAtom.h"
 
 #include "../general/AtomInformations.h"
 
@@ -100,14 +99,14 @@ std::vector<Molecule*>* PdbFileReader::loadResources() {
             throw oss.str();
         }
 
-        newMol->addAtom(new StdAtom(new Vector3D(x, y, z), symbol, 0.0));
+        newMol->addAtom(symbol, x, y, z, 0.0);
       }
     }
     if (newMol->getAtomNumber() > 0) {
       // Répartition des charges homogène.
-      std::vector<Atom*> atoms = *(newMol->getAllAtoms());
-      for (int i = 0; i < atoms.size(); ++i) {
-        atoms[i]->setCharge(1.0 / atoms.size());
+      const unsigned int atomsNb = newMol->getAtomNumber();
+      for (unsigned int i = 0; i < atomsNb; ++i) {
+        newMol->setCharge(i, 1.0 / atomsNb);
       }
       moleculevector->push_back(newMol);
     } else {
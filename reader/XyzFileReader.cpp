@@ -22,7 +22,6 @@
 #include "../lib/boost/tokenizer.hpp"
 
 #include "../molecule/StdMolecule.h"
-#include "../molecule/StdAtom.h"
 
 #include "../general/AtomInformations.h"
 
@@ -120,7 +119,7 @@ std::vector<Molecule*>* XyzFileReader::loadResources() {
             throw oss.str();
         }
         z = convertToDouble((*(param)).c_str());
-        newMol->addAtom(new StdAtom(new Vector3D(x, y, z), symbol, 0.0));
+        newMol->addAtom(symbol, x, y, z, 0.0);
       }
 
       if (molName.size() == 0) {
@@ -135,9 +134,9 @@ std::vector<Molecule*>* XyzFileReader::loadResources() {
       }
 
       // Répartition des charges homogène.
-      std::vector<Atom*> atoms = *(newMol->getAllAtoms());
-      for (int i = 0; i < atoms.size(); ++i) {
-        atoms[i]->setCharge(1.0 / atoms.size());
+      const unsigned int atomsNb = newMol->getAtomNumber();
+      for (unsigned int i = 0; i < atomsNb; ++i) {
+        newMol->setCharge(i, 1.0 / atomsNb);
       }
 
       moleculevector->push_back(newMol);
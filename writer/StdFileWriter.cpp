@@ -37,7 +37,9 @@ void StdFileWriter::visitResult(Result* result) {
   // TM
   if (result->isTMPrintable()) {
       m_stream << "\t|  " << result->getTM();
-      m_stream << "\t|\t  " << result->getStructAsymParam() << "\t";
+      if (result->isStructAsymParamPrintable()) {
+        m_stream << "\t|\t  " << result->getStructAsymParam() << "\t";
+      }
       m_stream << "\t|\t" << result->getStandardDeviation() << "\t";
       m_stream << "\t|\t    " << result->getNumberOfFailedTrajectories() << "\t";
   }
@@ -57,7 +59,9 @@ void StdFileWriter::visitMean(Mean* mean) {
   // TM
   if (mean->isTMPrintable()) {
       m_stream << "\t|  " << mean->getMeanTM();
-      m_stream << "\t|\t  " << mean->getMeanStructAsymParam() << "\t";
+      if (mean->isStructAsymParamPrintable()) {
+        m_stream << "\t|\t  " << mean->getMeanStructAsymParam() << "\t";
+      }
       m_stream << "\t|\t" << mean->getMeanStandardDeviation() << "\t";
       m_stream << "\t|\t    " << mean->getMeanNumberOfFailedTrajectories() << "\t";
   }